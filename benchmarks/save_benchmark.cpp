@@ -0,0 +1,154 @@
+// save_benchmark.cpp
+// Lokalizacja: benchmarks/save_benchmark.cpp
+// Opis: Pomiar przepustowości zapisu katalogu (100k ćwiczeń) - JsonWriter
+//       w repozytoriach vs. dawny zapis przez std::ofstream, drobne << i escape
+//       znak po znaku.
+// Uruchomienie: ./PumpApp_bench [liczba_ćwiczeń]
+
+#include "../core/ExerciseRepository.h"
+#include "../core/WorkoutPlanRepository.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+
+namespace {
+
+constexpr int REPEATS = 5;
+
+// Najlepszy czas z kilku powtórzeń (ms)
+double bestOf(const std::function<void()>& action) {
+    double best = 1e300;
+    for(int i = 0; i < REPEATS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        action();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+size_t fileSize(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file ? static_cast<size_t>(file.tellg()) : 0;
+}
+
+void report(const char* label, double ms, size_t bytes) {
+    std::printf("%-34s %9.1f ms %9.1f MB/s\n", label, ms, bytes / 1e6 / (ms / 1000.0));
+}
+
+// Dawny escape z ExerciseRepository.cpp - znak po znaku, bez SIMD (punkt
+// odniesienia musi mierzyć starą ścieżkę, a nie JsonUtils::escape)
+std::string escapeJson(const std::string& str) {
+    std::string result;
+    for(char c : str) {
+        if(c == '"') result += "\\\"";
+        else if(c == '\\') result += "\\\\";
+        else if(c == '\n') result += "\\n";
+        else if(c == '\r') result += "\\r";
+        else if(c == '\t') result += "\\t";
+        else result += c;
+    }
+    return result;
+}
+
+// Dawny format zapisu (ofstream, << na każde pole) - punkt odniesienia
+void saveExercisesLegacy(const ExerciseRepository& repo, const std::string& path) {
+    std::ofstream file(path);
+    const auto& exercises = repo.getAllExercises();
+    file << "[\n";
+    for(size_t i = 0; i < exercises.size(); ++i) {
+        const auto& ex = exercises[i];
+        file << "  {\n";
+        file << "    \"name\": \"" << escapeJson(ex->getName()) << "\",\n";
+        file << "    \"description\": \"" << escapeJson(ex->getDescription()) << "\",\n";
+        file << "    \"muscles\": \"" << escapeJson(ex->getTargetMuscles()) << "\",\n";
+        file << "    \"type\": \"" << Exercise::typeToString(ex->getType()) << "\"\n";
+        file << "  }";
+        if(i < exercises.size() - 1) file << ",";
+        file << "\n";
+    }
+    file << "]\n";
+}
+
+void savePlansLegacy(const WorkoutPlanRepository& repo, const std::string& path) {
+    std::ofstream file(path);
+    const auto& plans = repo.getAllPlans();
+    file << "[\n";
+    for(size_t i = 0; i < plans.size(); ++i) {
+        file << "  {\n    \"name\": \"" << escapeJson(plans[i]->getName()) << "\",\n";
+        file << "    \"entries\": [\n";
+        const auto& entries = plans[i]->getEntries();
+        for(size_t j = 0; j < entries.size(); ++j) {
+            const auto& entry = entries[j];
+            file << "      {\n";
+            file << "        \"exerciseName\": \"" << escapeJson(entry.exercise->getName()) << "\",\n";
+            file << "        \"sets\": " << entry.sets << ",\n";
+            file << "        \"reps\": " << entry.reps << ",\n";
+            file << "        \"weight\": " << entry.weight << ",\n";
+            file << "        \"restTime\": " << entry.restTime << "\n";
+            file << "      }";
+            if(j < entries.size() - 1) file << ",";
+            file << "\n";
+        }
+        file << "    ]\n  }";
+        if(i < plans.size() - 1) file << ",";
+        file << "\n";
+    }
+    file << "]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t exerciseCount = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t planCount = exerciseCount / 10;
+    const std::string exercisePath = "bench_exercises.json";
+    const std::string planPath = "bench_plans.json";
+
+    ExerciseRepository exercises(exercisePath);
+    for(size_t i = 0; i < exerciseCount; ++i) {
+        const std::string id = std::to_string(i);
+        exercises.addExercise(ExerciseFactory::createExercise(
+            i % 2 ? ExerciseType::WEIGHTED : ExerciseType::BODYWEIGHT,
+            "Ćwiczenie " + id,
+            "Stań prosto, stopy na szerokość barków. Napnij mięśnie brzucha i wykonaj ruch "
+            "w kontrolowanym tempie \"" + id + "\".\nOddychaj równomiernie.",
+            "Klatka piersiowa, triceps"));
+    }
+
+    WorkoutPlanRepository plans(planPath);
+    const auto& all = exercises.getAllExercises();
+    for(size_t i = 0; i < planCount; ++i) {
+        auto plan = std::make_shared<WorkoutPlan>("Plan " + std::to_string(i));
+        for(size_t j = 0; j < 10; ++j) {
+            plan->addEntry(all[(i * 10 + j) % all.size()], 4, 8 + static_cast<int>(j),
+                           40.0 + 2.5 * static_cast<double>(j), 90);
+        }
+        plans.addPlan(plan);
+    }
+
+    std::printf("Zapis %zu ćwiczeń, %zu planów (najlepszy z %d)\n", exerciseCount, planCount, REPEATS);
+
+    double ms = bestOf([&]() { saveExercisesLegacy(exercises, exercisePath); });
+    report("exercises: ofstream <<", ms, fileSize(exercisePath));
+    ms = bestOf([&]() { exercises.saveToJSON(); });
+    report("exercises: JsonWriter", ms, fileSize(exercisePath));
+
+    // Leniwe opisy bez zmian - kopiowane wprost z poprzedniego pliku
+    exercises.setLazyDescriptions(true);
+    exercises.loadFromJSON();
+    ms = bestOf([&]() { exercises.saveToJSON(); });
+    report("exercises: JsonWriter (leniwe)", ms, fileSize(exercisePath));
+
+    ms = bestOf([&]() { savePlansLegacy(plans, planPath); });
+    report("plans: ofstream <<", ms, fileSize(planPath));
+    ms = bestOf([&]() { plans.saveToJSON(); });
+    report("plans: JsonWriter", ms, fileSize(planPath));
+
+    std::remove(exercisePath.c_str());
+    std::remove(planPath.c_str());
+    return 0;
+}
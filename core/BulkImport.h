@@ -0,0 +1,59 @@
+// BulkImport.h
+// Lokalizacja: core/BulkImport.h
+// Opis: Opcje i raport importu wsadowego (ExerciseRepository::importExercises,
+//       WorkoutPlanRepository::importPlans). Błędne wiersze nie rzucają wyjątków -
+//       trafiają do raportu z numerem wiersza, a poprawne są zatwierdzane razem
+//       jako jedna nowa wersja repozytorium. Tu też raport przeładowania pliku
+//       zmienionego z zewnątrz (applyExternalChanges).
+
+#ifndef BULKIMPORT_H
+#define BULKIMPORT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Co zrobić z wierszem, którego nazwa już istnieje w repozytorium
+enum class DuplicatePolicy {
+    SKIP,      // Zostawić istniejący rekord (wiersz liczony jako pominięty)
+    REPLACE    // Podmienić istniejący rekord na wiersz z importu
+};
+
+struct ImportOptions {
+    DuplicatePolicy duplicates = DuplicatePolicy::SKIP;
+    bool allOrNothing = false;   // true = przy jakimkolwiek błędzie nic nie zatwierdzamy
+};
+
+// Błąd pojedynczego wiersza (row = pozycja w danych wejściowych, od 0)
+struct ImportError {
+    size_t row = 0;
+    std::string name;
+    std::string message;
+};
+
+struct ImportReport {
+    size_t added = 0;        // Nowe rekordy
+    size_t replaced = 0;     // Podmienione (DuplicatePolicy::REPLACE)
+    size_t skipped = 0;      // Istniejące, pominięte (DuplicatePolicy::SKIP)
+    size_t duplicates = 0;   // Powtórzenia nazwy w samym imporcie (wygrywa pierwszy wiersz)
+    std::vector<ImportError> errors;
+    bool committed = false;  // false = nic nie zostało zmienione
+
+    bool ok() const { return errors.empty(); }
+};
+
+// Wynik przeładowania pliku zmienionego poza aplikacją - do repozytorium trafia
+// tylko różnica względem pamięci (jedna nowa wersja)
+struct ReloadReport {
+    size_t added = 0;
+    size_t updated = 0;
+    size_t removed = 0;
+    size_t unchanged = 0;
+    std::vector<std::string> conflicts;   // Niezapisane zmiany lokalne - zostały, plik pominięty
+    bool resetConflict = false;           // Niezapisana podmiana całej kolekcji - cały plik pominięty
+    bool reloaded = false;                // false = plik bez zmian, nieczytelny albo pominięty
+
+    size_t changes() const { return added + updated + removed; }
+};
+
+#endif // BULKIMPORT_H
@@ -0,0 +1,83 @@
+// ChangeJournal.cpp
+// Lokalizacja: core/ChangeJournal.cpp
+
+#include "ChangeJournal.h"
+#include <iterator>
+
+void ChangeJournal::recordNames(const std::string& collection, uint64_t version,
+                                const std::vector<std::string>& names, bool reset) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Collection& state = collections[collection];
+    if(reset) {
+        // Nazwy sprzed podmiany nic już nie znaczą - cały plik do zapisu
+        state.names.clear();
+        state.resetVersion = version;
+        return;
+    }
+    for(const auto& name : names) {
+        state.names[name] = version;
+    }
+}
+
+bool ChangeJournal::needsSave(const std::string& collection, uint64_t version) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = collections.find(collection);
+    if(it == collections.end() || !it->second.saved) {
+        return true;
+    }
+    const Collection& state = it->second;
+    if(state.resetVersion != 0 && state.resetVersion <= version) {
+        return true;
+    }
+    for(const auto& entry : state.names) {
+        if(entry.second <= version) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ChangeJournal::markSaved(const std::string& collection, uint64_t version) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Collection& state = collections[collection];
+    if(state.saved && version < state.savedVersion) {
+        return;   // Starszy zapis skończył się po nowszym
+    }
+    state.saved = true;
+    state.savedVersion = version;
+    if(state.resetVersion <= version) {
+        state.resetVersion = 0;
+    }
+    for(auto it = state.names.begin(); it != state.names.end();) {
+        it = it->second <= version ? state.names.erase(it) : std::next(it);
+    }
+}
+
+std::vector<std::string> ChangeJournal::pendingNames(const std::string& collection) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> result;
+    auto it = collections.find(collection);
+    if(it != collections.end()) {
+        for(const auto& entry : it->second.names) {
+            result.push_back(entry.first);
+        }
+    }
+    return result;
+}
+
+bool ChangeJournal::hasPendingChanges(const std::string& collection) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = collections.find(collection);
+    return it != collections.end() && (it->second.resetVersion != 0 || !it->second.names.empty());
+}
+
+bool ChangeJournal::hasPendingReset(const std::string& collection) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = collections.find(collection);
+    return it != collections.end() && it->second.resetVersion != 0;
+}
+
+void ChangeJournal::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    collections.clear();
+}
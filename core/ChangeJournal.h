@@ -0,0 +1,75 @@
+// ChangeJournal.h
+// Lokalizacja: core/ChangeJournal.h
+// Opis: Dziennik zmian od ostatniego zapisu - subskrybent partii zmian
+//       repozytoriów (zob. ChangeBatch w Snapshot.h). Dla każdej kolekcji
+//       pamięta nazwy zmienione od ostatniego zapisu i wersję, w której się
+//       zmieniły, więc DatabaseManager::saveAll przepisuje tylko pliki
+//       kolekcji, które naprawdę się zmieniły.
+//
+// Wątki: wszystkie metody bezpieczne wielowątkowo (record w wątku pisarza,
+// needsSave/markSaved z zapisu w tle).
+
+#ifndef CHANGEJOURNAL_H
+#define CHANGEJOURNAL_H
+
+#include "Snapshot.h"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ChangeJournal {
+private:
+    struct Collection {
+        bool saved = false;                      // Był choć jeden zapis
+        uint64_t savedVersion = 0;               // Wersja ostatniego zapisu
+        uint64_t resetVersion = 0;               // Podmiana całości po zapisie (0 = brak)
+        std::map<std::string, uint64_t> names;   // Nazwa -> wersja ostatniej zmiany
+    };
+
+    mutable std::mutex mutex;
+    std::map<std::string, Collection> collections;
+
+    void recordNames(const std::string& collection, uint64_t version,
+                     const std::vector<std::string>& names, bool reset);
+
+public:
+    // Zapamiętanie partii zmian kolekcji (wołane z subskrypcji repozytorium)
+    template<typename T>
+    void record(const std::string& collection, const ChangeBatch<T>& batch) {
+        std::vector<std::string> names;
+        names.reserve(batch.changes.size());
+        for(const auto& change : batch.changes) {
+            if(change.before) {
+                names.push_back(change.before->getName());
+            }
+            if(change.after && (!change.before || change.after->getName() != change.before->getName())) {
+                names.push_back(change.after->getName());
+            }
+        }
+        recordNames(collection, batch.version, names, batch.reset);
+    }
+
+    // Czy zapis wersji version coś zmieni w pliku: kolekcja jeszcze nie była
+    // zapisywana albo ma zmiany nowsze od zapisu, zawarte w tej wersji
+    bool needsSave(const std::string& collection, uint64_t version) const;
+
+    // Plik kolekcji zawiera już wersję version - zmiany do niej włącznie zapomniane
+    void markSaved(const std::string& collection, uint64_t version);
+
+    // Nazwy zmienione od ostatniego zapisu (posortowane)
+    std::vector<std::string> pendingNames(const std::string& collection) const;
+
+    // Czy są niezapisane zmiany (także podmiana całej kolekcji)
+    bool hasPendingChanges(const std::string& collection) const;
+
+    // Czy od zapisu podmieniono całą kolekcję (clear, replaceAll) - pendingNames
+    // nie wymienia wtedy usuniętych nazw, konfliktem jest cały plik
+    bool hasPendingReset(const std::string& collection) const;
+
+    // Zapomnienie wszystkiego (np. nowy katalog danych)
+    void clear();
+};
+
+#endif // CHANGEJOURNAL_H
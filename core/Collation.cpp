@@ -0,0 +1,107 @@
+// Collation.cpp
+// Lokalizacja: core/Collation.cpp
+
+#include "Collation.h"
+#include <algorithm>
+
+namespace {
+
+// Wagi bajtów klucza (rosnąco)
+constexpr char WEIGHT_SPACE = 0x01;
+constexpr char WEIGHT_PUNCTUATION = 0x02;
+constexpr char WEIGHT_DIGIT = 0x10;    // 0x10..0x19
+constexpr char WEIGHT_LETTER = 0x20;   // 0x20..0x42 - kolejne litery alfabetu polskiego
+constexpr char WEIGHT_OTHER = 0x60;    // Za nim surowe bajty znaku
+
+// Pozycja w alfabecie polskim litery ASCII (bez znaków diakrytycznych)
+int asciiLetterRank(unsigned char lower) {
+    // a ą b c ć d e ę f g h i j k l ł m n ń o ó p q r s ś t u v w x y z ź ż
+    static const int ranks[26] = {
+        0,  2,  3,  5,  6,  8,  9, 10, 11, 12, 13, 14, 16,   // a b c d e f g h i j k l m
+        17, 19, 21, 22, 23, 24, 26, 27, 28, 29, 30, 31, 32   // n o p q r s t u v w x y z
+    };
+    return ranks[lower - 'a'];
+}
+
+// Pozycja polskiej litery z diakrytykiem (UTF-8: 0xC3/0xC4/0xC5 + drugi bajt), -1 = inna
+int polishLetterRank(unsigned char lead, unsigned char next) {
+    switch(lead) {
+    case 0xC3:
+        return (next == 0xB3 || next == 0x93) ? 20 : -1;               // ó
+    case 0xC4:
+        switch(next) {
+        case 0x84: case 0x85: return 1;                                 // ą
+        case 0x86: case 0x87: return 4;                                 // ć
+        case 0x98: case 0x99: return 7;                                 // ę
+        default: return -1;
+        }
+    case 0xC5:
+        switch(next) {
+        case 0x81: case 0x82: return 15;                                // ł
+        case 0x83: case 0x84: return 18;                                // ń
+        case 0x9A: case 0x9B: return 25;                                // ś
+        case 0xB9: case 0xBA: return 33;                                // ź
+        case 0xBB: case 0xBC: return 34;                                // ż
+        default: return -1;
+        }
+    default:
+        return -1;
+    }
+}
+
+// Długość sekwencji UTF-8 po bajcie wiodącym (błędne bajty traktujemy pojedynczo)
+size_t sequenceLength(unsigned char lead) {
+    if(lead >= 0xF0) return 4;
+    if(lead >= 0xE0) return 3;
+    if(lead >= 0xC0) return 2;
+    return 1;
+}
+
+} // namespace
+
+namespace Collation {
+
+std::string polishKey(std::string_view text) {
+    std::string key;
+    key.reserve(text.size());
+
+    for(size_t i = 0; i < text.size();) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        if(c < 0x80) {
+            if(c >= 'A' && c <= 'Z') {
+                key.push_back(static_cast<char>(WEIGHT_LETTER + asciiLetterRank(static_cast<unsigned char>(c - 'A' + 'a'))));
+            } else if(c >= 'a' && c <= 'z') {
+                key.push_back(static_cast<char>(WEIGHT_LETTER + asciiLetterRank(c)));
+            } else if(c >= '0' && c <= '9') {
+                key.push_back(static_cast<char>(WEIGHT_DIGIT + (c - '0')));
+            } else if(c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                key.push_back(WEIGHT_SPACE);
+            } else {
+                key.push_back(WEIGHT_PUNCTUATION);
+            }
+            ++i;
+            continue;
+        }
+
+        const size_t length = std::min(sequenceLength(c), text.size() - i);
+        const int rank = length == 2 ? polishLetterRank(c, static_cast<unsigned char>(text[i + 1])) : -1;
+        if(rank >= 0) {
+            key.push_back(static_cast<char>(WEIGHT_LETTER + rank));
+        } else {
+            key.push_back(WEIGHT_OTHER);
+            key.append(text.substr(i, length));
+        }
+        i += length;
+    }
+    return key;
+}
+
+int comparePolish(std::string_view a, std::string_view b) {
+    const int primary = polishKey(a).compare(polishKey(b));
+    if(primary != 0) {
+        return primary;
+    }
+    return a.compare(b);
+}
+
+} // namespace Collation
@@ -0,0 +1,27 @@
+// Collation.h
+// Lokalizacja: core/Collation.h
+// Opis: Porządek alfabetyczny zgodny z polskim - klucze sortowania jako bajty
+//       porównywane zwykłym operator< (std::map, std::lower_bound), bez
+//       ponownego liczenia porządku przy każdym porównaniu.
+//       Kolejność: spacja < interpunkcja < cyfry < litery
+//       (a ą b c ć d e ę f g h i j k l ł m n ń o ó p q r s ś t u v w x y z ź ż),
+//       wielkość liter bez znaczenia; inne znaki UTF-8 za literami.
+
+#ifndef COLLATION_H
+#define COLLATION_H
+
+#include <string>
+#include <string_view>
+
+namespace Collation {
+
+// Klucz główny tekstu (bez bajtu 0 - można łączyć klucze separatorem '\0')
+std::string polishKey(std::string_view text);
+
+// Porównanie dwóch tekstów w porządku polskim (<0, 0, >0); remis po kluczu
+// rozstrzygany surowymi bajtami, więc porządek jest całkowity
+int comparePolish(std::string_view a, std::string_view b);
+
+} // namespace Collation
+
+#endif // COLLATION_H
@@ -0,0 +1,416 @@
+// CommandLog.cpp
+// Lokalizacja: core/CommandLog.cpp
+
+#include "CommandLog.h"
+#include "ExerciseCatalog.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <exception>
+
+namespace {
+
+struct CommandLogMetrics {
+    Counter& undoCalls = MetricsRegistry::getInstance().counter("pumpapp_command_undo_total");
+    Counter& redoCalls = MetricsRegistry::getInstance().counter("pumpapp_command_redo_total");
+    Counter& diverged = MetricsRegistry::getInstance().counter("pumpapp_command_diverged_total");
+};
+
+CommandLogMetrics& metrics() {
+    static CommandLogMetrics instance;
+    return instance;
+}
+
+bool sameEntry(const PlanEntry& a, const PlanEntry& b) {
+    return a.exercise == b.exercise && a.sets == b.sets && a.reps == b.reps
+           && a.weight == b.weight && a.restTime == b.restTime;
+}
+
+// Fragment [offset, offset + removed.size()) bieżącego planu zgadza się z zapisem delty
+bool matchesRange(const PlanEntries& entries, size_t offset, const std::vector<PlanEntry>& expected) {
+    if(offset + expected.size() > entries.size()) {
+        return false;
+    }
+    for(size_t i = 0; i < expected.size(); ++i) {
+        if(!sameEntry(entries[offset + i], expected[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Nowa wersja planu: kopia bieżącej (wpisy współdzielone) z podmienionym fragmentem
+std::shared_ptr<WorkoutPlan> rebuildPlan(const WorkoutPlan& current, const std::string& name,
+                                         size_t offset, size_t removedCount,
+                                         const std::vector<PlanEntry>& inserted) {
+    auto plan = std::make_shared<WorkoutPlan>(current);
+    plan->setName(name);
+    for(size_t i = 0; i < removedCount; ++i) {
+        plan->removeEntry(offset);
+    }
+    for(size_t i = 0; i < inserted.size(); ++i) {
+        const auto& e = inserted[i];
+        plan->insertEntry(offset + i, e.exercise, e.sets, e.reps, e.weight, e.restTime);
+    }
+    return plan;
+}
+
+std::vector<PlanEntry> slice(const PlanEntries& entries, size_t from, size_t to) {
+    std::vector<PlanEntry> result;
+    result.reserve(to - from);
+    for(size_t i = from; i < to; ++i) {
+        result.push_back(entries[i]);
+    }
+    return result;
+}
+
+size_t entriesMemory(const std::vector<PlanEntry>& entries) {
+    return entries.capacity() * sizeof(PlanEntry);
+}
+
+} // namespace
+
+CommandLog::CommandLog(ExerciseRepository& exercises, WorkoutPlanRepository& plans, size_t limit)
+    : exerciseRepo(exercises), planRepo(plans), limit(limit)
+    , stepsGauge(MetricsRegistry::getInstance().gauge(
+          MetricsRegistry::labeled("pumpapp_command_history_steps", "file", plans.getFilePath()))) {
+    batchBegin = [this]() {
+        exerciseRepo.beginBatch();
+        planRepo.beginBatch();
+    };
+    batchCommit = [this]() {
+        exerciseRepo.commitBatch();
+        planRepo.commitBatch();
+    };
+}
+
+void CommandLog::setBatchHooks(std::function<void()> begin, std::function<void()> commit) {
+    batchBegin = std::move(begin);
+    batchCommit = std::move(commit);
+}
+
+// === Edycje ===
+
+void CommandLog::addExercise(std::shared_ptr<Exercise> exercise) {
+    exerciseRepo.addExercise(exercise);   // Wyjątek = brak zmiany, nic do zapisania
+    Change change;
+    change.target = Change::Target::EXERCISE;
+    change.kind = Change::Kind::ADD;
+    change.exerciseAfter = std::move(exercise);
+    record(std::move(change), "Dodanie ćwiczenia");
+}
+
+bool CommandLog::updateExercise(const std::string& oldName, std::shared_ptr<Exercise> newExercise) {
+    auto previous = exerciseRepo.findByName(oldName);
+    if(!previous || !exerciseRepo.updateExercise(oldName, newExercise)) {
+        return false;
+    }
+    Change change;
+    change.target = Change::Target::EXERCISE;
+    change.kind = Change::Kind::UPDATE;
+    change.exerciseBefore = std::move(previous);
+    change.exerciseAfter = std::move(newExercise);
+    record(std::move(change), "Edycja ćwiczenia");
+    return true;
+}
+
+bool CommandLog::removeExercise(const std::string& name) {
+    auto previous = exerciseRepo.findByName(name);
+    if(!previous || !exerciseRepo.removeExercise(name)) {
+        return false;
+    }
+    Change change;
+    change.target = Change::Target::EXERCISE;
+    change.kind = Change::Kind::REMOVE;
+    change.exerciseBefore = std::move(previous);
+    record(std::move(change), "Usunięcie ćwiczenia");
+    return true;
+}
+
+void CommandLog::addPlan(std::shared_ptr<WorkoutPlan> plan) {
+    planRepo.addPlan(plan);
+    Change change;
+    change.target = Change::Target::PLAN;
+    change.kind = Change::Kind::ADD;
+    change.plan = std::move(plan);
+    record(std::move(change), "Dodanie planu");
+}
+
+bool CommandLog::updatePlan(const std::string& oldName, std::shared_ptr<WorkoutPlan> newPlan) {
+    auto previous = planRepo.findByName(oldName);
+    if(!previous || !newPlan || !planRepo.updatePlan(oldName, newPlan)) {
+        return false;
+    }
+    recordPlanUpdate(*previous, *newPlan);
+    return true;
+}
+
+bool CommandLog::commitDraft(const PlanDraft& draft) {
+    if(draft.isNew()) {
+        if(!draft.plan) {
+            return false;
+        }
+        addPlan(draft.plan);
+        return true;
+    }
+    if(!planRepo.commitDraft(draft)) {
+        return false;
+    }
+    recordPlanUpdate(*draft.base, *draft.plan);
+    return true;
+}
+
+void CommandLog::recordPlanUpdate(const WorkoutPlan& previous, const WorkoutPlan& current) {
+    if(previous.sharesEntriesWith(current) && previous.getName() == current.getName()) {
+        return;   // Szkic bez zmian - nie ma czego cofać
+    }
+
+    // Delta: pomijamy wspólny początek i koniec listy wpisów
+    const auto& before = previous.getEntries();
+    const auto& after = current.getEntries();
+    size_t prefix = 0;
+    while(prefix < before.size() && prefix < after.size() && sameEntry(before[prefix], after[prefix])) {
+        ++prefix;
+    }
+    size_t suffix = 0;
+    while(suffix < before.size() - prefix && suffix < after.size() - prefix
+          && sameEntry(before[before.size() - 1 - suffix], after[after.size() - 1 - suffix])) {
+        ++suffix;
+    }
+    if(previous.getName() == current.getName() && prefix + suffix == before.size()
+       && before.size() == after.size()) {
+        return;   // Nowy obiekt, ta sama treść
+    }
+
+    Change change;
+    change.target = Change::Target::PLAN;
+    change.kind = Change::Kind::UPDATE;
+    change.nameBefore = previous.getName();
+    change.nameAfter = current.getName();
+    change.offset = prefix;
+    change.entriesBefore = slice(before, prefix, before.size() - suffix);
+    change.entriesAfter = slice(after, prefix, after.size() - suffix);
+    record(std::move(change), "Edycja planu");
+}
+
+bool CommandLog::removePlan(const std::string& name) {
+    auto previous = planRepo.findByName(name);
+    if(!previous || !planRepo.removePlan(name)) {
+        return false;
+    }
+    Change change;
+    change.target = Change::Target::PLAN;
+    change.kind = Change::Kind::REMOVE;
+    change.plan = std::move(previous);
+    record(std::move(change), "Usunięcie planu");
+    return true;
+}
+
+// === Transakcje ===
+
+void CommandLog::beginTransaction(const std::string& label) {
+    if(depth++ == 0) {
+        open.label = label;
+        batchBegin();
+    }
+}
+
+void CommandLog::commitTransaction() {
+    if(depth == 0) {
+        return;   // Nadmiarowy commit nic nie robi (jak commitBatch)
+    }
+    if(--depth > 0) {
+        return;
+    }
+    if(!open.changes.empty()) {
+        push(std::move(open));
+    }
+    open = CommandGroup();
+    batchCommit();
+}
+
+void CommandLog::record(Change change, const char* label) {
+    redoStack.clear();   // Nowa zmiana unieważnia ponowienia
+    if(depth > 0) {
+        open.changes.push_back(std::move(change));
+        return;
+    }
+    CommandGroup group;
+    group.label = label;
+    group.changes.push_back(std::move(change));
+    push(std::move(group));
+}
+
+void CommandLog::push(CommandGroup group) {
+    undoStack.push_back(std::move(group));
+    while(undoStack.size() > limit) {
+        undoStack.pop_front();
+    }
+    stepsGauge.set(static_cast<int64_t>(undoStack.size() + redoStack.size()));
+}
+
+// === Historia ===
+
+bool CommandLog::undo() {
+    if(undoStack.empty() || depth > 0) {
+        return false;
+    }
+    metrics().undoCalls.increment();
+    CommandGroup group = std::move(undoStack.back());
+    undoStack.pop_back();
+
+    if(!replay(group, false)) {
+        return false;
+    }
+    redoStack.push_back(std::move(group));
+    return true;
+}
+
+bool CommandLog::redo() {
+    if(redoStack.empty() || depth > 0) {
+        return false;
+    }
+    metrics().redoCalls.increment();
+    CommandGroup group = std::move(redoStack.back());
+    redoStack.pop_back();
+
+    if(!replay(group, true)) {
+        return false;
+    }
+    undoStack.push_back(std::move(group));
+    return true;
+}
+
+bool CommandLog::replay(const CommandGroup& group, bool forward) {
+    batchBegin();
+    bool ok = true;
+    const size_t count = group.changes.size();
+    for(size_t i = 0; i < count && ok; ++i) {
+        ok = apply(group.changes[forward ? i : count - 1 - i], forward);
+    }
+    batchCommit();
+
+    if(!ok) {
+        // Ktoś zmienił dane z pominięciem historii - dalsze kroki nie pasują do stanu
+        metrics().diverged.increment();
+        Logger::warning("CommandLog", "Historia niezgodna z danymi - wyczyszczono",
+                        {{"label", group.label}, {"direction", forward ? "redo" : "undo"}});
+        clear();
+    }
+    return ok;
+}
+
+bool CommandLog::apply(const Change& change, bool forward) {
+    try {
+        return change.target == Change::Target::EXERCISE ? applyExercise(change, forward)
+                                                         : applyPlan(change, forward);
+    } catch(const std::exception& e) {
+        Logger::warning("CommandLog", "Nie można odtworzyć zmiany", {{"error", e.what()}});
+        return false;
+    }
+}
+
+bool CommandLog::applyExercise(const Change& change, bool forward) {
+    const auto& before = change.exerciseBefore;
+    const auto& after = change.exerciseAfter;
+
+    switch(change.kind) {
+    case Change::Kind::ADD:
+        if(forward) {
+            exerciseRepo.addExercise(after);
+            return true;
+        }
+        return exerciseRepo.removeExercise(after->getName());
+
+    case Change::Kind::REMOVE:
+        if(forward) {
+            return exerciseRepo.removeExercise(before->getName());
+        }
+        // Usunięcie przesłonięcia odsłoniło wersję z katalogu - przywracamy przesłonięcie
+        if(exerciseRepo.exists(before->getName())) {
+            return exerciseRepo.updateExercise(before->getName(), before);
+        }
+        exerciseRepo.addExercise(before);
+        return true;
+
+    case Change::Kind::UPDATE: {
+        if(forward) {
+            return exerciseRepo.updateExercise(before->getName(), after);
+        }
+        // Pierwsza edycja ćwiczenia z katalogu - cofnięcie usuwa przesłonięcie,
+        // zamiast zapisywać w nakładce kopię identyczną z katalogiem
+        auto base = exerciseRepo.getBaseCatalog();
+        if(base && base->findByName(before->getName()) == before) {
+            return exerciseRepo.removeExercise(after->getName());
+        }
+        return exerciseRepo.updateExercise(after->getName(), before);
+    }
+    }
+    return false;
+}
+
+bool CommandLog::applyPlan(const Change& change, bool forward) {
+    switch(change.kind) {
+    case Change::Kind::ADD:
+        if(forward) {
+            planRepo.addPlan(change.plan);
+            return true;
+        }
+        return planRepo.removePlan(change.plan->getName());
+
+    case Change::Kind::REMOVE:
+        if(forward) {
+            return planRepo.removePlan(change.plan->getName());
+        }
+        planRepo.addPlan(change.plan);   // Wraca na koniec listy
+        return true;
+
+    case Change::Kind::UPDATE: {
+        const std::string& from = forward ? change.nameBefore : change.nameAfter;
+        const std::string& to = forward ? change.nameAfter : change.nameBefore;
+        const auto& removed = forward ? change.entriesBefore : change.entriesAfter;
+        const auto& inserted = forward ? change.entriesAfter : change.entriesBefore;
+
+        auto current = planRepo.findByName(from);
+        if(!current || !matchesRange(current->getEntries(), change.offset, removed)) {
+            return false;
+        }
+        return planRepo.updatePlan(from, rebuildPlan(*current, to, change.offset, removed.size(), inserted));
+    }
+    }
+    return false;
+}
+
+void CommandLog::setLimit(size_t steps) {
+    limit = steps;
+    while(undoStack.size() > limit) {
+        undoStack.pop_front();
+    }
+    stepsGauge.set(static_cast<int64_t>(undoStack.size() + redoStack.size()));
+}
+
+void CommandLog::clear() {
+    undoStack.clear();
+    redoStack.clear();
+    stepsGauge.set(0);
+}
+
+size_t CommandLog::estimateMemoryUsage() const {
+    size_t bytes = sizeof(CommandLog);
+    auto groupBytes = [](const CommandGroup& group) {
+        size_t total = sizeof(CommandGroup) + group.label.capacity()
+                       + group.changes.capacity() * sizeof(Change);
+        for(const auto& change : group.changes) {
+            total += change.nameBefore.capacity() + change.nameAfter.capacity()
+                     + entriesMemory(change.entriesBefore) + entriesMemory(change.entriesAfter);
+        }
+        return total;
+    };
+    for(const auto& group : undoStack) {
+        bytes += groupBytes(group);
+    }
+    for(const auto& group : redoStack) {
+        bytes += groupBytes(group);
+    }
+    return bytes;
+}
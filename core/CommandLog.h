@@ -0,0 +1,151 @@
+// CommandLog.h
+// Lokalizacja: core/CommandLog.h
+// Opis: Cofnij/ponów dla zmian ćwiczeń i planów. Edycje wykonujemy przez
+//       CommandLog zamiast bezpośrednio w repozytoriach - każda zapisuje
+//       minimalną deltę:
+//       - ćwiczenie: wskaźnik do obiektu sprzed i po zmianie. Opublikowane
+//         ćwiczenia są niezmienne, więc to te same obiekty, które trzymają
+//         snapshoty (MVCC) i które zapisuje saveSnapshot - historia nie kopiuje
+//         danych, tylko przedłuża życie starej wersji;
+//       - plan: zmieniony fragment listy wpisów (wspólny początek i koniec
+//         pominięte) i ewentualnie nazwa, a nie dwie pełne kopie planu.
+//       Transakcja grupuje dowolnie wiele zmian w jeden krok historii i jedną
+//       publikację wersji (beginTransaction/commitTransaction albo
+//       CommandTransaction jako RAII).
+// Design Pattern: Command Pattern, Memento (delta zamiast pełnego stanu)
+//
+// Wątki: jeden wątek pisarza (GUI) - jak kopia robocza repozytoriów.
+// Czytelnicy korzystają ze snapshotów i nie widzą historii.
+
+#ifndef COMMANDLOG_H
+#define COMMANDLOG_H
+
+#include "ExerciseRepository.h"
+#include "WorkoutPlanRepository.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Jedna zmiana w repozytorium
+struct Change {
+    enum class Target { EXERCISE, PLAN };
+    enum class Kind { ADD, UPDATE, REMOVE };
+
+    Target target = Target::EXERCISE;
+    Kind kind = Kind::ADD;
+
+    // Ćwiczenie: stan przed (UPDATE/REMOVE) i po (ADD/UPDATE)
+    std::shared_ptr<Exercise> exerciseBefore;
+    std::shared_ptr<Exercise> exerciseAfter;
+
+    // Plan dodany/usunięty - jedyna kopia, gdy nie ma go w repozytorium
+    std::shared_ptr<WorkoutPlan> plan;
+
+    // Plan zmieniony: nazwy i podmieniony fragment wpisów od pozycji offset
+    std::string nameBefore;
+    std::string nameAfter;
+    size_t offset = 0;
+    std::vector<PlanEntry> entriesBefore;
+    std::vector<PlanEntry> entriesAfter;
+};
+
+// Krok historii - jedna transakcja
+struct CommandGroup {
+    std::string label;             // Opis do menu ("Edycja planu")
+    std::vector<Change> changes;   // W kolejności wykonania
+};
+
+class CommandLog {
+public:
+    static constexpr size_t DEFAULT_LIMIT = 100;
+
+    CommandLog(ExerciseRepository& exercises, WorkoutPlanRepository& plans,
+               size_t limit = DEFAULT_LIMIT);
+
+    CommandLog(const CommandLog&) = delete;
+    CommandLog& operator=(const CommandLog&) = delete;
+
+    // Partia wersji dla transakcji (domyślnie partie obu repozytoriów osobno;
+    // DatabaseManager podpina swoją, by transakcja dała jedną parę wersji)
+    void setBatchHooks(std::function<void()> begin, std::function<void()> commit);
+
+    // === Edycje (semantyka i wyjątki jak w repozytoriach) ===
+    void addExercise(std::shared_ptr<Exercise> exercise);
+    bool updateExercise(const std::string& oldName, std::shared_ptr<Exercise> newExercise);
+    bool removeExercise(const std::string& name);
+
+    void addPlan(std::shared_ptr<WorkoutPlan> plan);
+    bool updatePlan(const std::string& oldName, std::shared_ptr<WorkoutPlan> newPlan);
+    bool removePlan(const std::string& name);
+
+    // Zatwierdzenie szkicu (WorkoutPlanRepository::commitDraft) jako krok historii;
+    // false = konflikt z równoległą zmianą planu
+    bool commitDraft(const PlanDraft& draft);
+
+    // === Transakcje (zagnieżdżone łączą się w najbardziej zewnętrzną) ===
+    void beginTransaction(const std::string& label);
+    void commitTransaction();
+
+    // === Historia ===
+    // false gdy nie ma czego cofnąć/ponowić albo stan repozytorium rozjechał się
+    // z historią (zmiana z pominięciem CommandLog) - wtedy historia jest czyszczona
+    bool undo();
+    bool redo();
+
+    bool canUndo() const { return !undoStack.empty(); }
+    bool canRedo() const { return !redoStack.empty(); }
+    std::string undoLabel() const { return canUndo() ? undoStack.back().label : std::string(); }
+    std::string redoLabel() const { return canRedo() ? redoStack.back().label : std::string(); }
+
+    // Maksymalna liczba kroków historii (najstarsze odpadają)
+    void setLimit(size_t steps);
+    size_t getLimit() const { return limit; }
+
+    // Po wczytaniu albo wyczyszczeniu bazy historia nie pasuje do danych
+    void clear();
+
+    // Pamięć historii bez współdzielonych obiektów ćwiczeń i planów w repozytorium
+    size_t estimateMemoryUsage() const;
+
+private:
+    ExerciseRepository& exerciseRepo;
+    WorkoutPlanRepository& planRepo;
+    size_t limit;
+    Gauge& stepsGauge;        // pumpapp_command_history_steps{file=<plik planów>}
+
+    std::deque<CommandGroup> undoStack;
+    std::deque<CommandGroup> redoStack;
+    CommandGroup open;        // Bieżąca transakcja
+    int depth = 0;
+
+    std::function<void()> batchBegin;
+    std::function<void()> batchCommit;
+
+    // Zmiana wykonana - do bieżącej transakcji albo jako osobny krok
+    void record(Change change, const char* label);
+    void push(CommandGroup group);
+    void recordPlanUpdate(const WorkoutPlan& previous, const WorkoutPlan& current);
+
+    // Wykonanie zmiany w przód (redo) albo wstecz (undo)
+    bool apply(const Change& change, bool forward);
+    bool applyExercise(const Change& change, bool forward);
+    bool applyPlan(const Change& change, bool forward);
+    bool replay(const CommandGroup& group, bool forward);
+};
+
+// RAII dla transakcji: CommandTransaction tx(log, "Import planów");
+class CommandTransaction {
+private:
+    CommandLog& log;
+
+public:
+    CommandTransaction(CommandLog& l, const std::string& label) : log(l) { log.beginTransaction(label); }
+    ~CommandTransaction() { log.commitTransaction(); }
+
+    CommandTransaction(const CommandTransaction&) = delete;
+    CommandTransaction& operator=(const CommandTransaction&) = delete;
+};
+
+#endif // COMMANDLOG_H
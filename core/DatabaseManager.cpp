@@ -2,8 +2,13 @@
 // Lokalizacja: core/DatabaseManager.cpp
 
 #include "DatabaseManager.h"
-#include <iostream>
+#include "Logger.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include "ThreadPool.h"
 #include <filesystem>
+#include <future>
+#include <unordered_set>
 #include <QCoreApplication>
 #include <QString>
 #include <QDir>
@@ -12,115 +17,337 @@
 // Namespace dla filesystem (C++17)
 namespace fs = std::filesystem;
 
-DatabaseManager::DatabaseManager() {
-    // Ścieżka do working directory (katalog roboczy)
-    QString workDir = QDir::currentPath();
-    QString dataDir = workDir + "/data";
+DatabaseManager::DatabaseManager()
+    : DatabaseManager((QDir::currentPath() + "/data").toStdString()) {
+}
 
+DatabaseManager::DatabaseManager(const std::string& dataDir,
+                                 std::shared_ptr<const ExerciseCatalog> catalog)
+    : dataDir(dataDir) {
     // Tworzenie repozytoriów z pełnymi ścieżkami
-    exerciseRepo = std::make_unique<ExerciseRepository>(
-        (dataDir + "/exercises.json").toStdString()
-        );
-    planRepo = std::make_unique<WorkoutPlanRepository>(
-        (dataDir + "/plans.json").toStdString(),
-        exerciseRepo.get()
-        );
+    exerciseRepo = std::make_unique<ExerciseRepository>(dataDir + "/exercises.json");
+    planRepo = std::make_unique<WorkoutPlanRepository>(dataDir + "/plans.json", exerciseRepo.get());
+
+    // Ćwiczenia katalogu współdzielone z innymi instancjami (przed pierwszą publikacją)
+    if(catalog) {
+        exerciseRepo->setBaseCatalog(std::move(catalog));
+    }
 
     // Powiązanie planRepo z exerciseRepo
     planRepo->setExerciseRepository(exerciseRepo.get());
+
+    // Opisy wyświetla tylko ExerciseDialog - w pamięci trzymamy jedynie ich położenie w pliku
+    exerciseRepo->setLazyDescriptions(true);
+
+    // Każda nowa wersja repozytorium = nowa para wersji bazy (poza partią)
+    exerciseRepo->setPublishListener([this]() { publishSnapshot(); });
+    planRepo->setPublishListener([this]() { publishSnapshot(); });
+    exerciseRepo->subscribe([this](const ExerciseChangeBatch& batch) { journal.record("exercises", batch); });
+    planRepo->subscribe([this](const WorkoutPlanChangeBatch& batch) { journal.record("plans", batch); });
+    publishSnapshot();
+
+    commandLog = std::make_unique<CommandLog>(*exerciseRepo, *planRepo);
+    commandLog->setBatchHooks([this]() { beginBatch(); }, [this]() { commitBatch(); });
+}
+
+void DatabaseManager::publishSnapshot() {
+    if(batchDepth > 0) {
+        return;  // Para zostanie opublikowana w commitBatch()
+    }
+    std::lock_guard<std::mutex> lock(publishMutex);
+    std::atomic_store(&snapshot, std::shared_ptr<const DatabaseSnapshot>(
+        std::make_shared<const DatabaseSnapshot>(
+            DatabaseSnapshot{exerciseRepo->getSnapshot(), planRepo->getSnapshot()})));
+}
+
+std::shared_ptr<const DatabaseSnapshot> DatabaseManager::getSnapshot() const {
+    return std::atomic_load(&snapshot);
+}
+
+void DatabaseManager::beginBatch() {
+    ++batchDepth;
+    exerciseRepo->beginBatch();
+    planRepo->beginBatch();
+}
+
+void DatabaseManager::commitBatch() {
+    exerciseRepo->commitBatch();
+    planRepo->commitBatch();
+    // Zmniejszenie licznika tylko gdy > 0 (nadmiarowy commitBatch nic nie robi)
+    int depth = batchDepth.load();
+    while(depth > 0 && !batchDepth.compare_exchange_weak(depth, depth - 1)) {
+    }
+    if(depth == 1) {
+        publishSnapshot();
+    }
 }
 
 bool DatabaseManager::initialize() {
-    std::cout << "[DatabaseManager] Inicjalizacja bazy danych..." << std::endl;
+    PUMP_TRACE_SCOPE("DatabaseManager::initialize", "db");
+    Logger::info("DatabaseManager", "Inicjalizacja bazy danych...");
+
+    if(!prepareStorage()) {
+        return false;
+    }
+
+    // Próba załadowania danych
+    return loadAll();
+}
 
-    // Ścieżka do folderu data/ (w working directory)
-    QString workDir = QDir::currentPath();
-    QString dataDir = workDir + "/data";
+bool DatabaseManager::prepareStorage() {
+    QString dir = QString::fromStdString(dataDir);
 
-    std::cout << "[DatabaseManager] Working directory: "
-              << workDir.toStdString() << std::endl;  // <- DEBUG!
+    Logger::debug("DatabaseManager", "Katalog danych", {{"path", dataDir}});
 
-    // Sprawdzenie/utworzenie folderu data/
-    QDir dir;
-    if(!dir.exists(dataDir)) {
-        if(dir.mkpath(dataDir)) {
-            std::cout << "[DatabaseManager] Utworzono folder: "
-                      << dataDir.toStdString() << std::endl;
+    // Sprawdzenie/utworzenie folderu danych
+    QDir qdir;
+    if(!qdir.exists(dir)) {
+        if(qdir.mkpath(dir)) {
+            Logger::info("DatabaseManager", "Utworzono folder", {{"path", dataDir}});
         } else {
-            std::cerr << "[DatabaseManager] Błąd tworzenia folderu!" << std::endl;
+            Logger::error("DatabaseManager", "Błąd tworzenia folderu!", {{"path", dataDir}});
             return false;
         }
     } else {
-        std::cout << "[DatabaseManager] Folder data/ już istnieje: "
-                  << dataDir.toStdString() << std::endl;
+        Logger::info("DatabaseManager", "Folder danych już istnieje", {{"path", dataDir}});
     }
 
-    // Próba załadowania danych
-    return loadAll();
+    return true;
 }
 
 
 bool DatabaseManager::saveAll() {
-    std::cout << "[DatabaseManager] Zapisywanie danych..." << std::endl;
+    PUMP_TRACE_SCOPE("DatabaseManager::saveAll", "db");
+    static Counter& saveCalls = MetricsRegistry::getInstance().counter("pumpapp_db_save_total");
+    static Counter& saveFailures = MetricsRegistry::getInstance().counter("pumpapp_db_save_failures_total");
+    static LatencyHistogram& saveLatency = MetricsRegistry::getInstance().histogram("pumpapp_db_save_latency_us");
+    saveCalls.increment();
+    ScopedLatency latency(saveLatency);
+    Logger::info("DatabaseManager", "Zapisywanie danych...");
 
     bool success = true;
+    auto current = getSnapshot();
 
-    // Zapis ćwiczeń
-    if(!exerciseRepo->saveToJSON()) {
-        std::cerr << "[DatabaseManager] Błąd zapisu ćwiczeń!" << std::endl;
+    // Zapis ćwiczeń (plik bez zmian od ostatniego zapisu zostaje)
+    const uint64_t exerciseVersion = current->exercises->getVersion();
+    if(!journal.needsSave("exercises", exerciseVersion)) {
+        Logger::debug("DatabaseManager", "Ćwiczenia bez zmian - pominięto zapis");
+    } else if(!exerciseRepo->saveSnapshot(*current->exercises)) {
+        Logger::error("DatabaseManager", "Błąd zapisu ćwiczeń!");
         success = false;
     } else {
-        std::cout << "[DatabaseManager] Zapisano " << exerciseRepo->getCount() << " ćwiczeń" << std::endl;
+        journal.markSaved("exercises", exerciseVersion);
+        Logger::info("DatabaseManager", "Zapisano ćwiczenia", {{"count", std::to_string(current->exercises->getCount())}});
     }
 
     // Zapis planów
-    if(!planRepo->saveToJSON()) {
-        std::cerr << "[DatabaseManager] Błąd zapisu planów!" << std::endl;
+    const uint64_t planVersion = current->plans->getVersion();
+    if(!journal.needsSave("plans", planVersion)) {
+        Logger::debug("DatabaseManager", "Plany bez zmian - pominięto zapis");
+    } else if(!planRepo->saveSnapshot(*current->plans)) {
+        Logger::error("DatabaseManager", "Błąd zapisu planów!");
         success = false;
     } else {
-        std::cout << "[DatabaseManager] Zapisano " << planRepo->getCount() << " planów" << std::endl;
+        journal.markSaved("plans", planVersion);
+        Logger::info("DatabaseManager", "Zapisano plany", {{"count", std::to_string(current->plans->getCount())}});
     }
 
+    if(!success) saveFailures.increment();
+    updateMetrics();
     return success;
 }
 
 bool DatabaseManager::loadAll() {
-    std::cout << "[DatabaseManager] Ładowanie danych..." << std::endl;
+    PUMP_TRACE_SCOPE("DatabaseManager::loadAll", "db");
+    static LatencyHistogram& loadLatency = MetricsRegistry::getInstance().histogram("pumpapp_db_load_latency_us");
+    ScopedLatency latency(loadLatency);
+    Logger::info("DatabaseManager", "Ładowanie danych...");
+
+    ThreadPool& pool = ThreadPool::getShared();
+
+    // Etap 1: odczyt i parsowanie obu plików równolegle. Osobne wątki (std::async),
+    // bo parseJSON dzieli duże pliki na fragmenty w puli - zadanie puli nie może
+    // czekać na inne zadania tej samej puli.
+    // Słownik kompresji opisów wczytujemy przed parsowaniem (plik może go nie mieć)
+    exerciseRepo->loadCompressionDictionary();
+    auto dictionary = exerciseRepo->getCompressionDictionary();
+    auto descriptionStore = exerciseRepo->createDescriptionStore();
+    auto exerciseTask = std::async(std::launch::async, [this, &pool, descriptionStore, dictionary]() {
+        std::string content;
+        std::pair<bool, std::vector<std::shared_ptr<Exercise>>> result;
+        result.first = exerciseRepo->readJSON(content);
+        if(result.first) {
+            result.second = ExerciseRepository::parseJSON(content, &pool, descriptionStore,
+                                                          dictionary.get());
+        }
+        return result;
+    });
+
+    auto planTask = std::async(std::launch::async, [this, &pool]() {
+        std::string content;
+        std::pair<bool, std::vector<PlanRecord>> result;
+        result.first = planRepo->readJSON(content);
+        if(result.first) {
+            result.second = WorkoutPlanRepository::parseJSON(content, &pool);
+        }
+        return result;
+    });
+
+    auto exercises = exerciseTask.get();
+    auto planRecords = planTask.get();
 
     bool success = true;
 
-    QString workDir = QDir::currentPath();
-    QFile exFile(workDir + "/data/exercises.json");
-    QFile plFile(workDir + "/data/plans.json");
+    // Etapy 2-3 jako jedna partia - czytelnicy nie zobaczą nowych ćwiczeń ze starymi planami
+    beginBatch();
 
-    // Odczyt ćwiczeń (MUSI być PRZED planami!)
-    if(!exerciseRepo->loadFromJSON()) {
-        std::cerr << "[DatabaseManager] Nie można załadować ćwiczeń (plik może nie istnieć)" << std::endl;
+    // Etap 2: podmiana ćwiczeń (MUSI być PRZED linkowaniem planów!)
+    if(!exercises.first) {
+        Logger::warning("DatabaseManager", "Nie można załadować ćwiczeń (plik może nie istnieć)");
         success = false;
     } else {
-        std::cout << "[DatabaseManager] Załadowano " << exerciseRepo->getCount() << " ćwiczeń" << std::endl;
+        exerciseRepo->replaceAll(std::move(exercises.second), descriptionStore);
+        Logger::info("DatabaseManager", "Załadowano ćwiczenia", {{"count", std::to_string(exerciseRepo->getCount())}});
     }
 
-    // Odczyt planów
-    if(!planRepo->loadFromJSON()) {
-        std::cerr << "[DatabaseManager] Nie można załadować planów (plik może nie istnieć)" << std::endl;
+    // Etap 3: linkowanie planów z ćwiczeniami
+    if(!planRecords.first) {
+        Logger::warning("DatabaseManager", "Nie można załadować planów (plik może nie istnieć)");
         success = false;
     } else {
-        std::cout << "[DatabaseManager] Załadowano " << planRepo->getCount() << " planów" << std::endl;
+        planRepo->linkRecords(planRecords.second);
+        Logger::info("DatabaseManager", "Załadowano plany", {{"count", std::to_string(planRepo->getCount())}});
     }
 
+    commitBatch();
+    commandLog->clear();
+
+    // Wczytany plik = zapisana wersja; kolekcja bez pliku zapisze się przy pierwszym saveAll
+    auto loaded = getSnapshot();
+    if(exercises.first) {
+        journal.markSaved("exercises", loaded->exercises->getVersion());
+    }
+    if(planRecords.first) {
+        journal.markSaved("plans", loaded->plans->getVersion());
+    }
+    updateMetrics();
     return success;
 }
 
+std::vector<std::string> DatabaseManager::getDataFiles() const {
+    // Słownik też - nowy JSON bywa skompresowany słownikiem, który dochodzi później
+    return {dataDir + "/exercises.json", exerciseRepo->getDictionaryPath(), dataDir + "/plans.json"};
+}
+
+bool DatabaseManager::hasExternalChanges() const {
+    return exerciseRepo->hasExternalChanges() || planRepo->hasExternalChanges();
+}
+
+DatabaseReload DatabaseManager::reloadChangedFiles() {
+    PUMP_TRACE_SCOPE("DatabaseManager::reloadChangedFiles", "db");
+    DatabaseReload result;
+    const bool exercisesChanged = exerciseRepo->hasExternalChanges();
+    const bool plansChanged = planRepo->hasExternalChanges();
+    if(!exercisesChanged && !plansChanged) {
+        return result;
+    }
+
+    // Nazwy z niezapisanymi zmianami zostają w wersji z pamięci
+    auto pendingIn = [this](const std::string& collection) {
+        auto names = journal.pendingNames(collection);
+        std::unordered_set<std::string> pending(names.begin(), names.end());
+        return [pending = std::move(pending)](const std::string& name) { return pending.count(name) > 0; };
+    };
+
+    {
+        // Jedna para wersji - czytelnicy nie zobaczą nowych ćwiczeń ze starymi planami
+        MutationBatch<DatabaseManager> batch(*this);
+
+        // Ćwiczenia przed planami - plany linkują się do aktualnych ćwiczeń.
+        // Brak pliku (np. podmiana przez usunięcie + zapis) - czekamy na nowy plik.
+        std::string content;
+        // Niezapisana podmiana całej kolekcji (clearAll, replaceAll) - dziennik nie
+        // zna już usuniętych nazw, więc konfliktem jest cały plik: zostaje wersja
+        // z pamięci, a następny zapis nadpisze plik
+        if(exercisesChanged && journal.hasPendingReset("exercises")) {
+            exerciseRepo->keepLocalVersion();
+            result.exercises.resetConflict = true;
+        } else if(exercisesChanged) {
+            exerciseRepo->loadCompressionDictionary();   // Sprawdzany w readJSON
+        }
+        if(exercisesChanged && !result.exercises.resetConflict && exerciseRepo->readJSON(content)) {
+            auto dictionary = exerciseRepo->getCompressionDictionary();
+            auto store = exerciseRepo->createDescriptionStore();
+            auto loaded = ExerciseRepository::parseJSON(content, &ThreadPool::getShared(), store, dictionary.get());
+            result.exercises = exerciseRepo->applyExternalChanges(std::move(loaded), store, pendingIn("exercises"));
+        }
+        if(plansChanged && journal.hasPendingReset("plans")) {
+            planRepo->keepLocalVersion();
+            result.plans.resetConflict = true;
+        }
+        if(plansChanged && !result.plans.resetConflict && planRepo->readJSON(content)) {
+            auto records = WorkoutPlanRepository::parseJSON(content, &ThreadPool::getShared());
+            result.plans = planRepo->applyExternalChanges(records, pendingIn("plans"));
+        }
+    }
+
+    // Bez konfliktów pamięć = plik; z konfliktami zapis scali obie strony
+    auto current = getSnapshot();
+    if(result.exercises.reloaded && result.exercises.conflicts.empty()) {
+        journal.markSaved("exercises", current->exercises->getVersion());
+    }
+    if(result.plans.reloaded && result.plans.conflicts.empty()) {
+        journal.markSaved("plans", current->plans->getVersion());
+    }
+    updateMetrics();
+    return result;
+}
+
+std::future<bool> DatabaseManager::saveAllAsync() {
+    return std::async(std::launch::async, [this]() { return saveAll(); });
+}
+
 void DatabaseManager::clearAll() {
-    std::cout << "[DatabaseManager] UWAGA: Czyszczenie całej bazy danych!" << std::endl;
+    Logger::warning("DatabaseManager", "UWAGA: Czyszczenie całej bazy danych!");
+    MutationBatch<DatabaseManager> batch(*this);
     exerciseRepo->clear();
     planRepo->clear();
+    commandLog->clear();
+}
+
+void DatabaseManager::updateMetrics() const {
+    // Liczności publikują repozytoria (etykieta file); tu pamięć tej instancji
+    // z etykietą data_dir - kilka baz w procesie to osobne serie
+    auto& registry = MetricsRegistry::getInstance();
+    registry.gauge(MetricsRegistry::labeled("pumpapp_catalog_memory_bytes", "data_dir", dataDir))
+        .set(static_cast<int64_t>(exerciseRepo->estimateMemoryUsage() + planRepo->estimateMemoryUsage()));
+    registry.gauge(MetricsRegistry::labeled("pumpapp_command_history_bytes", "data_dir", dataDir))
+        .set(static_cast<int64_t>(commandLog->estimateMemoryUsage()));
+    if(auto base = getBaseCatalog()) {
+        // Wspólny dla wszystkich instancji - nie wliczany do pamięci instancji
+        registry.gauge("pumpapp_base_catalog_memory_bytes").set(static_cast<int64_t>(base->estimateMemoryUsage()));
+    }
+}
+
+bool DatabaseManager::dumpMetrics(const std::string& filePath) const {
+    updateMetrics();
+
+    // Format wybierany po rozszerzeniu: .json -> JSON, inaczej Prometheus text
+    bool json = filePath.size() >= 5 && filePath.compare(filePath.size() - 5, 5, ".json") == 0;
+    bool ok = json ? MetricsRegistry::getInstance().writeJsonFile(filePath)
+                   : MetricsRegistry::getInstance().writePrometheusFile(filePath);
+    if(!ok) {
+        Logger::error("DatabaseManager", "Nie można zapisać metryk", {{"path", filePath}});
+    }
+    return ok;
 }
 
 void DatabaseManager::printStatus() const {
-    std::cout << "\n=== STATUS BAZY DANYCH ===" << std::endl;
-    std::cout << "Liczba ćwiczeń: " << exerciseRepo->getCount() << std::endl;
-    std::cout << "Liczba planów: " << planRepo->getCount() << std::endl;
-    std::cout << "========================\n" << std::endl;
+    Logger::info("DatabaseManager", "Status bazy danych", {
+        {"dataDir", dataDir},
+        {"exercises", std::to_string(exerciseRepo->getCount())},
+        {"overlayExercises", std::to_string(exerciseRepo->getOverlayCount())},
+        {"plans", std::to_string(planRepo->getCount())}
+    });
+    Logger::getInstance().flush();
 }
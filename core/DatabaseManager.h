@@ -8,26 +8,75 @@
 
 #include "ExerciseRepository.h"
 #include "WorkoutPlanRepository.h"
+#include "ExerciseCatalog.h"
+#include "CommandLog.h"
+#include "ChangeJournal.h"
+#include <atomic>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 
-// Wzorzec Singleton - tylko jedna instancja managera bazy danych w całej aplikacji
+// Spójna para wersji obu repozytoriów - plany odwołują się tylko do ćwiczeń
+// obecnych w tej samej parze (zob. Snapshot.h)
+struct DatabaseSnapshot {
+    std::shared_ptr<const ExerciseSnapshot> exercises;
+    std::shared_ptr<const WorkoutPlanSnapshot> plans;
+};
+
+// Wynik przeładowania plików zmienionych poza aplikacją (reloadChangedFiles)
+struct DatabaseReload {
+    ReloadReport exercises;
+    ReloadReport plans;
+
+    bool any() const {
+        return exercises.reloaded || plans.reloaded || exercises.resetConflict || plans.resetConflict;
+    }
+};
+
+// Wzorzec Singleton - jedna domyślna instancja dla GUI (getInstance, katalog data/)
 // Wzorzec Facade - uproszczony interfejs do zarządzania wieloma repozytoriami
+//
+// Serwer obsługujący wielu użytkowników tworzy osobne instancje z własnymi
+// katalogami danych i jednym wspólnym ExerciseCatalog - pamięć rośnie wtedy
+// tylko o zmiany użytkownika (nakładka), a nie o pełną kopię katalogu.
 class DatabaseManager {
 private:
-    // Prywatny konstruktor (Singleton)
+    // Konstruktor instancji domyślnej (Singleton) - <katalog roboczy>/data
     DatabaseManager();
 
     // Usunięcie copy constructor i assignment operator (Singleton)
     DatabaseManager(const DatabaseManager&) = delete;
     DatabaseManager& operator=(const DatabaseManager&) = delete;
 
+    std::string dataDir;   // Katalog z plikami tej instancji
+
+    // Zmiany od ostatniego zapisu (subskrybent obu repozytoriów) - saveAll
+    // pomija pliki kolekcji bez zmian
+    ChangeJournal journal;
+
     // Repozytoria
     std::unique_ptr<ExerciseRepository> exerciseRepo;
     std::unique_ptr<WorkoutPlanRepository> planRepo;
 
+    // Historia edycji (cofnij/ponów) - transakcja = jedna para wersji
+    std::unique_ptr<CommandLog> commandLog;
+
+    // Ostatnia spójna wersja całej bazy (atomic_load/atomic_store)
+    std::shared_ptr<const DatabaseSnapshot> snapshot;
+    std::atomic<int> batchDepth{0};
+    std::mutex publishMutex;   // Pisarze obu repozytoriów publikują parę po kolei
+
+    // Publikacja pary wersji (wołane po publikacji w którymś z repozytoriów)
+    void publishSnapshot();
+
 public:
-    // Statyczna metoda dostępu do jedynej instancji (Singleton Pattern)
+    // Niezależna instancja z jawnym katalogiem danych (np. jeden użytkownik serwera).
+    // Z catalog ćwiczenia katalogu są wspólne, a pliki instancji trzymają tylko nakładkę.
+    explicit DatabaseManager(const std::string& dataDir,
+                             std::shared_ptr<const ExerciseCatalog> catalog = nullptr);
+
+    // Statyczna metoda dostępu do instancji domyślnej (Singleton Pattern)
     static DatabaseManager& getInstance() {
         static DatabaseManager instance;  // Thread-safe w C++11+
         return instance;
@@ -38,6 +87,13 @@ public:
 
     // === Dostęp do repozytoriów ===
 
+    const std::string& getDataDir() const { return dataDir; }
+
+    // Wspólny katalog ćwiczeń (nullptr gdy instancja ma pełny katalog we własnym pliku)
+    std::shared_ptr<const ExerciseCatalog> getBaseCatalog() const {
+        return exerciseRepo->getBaseCatalog();
+    }
+
     ExerciseRepository& getExerciseRepository() {
         return *exerciseRepo;
     }
@@ -46,22 +102,71 @@ public:
         return *planRepo;
     }
 
+    // Edycje z historią - GUI zmienia dane przez CommandLog, nie wprost w repozytoriach.
+    // Wczytanie i wyczyszczenie bazy zerują historię.
+    CommandLog& getCommandLog() {
+        return *commandLog;
+    }
+
+    // === Snapshoty (MVCC) ===
+    // Repozytoria są bezpieczne wielowątkowo (zob. ExerciseRepository); snapshot
+    // można pobrać w dowolnym wątku bez blokad - np. do zapisu w tle, statystyk
+    // albo wyszukiwania. Para jest publikowana pod publishMutex, więc ostatnia
+    // opublikowana para zawiera zawsze najnowsze wersje obu repozytoriów.
+
+    std::shared_ptr<const DatabaseSnapshot> getSnapshot() const;
+
+    // Partia zmian w obu repozytoriach = jedna nowa para wersji
+    void beginBatch();
+    void commitBatch();
+
     // === Operacje na całej bazie danych ===
 
     // Inicjalizacja - tworzenie folderów, ładowanie danych
     bool initialize();
 
-    // Zapis wszystkich danych do plików
+    // Tylko utworzenie folderu danych (bez ładowania) - initialize() = prepareStorage() + loadAll()
+    bool prepareStorage();
+
+    // Zapis wszystkich danych do plików (spójny snapshot, bezpieczne w tle).
+    // Plik kolekcji bez zmian od ostatniego zapisu/wczytania nie jest przepisywany.
     bool saveAll();
 
+    // Dziennik niezapisanych zmian (kolekcje "exercises" i "plans")
+    const ChangeJournal& getJournal() const { return journal; }
+
+    // Zapis w osobnym wątku - GUI może dalej edytować dane
+    std::future<bool> saveAllAsync();
+
     // Odczyt wszystkich danych z plików
     bool loadAll();
 
-    // Wyczyszczenie całej bazy (UWAGA!)
+    // === Zmiany plików z zewnątrz (np. zadanie synchronizacji katalogu) ===
+
+    // Pliki danych tej instancji (do obserwowania, np. QFileSystemWatcher)
+    std::vector<std::string> getDataFiles() const;
+
+    // Czy któryś plik zmienił się od ostatniego odczytu/zapisu (czas modyfikacji,
+    // rozmiar). saveAll nie nadpisuje takiego pliku - najpierw reloadChangedFiles.
+    bool hasExternalChanges() const;
+
+    // Przeładowanie tylko zmienionych plików: różnica względem pamięci jako jedna
+    // para wersji. Niezapisane zmiany lokalne (dziennik) wygrywają z plikiem
+    // (ReloadReport::conflicts) i trafią do niego przy następnym saveAll.
+    // Niezapisana podmiana całej kolekcji - plik pominięty (resetConflict).
+    DatabaseReload reloadChangedFiles();
+
+    // Wyczyszczenie całej bazy (UWAGA!) - katalog bazowy zostaje nienaruszony
     void clearAll();
 
     // Status bazy danych (do debugowania)
     void printStatus() const;
+
+    // Odświeżenie gauge'y (liczba rekordów, pamięć katalogu) w MetricsRegistry
+    void updateMetrics() const;
+
+    // Zrzut metryk do pliku (.json -> JSON, inne -> Prometheus text)
+    bool dumpMetrics(const std::string& filePath) const;
 };
 
 #endif // DATABASEMANAGER_H
@@ -0,0 +1,396 @@
+// DescriptionCodec.cpp
+// Lokalizacja: core/DescriptionCodec.cpp
+
+#include "DescriptionCodec.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace DescriptionCodec {
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int DICT_HASH_BITS = 14;
+constexpr int MAX_INPUT_HASH_BITS = 14;
+constexpr size_t ID_DIGITS = 8;         // Prefiks wartości w JSON: id słownika (hex) + ':'
+
+// Parametry trenowania słownika
+constexpr size_t KGRAM = 6;              // Długość k-gramu
+constexpr size_t SEGMENT = 64;           // Długość fragmentu kandydującego do słownika
+constexpr size_t SEGMENT_STEP = 32;
+constexpr size_t SAMPLE_BUDGET = 4 << 20; // Maks. bajtów próbek analizowanych przy treningu
+
+inline uint32_t read32(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline size_t hash4(uint32_t v, int bits) {
+    return static_cast<size_t>((v * 2654435761u) >> (32 - bits));
+}
+
+inline uint64_t hashKgram(const char* p) {
+    // FNV-1a na KGRAM bajtach
+    uint64_t h = 1469598103934665603ull;
+    for(size_t i = 0; i < KGRAM; ++i) {
+        h ^= static_cast<unsigned char>(p[i]);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+void writeLength(std::string& out, size_t length) {
+    while(length >= 255) {
+        out += static_cast<char>(255);
+        length -= 255;
+    }
+    out += static_cast<char>(length);
+}
+
+size_t readLength(const std::string& in, size_t& pos) {
+    size_t length = 0;
+    unsigned char byte;
+    do {
+        if(pos >= in.size()) throw std::runtime_error("Uszkodzony blok opisu (długość)");
+        byte = static_cast<unsigned char>(in[pos++]);
+        length += byte;
+    } while(byte == 255);
+    return length;
+}
+
+void writeSequence(std::string& out, const char* literals, size_t literalCount,
+                   size_t offset, size_t matchLength) {
+    size_t matchCode = matchLength ? matchLength - MIN_MATCH : 0;
+    unsigned char token = static_cast<unsigned char>(
+        ((literalCount < 15 ? literalCount : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+    out += static_cast<char>(token);
+    if(literalCount >= 15) writeLength(out, literalCount - 15);
+    out.append(literals, literalCount);
+
+    if(matchLength) {
+        out += static_cast<char>(offset & 0xFF);
+        out += static_cast<char>((offset >> 8) & 0xFF);
+        if(matchCode >= 15) writeLength(out, matchCode - 15);
+    }
+}
+
+} // namespace
+
+Dictionary::Dictionary(const std::string& bytes)
+    : data(bytes.size() > MAX_DICTIONARY_SIZE ? bytes.substr(bytes.size() - MAX_DICTIONARY_SIZE) : bytes),
+      table(size_t(1) << DICT_HASH_BITS, -1),
+      id(2166136261u) {
+    // FNV-1a (32 bity) - id słownika w wartościach JSON
+    for(unsigned char c : data) {
+        id = (id ^ c) * 16777619u;
+    }
+    for(size_t i = 0; i + MIN_MATCH <= data.size(); ++i) {
+        table[hash4(read32(data.data() + i), DICT_HASH_BITS)] = static_cast<int32_t>(i);
+    }
+}
+
+std::string Dictionary::compress(const std::string& input) const {
+    const size_t dictSize = data.size();
+    const char* dict = data.data();
+
+    std::string out;
+    out.reserve(input.size() / 2 + 16);
+
+    // Nagłówek: długość oryginału (varint)
+    size_t n = input.size();
+    do {
+        unsigned char byte = n & 0x7F;
+        n >>= 7;
+        if(n) byte |= 0x80;
+        out += static_cast<char>(byte);
+    } while(n);
+
+    // Tablica haszy wejścia - rozmiar dopasowany do długości opisu (tani memset)
+    int inputBits = 6;
+    while(inputBits < MAX_INPUT_HASH_BITS && (size_t(1) << inputBits) < input.size()) {
+        ++inputBits;
+    }
+    std::vector<int32_t> inputTable(size_t(1) << inputBits, -1);
+
+    const char* src = input.data();
+    const size_t size = input.size();
+    size_t anchor = 0;  // Początek literałów do wypisania
+    size_t pos = 0;
+
+    while(pos + MIN_MATCH <= size) {
+        const uint32_t sequence = read32(src + pos);
+        const size_t h = hash4(sequence, inputBits);
+        const int32_t inputCandidate = inputTable[h];
+        inputTable[h] = static_cast<int32_t>(pos);
+
+        // Kandydat we wcześniejszej części opisu
+        size_t bestLength = 0;
+        size_t bestOffset = 0;
+        if(inputCandidate >= 0 && pos - static_cast<size_t>(inputCandidate) <= MAX_OFFSET) {
+            size_t from = static_cast<size_t>(inputCandidate);
+            size_t length = 0;
+            while(pos + length < size && src[from + length] == src[pos + length]) {
+                ++length;
+            }
+            bestLength = length;
+            bestOffset = pos - from;
+        }
+
+        // Kandydat w słowniku - porównujemy do końca słownika
+        const int32_t dictCandidate = dictSize ? table[hash4(sequence, DICT_HASH_BITS)] : -1;
+        if(dictCandidate >= 0 && dictSize + pos - static_cast<size_t>(dictCandidate) <= MAX_OFFSET) {
+            size_t from = static_cast<size_t>(dictCandidate);
+            size_t length = 0;
+            while(from + length < dictSize && pos + length < size &&
+                  dict[from + length] == src[pos + length]) {
+                ++length;
+            }
+            if(length > bestLength) {
+                bestLength = length;
+                bestOffset = dictSize + pos - from;
+            }
+        }
+
+        if(bestLength < MIN_MATCH) {
+            ++pos;
+            continue;
+        }
+
+        writeSequence(out, src + anchor, pos - anchor, bestOffset, bestLength);
+        pos += bestLength;
+        anchor = pos;
+    }
+
+    // Ostatnia sekwencja - same literały
+    writeSequence(out, src + anchor, size - anchor, 0, 0);
+    return out;
+}
+
+std::string Dictionary::decompress(const std::string& block) const {
+    const size_t dictSize = data.size();
+    const char* dict = data.data();
+
+    size_t pos = 0;
+    size_t expected = 0;
+    int shift = 0;
+    while(true) {
+        if(pos >= block.size() || shift > 56) throw std::runtime_error("Uszkodzony blok opisu (nagłówek)");
+        unsigned char byte = static_cast<unsigned char>(block[pos++]);
+        expected |= static_cast<size_t>(byte & 0x7F) << shift;
+        if(!(byte & 0x80)) break;
+        shift += 7;
+    }
+
+    std::string out;
+    out.reserve(expected);
+
+    while(pos < block.size()) {
+        unsigned char token = static_cast<unsigned char>(block[pos++]);
+
+        size_t literalCount = token >> 4;
+        if(literalCount == 15) literalCount += readLength(block, pos);
+        if(pos + literalCount > block.size()) throw std::runtime_error("Uszkodzony blok opisu (literały)");
+        out.append(block, pos, literalCount);
+        pos += literalCount;
+
+        if(pos >= block.size()) break;  // Ostatnia sekwencja bez dopasowania
+
+        if(pos + 2 > block.size()) throw std::runtime_error("Uszkodzony blok opisu (offset)");
+        size_t offset = static_cast<unsigned char>(block[pos]) |
+                        (static_cast<size_t>(static_cast<unsigned char>(block[pos + 1])) << 8);
+        pos += 2;
+
+        size_t matchLength = (token & 0x0F);
+        if(matchLength == 15) matchLength += readLength(block, pos);
+        matchLength += MIN_MATCH;
+
+        size_t virtualPos = dictSize + out.size();
+        if(offset == 0 || offset > virtualPos) throw std::runtime_error("Uszkodzony blok opisu (zakres)");
+        size_t from = virtualPos - offset;
+
+        // Kopiowanie bajt po bajcie - źródło może nachodzić na właśnie pisane dane
+        for(size_t i = 0; i < matchLength; ++i, ++from) {
+            out += (from < dictSize) ? dict[from] : out[from - dictSize];
+        }
+    }
+
+    if(out.size() != expected) throw std::runtime_error("Uszkodzony blok opisu (długość)");
+    return out;
+}
+
+std::string trainDictionary(const std::vector<std::string>& samples, size_t maxSize) {
+    if(maxSize > MAX_DICTIONARY_SIZE) maxSize = MAX_DICTIONARY_SIZE;
+
+    // 1. W ilu próbkach występuje dany k-gram
+    std::unordered_map<uint64_t, uint32_t> frequency;
+    size_t used = 0;
+    size_t sampleCount = 0;
+    for(const auto& sample : samples) {
+        if(used >= SAMPLE_BUDGET) break;
+        used += sample.size();
+        ++sampleCount;
+        if(sample.size() < KGRAM) continue;
+
+        std::unordered_set<uint64_t> seen;
+        for(size_t i = 0; i + KGRAM <= sample.size(); ++i) {
+            uint64_t h = hashKgram(sample.data() + i);
+            if(seen.insert(h).second) ++frequency[h];
+        }
+    }
+
+    // Wartość fragmentu = suma częstości jeszcze niepokrytych k-gramów (tylko wspólne, >= 2 próbki)
+    auto score = [&frequency](const std::string& sample, size_t start) {
+        uint64_t total = 0;
+        size_t end = std::min(start + SEGMENT, sample.size());
+        for(size_t i = start; i + KGRAM <= end; ++i) {
+            auto it = frequency.find(hashKgram(sample.data() + i));
+            if(it != frequency.end() && it->second >= 2) total += it->second;
+        }
+        return total;
+    };
+
+    // 2. Zachłanny wybór fragmentów (leniwe przeliczanie - wartości tylko maleją)
+    using Candidate = std::tuple<uint64_t, size_t, size_t>;  // wartość, próbka, pozycja
+    std::priority_queue<Candidate> queue;
+    for(size_t s = 0; s < sampleCount; ++s) {
+        const auto& sample = samples[s];
+        for(size_t start = 0; start + KGRAM <= sample.size(); start += SEGMENT_STEP) {
+            uint64_t value = score(sample, start);
+            if(value > 0) queue.emplace(value, s, start);
+        }
+    }
+
+    std::string dictionary;
+    while(!queue.empty() && dictionary.size() < maxSize) {
+        Candidate top = queue.top();
+        queue.pop();
+
+        const auto& sample = samples[std::get<1>(top)];
+        size_t start = std::get<2>(top);
+        uint64_t current = score(sample, start);
+        if(current == 0) continue;
+
+        if(!queue.empty() && current < std::get<0>(queue.top())) {
+            queue.emplace(current, std::get<1>(top), start);  // Wróci, gdy znów będzie najlepszy
+            continue;
+        }
+
+        size_t end = std::min(start + SEGMENT, sample.size());
+        size_t length = std::min(end - start, maxSize - dictionary.size());
+        dictionary.append(sample, start, length);
+
+        // Pokryte k-gramy nie podnoszą już wartości innych fragmentów
+        for(size_t i = start; i + KGRAM <= end; ++i) {
+            auto it = frequency.find(hashKgram(sample.data() + i));
+            if(it != frequency.end()) it->second = 0;
+        }
+    }
+
+    return dictionary;
+}
+
+std::string encodeBase64(const std::string& data) {
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+
+    size_t i = 0;
+    for(; i + 3 <= data.size(); i += 3) {
+        uint32_t v = (static_cast<unsigned char>(data[i]) << 16) |
+                     (static_cast<unsigned char>(data[i + 1]) << 8) |
+                     static_cast<unsigned char>(data[i + 2]);
+        out += alphabet[(v >> 18) & 63];
+        out += alphabet[(v >> 12) & 63];
+        out += alphabet[(v >> 6) & 63];
+        out += alphabet[v & 63];
+    }
+
+    size_t rest = data.size() - i;
+    if(rest > 0) {
+        uint32_t v = static_cast<unsigned char>(data[i]) << 16;
+        if(rest == 2) v |= static_cast<unsigned char>(data[i + 1]) << 8;
+        out += alphabet[(v >> 18) & 63];
+        out += alphabet[(v >> 12) & 63];
+        out += (rest == 2) ? alphabet[(v >> 6) & 63] : '=';
+        out += '=';
+    }
+    return out;
+}
+
+std::string decodeBase64(const std::string& text) {
+    auto value = [](char c) -> int {
+        if(c >= 'A' && c <= 'Z') return c - 'A';
+        if(c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if(c >= '0' && c <= '9') return c - '0' + 52;
+        if(c == '+') return 62;
+        if(c == '/') return 63;
+        return -1;
+    };
+
+    std::string out;
+    out.reserve(text.size() / 4 * 3);
+
+    uint32_t buffer = 0;
+    int bits = 0;
+    for(char c : text) {
+        if(c == '=') break;
+        int v = value(c);
+        if(v < 0) throw std::runtime_error("Niepoprawny znak base64");
+        buffer = (buffer << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if(bits >= 8) {
+            bits -= 8;
+            out += static_cast<char>((buffer >> bits) & 0xFF);
+        }
+    }
+    return out;
+}
+
+std::string encodeValue(const Dictionary& dictionary, const std::string& text) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(ID_DIGITS + 1, ':');
+    for(size_t i = 0; i < ID_DIGITS; ++i) {
+        out[i] = digits[(dictionary.getId() >> (4 * (ID_DIGITS - 1 - i))) & 0xF];
+    }
+    out += encodeBase64(dictionary.compress(text));
+    return out;
+}
+
+bool valueDictionaryId(std::string_view value, uint32_t& id) {
+    if(value.size() <= ID_DIGITS || value[ID_DIGITS] != ':') {
+        return false;   // ':' nie występuje w base64 - brak prefiksu
+    }
+    id = 0;
+    for(size_t i = 0; i < ID_DIGITS; ++i) {
+        const char c = value[i];
+        int digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+        if(digit < 0) {
+            return false;
+        }
+        id = (id << 4) | static_cast<uint32_t>(digit);
+    }
+    return true;
+}
+
+std::string decodeValue(const Dictionary& dictionary, std::string_view value) {
+    uint32_t id = 0;
+    if(valueDictionaryId(value, id)) {
+        if(id != dictionary.getId()) {
+            throw std::runtime_error("Blok opisu skompresowany innym słownikiem");
+        }
+        value.remove_prefix(ID_DIGITS + 1);
+    }
+    return dictionary.decompress(decodeBase64(std::string(value)));
+}
+
+} // namespace DescriptionCodec
@@ -0,0 +1,72 @@
+// DescriptionCodec.h
+// Lokalizacja: core/DescriptionCodec.h
+// Opis: Kompresja opisów ćwiczeń - prosty kodek LZ77 (format sekwencji w stylu LZ4)
+//       ze wspólnym, "trenowanym" słownikiem. Opisy to długa, powtarzalna polska
+//       proza - wspólne frazy ("Napnij mięśnie brzucha", "na szerokość barków")
+//       trafiają do słownika, więc nawet krótki opis kompresuje się dobrze.
+//
+// Bez zewnętrznych bibliotek (jak reszta core). Format bloku:
+//   varint(długość oryginału) + sekwencje [token][literały][offset 2B][dł. dopasowania]
+//   token: 4 starsze bity = liczba literałów, 4 młodsze = długość dopasowania - 4
+//   (15 = rozszerzenie kolejnymi bajtami 255...). Offset liczony wstecz w
+//   wirtualnym buforze słownik + dane, więc dopasowania mogą sięgać do słownika.
+// Wartość w JSON (encodeValue): "<id słownika, 8 hex>:<base64 bloku>" - blok
+// z innego słownika dekoduje się do wiarygodnie wyglądających śmieci, więc
+// decodeValue porównuje id. Wartości bez prefiksu (starsze pliki) bez kontroli.
+
+#ifndef DESCRIPTIONCODEC_H
+#define DESCRIPTIONCODEC_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace DescriptionCodec {
+
+// Maksymalny rozmiar słownika (okno dopasowań to 64 KB)
+constexpr size_t MAX_DICTIONARY_SIZE = 32 * 1024;
+
+// Budowa słownika z próbek (uproszczony algorytm COVER: wybieramy fragmenty
+// próbek z największą liczbą k-gramów występujących w wielu opisach)
+std::string trainDictionary(const std::vector<std::string>& samples,
+                            size_t maxSize = MAX_DICTIONARY_SIZE);
+
+// Słownik przygotowany do kompresji - tablica haszy słownika liczona raz,
+// a nie przy każdym opisie. Niezmienny po konstrukcji (bezpieczny wielowątkowo).
+class Dictionary {
+private:
+    std::string data;             // Końcówka słownika mieszcząca się w oknie
+    std::vector<int32_t> table;   // hash(4 bajty) -> ostatnia pozycja w słowniku
+    uint32_t id;                  // Skrót bajtów słownika (prefiks wartości w JSON)
+
+public:
+    explicit Dictionary(const std::string& bytes = std::string());
+
+    const std::string& getBytes() const { return data; }
+    uint32_t getId() const { return id; }
+
+    // Kompresja/dekompresja jednego opisu
+    std::string compress(const std::string& input) const;
+
+    // Rzuca std::runtime_error przy uszkodzonych danych
+    std::string decompress(const std::string& block) const;
+};
+
+// Base64 - skompresowany blok zapisywany jest jako string JSON
+std::string encodeBase64(const std::string& data);
+std::string decodeBase64(const std::string& text);
+
+// Opis -> wartość "descriptionLz" (id słownika + base64 skompresowanego bloku)
+std::string encodeValue(const Dictionary& dictionary, const std::string& text);
+
+// Wartość "descriptionLz" -> opis. Rzuca std::runtime_error, gdy blok pochodzi
+// z innego słownika albo jest uszkodzony.
+std::string decodeValue(const Dictionary& dictionary, std::string_view value);
+
+// Id słownika zapisane w wartości (false = wartość bez prefiksu, starszy format)
+bool valueDictionaryId(std::string_view value, uint32_t& id);
+
+} // namespace DescriptionCodec
+
+#endif // DESCRIPTIONCODEC_H
@@ -0,0 +1,121 @@
+// DescriptionStore.cpp
+// Lokalizacja: core/DescriptionStore.cpp
+
+#include "DescriptionStore.h"
+#include "JsonUtils.h"
+#include "Logger.h"
+
+uint64_t DescriptionStore::digest(std::string_view raw) {
+    uint64_t hash = 14695981039346656037ull;
+    for(unsigned char c : raw) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+DescriptionStore::DescriptionStore(const std::string& path, size_t cacheCapacity)
+    : filePath(path), capacity(cacheCapacity > 0 ? cacheCapacity : 1) {
+    // Deskryptor trzyma wczytaną wersję pliku także po jego podmianie
+    file.open(filePath, std::ios::binary);
+}
+
+void DescriptionStore::setDictionary(std::shared_ptr<const DescriptionCodec::Dictionary> dict) {
+    std::lock_guard<std::mutex> lock(mutex);
+    dictionary = std::move(dict);
+}
+
+std::shared_ptr<const DescriptionCodec::Dictionary> DescriptionStore::getDictionary() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return dictionary;
+}
+
+std::string DescriptionStore::fetch(uint64_t offset, uint32_t length, bool compressed, uint64_t expectedDigest) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto found = index.find(offset);
+    if(found != index.end()) {
+        ++hits;
+        lru.splice(lru.begin(), lru, found->second);  // Przesunięcie na początek (O(1))
+        return found->second->second;
+    }
+
+    ++misses;
+
+    if(!file.is_open()) {
+        file.open(filePath, std::ios::binary);
+    }
+
+    // Bez zamykania po błędzie - ponowne otwarcie mogłoby trafić na nowszą wersję pliku
+    std::string raw(length, '\0');
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset));
+    if(length > 0) {
+        file.read(&raw[0], length);
+    }
+    if(!file) {
+        Logger::error("DescriptionStore", "Nie można odczytać opisu",
+                      {{"path", filePath}, {"offset", std::to_string(offset)}});
+        return std::string();
+    }
+    if(expectedDigest != 0 && digest(raw) != expectedDigest) {
+        Logger::error("DescriptionStore", "Opis niezgodny ze skrótem - plik nadpisany w miejscu",
+                      {{"path", filePath}, {"offset", std::to_string(offset)}});
+        return std::string();
+    }
+
+    std::string text;
+    if(compressed) {
+        try {
+            static const DescriptionCodec::Dictionary emptyDictionary;
+            const auto& dict = dictionary ? *dictionary : emptyDictionary;
+            text = DescriptionCodec::decodeValue(dict, raw);
+        } catch(const std::exception& e) {
+            Logger::error("DescriptionStore", "Nie można zdekompresować opisu",
+                          {{"offset", std::to_string(offset)}, {"error", e.what()}});
+            return std::string();
+        }
+    } else {
+        text = JsonUtils::unescape(raw);
+    }
+
+    lru.emplace_front(offset, std::move(text));
+    index[offset] = lru.begin();
+    cachedBytes += lru.front().second.size();
+    evictOverCapacity();
+
+    return lru.front().second;
+}
+
+void DescriptionStore::evictOverCapacity() {
+    while(lru.size() > capacity) {
+        cachedBytes -= lru.back().second.size();
+        index.erase(lru.back().first);
+        lru.pop_back();
+    }
+}
+
+void DescriptionStore::setCapacity(size_t cacheCapacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = cacheCapacity > 0 ? cacheCapacity : 1;
+    evictOverCapacity();
+}
+
+size_t DescriptionStore::getCachedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lru.size();
+}
+
+size_t DescriptionStore::getCachedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cachedBytes;
+}
+
+size_t DescriptionStore::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+size_t DescriptionStore::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
@@ -0,0 +1,78 @@
+// DescriptionStore.h
+// Lokalizacja: core/DescriptionStore.h
+// Opis: Leniwe ładowanie opisów ćwiczeń - przy ładowaniu zapamiętujemy tylko
+//       położenie (offset/długość) opisu w pliku JSON, tekst czytamy na żądanie
+//       i trzymamy w cache LRU o ograniczonej pojemności.
+//
+// Zakres wskazuje surową (escapowaną) wartość spomiędzy cudzysłowów; dla opisów
+// skompresowanych jest to wartość DescriptionCodec::encodeValue (słownik: setDictionary).
+// Plik otwieramy od razu przy tworzeniu magazynu i trzymamy otwarty - zapis
+// podmienia plik przez rename (JsonUtils::replaceFile), więc stary magazyn dalej
+// czyta swoją wersję (stary i-węzeł), bez kopii treści w pamięci. Plik jest
+// jedyną kopią tekstu; ExerciseRepository::saveToJSON przepina ćwiczenia na nowy
+// magazyn, a stare obiekty (snapshoty, historia CommandLog) zostają przy starym.
+
+#ifndef DESCRIPTIONSTORE_H
+#define DESCRIPTIONSTORE_H
+
+#include "DescriptionCodec.h"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+class DescriptionStore {
+private:
+    std::string filePath;
+    std::ifstream file;      // Otwierany w konstruktorze (gdy pliku brak - przy odczycie)
+    size_t capacity;         // Maks. liczba opisów w cache
+    std::shared_ptr<const DescriptionCodec::Dictionary> dictionary;  // Dla opisów skompresowanych
+
+    // LRU: najświeższe na początku listy, mapa offset -> pozycja na liście
+    std::list<std::pair<uint64_t, std::string>> lru;
+    std::unordered_map<uint64_t, std::list<std::pair<uint64_t, std::string>>::iterator> index;
+    size_t cachedBytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+
+    mutable std::mutex mutex;
+
+    void evictOverCapacity();
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+    explicit DescriptionStore(const std::string& path, size_t cacheCapacity = DEFAULT_CAPACITY);
+
+    DescriptionStore(const DescriptionStore&) = delete;
+    DescriptionStore& operator=(const DescriptionStore&) = delete;
+
+    // Tekst opisu (odczyt z pliku przy braku w cache). Bezpieczne wielowątkowo.
+    // expectedDigest != 0 - surowa wartość musi mieć ten skrót (DescriptionRef::digest);
+    // inaczej plik nadpisano w miejscu i pod offsetem są inne dane - pusty opis.
+    std::string fetch(uint64_t offset, uint32_t length, bool compressed = false, uint64_t expectedDigest = 0);
+
+    // Słownik do dekompresji opisów "descriptionLz" (ustawiany przed pierwszym fetch)
+    void setDictionary(std::shared_ptr<const DescriptionCodec::Dictionary> dict);
+    std::shared_ptr<const DescriptionCodec::Dictionary> getDictionary() const;
+
+    const std::string& getFilePath() const { return filePath; }
+
+    // Skrót surowej wartości (FNV-1a, nigdy 0) - porównanie opisu z nową wersją
+    // pliku bez czytania starego pliku (przeładowanie zmian z zewnątrz)
+    static uint64_t digest(std::string_view raw);
+
+    void setCapacity(size_t cacheCapacity);
+
+    // Statystyki cache
+    size_t getCachedCount() const;
+    size_t getCachedBytes() const;
+    size_t getHits() const;
+    size_t getMisses() const;
+};
+
+#endif // DESCRIPTIONSTORE_H
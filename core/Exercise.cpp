@@ -3,6 +3,7 @@
 // Implementacja klasy Exercise
 
 #include "Exercise.h"
+#include "DescriptionStore.h"
 #include <stdexcept>
 
 Exercise::Exercise(const std::string& name,
@@ -11,6 +12,41 @@ Exercise::Exercise(const std::string& name,
     : name(name), description(desc), targetMuscles(muscles) {
 }
 
+std::string Exercise::getDescription() const {
+    auto ref = std::atomic_load(&lazyDescription);
+    if(ref) {
+        return ref->store->fetch(ref->offset, ref->length, ref->compressed, ref->digest);
+    }
+    return description;
+}
+
+void Exercise::setDescription(const std::string& d) {
+    description = d;
+    std::atomic_store(&lazyDescription, std::shared_ptr<const DescriptionRef>());
+}
+
+void Exercise::setLazyDescription(DescriptionRef ref) {
+    std::atomic_store(&lazyDescription, std::make_shared<const DescriptionRef>(std::move(ref)));
+    std::string().swap(description);  // Zwolnienie bufora (clear() zostawia capacity)
+}
+
+bool Exercise::hasLazyDescription() const {
+    return std::atomic_load(&lazyDescription) != nullptr;
+}
+
+DescriptionRef Exercise::getLazyDescription() const {
+    auto ref = std::atomic_load(&lazyDescription);
+    return ref ? *ref : DescriptionRef{};
+}
+
+bool Exercise::rebindLazyDescription(DescriptionRef ref) const {
+    if(!hasLazyDescription()) {
+        return false;
+    }
+    std::atomic_store(&lazyDescription, std::make_shared<const DescriptionRef>(std::move(ref)));
+    return true;
+}
+
 // Konwersja typu ćwiczenia na string (do zapisu JSON)
 std::string Exercise::typeToString(ExerciseType type) {
     switch(type) {
@@ -9,6 +9,18 @@
 
 #include <string>
 #include <memory>
+#include <cstdint>
+
+class DescriptionStore;
+
+// Odwołanie do opisu ładowanego na żądanie (zob. DescriptionStore)
+struct DescriptionRef {
+    std::shared_ptr<DescriptionStore> store = nullptr;
+    uint64_t offset = 0;   // Początek surowej wartości w pliku
+    uint32_t length = 0;   // Długość surowej (escapowanej) wartości
+    bool compressed = false;  // Wartość to base64 bloku DescriptionCodec ("descriptionLz")
+    uint64_t digest = 0;      // DescriptionStore::digest surowej wartości (0 = nieznany)
+};
 
 // Enum definiujący typ ćwiczenia
 enum class ExerciseType {
@@ -22,6 +34,9 @@ protected:
     std::string name;           // Nazwa ćwiczenia
     std::string description;    // Opis jak wykonać ćwiczenie
     std::string targetMuscles;  // Mięśnie zaangażowane
+    // Ustawione = opis czytany z pliku na żądanie. Dostęp przez std::atomic_load/store -
+    // zapis pliku przepina odwołanie na nowy magazyn, gdy inne wątki czytają ze snapshotu.
+    mutable std::shared_ptr<const DescriptionRef> lazyDescription;
 
 public:
     // Konstruktor
@@ -41,15 +56,28 @@ public:
     virtual std::unique_ptr<Exercise> clone() const = 0;
 
     // Gettery
-    std::string getName() const { return name; }
-    std::string getDescription() const { return description; }
-    std::string getTargetMuscles() const { return targetMuscles; }
+    const std::string& getName() const { return name; }
+    std::string getDescription() const;  // Przy leniwym opisie - odczyt przez cache
+    const std::string& getTargetMuscles() const { return targetMuscles; }
 
     // Settery
     void setName(const std::string& n) { name = n; }
-    void setDescription(const std::string& d) { description = d; }
+    void setDescription(const std::string& d);
     void setTargetMuscles(const std::string& m) { targetMuscles = m; }
 
+    // Leniwy opis: zwalnia tekst w pamięci, od teraz getDescription() czyta z magazynu.
+    // Tylko dla obiektów jeszcze nieopublikowanych (np. zaraz po parsowaniu).
+    void setLazyDescription(DescriptionRef ref);
+    bool hasLazyDescription() const;
+    DescriptionRef getLazyDescription() const;
+
+    // Przepięcie istniejącego leniwego opisu (ta sama treść, nowy plik/offset).
+    // Bezpieczne przy równoległych odczytach; false gdy opis nie jest leniwy.
+    bool rebindLazyDescription(DescriptionRef ref) const;
+
+    // Pamięć zajmowana przez opis w obiekcie (0 dla leniwego) - bez materializacji
+    size_t getDescriptionFootprint() const { return hasLazyDescription() ? 0 : description.capacity(); }
+
     // Pomocnicza funkcja do konwersji typu na string
     static std::string typeToString(ExerciseType type);
     static ExerciseType stringToType(const std::string& typeStr);
@@ -0,0 +1,97 @@
+// ExerciseCatalog.cpp
+// Lokalizacja: core/ExerciseCatalog.cpp
+
+#include "ExerciseCatalog.h"
+#include "ExerciseRepository.h"
+#include "WeightedExercise.h"
+#include "Logger.h"
+#include <algorithm>
+
+ExerciseCatalog::ExerciseCatalog(std::vector<std::shared_ptr<Exercise>> loaded) {
+    exercises.reserve(loaded.size());
+    positions.reserve(loaded.size());
+    for(auto& ex : loaded) {
+        if(!ex || !positions.emplace(ex->getName(), exercises.size()).second) {
+            continue;  // Duplikat nazwy - nakładka nie mogłaby go jednoznacznie przesłonić
+        }
+        fuzzyIndex.insert(ex->getName());
+        exercises.push_back(std::move(ex));
+    }
+    items = RepositorySnapshot<Exercise>::Items(
+        std::vector<std::shared_ptr<const Exercise>>(exercises.begin(), exercises.end()));
+
+    // Indeksy posortowane liczone raz - strony zapytań wszystkich użytkowników
+    // to tylko wyszukiwanie binarne kursora
+    const ExerciseSortKey keys[3] = {ExerciseSortKey::NAME, ExerciseSortKey::TYPE, ExerciseSortKey::MUSCLES};
+    for(int k = 0; k < 3; ++k) {
+        auto& rows = sortedRows[k];
+        rows.reserve(exercises.size());
+        for(const auto& ex : exercises) {
+            rows.emplace_back(exerciseSortKey(keys[k], *ex), ex);
+        }
+        std::sort(rows.begin(), rows.end(),
+                  [](const SortedRow& a, const SortedRow& b) { return a.first < b.first; });
+    }
+}
+
+std::shared_ptr<const ExerciseCatalog> ExerciseCatalog::loadFromJSON(const std::string& filePath) {
+    // Plik katalogu się nie zmienia - opisy zostają na dysku (leniwie, wspólny cache)
+    ExerciseRepository repo(filePath);
+    repo.setLazyDescriptions(true);
+    if(!repo.loadFromJSON()) {
+        Logger::error("ExerciseCatalog", "Nie można wczytać katalogu globalnego", {{"path", filePath}});
+        return nullptr;
+    }
+
+    auto catalog = std::make_shared<const ExerciseCatalog>(repo.getAllExercises());
+    Logger::info("ExerciseCatalog", "Wczytano katalog globalny",
+                 {{"path", filePath}, {"exercises", std::to_string(catalog->getCount())}});
+    return catalog;
+}
+
+std::shared_ptr<Exercise> ExerciseCatalog::findByName(const std::string& name) const {
+    auto it = positions.find(name);
+    return it != positions.end() ? exercises[it->second] : nullptr;
+}
+
+std::vector<NameSuggestion> ExerciseCatalog::suggestNames(const std::string& name, size_t limit,
+                                                          int maxDistance) const {
+    return fuzzyIndex.query(name, limit, maxDistance);
+}
+
+const std::vector<ExerciseCatalog::SortedRow>& ExerciseCatalog::getSorted(ExerciseSortKey key) const {
+    switch(key) {
+    case ExerciseSortKey::TYPE:
+        return sortedRows[1];
+    case ExerciseSortKey::MUSCLES:
+        return sortedRows[2];
+    default:
+        return sortedRows[0];
+    }
+}
+
+size_t ExerciseCatalog::indexOf(const std::string& name) const {
+    auto it = positions.find(name);
+    return it != positions.end() ? it->second : npos;
+}
+
+bool ExerciseCatalog::contains(const Exercise* exercise) const {
+    if(!exercise) {
+        return false;
+    }
+    size_t index = indexOf(exercise->getName());
+    return index != npos && exercises[index].get() == exercise;
+}
+
+size_t ExerciseCatalog::estimateMemoryUsage() const {
+    size_t total = exercises.size() * 2 * sizeof(std::shared_ptr<Exercise>);
+    for(const auto& ex : exercises) {
+        total += sizeof(WeightedExercise) + 2 * sizeof(void*);
+        total += ex->getName().capacity() + ex->getDescriptionFootprint()
+                 + ex->getTargetMuscles().capacity();
+        total += ex->getName().capacity() + sizeof(size_t) + 2 * sizeof(void*);  // positions
+        total += 3 * ex->getName().capacity() + 48;                              // fuzzyIndex
+        total += 3 * (2 * ex->getName().capacity() + sizeof(SortedRow));          // sortedRows
+    }
+    return total;
+}
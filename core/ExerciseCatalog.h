@@ -0,0 +1,68 @@
+// ExerciseCatalog.h
+// Lokalizacja: core/ExerciseCatalog.h
+// Opis: Globalny, tylko do odczytu katalog ćwiczeń współdzielony przez wiele
+//       instancji DatabaseManager (wielu użytkowników w jednym procesie).
+//       Repozytorium użytkownika trzyma jedynie nakładkę (własne ćwiczenia
+//       i zmienione kopie ćwiczeń z katalogu) - zob. ExerciseRepository::setBaseCatalog.
+// Design Pattern: Immutable Object, Flyweight
+//
+// Wątki: obiekt jest niezmienny po konstrukcji - wszystkie metody bezpieczne
+// wielowątkowo bez blokad. Ćwiczeń z katalogu nie wolno modyfikować w miejscu.
+
+#ifndef EXERCISECATALOG_H
+#define EXERCISECATALOG_H
+
+#include "Exercise.h"
+#include "FuzzyIndex.h"
+#include "ExerciseQuery.h"
+#include "Snapshot.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ExerciseCatalog {
+private:
+    std::vector<std::shared_ptr<Exercise>> exercises;
+    RepositorySnapshot<Exercise>::Items items;          // Bloki współdzielone z wersjami nakładek
+    std::unordered_map<std::string, size_t> positions;  // Nazwa -> pozycja
+    FuzzyIndex fuzzyIndex;                              // Podpowiedzi nazw
+    // NAME, TYPE, MUSCLES posortowane raz (klucz exerciseSortKey -> ćwiczenie)
+    std::vector<std::pair<std::string, std::shared_ptr<Exercise>>> sortedRows[3];
+
+public:
+    // Wiersz indeksu posortowanego: klucz exerciseSortKey i ćwiczenie
+    using SortedRow = std::pair<std::string, std::shared_ptr<Exercise>>;
+
+    // Przy powtórzonych nazwach zostaje pierwsze ćwiczenie
+    explicit ExerciseCatalog(std::vector<std::shared_ptr<Exercise>> exercises);
+
+    // Wczytanie katalogu z pliku JSON w formacie ExerciseRepository (nullptr = błąd)
+    static std::shared_ptr<const ExerciseCatalog> loadFromJSON(const std::string& filePath);
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    size_t getCount() const { return exercises.size(); }
+    const std::vector<std::shared_ptr<Exercise>>& getAllExercises() const { return exercises; }
+    const RepositorySnapshot<Exercise>::Items& getItems() const { return items; }
+
+    std::shared_ptr<Exercise> findByName(const std::string& name) const;
+
+    // Nazwy katalogu najbliższe zapytaniu (zob. FuzzyIndex::query)
+    std::vector<NameSuggestion> suggestNames(const std::string& name, size_t limit = 5,
+                                             int maxDistance = -1) const;
+
+    // Katalog posortowany po kluczu (NAME, TYPE albo MUSCLES; RECENT = NAME)
+    const std::vector<SortedRow>& getSorted(ExerciseSortKey key) const;
+
+    // Pozycja ćwiczenia w katalogu (npos gdy brak)
+    size_t indexOf(const std::string& name) const;
+
+    // Czy to dokładnie obiekt z katalogu (a nie kopia o tej samej nazwie)
+    bool contains(const Exercise* exercise) const;
+
+    // Przybliżona pamięć katalogu (bajty) - liczona raz dla wszystkich użytkowników
+    size_t estimateMemoryUsage() const;
+};
+
+#endif // EXERCISECATALOG_H
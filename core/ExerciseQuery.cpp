@@ -0,0 +1,29 @@
+// ExerciseQuery.cpp
+// Lokalizacja: core/ExerciseQuery.cpp
+
+#include "ExerciseQuery.h"
+#include "Collation.h"
+
+// Separator '\0' jest mniejszy od każdej wagi klucza, więc krótszy prefiks
+// ("Legs") wypada przed dłuższym ("Legs, Core")
+std::string exerciseNameKey(const std::string& name) {
+    std::string key = Collation::polishKey(name);
+    key.push_back('\0');
+    key += name;
+    return key;
+}
+
+std::string exerciseSortKey(ExerciseSortKey key, const Exercise& exercise) {
+    std::string nameKey = exerciseNameKey(exercise.getName());
+
+    switch(key) {
+    case ExerciseSortKey::TYPE:
+        return static_cast<char>('0' + static_cast<int>(exercise.getType())) + nameKey;
+    case ExerciseSortKey::MUSCLES:
+        return Collation::polishKey(exercise.getTargetMuscles()) + '\0' + nameKey;
+    case ExerciseSortKey::NAME:
+    case ExerciseSortKey::RECENT:
+    default:
+        return nameKey;
+    }
+}
@@ -0,0 +1,46 @@
+// ExerciseQuery.h
+// Lokalizacja: core/ExerciseQuery.h
+// Opis: Zapytania o posortowaną listę ćwiczeń ze stronicowaniem kursorem
+//       (ExerciseRepository::queryExercises). Kursor to klucz sortowania
+//       ostatniego zwróconego wiersza - następna strona zaczyna się tuż za nim,
+//       więc dodanie/usunięcie ćwiczeń między stronami niczego nie przesuwa
+//       ani nie dubluje (w przeciwieństwie do offsetu).
+
+#ifndef EXERCISEQUERY_H
+#define EXERCISEQUERY_H
+
+#include "Exercise.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class ExerciseSortKey {
+    NAME,      // Nazwa, porządek polski (Collation)
+    TYPE,      // Typ, potem nazwa
+    MUSCLES,   // Partia mięśniowa, potem nazwa
+    RECENT     // Ostatnio użyte najpierw (ExerciseRepository::markUsed), reszta po nazwie
+};
+
+struct ExerciseQuery {
+    ExerciseSortKey sortBy = ExerciseSortKey::NAME;
+    std::string nameContains;   // Fragment nazwy jak w searchByName (pusty = wszystkie)
+    size_t pageSize = 50;
+    std::string cursor;         // nextCursor poprzedniej strony (pusty = od początku)
+};
+
+struct ExercisePage {
+    std::vector<std::shared_ptr<Exercise>> items;
+    std::string nextCursor;     // Pusty = to była ostatnia strona
+
+    bool hasMore() const { return !nextCursor.empty(); }
+};
+
+// Klucz sortowania po samej nazwie (porządek polski, remis - surowe bajty)
+std::string exerciseNameKey(const std::string& name);
+
+// Klucz sortowania NAME/TYPE/MUSCLES jako bajty do porównania operator<.
+// Kończy się pełną nazwą, więc jest unikalny w obrębie repozytorium.
+std::string exerciseSortKey(ExerciseSortKey key, const Exercise& exercise);
+
+#endif // EXERCISEQUERY_H
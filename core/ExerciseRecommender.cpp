@@ -0,0 +1,167 @@
+// ExerciseRecommender.cpp
+// Lokalizacja: core/ExerciseRecommender.cpp
+
+#include "ExerciseRecommender.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct ExerciseRecommenderMetrics {
+    LatencyHistogram& latency = MetricsRegistry::getInstance().histogram("pumpapp_recommend_latency_us");
+};
+
+ExerciseRecommenderMetrics& metrics() {
+    static ExerciseRecommenderMetrics instance;
+    return instance;
+}
+
+} // namespace
+
+uint32_t ExerciseRecommender::idOf(const std::string& name) const {
+    auto it = ids.find(name);
+    return it == ids.end() ? NONE : it->second;
+}
+
+std::vector<uint32_t> ExerciseRecommender::distinctIds(const WorkoutPlan& plan, bool create) {
+    std::vector<uint32_t> result;
+    result.reserve(plan.getEntryCount());
+    for(const auto& entry : plan.getEntries()) {
+        const std::string& name = entry.exercise->getName();
+        uint32_t id = idOf(name);
+        if(id == NONE) {
+            if(!create) {
+                continue;
+            }
+            id = static_cast<uint32_t>(names.size());
+            ids.emplace(name, id);
+            names.push_back(name);
+            planCounts.push_back(0);
+            rows.emplace_back();
+        }
+        result.push_back(id);
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+void ExerciseRecommender::addPlan(const WorkoutPlan& plan) {
+    const auto exercises = distinctIds(plan, true);
+    for(uint32_t a : exercises) {
+        ++planCounts[a];
+        for(uint32_t b : exercises) {
+            if(a != b) {
+                ++rows[a][b];
+            }
+        }
+    }
+}
+
+void ExerciseRecommender::removePlan(const WorkoutPlan& plan) {
+    const auto exercises = distinctIds(plan, false);
+    for(uint32_t a : exercises) {
+        if(planCounts[a] > 0) {
+            --planCounts[a];
+        }
+        for(uint32_t b : exercises) {
+            if(a == b) {
+                continue;
+            }
+            auto it = rows[a].find(b);
+            if(it != rows[a].end() && --it->second == 0) {
+                rows[a].erase(it);   // Macierz pozostaje rzadka
+            }
+        }
+    }
+}
+
+void ExerciseRecommender::clear() {
+    ids.clear();
+    names.clear();
+    planCounts.clear();
+    rows.clear();
+}
+
+void ExerciseRecommender::rebuild(const std::vector<std::shared_ptr<WorkoutPlan>>& plans) {
+    clear();
+    for(const auto& plan : plans) {
+        addPlan(*plan);
+    }
+}
+
+std::vector<ExerciseRecommendation> ExerciseRecommender::recommend(const WorkoutPlan& draft, size_t limit) const {
+    ScopedLatency latency(metrics().latency);
+
+    std::vector<uint32_t> inDraft;
+    for(const auto& entry : draft.getEntries()) {
+        const uint32_t id = idOf(entry.exercise->getName());
+        if(id != NONE) {
+            inDraft.push_back(id);
+        }
+    }
+    std::sort(inDraft.begin(), inDraft.end());
+    inDraft.erase(std::unique(inDraft.begin(), inDraft.end()), inDraft.end());
+
+    // Nic znanego w szkicu - najczęściej używane
+    std::unordered_map<uint32_t, double> scores;
+    if(inDraft.empty()) {
+        for(uint32_t id = 0; id < planCounts.size(); ++id) {
+            if(planCounts[id] > 0) {
+                scores.emplace(id, static_cast<double>(planCounts[id]));
+            }
+        }
+    }
+    for(uint32_t a : inDraft) {
+        for(const auto& [b, count] : rows[a]) {
+            if(!std::binary_search(inDraft.begin(), inDraft.end(), b)) {
+                scores[b] += count / std::sqrt(static_cast<double>(planCounts[a]) * planCounts[b]);
+            }
+        }
+    }
+
+    std::vector<ExerciseRecommendation> results;
+    std::vector<std::pair<uint32_t, double>> ranked(scores.begin(), scores.end());
+    const size_t count = std::min(limit, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(count), ranked.end(),
+                      [this](const auto& a, const auto& b) {
+                          if(a.second != b.second) {
+                              return a.second > b.second;
+                          }
+                          if(planCounts[a.first] != planCounts[b.first]) {
+                              return planCounts[a.first] > planCounts[b.first];
+                          }
+                          return names[a.first] < names[b.first];
+                      });
+    results.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+        results.push_back({names[ranked[i].first], ranked[i].second});
+    }
+    return results;
+}
+
+uint32_t ExerciseRecommender::planCount(const std::string& exercise) const {
+    const uint32_t id = idOf(exercise);
+    return id == NONE ? 0 : planCounts[id];
+}
+
+uint32_t ExerciseRecommender::coOccurrences(const std::string& a, const std::string& b) const {
+    const uint32_t first = idOf(a);
+    const uint32_t second = idOf(b);
+    if(first == NONE || second == NONE) {
+        return 0;
+    }
+    auto it = rows[first].find(second);
+    return it == rows[first].end() ? 0 : it->second;
+}
+
+size_t ExerciseRecommender::estimateMemoryUsage() const {
+    size_t total = names.capacity() * sizeof(std::string) + planCounts.capacity() * sizeof(uint32_t)
+                   + rows.capacity() * sizeof(std::unordered_map<uint32_t, uint32_t>);
+    for(size_t i = 0; i < names.size(); ++i) {
+        total += 2 * names[i].capacity() + sizeof(uint32_t) + 2 * sizeof(void*);   // names + ids
+        total += rows[i].size() * (2 * sizeof(uint32_t) + 2 * sizeof(void*));
+    }
+    return total;
+}
@@ -0,0 +1,64 @@
+// ExerciseRecommender.h
+// Lokalizacja: core/ExerciseRecommender.h
+// Opis: Podpowiedzi kolejnych ćwiczeń dla budowanego planu na podstawie tego,
+//       co występuje razem w istniejących planach. Rzadka macierz współwystąpień
+//       (wiersz = ćwiczenie, tylko niezerowe pary) aktualizowana przyrostowo przy
+//       dodaniu/usunięciu planu - koszt O(m^2) dla m różnych ćwiczeń planu,
+//       nie przeliczenie całej biblioteki.
+//
+//       Wynik kandydata: suma po ćwiczeniach szkicu współwystąpień
+//       znormalizowanych jak cosinus (c(a,b) / sqrt(n(a) * n(b)), n = liczba
+//       planów z ćwiczeniem), więc ćwiczenia obecne w każdym planie nie wypierają
+//       trafniejszych. Zapytanie czyta tylko wiersze ćwiczeń szkicu.
+//       Pusty szkic - najczęściej używane ćwiczenia.
+// Design Pattern: brak (struktura danych)
+//
+// Wątki: brak własnej synchronizacji - zapisy pod blokadą właściciela
+// (WorkoutPlanRepository::storageLock), zapytania równoległe są bezpieczne.
+
+#ifndef EXERCISERECOMMENDER_H
+#define EXERCISERECOMMENDER_H
+
+#include "WorkoutPlan.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ExerciseRecommendation {
+    std::string name;
+    double score = 0.0;
+};
+
+class ExerciseRecommender {
+public:
+    void addPlan(const WorkoutPlan& plan);
+    void removePlan(const WorkoutPlan& plan);
+    void clear();
+    void rebuild(const std::vector<std::shared_ptr<WorkoutPlan>>& plans);
+
+    // Maks. limit ćwiczeń spoza szkicu, malejąco po wyniku (remis - częstsze, potem nazwa)
+    std::vector<ExerciseRecommendation> recommend(const WorkoutPlan& draft, size_t limit = 5) const;
+
+    // Liczba planów zawierających ćwiczenie / oba ćwiczenia
+    uint32_t planCount(const std::string& exercise) const;
+    uint32_t coOccurrences(const std::string& a, const std::string& b) const;
+
+    size_t estimateMemoryUsage() const;
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    std::unordered_map<std::string, uint32_t> ids;              // Nazwa -> id (raz nadane zostaje)
+    std::vector<std::string> names;
+    std::vector<uint32_t> planCounts;
+    std::vector<std::unordered_map<uint32_t, uint32_t>> rows;   // rows[a][b] = plany z a i b
+
+    uint32_t idOf(const std::string& name) const;
+
+    // Posortowane id różnych ćwiczeń planu (create = nadanie id nowym nazwom)
+    std::vector<uint32_t> distinctIds(const WorkoutPlan& plan, bool create);
+};
+
+#endif // EXERCISERECOMMENDER_H
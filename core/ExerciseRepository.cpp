@@ -3,12 +3,90 @@
 // UWAGA: Używamy prostego JSON parsingu (bez zewnętrznych bibliotek)
 
 #include "ExerciseRepository.h"
+#include "ExerciseCatalog.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include "JsonUtils.h"
+#include "ThreadPool.h"
+#include "DescriptionStore.h"
+#include "JsonWriter.h"
+#include <cstdio>
 #include <fstream>
-#include <sstream>
-#include <iostream>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+// Metryki repozytorium - referencje pobrane raz, aktualizacja lock-free
+namespace {
+struct ExerciseRepositoryMetrics {
+    Counter& findCalls = MetricsRegistry::getInstance().counter("pumpapp_exercise_find_total");
+    LatencyHistogram& findLatency = MetricsRegistry::getInstance().histogram("pumpapp_exercise_find_latency_us");
+    Counter& searchCalls = MetricsRegistry::getInstance().counter("pumpapp_exercise_search_total");
+    LatencyHistogram& suggestLatency = MetricsRegistry::getInstance().histogram("pumpapp_exercise_suggest_latency_us");
+    LatencyHistogram& queryLatency = MetricsRegistry::getInstance().histogram("pumpapp_exercise_query_latency_us");
+    LatencyHistogram& searchLatency = MetricsRegistry::getInstance().histogram("pumpapp_exercise_search_latency_us");
+    LatencyHistogram& loadLatency = MetricsRegistry::getInstance().histogram("pumpapp_exercise_load_latency_us");
+    LatencyHistogram& saveLatency = MetricsRegistry::getInstance().histogram("pumpapp_exercise_save_latency_us");
+    LatencyHistogram& importLatency = MetricsRegistry::getInstance().histogram("pumpapp_exercise_import_latency_us");
+    Counter& importRows = MetricsRegistry::getInstance().counter("pumpapp_exercise_import_rows_total");
+    Counter& importErrors = MetricsRegistry::getInstance().counter("pumpapp_exercise_import_errors_total");
+    Counter& saveConflicts = MetricsRegistry::getInstance().counter("pumpapp_exercise_save_conflicts_total");
+    LatencyHistogram& reloadLatency = MetricsRegistry::getInstance().histogram("pumpapp_exercise_reload_latency_us");
+};
+
+ExerciseRepositoryMetrics& metrics() {
+    static ExerciseRepositoryMetrics instance;
+    return instance;
+}
+
+// Indeksy posortowane w tablicy sortedIndexes (RECENT korzysta z NAME)
+const ExerciseSortKey SORTED_KEYS[3] = {ExerciseSortKey::NAME, ExerciseSortKey::TYPE, ExerciseSortKey::MUSCLES};
+
+size_t sortedSlot(ExerciseSortKey key) {
+    switch(key) {
+    case ExerciseSortKey::TYPE: return 1;
+    case ExerciseSortKey::MUSCLES: return 2;
+    default: return 0;
+    }
+}
+
+// Kursory RECENT: najpierw używane (prefiks USED, malejąco po znaczniku),
+// potem pozostałe w porządku nazw (prefiks UNUSED + klucz NAME)
+constexpr char RECENT_USED = '\x01';
+constexpr char RECENT_UNUSED = '\x02';
+
+std::string recentKey(uint64_t stamp, const std::string& name) {
+    std::string key(1, RECENT_USED);
+    const uint64_t inverted = ~stamp;   // Big-endian odwrócony - nowsze mniejsze
+    for(int shift = 56; shift >= 0; shift -= 8) {
+        key.push_back(static_cast<char>((inverted >> shift) & 0xFF));
+    }
+    key += exerciseNameKey(name);
+    return key;
+}
+
+// Ta sama treść ćwiczenia w pamięci i w przeładowanym pliku. Opis leniwy ze
+// starego magazynu pliku porównujemy skrótem surowej wartości - offsety
+// wskazują już nieistniejącą wersję pliku, więc tekstu nie da się odczytać.
+bool sameContent(const Exercise& current, const Exercise& loaded, const DescriptionStore* oldStore) {
+    if(current.getName() != loaded.getName() || current.getType() != loaded.getType()
+       || current.getTargetMuscles() != loaded.getTargetMuscles()) {
+        return false;
+    }
+    const DescriptionRef before = current.getLazyDescription();
+    if(current.hasLazyDescription() && before.store.get() == oldStore) {
+        const DescriptionRef after = loaded.getLazyDescription();
+        return loaded.hasLazyDescription() && before.digest != 0 && before.digest == after.digest
+               && before.compressed == after.compressed;
+    }
+    return current.getDescription() == loaded.getDescription();
+}
+}
 
 ExerciseRepository::ExerciseRepository(const std::string& filePath)
-    : jsonFilePath(filePath) {
+    : jsonFilePath(filePath)
+    , countGauge(MetricsRegistry::getInstance().gauge(MetricsRegistry::labeled("pumpapp_exercises", "file", filePath))) {
 }
 
 void ExerciseRepository::addExercise(std::shared_ptr<Exercise> exercise) {
@@ -16,29 +94,60 @@ void ExerciseRepository::addExercise(std::shared_ptr<Exercise> exercise) {
         throw std::invalid_argument("Nie można dodać pustego ćwiczenia!");
     }
 
-    // Sprawdzenie czy ćwiczenie o takiej nazwie już istnieje
-    if(exists(exercise->getName())) {
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    auto base = getBaseCatalog();
+
+    // Sprawdzenie czy ćwiczenie o takiej nazwie już istnieje (także w katalogu bazowym)
+    // (pod blokadą pisarza - żaden inny wątek nie doda tej nazwy w międzyczasie)
+    if((base && base->indexOf(exercise->getName()) != ExerciseCatalog::npos)
+       || !nameIndex.insert(exercise->getName(), exercise)) {
         throw std::runtime_error("Ćwiczenie o nazwie '" + exercise->getName() + "' już istnieje!");
     }
 
     exercises.push_back(exercise);
+    ++ownCount;   // Nazwy z katalogu odrzucone wyżej
+    versions.pushBack(exercise);
+    fuzzyIndex.insert(exercise->getName());
+    indexSorted(exercise);
+    mergedDirty = true;
+    countGauge.set(static_cast<int64_t>(countLocked(base.get())));
 }
 
 std::shared_ptr<Exercise> ExerciseRepository::findByName(const std::string& name) const {
-    auto it = std::find_if(exercises.begin(), exercises.end(),
-                           [&name](const std::shared_ptr<Exercise>& ex) {
-                               return ex->getName() == name;
-                           });
+    metrics().findCalls.increment();
+    ScopedLatency latency(metrics().findLatency);
 
-    return (it != exercises.end()) ? *it : nullptr;
+    // Nakładka przesłania katalog bazowy
+    if(auto exercise = nameIndex.find(name)) {
+        return exercise;
+    }
+    auto base = getBaseCatalog();
+    return base ? base->findByName(name) : nullptr;
 }
 
 std::vector<std::shared_ptr<Exercise>> ExerciseRepository::searchByName(const std::string& query) const {
+    PUMP_TRACE_SCOPE("ExerciseRepository::searchByName", "repo");
+    metrics().searchCalls.increment();
+    ScopedLatency latency(metrics().searchLatency);
     std::vector<std::shared_ptr<Exercise>> results;
 
+    std::shared_lock<std::shared_mutex> lock(storageLock);
+    auto base = getBaseCatalog();
+
+    // Kolejność jak w snapshocie: katalog bazowy (z przesłonięciami), potem własne
+    if(base) {
+        for(const auto& ex : base->getAllExercises()) {
+            if(ex->getName().find(query) != std::string::npos) {
+                auto shadow = nameIndex.find(ex->getName());
+                results.push_back(shadow ? shadow : ex);
+            }
+        }
+    }
+
     // Szukamy ćwiczeń zawierających query w nazwie (case-insensitive byłoby fajne, ale upraszczamy)
     for(const auto& ex : exercises) {
-        if(ex->getName().find(query) != std::string::npos) {
+        if(ex->getName().find(query) != std::string::npos
+           && !(base && base->indexOf(ex->getName()) != ExerciseCatalog::npos)) {
             results.push_back(ex);
         }
     }
@@ -46,147 +155,1125 @@ std::vector<std::shared_ptr<Exercise>> ExerciseRepository::searchByName(const st
     return results;
 }
 
-bool ExerciseRepository::updateExercise(const std::string& oldName,
-                                        std::shared_ptr<Exercise> newExercise) {
-    auto it = std::find_if(exercises.begin(), exercises.end(),
-                           [&oldName](const std::shared_ptr<Exercise>& ex) {
-                               return ex->getName() == oldName;
-                           });
+std::vector<NameSuggestion> ExerciseRepository::suggestNames(const std::string& name, size_t limit,
+                                                             int maxDistance) const {
+    ScopedLatency latency(metrics().suggestLatency);
+    std::vector<NameSuggestion> results;
+    {
+        std::shared_lock<std::shared_mutex> lock(storageLock);
+        results = fuzzyIndex.query(name, limit, maxDistance);
+    }
+    if(auto base = getBaseCatalog()) {
+        auto fromBase = base->suggestNames(name, limit, maxDistance);
+        results.insert(results.end(), fromBase.begin(), fromBase.end());
+    }
+
+    // Przesłonięcia i duplikaty z pliku mają tę samą nazwę - zostaje jedna
+    std::sort(results.begin(), results.end(), [](const NameSuggestion& a, const NameSuggestion& b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.name < b.name;
+    });
+    results.erase(std::unique(results.begin(), results.end(),
+                              [](const NameSuggestion& a, const NameSuggestion& b) { return a.name == b.name; }),
+                  results.end());
+    if(results.size() > limit) {
+        results.resize(limit);
+    }
+    return results;
+}
+
+std::shared_ptr<Exercise> ExerciseRepository::findClosest(const std::string& name, int maxDistance) const {
+    if(auto exact = findByName(name)) {
+        return exact;
+    }
+    auto suggestions = suggestNames(name, 2, maxDistance);
+    if(suggestions.empty()
+       || (suggestions.size() > 1 && suggestions[1].distance == suggestions[0].distance)) {
+        return nullptr;   // Brak albo remis - nie zgadujemy
+    }
+    return findByName(suggestions[0].name);
+}
 
-    if(it != exercises.end()) {
-        *it = newExercise;
+std::shared_ptr<Exercise> ExerciseRepository::findEquivalent(const std::string& name) const {
+    if(auto exact = findByName(name)) {
+        return exact;
+    }
+    auto equal = suggestNames(name, 2, 0);
+    if(equal.size() != 1) {
+        return nullptr;   // Brak albo kilka nazw różniących się tylko pisownią
+    }
+    return findByName(equal[0].name);
+}
+
+ExercisePage ExerciseRepository::queryExercises(const ExerciseQuery& query) const {
+    PUMP_TRACE_SCOPE("ExerciseRepository::queryExercises", "repo");
+    ScopedLatency latency(metrics().queryLatency);
+    ExercisePage page;
+    if(query.pageSize == 0) {
+        return page;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(storageLock);
+    auto base = getBaseCatalog();
+
+    // Wiersz przechodzący filtr: do strony albo - gdy strona pełna - sygnał,
+    // że istnieje następna (kursor = klucz ostatniego zwróconego wiersza)
+    std::string lastKey;
+    auto accept = [&](const std::string& key, const std::shared_ptr<Exercise>& ex) {
+        if(!query.nameContains.empty() && ex->getName().find(query.nameContains) == std::string::npos) {
+            return true;
+        }
+        if(page.items.size() == query.pageSize) {
+            page.nextCursor = lastKey;
+            return false;
+        }
+        page.items.push_back(ex);
+        lastKey = key;
         return true;
+    };
+
+    // Scalanie indeksu nakładki z indeksem katalogu od kursora (wyłącznie);
+    // ćwiczenia katalogu przesłonięte w nakładce są pomijane
+    auto scan = [&](ExerciseSortKey sortBy, const std::string& after, const std::string& prefix,
+                    bool skipUsed) {
+        const auto& overlay = sortedIndexes[sortedSlot(sortBy)];
+        auto own = overlay.upper_bound(after);   // Klucze są niepuste - "" = od początku
+
+        static const std::vector<ExerciseCatalog::SortedRow> noRows;
+        const auto& baseRows = base ? base->getSorted(sortBy) : noRows;
+        auto shared = std::upper_bound(baseRows.begin(), baseRows.end(), after,
+                                       [](const std::string& key, const ExerciseCatalog::SortedRow& row) {
+                                           return key < row.first;
+                                       });
+
+        while(own != overlay.end() || shared != baseRows.end()) {
+            const bool fromBase = shared != baseRows.end()
+                                  && (own == overlay.end() || shared->first < own->first);
+            const std::string& key = fromBase ? shared->first : own->first;
+            const std::shared_ptr<Exercise>& ex = fromBase ? shared->second : own->second;
+            if(fromBase) {
+                ++shared;
+                if(nameIndex.find(ex->getName())) {
+                    continue;
+                }
+            } else {
+                ++own;
+            }
+            if(skipUsed && usageStamps.count(ex->getName())) {
+                continue;
+            }
+            if(!accept(prefix + key, ex)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if(query.sortBy != ExerciseSortKey::RECENT) {
+        scan(query.sortBy, query.cursor, "", false);
+        return page;
     }
-    return false;
+
+    // RECENT: najpierw używane (mały indeks), potem reszta po nazwie
+    const bool inUsed = query.cursor.empty() || query.cursor[0] == RECENT_USED;
+    if(inUsed) {
+        for(auto it = recentIndex.upper_bound(query.cursor); it != recentIndex.end(); ++it) {
+            if(!accept(it->first, it->second)) {
+                return page;
+            }
+        }
+    }
+    const std::string after = inUsed ? std::string() : query.cursor.substr(1);
+    scan(ExerciseSortKey::NAME, after, std::string(1, RECENT_UNUSED), true);
+    return page;
 }
 
-bool ExerciseRepository::removeExercise(const std::string& name) {
+bool ExerciseRepository::markUsed(const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    auto base = getBaseCatalog();
+    auto exercise = visibleLocked(base.get(), name);
+    if(!exercise) {
+        return false;
+    }
+
+    auto usage = usageStamps.find(name);
+    if(usage != usageStamps.end()) {
+        recentIndex.erase(recentKey(usage->second, name));
+    }
+    const uint64_t stamp = ++usageClock;
+    usageStamps[name] = stamp;
+    recentIndex[recentKey(stamp, name)] = std::move(exercise);
+    return true;
+}
+
+std::shared_ptr<Exercise> ExerciseRepository::visibleLocked(const ExerciseCatalog* base,
+                                                            const std::string& name) const {
+    if(auto exercise = nameIndex.find(name)) {
+        return exercise;
+    }
+    return base ? base->findByName(name) : nullptr;
+}
+
+void ExerciseRepository::indexSorted(const std::shared_ptr<Exercise>& exercise) {
+    for(size_t k = 0; k < 3; ++k) {
+        sortedIndexes[k][exerciseSortKey(SORTED_KEYS[k], *exercise)] = exercise;
+    }
+    refreshUsage(exercise->getName());
+}
+
+void ExerciseRepository::unindexSorted(const Exercise& exercise) {
+    for(size_t k = 0; k < 3; ++k) {
+        auto it = sortedIndexes[k].find(exerciseSortKey(SORTED_KEYS[k], exercise));
+        if(it != sortedIndexes[k].end() && it->second.get() == &exercise) {
+            sortedIndexes[k].erase(it);
+        }
+    }
+}
+
+void ExerciseRepository::refreshUsage(const std::string& name) {
+    auto usage = usageStamps.find(name);
+    if(usage == usageStamps.end()) {
+        return;
+    }
+    const std::string key = recentKey(usage->second, name);
+    auto base = getBaseCatalog();
+    if(auto exercise = visibleLocked(base.get(), name)) {
+        recentIndex[key] = std::move(exercise);
+    } else {
+        recentIndex.erase(key);
+        usageStamps.erase(usage);
+    }
+}
+
+// Od nowa: nakładka (tylko obiekty widoczne pod swoją nazwą - duplikaty z
+// pliku pomijamy) i "ostatnio używane" bez nazw, których już nie ma
+void ExerciseRepository::rebuildSortedIndexes() {
+    for(auto& index : sortedIndexes) {
+        index.clear();
+    }
+    for(const auto& ex : exercises) {
+        if(nameIndex.find(ex->getName()) != ex) {
+            continue;
+        }
+        for(size_t k = 0; k < 3; ++k) {
+            sortedIndexes[k].emplace(exerciseSortKey(SORTED_KEYS[k], *ex), ex);
+        }
+    }
+
+    recentIndex.clear();
+    auto base = getBaseCatalog();
+    for(auto it = usageStamps.begin(); it != usageStamps.end();) {
+        if(auto exercise = visibleLocked(base.get(), it->first)) {
+            recentIndex.emplace(recentKey(it->second, it->first), std::move(exercise));
+            ++it;
+        } else {
+            it = usageStamps.erase(it);
+        }
+    }
+}
+
+// Pozycja ćwiczenia w kopii roboczej (wołane pod blokadą pisarza)
+size_t ExerciseRepository::indexOf(const std::string& name) const {
     auto it = std::find_if(exercises.begin(), exercises.end(),
                            [&name](const std::shared_ptr<Exercise>& ex) {
                                return ex->getName() == name;
                            });
+    return static_cast<size_t>(it - exercises.begin());
+}
+
+// Pozycja w wersji scalonej: przesłonięcia leżą na pozycjach katalogu,
+// własne ćwiczenia za katalogiem w kolejności nakładki - O(liczba zmian)
+size_t ExerciseRepository::versionIndexOf(const ExerciseCatalog* base, size_t overlayIndex) const {
+    if(!base) {
+        return overlayIndex;
+    }
+    size_t baseIndex = base->indexOf(exercises[overlayIndex]->getName());
+    if(baseIndex != ExerciseCatalog::npos) {
+        return baseIndex;
+    }
+    size_t ownBefore = 0;
+    for(size_t i = 0; i < overlayIndex; ++i) {
+        if(base->indexOf(exercises[i]->getName()) == ExerciseCatalog::npos) {
+            ++ownBefore;
+        }
+    }
+    return base->getCount() + ownBefore;
+}
+
+size_t ExerciseRepository::countLocked(const ExerciseCatalog* base) const {
+    return (base ? base->getCount() : 0) + ownCount;
+}
+
+void ExerciseRepository::recountOwn(const ExerciseCatalog* base) {
+    ownCount = 0;
+    for(const auto& ex : exercises) {
+        if(!base || base->indexOf(ex->getName()) == ExerciseCatalog::npos) {
+            ++ownCount;
+        }
+    }
+}
+
+// Wersja scalona od nowa: kopia katalogu (współdzielone bloki) + nakładka
+void ExerciseRepository::rebuildVersions() {
+    auto base = getBaseCatalog();
+    if(!base) {
+        versions.reset(exercises);
+        return;
+    }
+    ExerciseSnapshot::Items items = base->getItems();
+    for(const auto& ex : exercises) {
+        size_t baseIndex = base->indexOf(ex->getName());
+        if(baseIndex != ExerciseCatalog::npos) {
+            items.set(baseIndex, ex);
+        } else {
+            items.pushBack(ex);
+        }
+    }
+    versions.reset(std::move(items));
+}
+
+// Nazwa zwolniona w nakładce - duplikat z pliku przejmuje ją jedną podmianą
+// (bez chwili, w której findByName nie widzi nazwy), inaczej znika z indeksu
+void ExerciseRepository::reindexName(const std::string& name) {
+    size_t index = indexOf(name);
+    if(index < exercises.size()) {
+        nameIndex.assign(name, exercises[index]);
+    } else {
+        nameIndex.erase(name);
+    }
+}
+
+bool ExerciseRepository::updateExercise(const std::string& oldName,
+                                        std::shared_ptr<Exercise> newExercise) {
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    auto base = getBaseCatalog();
+
+    // Ćwiczenia z katalogu przesłaniamy kopią o tej samej nazwie - zmiana nazwy
+    // oznaczałaby usunięcie pozycji katalogu, a tego nakładka nie potrafi
+    const bool inBase = base && base->indexOf(oldName) != ExerciseCatalog::npos;
+    const bool renamed = newExercise->getName() != oldName;
+    if(base && renamed && (inBase || base->indexOf(newExercise->getName()) != ExerciseCatalog::npos)) {
+        Logger::warning("ExerciseRepository", "Nie można zmienić nazwy ćwiczenia z katalogu globalnego",
+                        {{"name", oldName}, {"newName", newExercise->getName()}});
+        return false;
+    }
+
+    size_t index = indexOf(oldName);
+    std::shared_ptr<Exercise> previous;   // Poprzedni obiekt nakładki (do indeksów posortowanych)
+    if(index < exercises.size()) {
+        size_t versionIndex = versionIndexOf(base.get(), index);
+        previous = exercises[index];
+        exercises[index] = newExercise;
+        versions.set(versionIndex, newExercise);
+        if(renamed) {
+            fuzzyIndex.erase(oldName);
+            fuzzyIndex.insert(newExercise->getName());
+        }
+    } else if(inBase) {
+        // Copy-on-write: pierwsza zmiana ćwiczenia z katalogu trafia do nakładki
+        exercises.push_back(newExercise);
+        versions.set(base->indexOf(oldName), newExercise);
+        fuzzyIndex.insert(newExercise->getName());
+    } else {
+        return false;
+    }
+
+    if(renamed) {
+        nameIndex.insert(newExercise->getName(), newExercise);   // Nowy klucz przed zwolnieniem starego
+        reindexName(oldName);
+    } else {
+        nameIndex.assign(oldName, newExercise);
+    }
 
-    if(it != exercises.end()) {
-        exercises.erase(it);
+    if(previous) {
+        unindexSorted(*previous);
+    }
+    if(renamed) {
+        // "Ostatnio używane" przechodzi na nową nazwę
+        auto usage = usageStamps.find(oldName);
+        if(usage != usageStamps.end()) {
+            const uint64_t stamp = usage->second;
+            recentIndex.erase(recentKey(stamp, oldName));
+            usageStamps.erase(usage);
+            usageStamps[newExercise->getName()] = stamp;
+        }
+        if(auto duplicate = nameIndex.find(oldName)) {
+            indexSorted(duplicate);   // Duplikat z pliku przejął starą nazwę
+        }
+    }
+    indexSorted(newExercise);
+    mergedDirty = true;
+    return true;
+}
+
+bool ExerciseRepository::removeExercise(const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    auto base = getBaseCatalog();
+
+    size_t index = indexOf(name);
+    if(index < exercises.size()) {
+        size_t baseIndex = base ? base->indexOf(name) : ExerciseCatalog::npos;
+        if(baseIndex != ExerciseCatalog::npos) {
+            // Usunięcie przesłonięcia = powrót do wersji z katalogu
+            versions.set(baseIndex, base->getAllExercises()[baseIndex]);
+        } else {
+            versions.erase(versionIndexOf(base.get(), index));
+            --ownCount;
+        }
+        auto removed = exercises[index];
+        exercises.erase(exercises.begin() + static_cast<std::ptrdiff_t>(index));
+        reindexName(name);
+        fuzzyIndex.erase(name);
+        unindexSorted(*removed);
+        if(auto duplicate = nameIndex.find(name)) {
+            indexSorted(duplicate);
+        } else {
+            refreshUsage(name);   // Powrót do wersji z katalogu albo koniec historii użycia
+        }
+        mergedDirty = true;
+        countGauge.set(static_cast<int64_t>(countLocked(base.get())));
         return true;
     }
+
+    if(base && base->indexOf(name) != ExerciseCatalog::npos) {
+        Logger::warning("ExerciseRepository", "Nie można usunąć ćwiczenia z katalogu globalnego", {{"name", name}});
+    }
     return false;
 }
 
+ImportReport ExerciseRepository::importExercises(const std::vector<std::shared_ptr<Exercise>>& rows,
+                                                 const ImportOptions& options) {
+    PUMP_TRACE_SCOPE("ExerciseRepository::importExercises", "repo");
+    ScopedLatency latency(metrics().importLatency);
+    metrics().importRows.increment(rows.size());
+    ImportReport report;
+
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    auto base = getBaseCatalog();
+
+    // Etap 1: walidacja i deduplikacja w jednym przebiegu (hash), bez zmian repozytorium.
+    // Klucze string_view wskazują nazwy obiektów żyjących do końca etapu.
+    std::unordered_map<std::string_view, size_t> positions;
+    positions.reserve(exercises.size());
+    for(size_t i = 0; i < exercises.size(); ++i) {
+        positions.emplace(exercises[i]->getName(), i);
+    }
+
+    std::unordered_set<std::string_view> seen;
+    seen.reserve(rows.size());
+
+    struct Action {
+        size_t row;
+        size_t position;   // Pozycja w nakładce do podmiany, npos = dopisanie
+    };
+    static constexpr size_t APPEND = static_cast<size_t>(-1);
+    std::vector<Action> actions;
+    actions.reserve(rows.size());
+    size_t appended = 0;
+
+    for(size_t i = 0; i < rows.size(); ++i) {
+        const auto& ex = rows[i];
+        if(!ex) {
+            report.errors.push_back({i, "", "Pusty rekord"});
+            continue;
+        }
+        const std::string& name = ex->getName();
+        if(name.empty()) {
+            report.errors.push_back({i, name, "Brak nazwy ćwiczenia"});
+            continue;
+        }
+        if(!seen.insert(name).second) {
+            ++report.duplicates;
+            continue;
+        }
+
+        auto existing = positions.find(name);
+        const bool inBase = base && base->indexOf(name) != ExerciseCatalog::npos;
+        if(existing == positions.end() && !inBase) {
+            actions.push_back({i, APPEND});
+            ++appended;
+            ++report.added;
+        } else if(options.duplicates == DuplicatePolicy::SKIP) {
+            ++report.skipped;
+        } else {
+            // Ćwiczenie z katalogu bazowego: pierwsza zmiana dopisuje przesłonięcie
+            actions.push_back({i, existing != positions.end() ? existing->second : APPEND});
+            appended += existing == positions.end() ? 1 : 0;
+            ++report.replaced;
+        }
+    }
+
+    metrics().importErrors.increment(report.errors.size());
+    if(options.allOrNothing && !report.ok()) {
+        report.added = report.replaced = 0;
+        return report;
+    }
+
+    // Etap 2: zatwierdzenie - miejsce rezerwujemy raz, publikujemy jedną wersję
+    exercises.reserve(exercises.size() + appended);
+    if(!base) {
+        versions.beginBatch();
+    }
+    for(const auto& action : actions) {
+        const auto& ex = rows[action.row];
+        if(action.position == APPEND) {
+            exercises.push_back(ex);
+            if(!base || base->indexOf(ex->getName()) == ExerciseCatalog::npos) {
+                ++ownCount;   // Inaczej pierwsze przesłonięcie pozycji katalogu
+            }
+            fuzzyIndex.insert(ex->getName());
+            if(!base) {
+                versions.pushBack(ex);
+            }
+            nameIndex.insert(ex->getName(), ex);
+        } else {
+            unindexSorted(*exercises[action.position]);
+            exercises[action.position] = ex;
+            if(!base) {
+                versions.set(action.position, ex);
+            }
+            nameIndex.assign(ex->getName(), ex);
+        }
+        indexSorted(ex);
+    }
+    if(!base) {
+        versions.commitBatch();
+    } else if(!actions.empty()) {
+        rebuildVersions();   // Układ widoku scalonego liczony raz dla całej partii
+    }
+
+    mergedDirty = mergedDirty || !actions.empty();
+    countGauge.set(static_cast<int64_t>(countLocked(base.get())));
+    report.committed = true;
+    return report;
+}
+
 bool ExerciseRepository::exists(const std::string& name) const {
     return findByName(name) != nullptr;
 }
 
-// === JSON Persistence - PROSTY WŁASNY PARSER ===
+size_t ExerciseRepository::getCount() const {
+    std::shared_lock<std::shared_mutex> lock(storageLock);
+    auto base = getBaseCatalog();
+    return countLocked(base.get());
+}
 
-// Helper: escape string dla JSON
-static std::string escapeJson(const std::string& str) {
-    std::string result;
-    for(char c : str) {
-        if(c == '"') result += "\\\"";
-        else if(c == '\\') result += "\\\\";
-        else if(c == '\n') result += "\\n";
-        else if(c == '\r') result += "\\r";
-        else if(c == '\t') result += "\\t";
-        else result += c;
+const std::vector<std::shared_ptr<Exercise>>& ExerciseRepository::getAllExercises() const {
+    auto base = getBaseCatalog();
+    if(!base) {
+        return exercises;
     }
-    return result;
+
+    // Widok scalony budujemy dopiero, gdy ktoś o niego poprosi po zmianie
+    if(mergedDirty) {
+        mergedExercises = base->getAllExercises();
+        for(const auto& ex : exercises) {
+            size_t baseIndex = base->indexOf(ex->getName());
+            if(baseIndex != ExerciseCatalog::npos) {
+                mergedExercises[baseIndex] = ex;
+            } else {
+                mergedExercises.push_back(ex);
+            }
+        }
+        mergedDirty = false;
+    }
+    return mergedExercises;
 }
 
-// Helper: unescape string z JSON
-static std::string unescapeJson(const std::string& str) {
-    std::string result;
-    for(size_t i = 0; i < str.size(); ++i) {
-        if(str[i] == '\\' && i + 1 < str.size()) {
-            char next = str[i + 1];
-            if(next == 'n') { result += '\n'; i++; }
-            else if(next == 'r') { result += '\r'; i++; }
-            else if(next == 't') { result += '\t'; i++; }
-            else if(next == '"') { result += '"'; i++; }
-            else if(next == '\\') { result += '\\'; i++; }
-            else result += str[i];
-        } else {
-            result += str[i];
+void ExerciseRepository::setBaseCatalog(std::shared_ptr<const ExerciseCatalog> catalog) {
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    std::atomic_store(&baseCatalog, std::move(catalog));
+    auto base = getBaseCatalog();
+    recountOwn(base.get());
+    rebuildVersions();
+    rebuildSortedIndexes();
+    mergedDirty = true;
+    countGauge.set(static_cast<int64_t>(countLocked(base.get())));
+}
+
+std::shared_ptr<const ExerciseCatalog> ExerciseRepository::getBaseCatalog() const {
+    return std::atomic_load(&baseCatalog);
+}
+
+size_t ExerciseRepository::getOverlayCount() const {
+    std::shared_lock<std::shared_mutex> lock(storageLock);
+    return exercises.size();
+}
+
+void ExerciseRepository::beginBatch() {
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    versions.beginBatch();
+}
+
+void ExerciseRepository::commitBatch() {
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    versions.commitBatch();
+}
+
+void ExerciseRepository::clear() {
+    {
+        std::unique_lock<std::shared_mutex> lock(storageLock);
+        exercises.clear();
+        ownCount = 0;
+        rebuildVersions();
+        nameIndex.clear();
+        fuzzyIndex.clear();
+        rebuildSortedIndexes();
+        mergedDirty = true;
+        auto base = getBaseCatalog();
+        countGauge.set(static_cast<int64_t>(countLocked(base.get())));
+    }
+    {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        descriptionStore = nullptr;
+    }
+}
+
+std::shared_ptr<const ExerciseSnapshot> ExerciseRepository::getSnapshot() const {
+    return versions.current();
+}
+
+size_t ExerciseRepository::estimateMemoryUsage() const {
+    // Przybliżenie: obiekty + bloki kontrolne shared_ptr + bufory stringów.
+    // Liczone na snapshocie - można wołać z dowolnego wątku. Ćwiczenia katalogu
+    // bazowego są współdzielone - liczy je raz ExerciseCatalog::estimateMemoryUsage.
+    auto snapshot = getSnapshot();
+    auto base = getBaseCatalog();
+    size_t total = 0;
+    for(const auto& ex : *snapshot) {
+        if(base && base->contains(ex.get())) {
+            continue;
         }
+        total += 2 * sizeof(std::shared_ptr<Exercise>);  // Kopia robocza + wersja
+        total += sizeof(WeightedExercise) + 2 * sizeof(void*);
+        total += ex->getName().capacity() + ex->getDescriptionFootprint()
+                 + ex->getTargetMuscles().capacity();
     }
-    return result;
+    std::lock_guard<std::mutex> lock(storageMutex);
+    if(descriptionStore) {
+        total += descriptionStore->getCachedBytes();  // Opisy w cache LRU
+    }
+    return total;
 }
 
+// === JSON Persistence - PROSTY WŁASNY PARSER (escapowanie w JsonUtils) ===
+
 bool ExerciseRepository::saveToJSON() const {
-    std::ofstream file(jsonFilePath);
-    if(!file.is_open()) {
-        std::cerr << "Błąd: Nie można otworzyć pliku do zapisu: " << jsonFilePath << std::endl;
+    return saveSnapshot(*getSnapshot());
+}
+
+bool ExerciseRepository::saveSnapshot(const ExerciseSnapshot& snapshot) const {
+    PUMP_TRACE_SCOPE("ExerciseRepository::saveToJSON", "repo");
+    ScopedLatency latency(metrics().saveLatency);
+
+    // Pisarz może w tym czasie zmieniać kopię roboczą - zapisujemy niezmienny
+    // snapshot. Blokada chroni plik, magazyn opisów i słownik.
+    std::lock_guard<std::mutex> lock(storageMutex);
+    const auto base = getBaseCatalog();   // Do pliku trafia tylko nakładka
+
+    // Plik zmieniony poza aplikacją - nadpisanie zgubiłoby tę zmianę
+    if(stampKnown && JsonUtils::fileStamp(jsonFilePath) != knownStamp) {
+        Logger::warning("ExerciseRepository", "Plik zmieniony z zewnątrz - zapis wstrzymany do przeładowania",
+                        {{"path", jsonFilePath}});
+        metrics().saveConflicts.increment();
         return false;
     }
 
-    file << "[\n";
-    for(size_t i = 0; i < exercises.size(); ++i) {
-        const auto& ex = exercises[i];
-        file << "  {\n";
-        file << "    \"name\": \"" << escapeJson(ex->getName()) << "\",\n";
-        file << "    \"description\": \"" << escapeJson(ex->getDescription()) << "\",\n";
-        file << "    \"muscles\": \"" << escapeJson(ex->getTargetMuscles()) << "\",\n";
-        file << "    \"type\": \"" << Exercise::typeToString(ex->getType()) << "\"\n";
-        file << "  }";
-        if(i < exercises.size() - 1) file << ",";
-        file << "\n";
-    }
-    file << "]\n";
+    // Nowy słownik trafia na dysk razem z plikiem JSON (oba przez plik tymczasowy)
+    // i do pamięci dopiero po udanej podmianie
+    const std::string dictionaryPath = getDictionaryPath();
+    const std::string dictionaryTemporaryPath = JsonUtils::temporaryPath(dictionaryPath);
+    std::shared_ptr<const DescriptionCodec::Dictionary> trained;
+    const DescriptionCodec::Dictionary* dictionary = nullptr;
+    if(compressDescriptions) {
+        if(!compressionDictionary) {
+            trained = trainCompressionDictionary(snapshot, dictionaryTemporaryPath);
+            if(!trained) {
+                return false;
+            }
+        }
+        dictionary = trained ? trained.get() : compressionDictionary.get();
+    }
+
+    // Opisy bez zmiany formatu kopiujemy wprost z bieżącego pliku (bez unescape
+    // i ponownego escape). Kopia tylko na czas zapisu - stary magazyn czyta dalej
+    // przez swój otwarty deskryptor, bo nowy plik zastępuje stary przez rename.
+    std::string previous;
+    const bool havePrevious = descriptionStore && JsonUtils::readFile(jsonFilePath, previous);
+    const auto previousDictionary = descriptionStore ? descriptionStore->getDictionary() : nullptr;
+    const bool sameDictionary = previousDictionary.get() == dictionary;
+
+    // Zapis strumieniowy dużymi blokami do pliku tymczasowego, potem podmiana
+    const std::string temporaryPath = JsonUtils::temporaryPath(jsonFilePath);
+    JsonWriter writer(JsonWriter::Style::PRETTY);
+    if(!writer.open(temporaryPath)) {
+        Logger::error("ExerciseRepository", "Nie można otworzyć pliku do zapisu", {{"path", temporaryPath}});
+        if(trained) {
+            std::remove(dictionaryTemporaryPath.c_str());
+        }
+        return false;
+    }
+
+    std::vector<std::pair<uint64_t, uint32_t>> descriptionRanges;
+    std::vector<uint64_t> descriptionDigests;   // Tylko z leniwymi opisami (przepięcie niżej)
+    descriptionRanges.reserve(snapshot.getCount());
+
+    writer.beginArray();
+    for(const auto& ex : snapshot) {
+        if(base && base->contains(ex.get())) {
+            continue;  // Niezmienione ćwiczenia katalogu bazowego nie trafiają do pliku
+        }
+        writer.beginObject();
+        writer.field("name", ex->getName());
+
+        // Wartość skompresowana (id słownika + base64) nie wymaga escapowania -
+        // offset wskazuje wprost zakodowany blok
+        writer.key(dictionary ? "descriptionLz" : "description");
+        const uint64_t descriptionStart = writer.getOffset() + 1;  // Za cudzysłowem
+
+        // Surowy fragment tylko przy zgodnym skrócie - plik pod ścieżką mógł zostać
+        // podmieniony z zewnątrz (keepLocalVersion), a magazyn czyta swoją wersję
+        const DescriptionRef& ref = ex->getLazyDescription();
+        std::string_view raw;
+        if(havePrevious && ex->hasLazyDescription() && ref.store == descriptionStore
+           && ref.offset + ref.length <= previous.size()) {
+            raw = std::string_view(previous).substr(ref.offset, ref.length);
+        }
+        const bool fromPrevious = raw.data() && (ref.digest == 0 || DescriptionStore::digest(raw) == ref.digest);
+
+        uint64_t digest = 0;
+        if(fromPrevious && ref.compressed == (dictionary != nullptr) && (!dictionary || sameDictionary)) {
+            writer.rawString(raw);
+            digest = !lazyDescriptions ? 0 : ref.digest != 0 ? ref.digest : DescriptionStore::digest(raw);
+        } else {
+            std::string text;
+            if(!fromPrevious) {
+                text = ex->getDescription();
+            } else if(!ref.compressed) {
+                text = JsonUtils::unescape(raw);
+            } else {
+                try {
+                    static const DescriptionCodec::Dictionary emptyDictionary;
+                    const auto& dict = previousDictionary ? *previousDictionary : emptyDictionary;
+                    text = DescriptionCodec::decodeValue(dict, raw);
+                } catch(const std::exception& e) {
+                    Logger::warning("ExerciseRepository", "Nie można zdekompresować opisu",
+                                    {{"name", ex->getName()}, {"error", e.what()}});
+                }
+            }
+
+            if(dictionary || lazyDescriptions) {
+                const std::string encoded = dictionary
+                    ? DescriptionCodec::encodeValue(*dictionary, text) : JsonUtils::escape(text);
+                writer.rawString(encoded);
+                digest = lazyDescriptions ? DescriptionStore::digest(encoded) : 0;
+            } else {
+                writer.value(text);
+            }
+        }
+        descriptionRanges.emplace_back(descriptionStart,
+                                       static_cast<uint32_t>(writer.getOffset() - 1 - descriptionStart));
+        descriptionDigests.push_back(digest);
+
+        writer.field("muscles", ex->getTargetMuscles());
+        writer.field("type", Exercise::typeToString(ex->getType()));
+        writer.endObject();
+    }
+    writer.endArray();
+
+    // Słownik tuż przed plikiem JSON - wartości JSON niosą id słownika, więc
+    // przerwa między podmianami kończy się błędem odczytu, a nie złym tekstem
+    const bool written = writer.close();
+    if(!written || (trained && !JsonUtils::replaceFile(dictionaryTemporaryPath, dictionaryPath))
+       || !JsonUtils::replaceFile(temporaryPath, jsonFilePath)) {
+        Logger::error("ExerciseRepository", "Błąd zapisu pliku", {{"path", jsonFilePath}});
+        std::remove(temporaryPath.c_str());
+        if(trained) {
+            std::remove(dictionaryTemporaryPath.c_str());
+        }
+        return false;
+    }
+    if(trained) {
+        compressionDictionary = trained;
+    }
+    knownStamp = JsonUtils::fileStamp(jsonFilePath);
+    stampKnown = true;
+
+    // Stare offsety są nieaktualne - przepinamy leniwe opisy na nowy plik (atomowo,
+    // obiekty mogą być właśnie czytane). Opisy trzymane w pamięci (ćwiczenia dodane
+    // lub edytowane) takie zostają - zwolnienie tekstu nie byłoby bezpieczne dla
+    // czytelników snapshotu; staną się leniwe po następnym wczytaniu pliku.
+    if(lazyDescriptions) {
+        auto store = std::make_shared<DescriptionStore>(jsonFilePath, lazyCacheCapacity);
+        store->setDictionary(compressionDictionary);
+        size_t i = 0;
+        for(const auto& ex : snapshot) {
+            if(base && base->contains(ex.get())) {
+                continue;  // Opisy katalogu należą do jego magazynu
+            }
+            ex->rebindLazyDescription(DescriptionRef{store, descriptionRanges[i].first,
+                                                     descriptionRanges[i].second,
+                                                     dictionary != nullptr, descriptionDigests[i]});
+            ++i;
+        }
+        descriptionStore = store;
+    }
 
-    file.close();
     return true;
 }
 
-bool ExerciseRepository::loadFromJSON() {
-    std::ifstream file(jsonFilePath);
+std::shared_ptr<const DescriptionCodec::Dictionary>
+ExerciseRepository::trainCompressionDictionary(const ExerciseSnapshot& snapshot, const std::string& path) const {
+    PUMP_TRACE_SCOPE("ExerciseRepository::trainCompressionDictionary", "repo");
+
+    std::vector<std::string> samples;
+    samples.reserve(snapshot.getCount());
+    const auto base = getBaseCatalog();
+    for(const auto& ex : snapshot) {
+        if(base && base->contains(ex.get())) {
+            continue;
+        }
+        samples.push_back(ex->getDescription());
+    }
+    auto dict = std::make_shared<const DescriptionCodec::Dictionary>(
+        DescriptionCodec::trainDictionary(samples));
+
+    std::ofstream file(path, std::ios::binary);
     if(!file.is_open()) {
-        std::cerr << "Plik nie istnieje lub nie można go otworzyć: " << jsonFilePath << std::endl;
-        return false;
+        Logger::error("ExerciseRepository", "Nie można zapisać słownika kompresji", {{"path", path}});
+        return nullptr;
+    }
+    const std::string& bytes = dict->getBytes();
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    file.close();
+    if(!file) {
+        Logger::error("ExerciseRepository", "Błąd zapisu słownika kompresji", {{"path", path}});
+        std::remove(path.c_str());
+        return nullptr;
     }
 
-    exercises.clear();
+    Logger::info("ExerciseRepository", "Wytrenowano słownik kompresji opisów",
+                 {{"samples", std::to_string(samples.size())}, {"bytes", std::to_string(bytes.size())}});
+    return dict;
+}
 
-    std::string line;
+bool ExerciseRepository::loadCompressionDictionary() {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    std::string bytes;
+    if(!JsonUtils::readFile(getDictionaryPath(), bytes)) {
+        compressionDictionary = nullptr;
+        return false;
+    }
+    compressionDictionary = std::make_shared<const DescriptionCodec::Dictionary>(bytes);
+    return true;
+}
+
+// Parsowanie fragmentu [begin, end) treści pliku - fragment zawiera całe rekordy
+// Z lazyStore opis nie jest kopiowany - zapamiętujemy tylko jego położenie w pliku
+static std::vector<std::shared_ptr<Exercise>> parseExerciseRange(const std::string& content,
+                                                                  size_t begin, size_t end,
+                                                                  const std::shared_ptr<DescriptionStore>& lazyStore,
+                                                                  const DescriptionCodec::Dictionary* dictionary) {
+    static const DescriptionCodec::Dictionary emptyDictionary;
+    std::vector<std::shared_ptr<Exercise>> result;
     std::string name, desc, muscles, typeStr;
+    DescriptionRef descRef;
 
     // Prosty parser JSON - zakładamy poprawny format!
-    while(std::getline(file, line)) {
+    size_t lineStart = begin;
+    while(lineStart < end) {
+        size_t lineEnd = content.find('\n', lineStart);
+        if(lineEnd == std::string::npos || lineEnd > end) lineEnd = end;
+        const std::string line = content.substr(lineStart, lineEnd - lineStart);
+        const size_t lineOffset = lineStart;
+        lineStart = lineEnd + 1;
+
         // Szukamy kluczy
         if(line.find("\"name\"") != std::string::npos) {
             size_t start = line.find(":") + 1;
             size_t first = line.find("\"", start) + 1;
-            size_t last = line.find("\"", first);
-            name = unescapeJson(line.substr(first, last - first));
+            size_t last = JsonUtils::findClosingQuote(line, first);
+            name = JsonUtils::unescape(std::string_view(line).substr(first, last - first));
         }
         else if(line.find("\"description\"") != std::string::npos) {
             size_t start = line.find(":") + 1;
             size_t first = line.find("\"", start) + 1;
-            size_t last = line.find("\"", first);
-            desc = unescapeJson(line.substr(first, last - first));
+            size_t last = JsonUtils::findClosingQuote(line, first);
+            if(lazyStore) {
+                descRef = DescriptionRef{lazyStore, lineOffset + first,
+                                         static_cast<uint32_t>(last - first), false,
+                                         DescriptionStore::digest(std::string_view(line).substr(first, last - first))};
+            } else {
+                desc = JsonUtils::unescape(std::string_view(line).substr(first, last - first));
+            }
+        }
+        else if(line.find("\"descriptionLz\"") != std::string::npos) {
+            size_t start = line.find(":") + 1;
+            size_t first = line.find("\"", start) + 1;
+            size_t last = line.find("\"", first);  // id + base64 - bez escapowanych znaków
+            if(lazyStore) {
+                descRef = DescriptionRef{lazyStore, lineOffset + first,
+                                         static_cast<uint32_t>(last - first), true,
+                                         DescriptionStore::digest(std::string_view(line).substr(first, last - first))};
+            } else {
+                try {
+                    const auto& dict = dictionary ? *dictionary : emptyDictionary;
+                    desc = DescriptionCodec::decodeValue(dict, std::string_view(line).substr(first, last - first));
+                } catch(const std::exception& e) {
+                    Logger::warning("ExerciseRepository", "Nie można zdekompresować opisu",
+                                    {{"name", name}, {"error", e.what()}});
+                    desc.clear();
+                }
+            }
         }
         else if(line.find("\"muscles\"") != std::string::npos) {
             size_t start = line.find(":") + 1;
             size_t first = line.find("\"", start) + 1;
-            size_t last = line.find("\"", first);
-            muscles = unescapeJson(line.substr(first, last - first));
+            size_t last = JsonUtils::findClosingQuote(line, first);
+            muscles = JsonUtils::unescape(std::string_view(line).substr(first, last - first));
         }
         else if(line.find("\"type\"") != std::string::npos) {
             size_t start = line.find(":") + 1;
             size_t first = line.find("\"", start) + 1;
-            size_t last = line.find("\"", first);
+            size_t last = JsonUtils::findClosingQuote(line, first);
             typeStr = line.substr(first, last - first);
 
             // Teraz mamy kompletny obiekt, tworzymy ćwiczenie
             try {
                 ExerciseType type = Exercise::stringToType(typeStr);
                 auto exercise = ExerciseFactory::createExercise(type, name, desc, muscles);
-                exercises.push_back(std::move(exercise));
+                if(lazyStore) {
+                    exercise->setLazyDescription(descRef);
+                }
+                result.push_back(std::move(exercise));
             } catch(const std::exception& e) {
-                std::cerr << "Błąd parsowania ćwiczenia: " << e.what() << std::endl;
+                Logger::warning("ExerciseRepository", "Błąd parsowania ćwiczenia", {{"name", name}, {"error", e.what()}});
             }
         }
     }
 
-    file.close();
+    return result;
+}
+
+std::vector<std::shared_ptr<Exercise>> ExerciseRepository::parseJSON(const std::string& content,
+                                                                     ThreadPool* pool,
+                                                                     std::shared_ptr<DescriptionStore> lazyStore,
+                                                                     const DescriptionCodec::Dictionary* dictionary) {
+    PUMP_TRACE_SCOPE("ExerciseRepository::parseJSON", "repo");
+
+    // Małe pliki parsujemy w bieżącym wątku - narzut puli się nie opłaca
+    size_t chunks = 1;
+    if(pool && content.size() >= PARALLEL_PARSE_THRESHOLD) {
+        chunks = pool->getThreadCount();
+    }
+
+    auto ranges = JsonUtils::splitAtRecordLines(content, "\"name\"", chunks);
+    if(ranges.size() == 1) {
+        return parseExerciseRange(content, ranges[0].first, ranges[0].second, lazyStore, dictionary);
+    }
+
+    std::vector<std::future<std::vector<std::shared_ptr<Exercise>>>> parts;
+    parts.reserve(ranges.size());
+    for(const auto& range : ranges) {
+        parts.push_back(pool->submit([&content, range, &lazyStore, dictionary]() {
+            return parseExerciseRange(content, range.first, range.second, lazyStore, dictionary);
+        }));
+    }
+
+    // Sklejenie wyników w kolejności z pliku
+    std::vector<std::shared_ptr<Exercise>> result;
+    for(auto& part : parts) {
+        auto chunk = part.get();
+        result.insert(result.end(),
+                      std::make_move_iterator(chunk.begin()),
+                      std::make_move_iterator(chunk.end()));
+    }
+    return result;
+}
+
+bool ExerciseRepository::readJSON(std::string& content) const {
+    {
+        // Stan sprzed odczytu - zmiana w trakcie czytania wyjdzie jako kolejna zmiana z zewnątrz
+        std::lock_guard<std::mutex> lock(storageMutex);
+        knownStamp = JsonUtils::fileStamp(jsonFilePath);
+        stampKnown = true;
+    }
+    if(!JsonUtils::readFile(jsonFilePath, content)) {
+        Logger::warning("ExerciseRepository", "Plik nie istnieje lub nie można go otworzyć", {{"path", jsonFilePath}});
+        return false;
+    }
+
+    // Wartości skompresowane niosą id słownika (jeden zapis = jeden słownik, więc
+    // wystarczy pierwsza). Inny niż wczytany słownik (np. nowy JSON obok starego
+    // .dict) - plik nieprzyjęty: dekodowanie dałoby śmieci, a zapis by je utrwalił.
+    // Zapis zostaje wstrzymany, a przeładowanie ponowi próbę ze świeżym słownikiem.
+    const size_t key = content.find("\"descriptionLz\"");
+    const size_t colon = key == std::string::npos ? key : content.find(':', key);
+    const size_t quote = colon == std::string::npos ? colon : content.find('"', colon);
+    uint32_t id = 0;
+    if(quote != std::string::npos
+       && DescriptionCodec::valueDictionaryId(std::string_view(content).substr(quote + 1, 9), id)) {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        if(!compressionDictionary || compressionDictionary->getId() != id) {
+            Logger::error("ExerciseRepository", "Plik skompresowany innym słownikiem niż wczytany",
+                          {{"path", jsonFilePath}, {"dictionary", getDictionaryPath()}});
+            knownStamp = JsonUtils::FileStamp{};
+            content.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<DescriptionStore> ExerciseRepository::createDescriptionStore() const {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    if(!lazyDescriptions) {
+        return nullptr;
+    }
+    auto store = std::make_shared<DescriptionStore>(jsonFilePath, lazyCacheCapacity);
+    store->setDictionary(compressionDictionary);
+    return store;
+}
+
+void ExerciseRepository::setLazyDescriptions(bool enabled, size_t cacheCapacity) {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    lazyDescriptions = enabled;
+    lazyCacheCapacity = cacheCapacity;
+    if(descriptionStore) {
+        descriptionStore->setCapacity(cacheCapacity);
+    }
+}
+
+void ExerciseRepository::replaceAll(std::vector<std::shared_ptr<Exercise>> loaded,
+                                    std::shared_ptr<DescriptionStore> store) {
+    {
+        std::unique_lock<std::shared_mutex> lock(storageLock);
+        exercises = std::move(loaded);
+        auto base = getBaseCatalog();
+        recountOwn(base.get());
+        rebuildVersions();
+        nameIndex.rebuild(exercises);
+        fuzzyIndex.clear();
+        for(const auto& ex : exercises) {
+            fuzzyIndex.insert(ex->getName());
+        }
+        rebuildSortedIndexes();
+        mergedDirty = true;
+        countGauge.set(static_cast<int64_t>(countLocked(base.get())));
+    }
+    {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        descriptionStore = std::move(store);
+    }
+}
+
+bool ExerciseRepository::hasExternalChanges() const {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    return stampKnown && JsonUtils::fileStamp(jsonFilePath) != knownStamp;
+}
+
+void ExerciseRepository::keepLocalVersion() {
+    std::lock_guard<std::mutex> lock(storageMutex);
+    knownStamp = JsonUtils::fileStamp(jsonFilePath);
+    stampKnown = true;
+}
+
+ReloadReport ExerciseRepository::applyExternalChanges(std::vector<std::shared_ptr<Exercise>> loaded,
+                                                      std::shared_ptr<DescriptionStore> store,
+                                                      const std::function<bool(const std::string&)>& keepLocal) {
+    PUMP_TRACE_SCOPE("ExerciseRepository::applyExternalChanges", "repo");
+    ScopedLatency latency(metrics().reloadLatency);
+
+    ReloadReport report;
+    report.reloaded = true;
+
+    std::shared_ptr<DescriptionStore> oldStore;
+    {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        oldStore = descriptionStore;
+    }
+
+    // Powtórzona nazwa w pliku - wygrywa pierwsze wystąpienie
+    std::unordered_map<std::string, std::shared_ptr<Exercise>> inFile;
+    inFile.reserve(loaded.size());
+    for(const auto& ex : loaded) {
+        inFile.emplace(ex->getName(), ex);
+    }
+
+    // Plik zawiera tylko nakładkę - ćwiczenia katalogu bazowego nie są usuwane
+    std::vector<std::string> overlayNames;
+    {
+        std::shared_lock<std::shared_mutex> lock(storageLock);
+        overlayNames.reserve(exercises.size());
+        for(const auto& ex : exercises) {
+            overlayNames.push_back(ex->getName());
+        }
+    }
+
+    auto isLocal = [&keepLocal, &report](const std::string& name) {
+        if(keepLocal && keepLocal(name)) {
+            report.conflicts.push_back(name);
+            return true;
+        }
+        return false;
+    };
+
+    MutationBatch<ExerciseRepository> batch(*this);
+    for(const auto& name : overlayNames) {
+        if(inFile.count(name) == 0 && !isLocal(name) && removeExercise(name)) {
+            ++report.removed;
+        }
+    }
+    for(const auto& ex : loaded) {
+        const std::string& name = ex->getName();
+        if(inFile[name] != ex) {
+            continue;
+        }
+        auto current = findByName(name);
+        if(current && sameContent(*current, *ex, oldStore.get())) {
+            // Ten sam obiekt zostaje - tylko opis wskazuje nowe miejsce w pliku
+            if(current->hasLazyDescription() && current->getLazyDescription().store == oldStore) {
+                current->rebindLazyDescription(ex->getLazyDescription());
+            }
+            ++report.unchanged;
+        } else if(isLocal(name)) {
+            // Zmiana lokalna wygrywa, ale jej opis wciąż może wskazywać stary plik -
+            // ta sama surowa wartość w nowym pliku, więc przepinamy
+            if(current && current->hasLazyDescription() && current->getLazyDescription().store == oldStore
+               && ex->hasLazyDescription() && current->getLazyDescription().digest != 0
+               && current->getLazyDescription().digest == ex->getLazyDescription().digest) {
+                current->rebindLazyDescription(ex->getLazyDescription());
+            }
+        } else if(!current) {
+            addExercise(ex);
+            ++report.added;
+        } else if(updateExercise(name, ex)) {   // Ta sama nazwa - podmiana w indeksie, bez luki dla czytelników
+            ++report.updated;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        descriptionStore = std::move(store);
+    }
+    Logger::info("ExerciseRepository", "Przeładowano plik zmieniony z zewnątrz",
+                 {{"added", std::to_string(report.added)}, {"updated", std::to_string(report.updated)},
+                  {"removed", std::to_string(report.removed)}, {"conflicts", std::to_string(report.conflicts.size())}});
+    return report;
+}
+
+bool ExerciseRepository::loadFromJSON() {
+    PUMP_TRACE_SCOPE("ExerciseRepository::loadFromJSON", "repo");
+    ScopedLatency latency(metrics().loadLatency);
+
+    // Słownik przed plikiem - readJSON sprawdza, czy plik był nim skompresowany
+    loadCompressionDictionary();
+    std::string content;
+    if(!readJSON(content)) {
+        return false;
+    }
+
+    auto dictionary = getCompressionDictionary();
+    auto store = createDescriptionStore();
+    replaceAll(parseJSON(content, &ThreadPool::getShared(), store, dictionary.get()), store);
     return true;
 }
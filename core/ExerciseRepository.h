@@ -8,16 +8,118 @@
 
 #include "Exercise.h"
 #include "ExerciseFactory.h"
+#include "DescriptionCodec.h"
+#include "Snapshot.h"
+#include "NameIndex.h"
+#include "FuzzyIndex.h"
+#include "ExerciseQuery.h"
+#include "BulkImport.h"
 #include <vector>
+#include <map>
+#include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <algorithm>
+#include <functional>
+#include "JsonUtils.h"
+
+class ThreadPool;
+class Gauge;
+class DescriptionStore;
+class ExerciseCatalog;
+
+// Niezmienna wersja katalogu ćwiczeń (zob. Snapshot.h)
+using ExerciseSnapshot = RepositorySnapshot<Exercise>;
+using ExerciseChangeBatch = ChangeBatch<Exercise>;
 
 // Wzorzec Repository - separacja logiki dostępu do danych od logiki biznesowej
+//
+// Wątki: wszystkie metody publiczne są bezpieczne wielowątkowo, o ile nie
+// zaznaczono inaczej. Pisarze (CRUD, clear, replaceAll) są serializowani przez
+// storageLock; findByName/exists idą przez indeks shardowany i nie czekają na
+// pisarza dłużej niż jedna operacja na shardzie; getSnapshot nie blokuje wcale.
 class ExerciseRepository {
 private:
     std::vector<std::shared_ptr<Exercise>> exercises;  // Kontener ćwiczeń
+    size_t ownCount = 0;                               // Pozycje nakładki spoza katalogu bazowego (pod storageLock)
     std::string jsonFilePath;                          // Ścieżka do pliku JSON
+    Gauge& countGauge;                                 // pumpapp_exercises{file=...} - seria tej instancji
+    VersionPublisher<Exercise> versions;               // Wersje dla czytelników (MVCC)
+
+    // Chroni kopię roboczą (exercises) i versions - pisarze na wyłączność,
+    // searchByName/getCount współdzielone
+    mutable std::shared_mutex storageLock;
+    NameIndex<Exercise> nameIndex;                     // Nazwa -> ćwiczenie, O(1)
+    FuzzyIndex fuzzyIndex;                             // Nazwy nakładki dla podpowiedzi (pod storageLock)
+
+    // Indeksy posortowane nakładki (pod storageLock): NAME, TYPE, MUSCLES,
+    // klucz exerciseSortKey -> ćwiczenie widoczne pod tą nazwą. Katalog bazowy
+    // ma własne (ExerciseCatalog::getSorted) - zapytanie scala oba strumienie.
+    std::map<std::string, std::shared_ptr<Exercise>> sortedIndexes[3];
+
+    // Ostatnio używane (pod storageLock): znacznik logiczny na nazwę (także
+    // ćwiczeń katalogu) i indeks malejąco po znaczniku. Tylko w pamięci sesji.
+    std::unordered_map<std::string, uint64_t> usageStamps;
+    std::map<std::string, std::shared_ptr<Exercise>> recentIndex;
+    uint64_t usageClock = 0;
+
+    // Katalog bazowy (opcjonalny, atomic_load/atomic_store). Gdy jest ustawiony,
+    // exercises to tylko nakładka użytkownika: własne ćwiczenia i przesłonięte
+    // (zmienione) kopie ćwiczeń katalogu. Wersje zawierają widok scalony.
+    std::shared_ptr<const ExerciseCatalog> baseCatalog;
+    mutable std::vector<std::shared_ptr<Exercise>> mergedExercises;  // Cache dla getAllExercises
+    mutable bool mergedDirty = true;
+
+    // Chroni plik, magazyn opisów, słownik i opcje zapisu - saveToJSON może
+    // działać w tle równolegle ze zmianami kopii roboczej
+    mutable std::mutex storageMutex;
+
+    // Leniwe opisy: w pamięci tylko offset/długość, tekst z pliku przez cache LRU
+    bool lazyDescriptions = false;
+    size_t lazyCacheCapacity = 256;
+    mutable std::shared_ptr<DescriptionStore> descriptionStore;  // Magazyn bieżącego pliku
+
+    // Stan pliku po ostatnim odczycie/zapisie - zmiana z zewnątrz blokuje
+    // nadpisanie pliku (konflikt), dopóki nie zostanie przeładowana
+    mutable JsonUtils::FileStamp knownStamp;
+    mutable bool stampKnown = false;
+
+    // Kompresja opisów: blok LZ ze słownikiem wytrenowanym na katalogu (plik <json>.dict)
+    bool compressDescriptions = false;
+    mutable std::shared_ptr<const DescriptionCodec::Dictionary> compressionDictionary;
+
+    // Trenowanie słownika na opisach snapshotu i zapis do path (plik tymczasowy
+    // słownika - saveToJSON podmienia go razem z JSON); nullptr przy błędzie.
+    // Wołane z saveToJSON pod storageMutex.
+    std::shared_ptr<const DescriptionCodec::Dictionary>
+    trainCompressionDictionary(const ExerciseSnapshot& snapshot, const std::string& path) const;
+
+    // Pozycja w kopii roboczej (exercises.size() gdy brak) - pod storageLock
+    size_t indexOf(const std::string& name) const;
+
+    // Nazwa zwolniona w nakładce: duplikat z pliku przejmuje ją w indeksie
+    // (podmiana), inaczej usunięcie - pod storageLock
+    void reindexName(const std::string& name);
+
+    // Nakładka na katalog bazowy (wszystkie pod storageLock):
+    // pozycja elementu nakładki w wersji scalonej, liczba ćwiczeń widoku
+    // scalonego (O(1) z ownCount; przeliczenie całości tylko przy podmianie
+    // nakładki lub katalogu) i odbudowa wersji z katalogu + nakładki
+    size_t versionIndexOf(const ExerciseCatalog* base, size_t overlayIndex) const;
+    size_t countLocked(const ExerciseCatalog* base) const;
+    void recountOwn(const ExerciseCatalog* base);
+    void rebuildVersions();
+
+    // Indeksy posortowane (pod storageLock): dodanie/usunięcie obiektu nakładki,
+    // przepięcie wpisu "ostatnio używane" na obiekt widoczny pod nazwą
+    // i odbudowa całości (replaceAll, clear, setBaseCatalog)
+    void indexSorted(const std::shared_ptr<Exercise>& exercise);
+    void unindexSorted(const Exercise& exercise);
+    void refreshUsage(const std::string& name);
+    void rebuildSortedIndexes();
+    std::shared_ptr<Exercise> visibleLocked(const ExerciseCatalog* base, const std::string& name) const;
 
 public:
     // Konstruktor
@@ -28,39 +130,188 @@ public:
     // Create - dodanie nowego ćwiczenia
     void addExercise(std::shared_ptr<Exercise> exercise);
 
-    // Read - pobranie wszystkich ćwiczeń
-    const std::vector<std::shared_ptr<Exercise>>& getAllExercises() const {
-        return exercises;
-    }
+    // Read - pobranie wszystkich ćwiczeń (z katalogiem bazowym - widok scalony).
+    // Uwaga: referencja do kopii roboczej - tylko w wątku pisarza (GUI);
+    // inne wątki iterują po getSnapshot()
+    const std::vector<std::shared_ptr<Exercise>>& getAllExercises() const;
 
-    // Read - znalezienie ćwiczenia po nazwie
+    // Read - znalezienie ćwiczenia po nazwie (indeks shardowany, dowolny wątek)
     std::shared_ptr<Exercise> findByName(const std::string& name) const;
 
-    // Read - wyszukiwanie ćwiczeń po fragmencie nazwy (search)
+    // Read - wyszukiwanie ćwiczeń po fragmencie nazwy (search, blokada współdzielona)
     std::vector<std::shared_ptr<Exercise>> searchByName(const std::string& query) const;
 
-    // Update - aktualizacja ćwiczenia
+    // Read - "czy chodziło o...": najbliższe nazwy (bez wielkości liter i polskich
+    // znaków, literówki i przestawienia liter), bez powtórzeń, także z katalogu bazowego
+    std::vector<NameSuggestion> suggestNames(const std::string& name, size_t limit = 5,
+                                             int maxDistance = -1) const;
+
+    // Read - ćwiczenie, jeśli nazwa wskazuje je jednoznacznie: dokładne trafienie
+    // albo dokładnie jedna najbliższa nazwa w zasięgu maxDistance (inaczej nullptr)
+    std::shared_ptr<Exercise> findClosest(const std::string& name, int maxDistance = -1) const;
+
+    // Read - ćwiczenie o tej samej nazwie po normalizacji (wielkość liter, polskie
+    // znaki, spacje), o ile jest dokładnie jedno. Do automatycznego wiązania nazw
+    // z plików - literówki zostają podpowiedzią (findClosest/suggestNames).
+    std::shared_ptr<Exercise> findEquivalent(const std::string& name) const;
+
+    // Read - strona posortowanej listy (z filtrem fragmentu nazwy). Strona
+    // to wyszukanie kursora w indeksach posortowanych + pageSize wierszy,
+    // bez sortowania całego katalogu. Z filtrem pomijane wiersze też są czytane.
+    ExercisePage queryExercises(const ExerciseQuery& query) const;
+
+    // Oznaczenie ćwiczenia jako właśnie użytego (sortowanie RECENT);
+    // false gdy nie ma takiego ćwiczenia
+    bool markUsed(const std::string& name);
+
+    // Update - aktualizacja ćwiczenia (ćwiczenie z katalogu bazowego jest
+    // przesłaniane kopią w nakładce; zmiana jego nazwy zwraca false)
     bool updateExercise(const std::string& oldName, std::shared_ptr<Exercise> newExercise);
 
-    // Delete - usunięcie ćwiczenia po nazwie
+    // Delete - usunięcie ćwiczenia po nazwie (z katalogu bazowego - odmowa, false;
+    // usunięcie przesłonięcia przywraca wersję z katalogu)
     bool removeExercise(const std::string& name);
 
+    // Import wsadowy (np. scalanie katalogów partnerów): walidacja i deduplikacja
+    // w jednym przebiegu, błędy wierszy w raporcie zamiast wyjątków, wszystkie
+    // poprawne wiersze zatwierdzane jako jedna nowa wersja (pod storageLock)
+    ImportReport importExercises(const std::vector<std::shared_ptr<Exercise>>& rows,
+                                 const ImportOptions& options = ImportOptions());
+
+    // === Snapshoty (MVCC) ===
+    // Każda zmiana - albo cała partia - publikuje nową wersję; getSnapshot()
+    // jest bezpieczne w dowolnym wątku i nie blokuje pisarza.
+
+    std::shared_ptr<const ExerciseSnapshot> getSnapshot() const;
+
+    // Partia zmian = jedna nowa wersja (można zagnieżdżać, zob. MutationBatch).
+    // Partia nie wyklucza innych pisarzy - ich zmiany trafią do tej samej wersji.
+    void beginBatch();
+    void commitBatch();
+
+    // Powiadomienie o publikacji nowej wersji (w wątku pisarza, pod storageLock -
+    // listener nie może wołać metod CRUD ani searchByName tego repozytorium)
+    void setPublishListener(std::function<void()> listener) {
+        std::unique_lock<std::shared_mutex> lock(storageLock);
+        versions.setListener(std::move(listener));
+    }
+
+    // Subskrypcja zmian: po każdej nowej wersji partia dodanych/zmienionych/
+    // usuniętych ćwiczeń (zob. ChangeBatch). Te same zasady co dla listenera -
+    // subskrybent czyta batch.snapshot albo odkłada pracę (np. kolejka zdarzeń GUI).
+    uint64_t subscribe(std::function<void(const ExerciseChangeBatch&)> subscriber) {
+        std::unique_lock<std::shared_mutex> lock(storageLock);
+        return versions.subscribe(std::move(subscriber));
+    }
+
+    void unsubscribe(uint64_t id) {
+        std::unique_lock<std::shared_mutex> lock(storageLock);
+        versions.unsubscribe(id);
+    }
+
+    // === Katalog bazowy (wielu użytkowników, zob. ExerciseCatalog) ===
+
+    // Ustawienie współdzielonego katalogu tylko do odczytu (nullptr = brak).
+    // Plik repozytorium przechowuje wtedy wyłącznie nakładkę użytkownika.
+    void setBaseCatalog(std::shared_ptr<const ExerciseCatalog> catalog);
+    std::shared_ptr<const ExerciseCatalog> getBaseCatalog() const;
+
+    // Liczba ćwiczeń w nakładce (własne + przesłonięte) - bez katalogu = getCount()
+    size_t getOverlayCount() const;
+
     // === Persistence (JSON) ===
 
-    // Zapis do pliku JSON
+    // Zapis ostatniej opublikowanej wersji do pliku JSON (bezpieczne w tle)
     bool saveToJSON() const;
 
+    // Zapis konkretnej wersji (np. spójnej z planami - DatabaseManager::saveAll)
+    bool saveSnapshot(const ExerciseSnapshot& snapshot) const;
+
     // Odczyt z pliku JSON
     bool loadFromJSON();
 
+    // === Ładowanie etapami (np. równolegle z planami - DatabaseManager::loadAll) ===
+
+    // Od tej wielkości pliku parseJSON dzieli treść na fragmenty dla puli wątków
+    static constexpr size_t PARALLEL_PARSE_THRESHOLD = 1 << 20;
+
+    // Odczyt surowej treści pliku JSON
+    bool readJSON(std::string& content) const;
+
+    // Parsowanie treści (bez modyfikacji repozytorium - bezpieczne w dowolnym wątku).
+    // Z pulą duże pliki są parsowane równolegle, kolejność rekordów zostaje zachowana.
+    // Z lazyStore opisy nie są kopiowane do pamięci (tylko offset/długość w pliku).
+    // Opisy skompresowane ("descriptionLz") bez lazyStore rozpakowujemy słownikiem dictionary.
+    static std::vector<std::shared_ptr<Exercise>> parseJSON(const std::string& content,
+                                                            ThreadPool* pool = nullptr,
+                                                            std::shared_ptr<DescriptionStore> lazyStore = nullptr,
+                                                            const DescriptionCodec::Dictionary* dictionary = nullptr);
+
+    // Podmiana zawartości repozytorium na sparsowane ćwiczenia
+    void replaceAll(std::vector<std::shared_ptr<Exercise>> loaded,
+                    std::shared_ptr<DescriptionStore> store = nullptr);
+
+    // === Zmiany pliku z zewnątrz (np. synchronizacja katalogu) ===
+
+    // Czy plik zmienił się od ostatniego odczytu/zapisu tego repozytorium
+    // (czas modyfikacji albo rozmiar). Przed pierwszym odczytem/zapisem - false.
+    // Zapis do zmienionego pliku jest odrzucany (konflikt) do przeładowania.
+    bool hasExternalChanges() const;
+
+    // Konflikt całego pliku (niezapisana podmiana kolekcji): zmiany z zewnątrz
+    // pominięte, następny zapis nadpisze plik wersją z pamięci
+    void keepLocalVersion();
+
+    // Przeładowanie: różnica między plikiem (loaded, store - jak przy wczytaniu)
+    // a pamięcią jako jedna partia add/update/remove. Nazwy, dla których keepLocal
+    // zwraca true (niezapisane zmiany), zostają w wersji z pamięci.
+    // Niezmienione ćwiczenia zostają tymi samymi obiektami (leniwe opisy
+    // przepinane na nowy plik po skrócie surowej wartości). Czytelnicy w tle
+    // przez cały czas widzą ćwiczenia obecne w pliku przed i po przeładowaniu.
+    ReloadReport applyExternalChanges(std::vector<std::shared_ptr<Exercise>> loaded,
+                                      std::shared_ptr<DescriptionStore> store,
+                                      const std::function<bool(const std::string&)>& keepLocal = nullptr);
+
+    // === Leniwe opisy ===
+
+    // Włączenie trybu leniwych opisów (działa od następnego load/save)
+    void setLazyDescriptions(bool enabled, size_t cacheCapacity = 256);
+    bool isLazyDescriptions() const { std::lock_guard<std::mutex> lock(storageMutex); return lazyDescriptions; }
+
+    // Nowy magazyn opisów dla pliku repozytorium (nullptr gdy tryb wyłączony)
+    std::shared_ptr<DescriptionStore> createDescriptionStore() const;
+
+    // === Kompresja opisów (opcjonalna) ===
+
+    // Zapis opisów jako skompresowane bloki (działa od następnego save).
+    // Odczyt plików skompresowanych działa zawsze, niezależnie od tej opcji.
+    void setDescriptionCompression(bool enabled) { std::lock_guard<std::mutex> lock(storageMutex); compressDescriptions = enabled; }
+    bool isDescriptionCompression() const { std::lock_guard<std::mutex> lock(storageMutex); return compressDescriptions; }
+
+    // Ścieżka pliku słownika obok pliku JSON
+    std::string getDictionaryPath() const { return jsonFilePath + ".dict"; }
+
+    // Wczytanie słownika z dysku (brak pliku = pusty słownik, zwraca false)
+    bool loadCompressionDictionary();
+    std::shared_ptr<const DescriptionCodec::Dictionary> getCompressionDictionary() const {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        return compressionDictionary;
+    }
+
+    // Wymuszenie ponownego trenowania słownika przy najbliższym zapisie
+    void resetCompressionDictionary() { std::lock_guard<std::mutex> lock(storageMutex); compressionDictionary = nullptr; }
+
     // Liczba ćwiczeń w repozytorium
-    size_t getCount() const { return exercises.size(); }
+    size_t getCount() const;
 
     // Sprawdzenie czy istnieje ćwiczenie o danej nazwie
     bool exists(const std::string& name) const;
 
     // Wyczyszczenie całego repozytorium
-    void clear() { exercises.clear(); }
+    void clear();
+
+    // Przybliżona pamięć zajmowana przez katalog (bajty) - do metryk
+    size_t estimateMemoryUsage() const;
 };
 
 #endif // EXERCISEREPOSITORY_H
@@ -0,0 +1,337 @@
+// FuzzyIndex.cpp
+// Lokalizacja: core/FuzzyIndex.cpp
+
+#include "FuzzyIndex.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+namespace {
+
+// Drugi bajt UTF-8 polskiej litery -> litera ASCII (pierwszy bajt 0xC3/0xC4/0xC5)
+char foldPolish(unsigned char lead, unsigned char next) {
+    switch(lead) {
+    case 0xC3:
+        return (next == 0xB3 || next == 0x93) ? 'o' : 0;             // ó Ó
+    case 0xC4:
+        switch(next) {
+        case 0x84: case 0x85: return 'a';                             // Ą ą
+        case 0x86: case 0x87: return 'c';                             // Ć ć
+        case 0x98: case 0x99: return 'e';                             // Ę ę
+        default: return 0;
+        }
+    case 0xC5:
+        switch(next) {
+        case 0x81: case 0x82: return 'l';                             // Ł ł
+        case 0x83: case 0x84: return 'n';                             // Ń ń
+        case 0x9A: case 0x9B: return 's';                             // Ś ś
+        case 0xB9: case 0xBA: case 0xBB: case 0xBC: return 'z';       // Ź ź Ż ż
+        default: return 0;
+        }
+    default:
+        return 0;
+    }
+}
+
+// Zapytanie przygotowane raz na całe przeszukanie drzewa: maski pozycji znaków
+// dla algorytmu bitowo-równoległego (klucze do 64 bajtów)
+struct Pattern {
+    std::string_view text;
+    std::array<uint64_t, 256> positions{};
+
+    explicit Pattern(std::string_view text) : text(text) {
+        if(bitParallel()) {
+            for(size_t i = 0; i < text.size(); ++i) {
+                positions[static_cast<unsigned char>(text[i])] |= uint64_t(1) << i;
+            }
+        }
+    }
+
+    bool bitParallel() const { return !text.empty() && text.size() <= 64; }
+};
+
+// Hyyrö (2003): odległość OSA bitowo-równolegle - jedna kolumna macierzy
+// programowania dynamicznego na słowo 64-bitowe, O(|b|) operacji
+int distanceBitParallel(const Pattern& pattern, std::string_view b, int limit) {
+    const int m = static_cast<int>(pattern.text.size());
+    const uint64_t last = uint64_t(1) << (m - 1);
+    uint64_t vp = m == 64 ? ~uint64_t(0) : (uint64_t(1) << m) - 1;
+    uint64_t vn = 0;
+    uint64_t d0 = 0;
+    uint64_t previousMatch = 0;
+    int current = m;
+    int remaining = static_cast<int>(b.size());
+
+    for(char c : b) {
+        const uint64_t match = pattern.positions[static_cast<unsigned char>(c)];
+        const uint64_t transposition = ((~d0 & match) << 1) & previousMatch;
+        d0 = (((match & vp) + vp) ^ vp) | match | vn | transposition;
+        uint64_t hp = vn | ~(d0 | vp);
+        uint64_t hn = d0 & vp;
+        if(hp & last) {
+            ++current;
+        } else if(hn & last) {
+            --current;
+        }
+        hp = (hp << 1) | 1;
+        hn <<= 1;
+        vp = hn | ~(d0 | hp);
+        vn = hp & d0;
+        previousMatch = match;
+
+        // Każdy pozostały znak może obniżyć wynik najwyżej o 1
+        if(current - --remaining > limit) {
+            return limit + 1;
+        }
+    }
+    return std::min(current, limit + 1);
+}
+
+// Wersja macierzowa dla kluczy dłuższych niż 64 bajty
+int distanceMatrix(std::string_view a, std::string_view b, int limit) {
+    const int m = static_cast<int>(a.size());
+    const int n = static_cast<int>(b.size());
+    std::vector<int> beforePrevious(n + 1), previous(n + 1), current(n + 1);
+    for(int j = 0; j <= n; ++j) {
+        previous[j] = j;
+    }
+
+    int floor = 0;   // Dolne ograniczenie wyniku (także ścieżek przeskakujących wiersz)
+    for(int i = 1; i <= m; ++i) {
+        current[0] = i;
+        int rowMin = i;
+        for(int j = 1; j <= n; ++j) {
+            const int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            int value = std::min({current[j - 1] + 1, previous[j] + 1, previous[j - 1] + cost});
+            if(i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+                value = std::min(value, beforePrevious[j - 2] + 1);
+            }
+            current[j] = value;
+            rowMin = std::min(rowMin, value);
+        }
+        // Transpozycja przeskakuje najwyżej jeden wiersz kosztem 1
+        floor = std::min(rowMin, floor + 1);
+        if(floor > limit) {
+            return limit + 1;
+        }
+        std::swap(beforePrevious, previous);
+        std::swap(previous, current);
+    }
+    return std::min(previous[n], limit + 1);
+}
+
+int distanceTo(const Pattern& pattern, std::string_view b, int limit) {
+    const int m = static_cast<int>(pattern.text.size());
+    const int n = static_cast<int>(b.size());
+    if(std::abs(m - n) > limit) {
+        return limit + 1;
+    }
+    if(m == 0 || n == 0) {
+        return std::min(std::max(m, n), limit + 1);
+    }
+    return pattern.bitParallel() ? distanceBitParallel(pattern, b, limit)
+                                 : distanceMatrix(pattern.text, b, limit);
+}
+
+} // namespace
+
+std::string FuzzyIndex::normalize(std::string_view name) {
+    std::string result;
+    result.reserve(name.size());
+    bool pendingSpace = false;
+
+    for(size_t i = 0; i < name.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(name[i]);
+        if(c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            pendingSpace = !result.empty();
+            continue;
+        }
+        if(pendingSpace) {
+            result.push_back(' ');
+            pendingSpace = false;
+        }
+
+        if(c >= 'A' && c <= 'Z') {
+            result.push_back(static_cast<char>(c - 'A' + 'a'));
+        } else if(c >= 0xC3 && c <= 0xC5 && i + 1 < name.size()) {
+            char folded = foldPolish(c, static_cast<unsigned char>(name[i + 1]));
+            if(folded) {
+                result.push_back(folded);
+                ++i;
+            } else {
+                result.push_back(static_cast<char>(c));
+            }
+        } else {
+            result.push_back(static_cast<char>(c));
+        }
+    }
+    return result;
+}
+
+int FuzzyIndex::distance(std::string_view a, std::string_view b, int limit) {
+    return distanceTo(Pattern(a), b, limit);
+}
+
+uint64_t FuzzyIndex::signature(std::string_view normalized) {
+    uint64_t mask = 0;
+    for(char c : normalized) {
+        const unsigned char u = static_cast<unsigned char>(c);
+        unsigned bit;
+        if(u >= 'a' && u <= 'z') {
+            bit = u - 'a';
+        } else if(u >= '0' && u <= '9') {
+            bit = 26 + (u - '0');
+        } else {
+            bit = 36 + u % 28;
+        }
+        mask |= uint64_t(1) << bit;
+    }
+    return mask;
+}
+
+int FuzzyIndex::defaultMaxDistance(std::string_view normalized) {
+    if(normalized.size() <= 4) {
+        return 1;
+    }
+    return normalized.size() <= 12 ? 2 : 3;
+}
+
+void FuzzyIndex::insert(const std::string& name) {
+    std::string key = normalize(name);
+    ++liveNames;
+
+    auto found = byKey.find(key);
+    if(found != byKey.end()) {
+        slotNames[found->second].push_back(name);
+        return;
+    }
+
+    uint32_t slot;
+    if(!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(slotKeys.size());
+        slotKeys.emplace_back();
+        slotNames.emplace_back();
+        positions.push_back(0);
+    }
+
+    if(buckets.size() <= key.size()) {
+        buckets.resize(key.size() + 1);
+    }
+    auto& bucket = buckets[key.size()];
+    positions[slot] = static_cast<uint32_t>(bucket.size());
+    bucket.push_back({signature(key), slot});
+
+    slotNames[slot].push_back(name);
+    slotKeys[slot] = key;
+    byKey.emplace(std::move(key), slot);
+}
+
+void FuzzyIndex::erase(const std::string& name) {
+    auto found = byKey.find(normalize(name));
+    if(found == byKey.end()) {
+        return;
+    }
+    const uint32_t slot = found->second;
+    auto& original = slotNames[slot];
+    auto it = std::find(original.begin(), original.end(), name);
+    if(it == original.end()) {
+        return;
+    }
+    original.erase(it);
+    --liveNames;
+    if(!original.empty()) {
+        return;
+    }
+
+    // Ostatni oryginał - wpis wylatuje z kubełka (zamiana z ostatnim), slot do ponownego użycia
+    auto& bucket = buckets[slotKeys[slot].size()];
+    const uint32_t position = positions[slot];
+    bucket[position] = bucket.back();
+    positions[bucket[position].slot] = position;
+    bucket.pop_back();
+
+    byKey.erase(found);
+    slotKeys[slot].clear();
+    freeSlots.push_back(slot);
+}
+
+void FuzzyIndex::clear() {
+    buckets.clear();
+    slotKeys.clear();
+    slotNames.clear();
+    positions.clear();
+    freeSlots.clear();
+    byKey.clear();
+    liveNames = 0;
+}
+
+std::vector<NameSuggestion> FuzzyIndex::query(const std::string& name, size_t limit,
+                                              int maxDistance) const {
+    std::vector<NameSuggestion> results;
+    if(liveNames == 0 || limit == 0) {
+        return results;
+    }
+
+    const std::string key = normalize(name);
+    int radius = maxDistance < 0 ? defaultMaxDistance(key) : maxDistance;
+    const Pattern pattern(key);
+    const uint64_t querySignature = signature(key);
+    const int length = static_cast<int>(key.size());
+
+    // Liczba wyników na każdej odległości - gdy jest już limit wyników w
+    // promieniu r, dalsze szukanie zawęża się do r (remisy nadal wchodzą)
+    std::vector<size_t> perDistance(static_cast<size_t>(radius) + 1, 0);
+
+    // Kubełki od najbliższej długości: 0, -1, +1, -2, +2, ...
+    for(int shift = 0; shift <= 2 * radius; ++shift) {
+        const int delta = (shift % 2 == 0) ? shift / 2 : -(shift + 1) / 2;
+        if(std::abs(delta) > radius) {
+            break;
+        }
+        const int bucketLength = length + delta;
+        if(bucketLength < 0 || bucketLength >= static_cast<int>(buckets.size())) {
+            continue;
+        }
+
+        for(const Entry& entry : buckets[static_cast<size_t>(bucketLength)]) {
+            const int lowerBound = std::max(__builtin_popcountll(querySignature & ~entry.signature),
+                                            __builtin_popcountll(entry.signature & ~querySignature));
+            if(lowerBound > radius) {
+                continue;
+            }
+            const int d = distanceTo(pattern, slotKeys[entry.slot], radius);
+            if(d > radius) {
+                continue;
+            }
+
+            const auto& original = slotNames[entry.slot];
+            for(const auto& candidate : original) {
+                results.push_back({candidate, d});
+            }
+            perDistance[static_cast<size_t>(d)] += original.size();
+            size_t found = 0;
+            for(int r = 0; r < radius; ++r) {
+                found += perDistance[static_cast<size_t>(r)];
+                if(found >= limit) {
+                    radius = r;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Wyniki sprzed zawężenia promienia mogą być dalsze niż końcowy promień
+    results.erase(std::remove_if(results.begin(), results.end(),
+                                 [radius](const NameSuggestion& s) { return s.distance > radius; }),
+                  results.end());
+    std::sort(results.begin(), results.end(), [](const NameSuggestion& x, const NameSuggestion& y) {
+        return x.distance != y.distance ? x.distance < y.distance : x.name < y.name;
+    });
+    if(results.size() > limit) {
+        results.resize(limit);
+    }
+    return results;
+}
@@ -0,0 +1,75 @@
+// FuzzyIndex.h
+// Lokalizacja: core/FuzzyIndex.h
+// Opis: Przybliżone wyszukiwanie nazw ("czy chodziło o...") z odległością
+//       Damerau-Levenshteina (wariant OSA - transpozycja sąsiednich znaków = 1).
+//       Normalizacja: małe litery, polskie znaki diakrytyczne -> ASCII
+//       ("Wyciskanie na ławce" == "wyciskanie na lawce"), zwinięte spacje.
+//
+//       Klucze są w kubełkach po długości; zapytanie przegląda tylko kubełki
+//       w zasięgu +-k, odrzuca kandydatów po masce znaków (dolne ograniczenie
+//       odległości, jedna instrukcja popcount), a resztę weryfikuje algorytmem
+//       bitowo-równoległym (Hyyrö). Ciągły skan bez wskaźników jest szybszy od
+//       BK-drzewa, które przy zróżnicowanych nazwach odwiedza większość węzłów.
+// Design Pattern: brak (struktura danych)
+//
+// Wątki: brak własnej synchronizacji - zapisy pod blokadą właściciela
+// (ExerciseRepository::storageLock), zapytania równoległe są bezpieczne.
+
+#ifndef FUZZYINDEX_H
+#define FUZZYINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Podpowiedź: oryginalna nazwa i jej odległość od zapytania (po normalizacji)
+struct NameSuggestion {
+    std::string name;
+    int distance = 0;
+};
+
+class FuzzyIndex {
+public:
+    // Nazwa znormalizowana do porównań (klucz indeksu)
+    static std::string normalize(std::string_view name);
+
+    // Odległość OSA; wynik > limit zwracany jako limit + 1 (wczesne przerwanie)
+    static int distance(std::string_view a, std::string_view b, int limit);
+
+    // Domyślna tolerancja dla nazwy o tej długości: 1 do 3 edycji
+    static int defaultMaxDistance(std::string_view normalized);
+
+    // Zbiór znaków jako maska bitowa. Każdy znak obecny tylko w jednej nazwie
+    // wymaga osobnej edycji, więc popcount różnicy masek ogranicza odległość z dołu.
+    static uint64_t signature(std::string_view normalized);
+
+    void insert(const std::string& name);
+    void erase(const std::string& name);
+    void clear();
+
+    // Najbliższe nazwy (maxDistance < 0 = defaultMaxDistance), posortowane po
+    // odległości, potem alfabetycznie; maks. limit wyników
+    std::vector<NameSuggestion> query(const std::string& name, size_t limit = 5,
+                                      int maxDistance = -1) const;
+
+    size_t size() const { return liveNames; }
+
+private:
+    // Wpis kubełka - 16 bajtów, skan zapytania czyta tylko te tablice
+    struct Entry {
+        uint64_t signature = 0;
+        uint32_t slot = 0;
+    };
+
+    std::vector<std::vector<Entry>> buckets;           // buckets[długość klucza]
+    std::vector<std::string> slotKeys;                 // Klucz znormalizowany slotu
+    std::vector<std::vector<std::string>> slotNames;   // Oryginały o tym kluczu
+    std::vector<uint32_t> positions;                   // Pozycja slotu w kubełku
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<std::string, uint32_t> byKey;   // Klucz -> slot
+    size_t liveNames = 0;
+};
+
+#endif // FUZZYINDEX_H
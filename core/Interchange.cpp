@@ -0,0 +1,904 @@
+// Interchange.cpp
+// Lokalizacja: core/Interchange.cpp
+
+#include "Interchange.h"
+#include "ExerciseFactory.h"
+#include "JsonUtils.h"
+#include "Logger.h"
+#include "Trace.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace Interchange {
+
+namespace {
+
+// ===== Czytanie linii z limitem długości =====
+
+enum class LineStatus {
+    OK,
+    TOO_LONG,   // Linia dłuższa niż limit - pominięta w całości
+    END
+};
+
+// Linia bez '\n' (i bez końcowego '\r'). Czytamy blokami, więc linia ponad
+// limit nie jest nigdy trzymana w pamięci w całości.
+LineStatus readLine(std::istream& in, std::string& line, size_t limit) {
+    line.clear();
+    char buffer[8192];
+    bool any = false;
+    bool tooLong = false;
+
+    while(true) {
+        in.getline(buffer, sizeof(buffer));
+        const size_t extracted = static_cast<size_t>(in.gcount());
+        if(in.bad()) {
+            return LineStatus::END;
+        }
+
+        // Bufor pełny, a linia trwa dalej
+        const bool full = in.fail() && !in.eof() && extracted == sizeof(buffer) - 1;
+        if(in.fail() && !full) {
+            // Koniec strumienia bez nowych znaków
+            if(!any) {
+                return LineStatus::END;
+            }
+            break;
+        }
+
+        any = any || extracted > 0 || !in.eof();
+        const size_t stored = (full || in.eof()) ? extracted : extracted - 1;
+        if(!tooLong) {
+            if(line.size() + stored > limit) {
+                tooLong = true;
+                line.clear();
+            } else {
+                line.append(buffer, stored);
+            }
+        }
+
+        if(!full) {
+            break;
+        }
+        in.clear();
+    }
+
+    if(tooLong) {
+        return LineStatus::TOO_LONG;
+    }
+    if(!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    return LineStatus::OK;
+}
+
+// Następny rekord: w CSV pole w cudzysłowie może zawierać znaki nowej linii,
+// więc rekord ciągnie się, dopóki liczba cudzysłowów jest nieparzysta
+LineStatus readRecord(std::istream& in, Format format, std::string& record, std::string& line) {
+    record.clear();
+    bool insideQuotes = false;
+    bool continuing = false;
+
+    while(true) {
+        LineStatus status = readLine(in, line, MAX_RECORD_BYTES);
+        if(status == LineStatus::END) {
+            return continuing ? LineStatus::OK : LineStatus::END;
+        }
+        if(status == LineStatus::TOO_LONG) {
+            return LineStatus::TOO_LONG;
+        }
+        if(!continuing && line.empty()) {
+            continue;  // Puste linie między rekordami
+        }
+        if(continuing) {
+            record.push_back('\n');
+        }
+        if(record.size() + line.size() > MAX_RECORD_BYTES) {
+            return LineStatus::TOO_LONG;
+        }
+        record += line;
+
+        if(format == Format::JSONL) {
+            return LineStatus::OK;
+        }
+        for(char c : line) {
+            insideQuotes ^= (c == '"');
+        }
+        if(!insideQuotes) {
+            return LineStatus::OK;
+        }
+        continuing = true;
+    }
+}
+
+// ===== CSV =====
+
+// Podział rekordu na pola (RFC 4180: "" w cudzysłowie = jeden cudzysłów).
+// Wektor pól jest używany wielokrotnie - bez alokacji dla kolejnych rekordów.
+void splitCsv(const std::string& record, std::vector<std::string>& fields) {
+    size_t count = 0;
+    size_t i = 0;
+    while(true) {
+        if(fields.size() <= count) {
+            fields.emplace_back();
+        }
+        std::string& field = fields[count++];
+        field.clear();
+
+        if(i < record.size() && record[i] == '"') {
+            ++i;
+            while(i < record.size()) {
+                if(record[i] == '"') {
+                    if(i + 1 < record.size() && record[i + 1] == '"') {
+                        field.push_back('"');
+                        i += 2;
+                        continue;
+                    }
+                    ++i;
+                    break;
+                }
+                field.push_back(record[i++]);
+            }
+            // Znaki między cudzysłowem zamykającym a przecinkiem (niepoprawne, ale tolerowane)
+            while(i < record.size() && record[i] != ',') {
+                field.push_back(record[i++]);
+            }
+        } else {
+            size_t comma = record.find(',', i);
+            if(comma == std::string::npos) {
+                comma = record.size();
+            }
+            field.assign(record, i, comma - i);
+            i = comma;
+        }
+
+        if(i >= record.size()) {
+            break;
+        }
+        ++i;  // Przecinek
+    }
+    fields.resize(count);
+}
+
+void appendCsvField(std::string& out, std::string_view field) {
+    const bool quote = field.find_first_of(",\"\n\r") != std::string_view::npos
+                       || (!field.empty() && (field.front() == ' ' || field.back() == ' '));
+    if(!quote) {
+        out.append(field);
+        return;
+    }
+    out.push_back('"');
+    for(char c : field) {
+        if(c == '"') {
+            out.push_back('"');
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+// Pozycje znanych kolumn wg nagłówka (-1 = brak kolumny)
+std::vector<int> mapColumns(std::vector<std::string> header, const std::vector<std::string_view>& names) {
+    if(!header.empty() && header[0].compare(0, 3, "\xEF\xBB\xBF") == 0) {
+        header[0].erase(0, 3);  // BOM z arkuszy kalkulacyjnych
+    }
+    std::vector<int> columns(names.size(), -1);
+    for(size_t c = 0; c < header.size(); ++c) {
+        std::string_view name = header[c];
+        while(!name.empty() && name.front() == ' ') name.remove_prefix(1);
+        while(!name.empty() && name.back() == ' ') name.remove_suffix(1);
+        for(size_t k = 0; k < names.size(); ++k) {
+            if(name == names[k] && columns[k] < 0) {
+                columns[k] = static_cast<int>(c);
+            }
+        }
+    }
+    return columns;
+}
+
+const std::string& column(const std::vector<std::string>& fields, int index) {
+    static const std::string empty;
+    return index >= 0 && static_cast<size_t>(index) < fields.size() ? fields[index] : empty;
+}
+
+// ===== Liczby =====
+
+bool parseInt(std::string_view text, int& out) {
+    if(text.empty()) {
+        out = 0;
+        return true;
+    }
+    auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+bool parseDouble(std::string_view text, double& out) {
+    if(text.empty()) {
+        out = 0.0;
+        return true;
+    }
+    auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+void appendInt(std::string& out, int value) {
+    char buffer[16];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void appendDouble(std::string& out, double value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// ===== JSON Lines - minimalny parser jednej linii =====
+
+struct JsonValue {
+    enum class Kind { NONE, STRING, NUMBER, LITERAL, ARRAY, OBJECT };
+    Kind kind = Kind::NONE;
+    std::string text;   // STRING (bez escapowania), NUMBER i LITERAL (surowy tekst)
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> fields;
+
+    const JsonValue* get(std::string_view key) const {
+        for(const auto& field : fields) {
+            if(field.first == key) {
+                return &field.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class JsonLineParser {
+private:
+    static constexpr int MAX_DEPTH = 32;
+    const std::string& line;
+    size_t pos = 0;
+
+    void skipSpaces() {
+        while(pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r')) {
+            ++pos;
+        }
+    }
+
+    bool parseString(std::string& out) {
+        const size_t first = pos + 1;
+        const size_t last = JsonUtils::findClosingQuote(line, first);
+        if(last == std::string::npos) {
+            return false;
+        }
+        out = JsonUtils::unescape(std::string_view(line).substr(first, last - first));
+        pos = last + 1;
+        return true;
+    }
+
+    bool parseValue(JsonValue& out, int depth) {
+        if(depth > MAX_DEPTH) {
+            return false;
+        }
+        skipSpaces();
+        if(pos >= line.size()) {
+            return false;
+        }
+
+        const char c = line[pos];
+        if(c == '"') {
+            out.kind = JsonValue::Kind::STRING;
+            return parseString(out.text);
+        }
+        if(c == '{') {
+            out.kind = JsonValue::Kind::OBJECT;
+            ++pos;
+            skipSpaces();
+            if(pos < line.size() && line[pos] == '}') {
+                ++pos;
+                return true;
+            }
+            while(true) {
+                skipSpaces();
+                std::pair<std::string, JsonValue> field;
+                if(pos >= line.size() || line[pos] != '"' || !parseString(field.first)) {
+                    return false;
+                }
+                skipSpaces();
+                if(pos >= line.size() || line[pos++] != ':') {
+                    return false;
+                }
+                if(!parseValue(field.second, depth + 1)) {
+                    return false;
+                }
+                out.fields.push_back(std::move(field));
+                skipSpaces();
+                if(pos < line.size() && line[pos] == ',') {
+                    ++pos;
+                    continue;
+                }
+                return pos < line.size() && line[pos++] == '}';
+            }
+        }
+        if(c == '[') {
+            out.kind = JsonValue::Kind::ARRAY;
+            ++pos;
+            skipSpaces();
+            if(pos < line.size() && line[pos] == ']') {
+                ++pos;
+                return true;
+            }
+            while(true) {
+                out.items.emplace_back();
+                if(!parseValue(out.items.back(), depth + 1)) {
+                    return false;
+                }
+                skipSpaces();
+                if(pos < line.size() && line[pos] == ',') {
+                    ++pos;
+                    continue;
+                }
+                return pos < line.size() && line[pos++] == ']';
+            }
+        }
+
+        // Liczba albo true/false/null
+        const size_t start = pos;
+        while(pos < line.size() && std::strchr(",]} \t", line[pos]) == nullptr) {
+            ++pos;
+        }
+        out.text.assign(line, start, pos - start);
+        if(out.text == "true" || out.text == "false" || out.text == "null") {
+            out.kind = JsonValue::Kind::LITERAL;
+            return true;
+        }
+        out.kind = JsonValue::Kind::NUMBER;
+        double ignored;
+        return !out.text.empty() && parseDouble(out.text, ignored);
+    }
+
+public:
+    explicit JsonLineParser(const std::string& line) : line(line) {}
+
+    bool parse(JsonValue& out) {
+        out = JsonValue();
+        if(!parseValue(out, 0) || out.kind != JsonValue::Kind::OBJECT) {
+            return false;
+        }
+        skipSpaces();
+        return pos == line.size();
+    }
+};
+
+// Pole tekstowe (brak = pusty tekst); false gdy pole ma inny typ
+bool stringField(const JsonValue& object, std::string_view key, std::string& out) {
+    const JsonValue* value = object.get(key);
+    if(!value || (value->kind == JsonValue::Kind::LITERAL && value->text == "null")) {
+        out.clear();
+        return true;
+    }
+    if(value->kind != JsonValue::Kind::STRING) {
+        return false;
+    }
+    out = value->text;
+    return true;
+}
+
+bool intField(const JsonValue& object, std::string_view key, int& out) {
+    const JsonValue* value = object.get(key);
+    if(!value) {
+        out = 0;
+        return true;
+    }
+    return value->kind == JsonValue::Kind::NUMBER && parseInt(value->text, out);
+}
+
+bool doubleField(const JsonValue& object, std::string_view key, double& out) {
+    const JsonValue* value = object.get(key);
+    if(!value) {
+        out = 0.0;
+        return true;
+    }
+    return value->kind == JsonValue::Kind::NUMBER && parseDouble(value->text, out);
+}
+
+bool entryFromJson(const JsonValue& object, PlanEntryRecord& entry) {
+    return stringField(object, "exercise", entry.exerciseName)
+           && intField(object, "sets", entry.sets)
+           && intField(object, "reps", entry.reps)
+           && doubleField(object, "weight", entry.weight)
+           && intField(object, "rest", entry.restTime);
+}
+
+void appendJsonString(std::string& out, std::string_view key, std::string_view value) {
+    out.push_back('"');
+    out.append(key);
+    out.append("\":\"");
+    JsonUtils::appendEscaped(out, value);
+    out.push_back('"');
+}
+
+// Wpis planu w JSON - wspólne dla WorkoutPlan i PlanRecord (plan tylko w układzie ENTRIES)
+void appendJsonEntry(std::string& out, const std::string* plan, std::string_view exercise,
+                     int sets, int reps, double weight, int restTime) {
+    out.push_back('{');
+    if(plan) {
+        appendJsonString(out, "plan", *plan);
+        out.push_back(',');
+    }
+    appendJsonString(out, "exercise", exercise);
+    out.append(",\"sets\":");
+    appendInt(out, sets);
+    out.append(",\"reps\":");
+    appendInt(out, reps);
+    out.append(",\"weight\":");
+    appendDouble(out, weight);
+    out.append(",\"rest\":");
+    appendInt(out, restTime);
+    out.push_back('}');
+}
+
+void reportError(ReadStats& stats, const ErrorCallback& onError, size_t record, const std::string& message) {
+    ++stats.errors;
+    if(onError) {
+        onError(record, message);
+    }
+}
+
+const char* TOO_LONG_MESSAGE = "Rekord przekracza maksymalną długość";
+
+} // namespace
+
+Format formatFromPath(const std::string& path) {
+    const bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    return csv ? Format::CSV : Format::JSONL;
+}
+
+// ===== Czytanie =====
+
+ReadStats readExercises(std::istream& in, Format format,
+                        const RowCallback<ExerciseRow>& onRow,
+                        const ErrorCallback& onError) {
+    PUMP_TRACE_SCOPE("Interchange::readExercises", "io");
+    ReadStats stats;
+    std::string record, line;
+    std::vector<std::string> fields;
+    std::vector<int> columns;
+    size_t index = 0;
+
+    if(format == Format::CSV) {
+        if(readRecord(in, format, record, line) != LineStatus::OK) {
+            return stats;
+        }
+        splitCsv(record, fields);
+        columns = mapColumns(fields, {"name", "type", "muscles", "description"});
+        if(columns[0] < 0 || columns[1] < 0) {
+            reportError(stats, onError, 0, "Nagłówek CSV bez kolumn name/type");
+            return stats;
+        }
+    }
+
+    while(true) {
+        LineStatus status = readRecord(in, format, record, line);
+        if(status == LineStatus::END) {
+            break;
+        }
+        const size_t current = index++;
+        if(status == LineStatus::TOO_LONG) {
+            reportError(stats, onError, current, TOO_LONG_MESSAGE);
+            continue;
+        }
+
+        ExerciseRow row;
+        if(format == Format::CSV) {
+            splitCsv(record, fields);
+            row.name = column(fields, columns[0]);
+            row.type = column(fields, columns[1]);
+            row.muscles = column(fields, columns[2]);
+            row.description = column(fields, columns[3]);
+        } else {
+            JsonValue object;
+            if(!JsonLineParser(record).parse(object)
+               || !stringField(object, "name", row.name) || !stringField(object, "type", row.type)
+               || !stringField(object, "muscles", row.muscles)
+               || !stringField(object, "description", row.description)) {
+                reportError(stats, onError, current, "Niepoprawny obiekt JSON");
+                continue;
+            }
+        }
+
+        ++stats.records;
+        if(!onRow(std::move(row))) {
+            break;
+        }
+    }
+    return stats;
+}
+
+ReadStats readPlanEntries(std::istream& in, Format format,
+                          const RowCallback<PlanEntryRow>& onRow,
+                          const ErrorCallback& onError) {
+    PUMP_TRACE_SCOPE("Interchange::readPlanEntries", "io");
+    ReadStats stats;
+    std::string record, line;
+    std::vector<std::string> fields;
+    std::vector<int> columns;
+    size_t index = 0;
+
+    if(format == Format::CSV) {
+        if(readRecord(in, format, record, line) != LineStatus::OK) {
+            return stats;
+        }
+        splitCsv(record, fields);
+        columns = mapColumns(fields, {"plan", "exercise", "sets", "reps", "weight", "rest"});
+        if(columns[0] < 0 || columns[1] < 0) {
+            reportError(stats, onError, 0, "Nagłówek CSV bez kolumn plan/exercise");
+            return stats;
+        }
+    }
+
+    while(true) {
+        LineStatus status = readRecord(in, format, record, line);
+        if(status == LineStatus::END) {
+            break;
+        }
+        const size_t current = index++;
+        if(status == LineStatus::TOO_LONG) {
+            reportError(stats, onError, current, TOO_LONG_MESSAGE);
+            continue;
+        }
+
+        PlanEntryRow row;
+        bool valid;
+        if(format == Format::CSV) {
+            splitCsv(record, fields);
+            row.plan = column(fields, columns[0]);
+            row.entry.exerciseName = column(fields, columns[1]);
+            valid = parseInt(column(fields, columns[2]), row.entry.sets)
+                    && parseInt(column(fields, columns[3]), row.entry.reps)
+                    && parseDouble(column(fields, columns[4]), row.entry.weight)
+                    && parseInt(column(fields, columns[5]), row.entry.restTime);
+        } else {
+            JsonValue object;
+            valid = JsonLineParser(record).parse(object)
+                    && stringField(object, "plan", row.plan)
+                    && entryFromJson(object, row.entry);
+        }
+        if(!valid) {
+            reportError(stats, onError, current, "Niepoprawny wpis planu");
+            continue;
+        }
+
+        ++stats.records;
+        if(!onRow(std::move(row))) {
+            break;
+        }
+    }
+    return stats;
+}
+
+ReadStats readPlans(std::istream& in, Format format, PlanLayout layout,
+                    const RowCallback<PlanRecord>& onPlan,
+                    const ErrorCallback& onError) {
+    PUMP_TRACE_SCOPE("Interchange::readPlans", "io");
+    ReadStats stats;
+
+    if(format == Format::JSONL && layout == PlanLayout::PLANS) {
+        std::string record, line;
+        size_t index = 0;
+        while(true) {
+            LineStatus status = readRecord(in, format, record, line);
+            if(status == LineStatus::END) {
+                break;
+            }
+            const size_t current = index++;
+            if(status == LineStatus::TOO_LONG) {
+                reportError(stats, onError, current, TOO_LONG_MESSAGE);
+                continue;
+            }
+
+            PlanRecord plan;
+            JsonValue object;
+            bool valid = JsonLineParser(record).parse(object) && stringField(object, "name", plan.name);
+            const JsonValue* entries = valid ? object.get("entries") : nullptr;
+            if(entries && entries->kind == JsonValue::Kind::ARRAY) {
+                plan.entries.reserve(entries->items.size());
+                for(const auto& item : entries->items) {
+                    PlanEntryRecord entry;
+                    if(item.kind != JsonValue::Kind::OBJECT || !entryFromJson(item, entry)) {
+                        valid = false;
+                        break;
+                    }
+                    plan.entries.push_back(std::move(entry));
+                }
+            } else if(entries) {
+                valid = false;
+            }
+            if(!valid) {
+                reportError(stats, onError, current, "Niepoprawny plan");
+                continue;
+            }
+
+            ++stats.records;
+            if(!onPlan(std::move(plan))) {
+                break;
+            }
+        }
+        return stats;
+    }
+
+    // Wpisy sklejane w plany - w pamięci tylko bieżący plan
+    PlanRecord current;
+    bool stopped = false;
+    ReadStats entryStats = readPlanEntries(in, format, [&](PlanEntryRow&& row) {
+        if(!current.entries.empty() && row.plan != current.name) {
+            ++stats.records;
+            if(!onPlan(std::move(current))) {
+                stopped = true;
+                return false;
+            }
+            current = PlanRecord();
+        }
+        if(current.entries.empty()) {
+            current.name = std::move(row.plan);
+        }
+        current.entries.push_back(std::move(row.entry));
+        return true;
+    }, onError);
+
+    stats.errors = entryStats.errors;
+    if(!stopped && !current.entries.empty()) {
+        ++stats.records;
+        onPlan(std::move(current));
+    }
+    return stats;
+}
+
+// ===== Pisanie =====
+
+ExerciseWriter::ExerciseWriter(std::ostream& out, Format format)
+    : out(out), format(format) {
+    if(format == Format::CSV) {
+        out << "name,type,muscles,description\n";
+    }
+}
+
+void ExerciseWriter::write(const Exercise& exercise) {
+    write(ExerciseRow{exercise.getName(), Exercise::typeToString(exercise.getType()),
+                      exercise.getTargetMuscles(), exercise.getDescription()});
+}
+
+void ExerciseWriter::write(const ExerciseRow& row) {
+    line.clear();
+    if(format == Format::CSV) {
+        appendCsvField(line, row.name);
+        line.push_back(',');
+        appendCsvField(line, row.type);
+        line.push_back(',');
+        appendCsvField(line, row.muscles);
+        line.push_back(',');
+        appendCsvField(line, row.description);
+    } else {
+        line.push_back('{');
+        appendJsonString(line, "name", row.name);
+        line.push_back(',');
+        appendJsonString(line, "type", row.type);
+        line.push_back(',');
+        appendJsonString(line, "muscles", row.muscles);
+        line.push_back(',');
+        appendJsonString(line, "description", row.description);
+        line.push_back('}');
+    }
+    line.push_back('\n');
+    out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    ++count;
+}
+
+PlanWriter::PlanWriter(std::ostream& out, Format format, PlanLayout layout)
+    : out(out), format(format), layout(format == Format::CSV ? PlanLayout::ENTRIES : layout) {
+    if(format == Format::CSV) {
+        out << "plan,exercise,sets,reps,weight,rest\n";
+    }
+}
+
+void PlanWriter::writeEntry(const std::string& plan, const std::string& exercise,
+                            int sets, int reps, double weight, int restTime) {
+    line.clear();
+    if(format == Format::CSV) {
+        appendCsvField(line, plan);
+        line.push_back(',');
+        appendCsvField(line, exercise);
+        line.push_back(',');
+        appendInt(line, sets);
+        line.push_back(',');
+        appendInt(line, reps);
+        line.push_back(',');
+        appendDouble(line, weight);
+        line.push_back(',');
+        appendInt(line, restTime);
+    } else {
+        appendJsonEntry(line, &plan, exercise, sets, reps, weight, restTime);
+    }
+    line.push_back('\n');
+    out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    ++count;
+}
+
+void PlanWriter::write(const WorkoutPlan& plan) {
+    if(layout == PlanLayout::ENTRIES) {
+        for(const auto& entry : plan.getEntries()) {
+            writeEntry(plan.getName(), entry.exercise->getName(),
+                       entry.sets, entry.reps, entry.weight, entry.restTime);
+        }
+        return;
+    }
+
+    line.clear();
+    line.push_back('{');
+    appendJsonString(line, "name", plan.getName());
+    line.append(",\"entries\":[");
+    bool first = true;
+    for(const auto& entry : plan.getEntries()) {
+        if(!first) {
+            line.push_back(',');
+        }
+        first = false;
+        appendJsonEntry(line, nullptr, entry.exercise->getName(), entry.sets, entry.reps, entry.weight, entry.restTime);
+    }
+    line.append("]}\n");
+    out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    ++count;
+}
+
+void PlanWriter::write(const PlanRecord& plan) {
+    if(layout == PlanLayout::ENTRIES) {
+        for(const auto& entry : plan.entries) {
+            writeEntry(plan.name, entry.exerciseName, entry.sets, entry.reps, entry.weight, entry.restTime);
+        }
+        return;
+    }
+
+    line.clear();
+    line.push_back('{');
+    appendJsonString(line, "name", plan.name);
+    line.append(",\"entries\":[");
+    bool first = true;
+    for(const auto& entry : plan.entries) {
+        if(!first) {
+            line.push_back(',');
+        }
+        first = false;
+        appendJsonEntry(line, nullptr, entry.exerciseName, entry.sets, entry.reps, entry.weight, entry.restTime);
+    }
+    line.append("]}\n");
+    out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    ++count;
+}
+
+// ===== Most do repozytoriów =====
+
+namespace {
+
+// Dołączenie raportu partii; indeksy wierszy partii -> numery wierszy strumienia
+void mergeReport(ImportReport& total, ImportReport&& batch, const std::vector<size_t>& rowNumbers) {
+    total.added += batch.added;
+    total.replaced += batch.replaced;
+    total.skipped += batch.skipped;
+    total.duplicates += batch.duplicates;
+    total.committed = total.committed && batch.committed;
+    for(auto& error : batch.errors) {
+        error.row = rowNumbers[error.row];
+        total.errors.push_back(std::move(error));
+    }
+}
+
+} // namespace
+
+ImportReport importExercises(std::istream& in, Format format, ExerciseRepository& repo,
+                             const ImportOptions& options, size_t batchSize) {
+    PUMP_TRACE_SCOPE("Interchange::importExercises", "io");
+    ImportReport total;
+    total.committed = true;
+    batchSize = std::max<size_t>(batchSize, 1);
+
+    std::vector<std::shared_ptr<Exercise>> batch;
+    std::vector<size_t> rowNumbers;
+    batch.reserve(batchSize);
+    rowNumbers.reserve(batchSize);
+    size_t row = 0;   // Każdy rekord (poprawny lub nie) dostaje kolejny numer
+
+    auto flush = [&]() {
+        if(!batch.empty()) {
+            mergeReport(total, repo.importExercises(batch, options), rowNumbers);
+            batch.clear();
+            rowNumbers.clear();
+        }
+    };
+
+    readExercises(in, format, [&](ExerciseRow&& r) {
+        const size_t current = row++;
+        try {
+            batch.push_back(ExerciseFactory::createExercise(Exercise::stringToType(r.type),
+                                                            r.name, r.description, r.muscles));
+            rowNumbers.push_back(current);
+        } catch(const std::exception& e) {
+            total.errors.push_back({current, r.name, e.what()});
+        }
+        if(batch.size() >= batchSize) {
+            flush();
+        }
+        return true;
+    }, [&](size_t, const std::string& message) {
+        total.errors.push_back({row++, "", message});
+    });
+    flush();
+
+    Logger::info("Interchange", "Import ćwiczeń zakończony",
+                 {{"rows", std::to_string(row)}, {"added", std::to_string(total.added)},
+                  {"errors", std::to_string(total.errors.size())}});
+    return total;
+}
+
+ImportReport importPlans(std::istream& in, Format format, PlanLayout layout,
+                         WorkoutPlanRepository& repo,
+                         const ImportOptions& options, size_t batchSize) {
+    PUMP_TRACE_SCOPE("Interchange::importPlans", "io");
+    ImportReport total;
+    total.committed = true;
+    batchSize = std::max<size_t>(batchSize, 1);
+
+    std::vector<PlanRecord> batch;
+    std::vector<size_t> rowNumbers;
+    batch.reserve(batchSize);
+    rowNumbers.reserve(batchSize);
+    size_t planIndex = 0;   // Numer planu w strumieniu (błędy importu)
+
+    auto flush = [&]() {
+        if(!batch.empty()) {
+            mergeReport(total, repo.importPlans(batch, options), rowNumbers);
+            batch.clear();
+            rowNumbers.clear();
+        }
+    };
+
+    // Błędy parsowania wskazują numer rekordu w pliku (dla CSV - wiersz wpisu)
+    readPlans(in, format, layout, [&](PlanRecord&& plan) {
+        batch.push_back(std::move(plan));
+        rowNumbers.push_back(planIndex++);
+        if(batch.size() >= batchSize) {
+            flush();
+        }
+        return true;
+    }, [&](size_t record, const std::string& message) {
+        total.errors.push_back({record, "", message});
+    });
+    flush();
+
+    Logger::info("Interchange", "Import planów zakończony",
+                 {{"plans", std::to_string(planIndex)}, {"added", std::to_string(total.added)},
+                  {"errors", std::to_string(total.errors.size())}});
+    return total;
+}
+
+size_t exportExercises(const ExerciseSnapshot& snapshot, std::ostream& out, Format format) {
+    PUMP_TRACE_SCOPE("Interchange::exportExercises", "io");
+    ExerciseWriter writer(out, format);
+    for(const auto& ex : snapshot) {
+        writer.write(*ex);
+    }
+    return writer.getCount();
+}
+
+size_t exportPlans(const WorkoutPlanSnapshot& snapshot, std::ostream& out, Format format,
+                   PlanLayout layout) {
+    PUMP_TRACE_SCOPE("Interchange::exportPlans", "io");
+    PlanWriter writer(out, format, layout);
+    for(const auto& plan : snapshot) {
+        writer.write(*plan);
+    }
+    return writer.getCount();
+}
+
+} // namespace Interchange
@@ -0,0 +1,148 @@
+// Interchange.h
+// Lokalizacja: core/Interchange.h
+// Opis: Strumieniowy import/eksport w formatach wymiany danych - CSV (RFC 4180,
+//       wiersz nagłówka) i JSON Lines (jeden obiekt JSON w linii). Rekordy są
+//       czytane i pisane pojedynczo, więc pamięć zależy od wielkości jednego
+//       rekordu, a nie całego pliku (eksporty wielogigabajtowe).
+//
+// Układ danych:
+//   ćwiczenia  CSV:   name,type,muscles,description
+//              JSONL: {"name":...,"type":...,"muscles":...,"description":...}
+//   wpisy      CSV:   plan,exercise,sets,reps,weight,rest   (jeden wiersz = jeden wpis)
+//              JSONL: {"plan":...,"exercise":...,"sets":...,"reps":...,"weight":...,"rest":...}
+//   plany      JSONL: {"name":...,"entries":[{"exercise":...,"sets":...,...}]}
+//              CSV:   jak wpisy - kolejne wiersze tego samego planu tworzą plan
+// Kolejność kolumn CSV jest dowolna (dopasowanie po nagłówku), nieznane
+// kolumny i klucze JSON są pomijane.
+
+#ifndef INTERCHANGE_H
+#define INTERCHANGE_H
+
+#include "BulkImport.h"
+#include "ExerciseRepository.h"
+#include "WorkoutPlanRepository.h"
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace Interchange {
+
+enum class Format {
+    CSV,
+    JSONL
+};
+
+// Dla planów w JSONL: cały plan w linii albo osobna linia na każdy wpis
+enum class PlanLayout {
+    PLANS,
+    ENTRIES
+};
+
+// Format po rozszerzeniu pliku (.csv -> CSV, pozostałe -> JSONL)
+Format formatFromPath(const std::string& path);
+
+// Rekord o większej liczbie bajtów jest odrzucany (ochrona przed plikiem bez końców linii)
+constexpr size_t MAX_RECORD_BYTES = 16 << 20;
+
+// Ćwiczenie w postaci surowej - typ jako tekst, walidacja przy imporcie
+struct ExerciseRow {
+    std::string name;
+    std::string type;
+    std::string muscles;
+    std::string description;
+};
+
+// Wpis planu z nazwą planu (wiersz CSV / linia JSONL układu ENTRIES)
+struct PlanEntryRow {
+    std::string plan;
+    PlanEntryRecord entry;
+};
+
+// Wynik czytania: liczba rekordów przekazanych do callbacka i błędnych (pominiętych)
+struct ReadStats {
+    size_t records = 0;
+    size_t errors = 0;
+};
+
+// Callback rekordu: false przerywa czytanie. Błąd: numer rekordu (od 0) i opis.
+template<typename Row>
+using RowCallback = std::function<bool(Row&& row)>;
+using ErrorCallback = std::function<void(size_t record, const std::string& message)>;
+
+// === Czytanie strumieniowe ===
+
+ReadStats readExercises(std::istream& in, Format format,
+                        const RowCallback<ExerciseRow>& onRow,
+                        const ErrorCallback& onError = nullptr);
+
+ReadStats readPlanEntries(std::istream& in, Format format,
+                          const RowCallback<PlanEntryRow>& onRow,
+                          const ErrorCallback& onError = nullptr);
+
+// Plany: JSONL w układzie PLANS albo wpisy (CSV / JSONL ENTRIES) sklejane
+// w plan, dopóki kolejne wiersze mają tę samą nazwę planu
+ReadStats readPlans(std::istream& in, Format format, PlanLayout layout,
+                    const RowCallback<PlanRecord>& onPlan,
+                    const ErrorCallback& onError = nullptr);
+
+// === Pisanie strumieniowe ===
+
+// Pisarz ćwiczeń - nagłówek CSV przy konstrukcji, potem rekord po rekordzie
+class ExerciseWriter {
+private:
+    std::ostream& out;
+    Format format;
+    std::string line;   // Bufor wielokrotnego użytku
+    size_t count = 0;
+
+public:
+    ExerciseWriter(std::ostream& out, Format format);
+
+    void write(const Exercise& exercise);
+    void write(const ExerciseRow& row);
+    size_t getCount() const { return count; }
+};
+
+// Pisarz planów (CSV zawsze w układzie wpisów)
+class PlanWriter {
+private:
+    std::ostream& out;
+    Format format;
+    PlanLayout layout;
+    std::string line;
+    size_t count = 0;   // Zapisane rekordy (plany albo wpisy - zależnie od układu)
+
+    void writeEntry(const std::string& plan, const std::string& exercise,
+                    int sets, int reps, double weight, int restTime);
+
+public:
+    PlanWriter(std::ostream& out, Format format, PlanLayout layout = PlanLayout::PLANS);
+
+    void write(const WorkoutPlan& plan);
+    void write(const PlanRecord& plan);
+    size_t getCount() const { return count; }
+};
+
+// === Most do repozytoriów ===
+// Rekordy trafiają do importu wsadowego partiami po batchSize - pamięć
+// ograniczona do jednej partii. Numery wierszy w raporcie są globalne
+// (od początku strumienia); allOrNothing dotyczy pojedynczej partii.
+
+ImportReport importExercises(std::istream& in, Format format, ExerciseRepository& repo,
+                             const ImportOptions& options = ImportOptions(),
+                             size_t batchSize = 4096);
+
+ImportReport importPlans(std::istream& in, Format format, PlanLayout layout,
+                         WorkoutPlanRepository& repo,
+                         const ImportOptions& options = ImportOptions(),
+                         size_t batchSize = 1024);
+
+// Eksport spójnej wersji (snapshot) - bezpieczne w tle
+size_t exportExercises(const ExerciseSnapshot& snapshot, std::ostream& out, Format format);
+size_t exportPlans(const WorkoutPlanSnapshot& snapshot, std::ostream& out, Format format,
+                   PlanLayout layout = PlanLayout::PLANS);
+
+} // namespace Interchange
+
+#endif // INTERCHANGE_H
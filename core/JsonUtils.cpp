@@ -0,0 +1,426 @@
+// JsonUtils.cpp
+// Lokalizacja: core/JsonUtils.cpp
+
+#include "JsonUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// SSE2 jest zawsze dostępne na x86-64; AVX2 kompilujemy per-funkcja
+// (bez globalnej flagi -mavx2) i włączamy tylko, gdy CPU je wspiera
+#if defined(__x86_64__) || defined(_M_X64)
+#define PUMP_JSON_X86_64 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PUMP_TARGET_AVX2
+#else
+#define PUMP_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define PUMP_JSON_X86_64 0
+#endif
+
+namespace JsonUtils {
+
+std::vector<Range> splitAtRecordLines(const std::string& content,
+                                      const std::string& recordKey,
+                                      size_t maxChunks) {
+    std::vector<Range> ranges;
+    if(maxChunks <= 1 || content.empty()) {
+        ranges.emplace_back(0, content.size());
+        return ranges;
+    }
+
+    const size_t target = content.size() / maxChunks;
+    size_t start = 0;
+
+    while(ranges.size() + 1 < maxChunks) {
+        // Szukamy pierwszego rekordu za docelową granicą
+        size_t keyPos = content.find(recordKey, start + target);
+        if(keyPos == std::string::npos) break;
+
+        size_t lineStart = content.rfind('\n', keyPos);
+        lineStart = (lineStart == std::string::npos) ? 0 : lineStart + 1;
+        if(lineStart <= start) break;
+
+        ranges.emplace_back(start, lineStart);
+        start = lineStart;
+    }
+
+    ranges.emplace_back(start, content.size());
+    return ranges;
+}
+
+size_t findClosingQuote(const std::string& line, size_t from) {
+    // memchr jest wektoryzowany w bibliotece standardowej - skaczemy po cudzysłowach
+    // i sprawdzamy tylko, czy nie są poprzedzone nieparzystą liczbą backslashy
+    const char* data = line.data();
+    size_t i = from;
+    while(i < line.size()) {
+        const void* hit = std::memchr(data + i, '"', line.size() - i);
+        if(!hit) break;
+        size_t quote = static_cast<const char*>(hit) - data;
+
+        size_t backslashes = 0;
+        while(quote - backslashes > from && data[quote - backslashes - 1] == '\\') {
+            ++backslashes;
+        }
+        if(backslashes % 2 == 0) {
+            return quote;
+        }
+        i = quote + 1;
+    }
+    return std::string::npos;
+}
+
+// === Escapowanie ===
+
+namespace {
+
+inline bool needsEscape(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+inline unsigned countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+// Skan zwraca indeks pierwszego bajtu wymagającego escapowania (size gdy brak)
+size_t scanScalar(const char* data, size_t size) {
+    for(size_t i = 0; i < size; ++i) {
+        if(needsEscape(static_cast<unsigned char>(data[i]))) {
+            return i;
+        }
+    }
+    return size;
+}
+
+#if PUMP_JSON_X86_64
+size_t scanSse2(const char* data, size_t size) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+
+    size_t i = 0;
+    for(; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // c <= 0x1F (bez znaku) <=> min(c, 0x1F) == c
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                                 _mm_cmpeq_epi8(v, backslash)),
+                                    _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        if(mask) {
+            return i + countTrailingZeros(mask);
+        }
+    }
+    return i + scanScalar(data + i, size - i);
+}
+
+// Reszta (< 32 bajty) też w tej funkcji - wywołanie wersji SSE2 (kodowanie bez VEX)
+// z brudną górną połową rejestrów YMM kosztuje więcej niż cały skan krótkiego tekstu
+PUMP_TARGET_AVX2
+size_t scanAvx2(const char* data, size_t size) {
+    size_t i = 0;
+    if(size >= 32) {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i control = _mm256_set1_epi8(0x1F);
+        for(; i + 32 <= size; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                                                           _mm256_cmpeq_epi8(v, backslash)),
+                                           _mm256_cmpeq_epi8(_mm256_min_epu8(v, control), v));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+            if(mask) {
+                _mm256_zeroupper();
+                return i + countTrailingZeros(mask);
+            }
+        }
+        _mm256_zeroupper();
+    }
+    if(i + 16 <= size) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                                                 _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+                                    _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1F)), v));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        if(mask) {
+            return i + countTrailingZeros(mask);
+        }
+        i += 16;
+    }
+    for(; i < size; ++i) {
+        if(needsEscape(static_cast<unsigned char>(data[i]))) {
+            return i;
+        }
+    }
+    return size;
+}
+
+bool cpuSupportsAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if(!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;  // System zapisuje rejestry YMM
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+SimdLevel detectSimdLevel() {
+#if PUMP_JSON_X86_64
+    return cpuSupportsAvx2() ? SimdLevel::AVX2 : SimdLevel::SSE2;  // SSE2 to minimum x86-64
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+const SimdLevel supportedLevel = detectSimdLevel();
+std::atomic<SimdLevel> activeLevel{supportedLevel};
+
+inline size_t scanForEscape(const char* data, size_t size) {
+#if PUMP_JSON_X86_64
+    switch(activeLevel.load(std::memory_order_relaxed)) {
+        case SimdLevel::AVX2: return scanAvx2(data, size);
+        case SimdLevel::SSE2: return scanSse2(data, size);
+        default: break;
+    }
+#endif
+    return scanScalar(data, size);
+}
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+// Sekwencja escape dla znaku c (maks. 6 bajtów), zwraca długość
+inline size_t writeEscape(unsigned char c, char* dst) {
+    dst[0] = '\\';
+    switch(c) {
+        case '"':  dst[1] = '"'; return 2;
+        case '\\': dst[1] = '\\'; return 2;
+        case '\b': dst[1] = 'b'; return 2;
+        case '\f': dst[1] = 'f'; return 2;
+        case '\n': dst[1] = 'n'; return 2;
+        case '\r': dst[1] = 'r'; return 2;
+        case '\t': dst[1] = 't'; return 2;
+        default:
+            dst[1] = 'u';
+            dst[2] = '0';
+            dst[3] = '0';
+            dst[4] = HEX_DIGITS[c >> 4];
+            dst[5] = HEX_DIGITS[c & 0x0F];
+            return 6;
+    }
+}
+
+inline int hexValue(char c) {
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 4 cyfry hex spod data (false gdy za krótko lub niepoprawne)
+bool parseHex4(const char* data, size_t available, uint32_t& value) {
+    if(available < 4) return false;
+    value = 0;
+    for(int k = 0; k < 4; ++k) {
+        int digit = hexValue(data[k]);
+        if(digit < 0) return false;
+        value = (value << 4) | static_cast<uint32_t>(digit);
+    }
+    return true;
+}
+
+inline size_t encodeUtf8(uint32_t cp, char* dst) {
+    if(cp < 0x80) {
+        dst[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if(cp < 0x800) {
+        dst[0] = static_cast<char>(0xC0 | (cp >> 6));
+        dst[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if(cp < 0x10000) {
+        dst[0] = static_cast<char>(0xE0 | (cp >> 12));
+        dst[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        dst[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    dst[0] = static_cast<char>(0xF0 | (cp >> 18));
+    dst[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    dst[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    dst[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+} // namespace
+
+SimdLevel getSimdLevel() {
+    return activeLevel.load(std::memory_order_relaxed);
+}
+
+void setSimdLevel(SimdLevel level) {
+    activeLevel.store(level > supportedLevel ? supportedLevel : level, std::memory_order_relaxed);
+}
+
+void appendEscaped(std::string& out, std::string_view str) {
+    const char* src = str.data();
+    const size_t size = str.size();
+
+    // Czyste fragmenty dopisujemy w całości (append rośnie geometrycznie -
+    // bufor wywołującego, np. JsonWriter, jest zwykle już zarezerwowany)
+    size_t i = 0;
+    while(i < size) {
+        const size_t run = scanForEscape(src + i, size - i);
+        out.append(src + i, run);
+        i += run;
+        if(i == size) break;
+
+        char sequence[6];
+        out.append(sequence, writeEscape(static_cast<unsigned char>(src[i]), sequence));
+        ++i;
+    }
+}
+
+std::string escape(std::string_view str) {
+    std::string result;
+    result.reserve(str.size() + str.size() / 8 + 16);  // Zapas na typowe escapowanie
+    appendEscaped(result, str);
+    return result;
+}
+
+std::string unescape(std::string_view str) {
+    const char* src = str.data();
+    const size_t size = str.size();
+
+    // Wynik nigdy nie jest dłuższy od wejścia (\uXXXX = 6 bajtów -> maks. 3 w UTF-8)
+    std::string result(size, '\0');
+    char* dst = &result[0];
+    size_t pos = 0;
+
+    size_t i = 0;
+    while(i < size) {
+        const void* hit = std::memchr(src + i, '\\', size - i);
+        const size_t run = hit ? static_cast<size_t>(static_cast<const char*>(hit) - (src + i)) : size - i;
+        std::memcpy(dst + pos, src + i, run);
+        pos += run;
+        i += run;
+        if(i >= size) break;
+
+        if(i + 1 >= size) {  // Samotny backslash na końcu
+            dst[pos++] = '\\';
+            break;
+        }
+
+        const char next = src[i + 1];
+        switch(next) {
+            case 'n': dst[pos++] = '\n'; i += 2; break;
+            case 'r': dst[pos++] = '\r'; i += 2; break;
+            case 't': dst[pos++] = '\t'; i += 2; break;
+            case 'b': dst[pos++] = '\b'; i += 2; break;
+            case 'f': dst[pos++] = '\f'; i += 2; break;
+            case '"':
+            case '\\':
+            case '/': dst[pos++] = next; i += 2; break;
+            case 'u': {
+                uint32_t cp;
+                if(!parseHex4(src + i + 2, size - i - 2, cp)) {
+                    dst[pos++] = src[i++];
+                    break;
+                }
+                size_t consumed = 6;
+                if(cp >= 0xD800 && cp <= 0xDBFF) {
+                    // Para surogatów: \uD83D\uDCAA -> jeden znak spoza BMP
+                    uint32_t low;
+                    if(i + 12 <= size && src[i + 6] == '\\' && src[i + 7] == 'u'
+                       && parseHex4(src + i + 8, 4, low) && low >= 0xDC00 && low <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        consumed = 12;
+                    } else {
+                        cp = 0xFFFD;  // Niesparowany surogat -> znak zastępczy
+                    }
+                } else if(cp >= 0xDC00 && cp <= 0xDFFF) {
+                    cp = 0xFFFD;
+                }
+                pos += encodeUtf8(cp, dst + pos);
+                i += consumed;
+                break;
+            }
+            default:
+                dst[pos++] = src[i++];  // Nieznana sekwencja - backslash zostaje
+                break;
+        }
+    }
+
+    result.resize(pos);
+    return result;
+}
+
+bool readFile(const std::string& filePath, std::string& content) {
+    std::ifstream file(filePath, std::ios::binary);
+    if(!file.is_open()) {
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    content.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    if(size > 0) {
+        file.read(&content[0], size);
+    }
+    return static_cast<bool>(file) || file.eof();
+}
+
+std::string temporaryPath(const std::string& filePath) {
+    return filePath + ".tmp";
+}
+
+bool replaceFile(const std::string& temporaryPath, const std::string& filePath) {
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, filePath, error);
+    if(error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+FileStamp fileStamp(const std::string& filePath) {
+    FileStamp stamp;
+    std::error_code error;
+    const auto modified = std::filesystem::last_write_time(filePath, error);
+    if(error) {
+        return stamp;
+    }
+    const auto size = std::filesystem::file_size(filePath, error);
+    if(error) {
+        return stamp;
+    }
+    stamp.exists = true;
+    stamp.modified = static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(modified.time_since_epoch()).count());
+    stamp.size = static_cast<uint64_t>(size);
+    return stamp;
+}
+
+} // namespace JsonUtils
@@ -0,0 +1,89 @@
+// JsonUtils.h
+// Lokalizacja: core/JsonUtils.h
+// Opis: Wspólne narzędzia dla prostego parsera JSON w repozytoriach
+
+#ifndef JSONUTILS_H
+#define JSONUTILS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace JsonUtils {
+
+// Zakres [first, second) w treści pliku
+using Range = std::pair<size_t, size_t>;
+
+// Podział treści na maks. maxChunks fragmentów o zbliżonej wielkości.
+// Granica zawsze wypada na początku linii zawierającej recordKey
+// (np. "\"name\""), więc każdy fragment zawiera całe rekordy
+// i może być parsowany niezależnie (równolegle).
+std::vector<Range> splitAtRecordLines(const std::string& content,
+                                      const std::string& recordKey,
+                                      size_t maxChunks);
+
+// Pozycja cudzysłowu zamykającego wartość zaczynającą się w from
+// (pomija escapowane \" wewnątrz tekstu); npos gdy brak
+size_t findClosingQuote(const std::string& line, size_t from);
+
+// === Escapowanie (szybka ścieżka SIMD) ===
+// Tekst bez znaków specjalnych kopiujemy blokami - skan 16 (SSE2) lub 32 (AVX2)
+// bajtów naraz szuka pierwszego znaku do escapowania. Wersja wybierana raz,
+// przy starcie, na podstawie możliwości procesora; poza x86-64 skan skalarny.
+
+enum class SimdLevel {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Aktualnie używany wariant skanu
+SimdLevel getSimdLevel();
+
+// Wymuszenie wariantu (testy/benchmarki) - ograniczane do wspieranego przez CPU
+void setSimdLevel(SimdLevel level);
+
+// Escapowanie tekstu do wartości JSON (bez otaczających cudzysłowów):
+// " \ \b \f \n \r \t, pozostałe znaki sterujące jako \u00XX
+std::string escape(std::string_view str);
+
+// Dopisanie escapowanego tekstu na koniec out (bez tymczasowych stringów)
+void appendEscaped(std::string& out, std::string_view str);
+
+// Odwrócenie escape() - surowa wartość spomiędzy cudzysłowów -> tekst.
+// Obsługuje też \/ oraz \uXXXX (z parami surogatów) -> UTF-8;
+// nieznane sekwencje zostają bez zmian.
+std::string unescape(std::string_view str);
+
+// Odczyt całego pliku do stringa (false gdy pliku nie da się otworzyć)
+bool readFile(const std::string& filePath, std::string& content);
+
+// Plik tymczasowy obok docelowego (ten sam katalog - rename nie kopiuje danych)
+std::string temporaryPath(const std::string& filePath);
+
+// Atomowa podmiana: rename zapisanego pliku tymczasowego na docelowy. Kto ma
+// otwarty stary plik, dalej czyta jego treść (stary i-węzeł, POSIX).
+// Przy błędzie plik tymczasowy jest usuwany, docelowy zostaje bez zmian.
+bool replaceFile(const std::string& temporaryPath, const std::string& filePath);
+
+// Stan pliku na dysku do wykrywania zmian z zewnątrz: czas modyfikacji
+// (nanosekundy, zależnie od systemu plików) i rozmiar
+struct FileStamp {
+    bool exists = false;
+    int64_t modified = 0;
+    uint64_t size = 0;
+
+    bool operator==(const FileStamp& other) const {
+        return exists == other.exists && modified == other.modified && size == other.size;
+    }
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+};
+
+// Bieżący stan pliku (exists == false, gdy go nie ma)
+FileStamp fileStamp(const std::string& filePath);
+
+} // namespace JsonUtils
+
+#endif // JSONUTILS_H
@@ -0,0 +1,164 @@
+// JsonWriter.cpp
+// Lokalizacja: core/JsonWriter.cpp
+
+#include "JsonWriter.h"
+#include "JsonUtils.h"
+#include <charconv>
+#include <cmath>
+
+JsonWriter::JsonWriter(Style style, size_t flushThreshold)
+    : style(style), flushThreshold(flushThreshold) {
+    buffer.reserve(flushThreshold + flushThreshold / 4);
+}
+
+JsonWriter::~JsonWriter() {
+    if(file) {
+        close();
+    }
+}
+
+bool JsonWriter::open(const std::string& path) {
+    if(file) {
+        close();
+    }
+    file = std::fopen(path.c_str(), "wb");  // Binarnie - offsety bez konwersji \r\n
+    if(!file) {
+        return false;
+    }
+    // Piszemy dużymi blokami - buforowanie stdio tylko by dublowało kopię
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    failed = false;
+    return true;
+}
+
+bool JsonWriter::close() {
+    if(!file) {
+        return false;
+    }
+    bool ok = flush();
+    ok = (std::fclose(file) == 0) && ok;
+    file = nullptr;
+    return ok && !failed;
+}
+
+bool JsonWriter::flush() {
+    if(!file || buffer.empty()) {
+        return !failed;
+    }
+    if(std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+        failed = true;
+    }
+    flushedBytes += buffer.size();
+    buffer.clear();  // Pojemność zostaje - bufor jest używany ponownie
+    return !failed;
+}
+
+void JsonWriter::newlineIndent(size_t depth) {
+    if(style == Style::COMPACT) {
+        return;
+    }
+    buffer += '\n';
+    buffer.append(depth * 2, ' ');
+}
+
+void JsonWriter::beforeValue() {
+    if(afterKey) {
+        afterKey = false;
+        return;
+    }
+    if(!stack.empty()) {
+        if(stack.back().count++ > 0) {
+            buffer += ',';
+        }
+        newlineIndent(stack.size());
+    }
+}
+
+void JsonWriter::afterValue() {
+    if(stack.empty() && style == Style::PRETTY) {
+        buffer += '\n';
+    }
+    if(file && buffer.size() >= flushThreshold) {
+        flush();
+    }
+}
+
+void JsonWriter::beginObject() {
+    beforeValue();
+    buffer += '{';
+    stack.push_back(Frame{});
+}
+
+void JsonWriter::beginArray() {
+    beforeValue();
+    buffer += '[';
+    stack.push_back(Frame{});
+}
+
+void JsonWriter::closeContainer(char bracket) {
+    stack.pop_back();
+    // Pusty kontener w PRETTY też zamykamy w nowej linii - tego oczekują parsery liniowe
+    newlineIndent(stack.size());
+    buffer += bracket;
+    afterValue();
+}
+
+void JsonWriter::endObject() {
+    closeContainer('}');
+}
+
+void JsonWriter::endArray() {
+    closeContainer(']');
+}
+
+void JsonWriter::key(std::string_view name) {
+    if(stack.back().count++ > 0) {
+        buffer += ',';
+    }
+    newlineIndent(stack.size());
+    buffer += '"';
+    JsonUtils::appendEscaped(buffer, name);
+    buffer += (style == Style::PRETTY) ? "\": " : "\":";
+    afterKey = true;
+}
+
+void JsonWriter::value(std::string_view str) {
+    beforeValue();
+    buffer += '"';
+    JsonUtils::appendEscaped(buffer, str);
+    buffer += '"';
+    afterValue();
+}
+
+void JsonWriter::rawString(std::string_view escaped) {
+    beforeValue();
+    buffer += '"';
+    buffer.append(escaped.data(), escaped.size());
+    buffer += '"';
+    afterValue();
+}
+
+void JsonWriter::value(bool flag) {
+    beforeValue();
+    buffer += flag ? "true" : "false";
+    afterValue();
+}
+
+void JsonWriter::appendInteger(long long number) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    buffer.append(digits, result.ptr);
+}
+
+void JsonWriter::value(double number) {
+    beforeValue();
+    if(!std::isfinite(number)) {
+        buffer += '0';  // JSON nie ma NaN/Inf, a parsery repozytoriów oczekują liczby
+    } else {
+        // Bez precyzji to_chars daje najkrótszy zapis, który wczytany daje tę samą liczbę
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number);
+        buffer.append(digits, result.ptr);
+    }
+    afterValue();
+}
@@ -0,0 +1,104 @@
+// JsonWriter.h
+// Lokalizacja: core/JsonWriter.h
+// Opis: Buforowany zapis JSON - wspólny dla repozytoriów. Wszystko formatujemy
+//       do jednego dużego bufora (liczby przez std::to_chars, bez locale iostream),
+//       a do pliku trafia kilka dużych bloków zamiast tysięcy drobnych <<.
+
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+class JsonWriter {
+public:
+    enum class Style {
+        PRETTY,   // Klucz w osobnej linii, wcięcia 2 spacje (format czytany przez parsery repozytoriów)
+        COMPACT   // Bez białych znaków (eksport, mniejsze pliki)
+    };
+
+    // Próg opróżniania bufora do otwartego pliku
+    static constexpr size_t DEFAULT_FLUSH_THRESHOLD = 1 << 20;
+
+    explicit JsonWriter(Style style = Style::PRETTY,
+                        size_t flushThreshold = DEFAULT_FLUSH_THRESHOLD);
+    ~JsonWriter();
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    // Strumieniowy zapis do pliku (bufor opróżniany po przekroczeniu progu).
+    // Bez open() całość zostaje w buforze - można ją zapisać później (open + close).
+    bool open(const std::string& path);
+
+    // Zapis reszty bufora i zamknięcie pliku; false przy błędzie zapisu
+    bool close();
+
+    // === Struktura ===
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    // Klucz w bieżącym obiekcie - następne wywołanie value/begin* to jego wartość
+    void key(std::string_view name);
+
+    // === Wartości ===
+    void value(std::string_view str);   // Escapowany string
+    void value(const char* str) { value(std::string_view(str)); }
+    void value(bool flag);
+    void value(double number);          // Najkrótsza reprezentacja odtwarzająca liczbę
+
+    template<typename T, typename std::enable_if<std::is_integral<T>::value &&
+                                                 !std::is_same<T, bool>::value, int>::type = 0>
+    void value(T number) {
+        beforeValue();
+        appendInteger(static_cast<long long>(number));
+        afterValue();
+    }
+
+    // String już w postaci JSON (escapowany, np. base64 lub surowy fragment pliku)
+    void rawString(std::string_view escaped);
+
+    // Wygodne skróty: key + value
+    template<typename T>
+    void field(std::string_view name, const T& v) {
+        key(name);
+        value(v);
+    }
+
+    // Pozycja (w bajtach całego wyjścia) następnego zapisanego znaku -
+    // np. offset wartości stringa zaraz po jej otwierającym cudzysłowie
+    uint64_t getOffset() const { return flushedBytes + buffer.size(); }
+
+    // Niewypisana do pliku część wyjścia (całość, gdy plik nie był otwarty)
+    const std::string& getBuffer() const { return buffer; }
+
+private:
+    // Kontekst zagnieżdżenia: liczba elementów już zapisanych
+    struct Frame {
+        size_t count = 0;
+    };
+
+    Style style;
+    size_t flushThreshold;
+    std::string buffer;
+    std::vector<Frame> stack;
+    bool afterKey = false;
+    std::FILE* file = nullptr;
+    uint64_t flushedBytes = 0;
+    bool failed = false;
+
+    void beforeValue();
+    void afterValue();
+    void newlineIndent(size_t depth);
+    void appendInteger(long long number);
+    void closeContainer(char bracket);
+    bool flush();
+};
+
+#endif // JSONWRITER_H
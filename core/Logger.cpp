@@ -0,0 +1,74 @@
+// Logger.cpp
+// Lokalizacja: core/Logger.cpp
+
+#include "Logger.h"
+#include <iostream>
+
+void ConsoleLogSink::write(const LogRecord& record) {
+    std::ostream& out = (record.level >= LogLevel::WARNING) ? std::cerr : std::cout;
+
+    out << '[' << record.component << "] ";
+    if(record.level >= LogLevel::WARNING) {
+        out << Logger::levelToString(record.level) << ": ";
+    }
+    out << record.message;
+    for(const auto& field : record.fields) {
+        out << ' ' << field.first << '=' << field.second;
+    }
+    out << '\n';
+}
+
+void ConsoleLogSink::flush() {
+    std::cout.flush();
+    std::cerr.flush();
+}
+
+Logger::Logger()
+    : sink(std::make_shared<ConsoleLogSink>()) {
+}
+
+void Logger::setSink(std::shared_ptr<LogSink> newSink) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(sink) sink->flush();
+    sink = std::move(newSink);
+}
+
+void Logger::setMinLevel(LogLevel level) {
+    std::lock_guard<std::mutex> lock(mutex);
+    minLevel = level;
+}
+
+LogLevel Logger::getMinLevel() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return minLevel;
+}
+
+void Logger::log(LogLevel level, const std::string& component,
+                 const std::string& message, Fields fields) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!sink || level < minLevel) return;
+
+    LogRecord record;
+    record.level = level;
+    record.component = component;
+    record.message = message;
+    record.fields = std::move(fields);
+    record.timestamp = std::chrono::system_clock::now();
+
+    sink->write(record);
+}
+
+void Logger::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(sink) sink->flush();
+}
+
+const char* Logger::levelToString(LogLevel level) {
+    switch(level) {
+    case LogLevel::VERBOSE: return "VERBOSE";
+    case LogLevel::INFO: return "INFO";
+    case LogLevel::WARNING: return "WARNING";
+    case LogLevel::FAILURE: return "ERROR";
+    default: return "UNKNOWN";
+    }
+}
@@ -0,0 +1,96 @@
+// Logger.h
+// Lokalizacja: core/Logger.h
+// Opis: Strukturalne logowanie - jeden punkt wyjścia dla komunikatów z core
+// Design Pattern: Singleton Pattern, Strategy Pattern (wymienny sink)
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Poziom ważności komunikatu
+enum class LogLevel {
+    VERBOSE,   // Szczegóły diagnostyczne
+    INFO,
+    WARNING,
+    FAILURE    // Błąd (nie ERROR - koliduje z makrem z <windows.h>)
+};
+
+// Pojedynczy wpis logu: komponent + treść + pola klucz=wartość
+struct LogRecord {
+    LogLevel level = LogLevel::INFO;
+    std::string component;                                   // np. "DatabaseManager"
+    std::string message;                                     // Treść komunikatu
+    std::vector<std::pair<std::string, std::string>> fields; // Dodatkowe dane (count=5, path=...)
+    std::chrono::system_clock::time_point timestamp;
+};
+
+// Interfejs ujścia logów (Strategy Pattern) - konsola, plik, GUI...
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+    virtual void write(const LogRecord& record) = 0;
+    virtual void flush() {}
+};
+
+// Domyślny sink: VERBOSE/INFO na stdout, WARNING/FAILURE na stderr.
+// Nie wymusza flush po każdej linii (w przeciwieństwie do std::endl).
+class ConsoleLogSink : public LogSink {
+public:
+    void write(const LogRecord& record) override;
+    void flush() override;
+};
+
+class Logger {
+private:
+    Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    std::shared_ptr<LogSink> sink;
+    LogLevel minLevel = LogLevel::INFO;
+    mutable std::mutex mutex;
+
+public:
+    using Fields = std::vector<std::pair<std::string, std::string>>;
+
+    static Logger& getInstance() {
+        static Logger instance;
+        return instance;
+    }
+
+    // Podmiana ujścia logów (nullptr = wyciszenie)
+    void setSink(std::shared_ptr<LogSink> newSink);
+
+    void setMinLevel(LogLevel level);
+    LogLevel getMinLevel() const;
+
+    void log(LogLevel level, const std::string& component,
+             const std::string& message, Fields fields = {});
+
+    void flush();
+
+    // Skróty
+    static void debug(const std::string& component, const std::string& message, Fields fields = {}) {
+        getInstance().log(LogLevel::VERBOSE, component, message, std::move(fields));
+    }
+    static void info(const std::string& component, const std::string& message, Fields fields = {}) {
+        getInstance().log(LogLevel::INFO, component, message, std::move(fields));
+    }
+    static void warning(const std::string& component, const std::string& message, Fields fields = {}) {
+        getInstance().log(LogLevel::WARNING, component, message, std::move(fields));
+    }
+    static void error(const std::string& component, const std::string& message, Fields fields = {}) {
+        getInstance().log(LogLevel::FAILURE, component, message, std::move(fields));
+    }
+
+    static const char* levelToString(LogLevel level);
+};
+
+#endif // LOGGER_H
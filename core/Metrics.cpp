@@ -0,0 +1,262 @@
+// Metrics.cpp
+// Lokalizacja: core/Metrics.cpp
+
+#include "Metrics.h"
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+// Nazwa z etykietą jako klucz JSON - cudzysłowy i ukośniki z escape
+std::string jsonKey(const std::string& name) {
+    std::string key;
+    for(char c : name) {
+        if(c == '\\' || c == '"') {
+            key += '\\';
+        }
+        key += c;
+    }
+    return key;
+}
+
+// Nazwa rodziny metryki - klucz bez części {etykiety}
+std::string familyName(const std::string& key) {
+    return key.substr(0, key.find('{'));
+}
+
+// Serie pogrupowane po rodzinie. Klucz z etykietami to cały napis
+// name{label="value"}, więc serie jednej rodziny nie muszą sąsiadować
+// w mapie - inna metryka (np. name_total) może się wcisnąć pomiędzy.
+template<typename Series>
+std::map<std::string, std::vector<const typename Series::value_type*>>
+groupByFamily(const Series& series) {
+    std::map<std::string, std::vector<const typename Series::value_type*>> families;
+    for(const auto& entry : series) {
+        families[familyName(entry.first)].push_back(&entry);
+    }
+    return families;
+}
+
+} // namespace
+
+// === LatencyHistogram ===
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t micros) {
+    if(micros < SUB_BUCKETS) {
+        return static_cast<size_t>(micros);  // Małe wartości - kubełki dokładne
+    }
+
+    // Pozycja najstarszego bitu (wykładnik potęgi dwójki)
+    int exponent = 63;
+    while(!(micros & (uint64_t(1) << exponent))) {
+        --exponent;
+    }
+
+    int shift = exponent - SUB_BUCKET_BITS;
+    uint64_t sub = (micros >> shift) - SUB_BUCKETS;  // 0..15 w obrębie potęgi
+    return static_cast<size_t>(SUB_BUCKETS + shift * SUB_BUCKETS + sub);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if(index < SUB_BUCKETS) {
+        return index;
+    }
+
+    size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    uint64_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return ((SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+    buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(micros, std::memory_order_relaxed);
+
+    uint64_t previous = max.load(std::memory_order_relaxed);
+    while(micros > previous &&
+          !max.compare_exchange_weak(previous, micros, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    uint64_t total = getCount();
+    if(total == 0) return 0;
+
+    if(q < 0.0) q = 0.0;
+    if(q > 1.0) q = 1.0;
+
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total));
+    if(rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for(size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += bucketCount(i);
+        if(seen >= rank) {
+            uint64_t bound = bucketUpperBound(i);
+            uint64_t maxValue = getMax();
+            return bound < maxValue ? bound : maxValue;
+        }
+    }
+    return getMax();
+}
+
+void LatencyHistogram::reset() {
+    for(auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+// === MetricsRegistry ===
+
+Counter& MetricsRegistry::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = counters[name];
+    if(!slot) slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = gauges[name];
+    if(!slot) slot = std::make_unique<Gauge>();
+    return *slot;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = histograms[name];
+    if(!slot) slot = std::make_unique<LatencyHistogram>();
+    return *slot;
+}
+
+std::string MetricsRegistry::labeled(const std::string& name, const std::string& label, const std::string& value) {
+    std::string result = name + '{' + label + "=\"";
+    for(char c : value) {
+        if(c == '\\' || c == '"') {
+            result += '\\';
+            result += c;
+        } else if(c == '\n') {
+            result += "\\n";
+        } else {
+            result += c;
+        }
+    }
+    return result + "\"}";
+}
+
+void MetricsRegistry::resetAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for(auto& entry : counters) entry.second->reset();
+    for(auto& entry : histograms) entry.second->reset();
+}
+
+std::string MetricsRegistry::toPrometheusText() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+
+    // Jeden nagłówek # TYPE na rodzinę, pod nim wszystkie jej serie
+    for(const auto& family : groupByFamily(counters)) {
+        out << "# TYPE " << family.first << " counter\n";
+        for(const auto* entry : family.second) {
+            out << entry->first << ' ' << entry->second->get() << '\n';
+        }
+    }
+
+    for(const auto& family : groupByFamily(gauges)) {
+        out << "# TYPE " << family.first << " gauge\n";
+        for(const auto* entry : family.second) {
+            out << entry->first << ' ' << entry->second->get() << '\n';
+        }
+    }
+
+    for(const auto& family : groupByFamily(histograms)) {
+        const std::string& name = family.first;
+        out << "# TYPE " << name << " histogram\n";
+
+        for(const auto* entry : family.second) {
+            const LatencyHistogram& h = *entry->second;
+            // Etykiety serii trafiają do każdej linii, le dołączane na końcu
+            const size_t brace = entry->first.find('{');
+            const std::string labels = brace == std::string::npos
+                ? std::string()
+                : entry->first.substr(brace + 1, entry->first.size() - brace - 2);
+            const std::string bucketPrefix = labels.empty() ? "{" : "{" + labels + ",";
+            const std::string suffix = labels.empty() ? "" : "{" + labels + "}";
+
+            // Tylko niepuste kubełki - wartości skumulowane, jak wymaga format
+            uint64_t cumulative = 0;
+            for(size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+                uint64_t c = h.bucketCount(i);
+                if(c == 0) continue;
+                cumulative += c;
+                out << name << "_bucket" << bucketPrefix << "le=\""
+                    << LatencyHistogram::bucketUpperBound(i) << "\"} " << cumulative << '\n';
+            }
+            out << name << "_bucket" << bucketPrefix << "le=\"+Inf\"} " << h.getCount() << '\n';
+            out << name << "_sum" << suffix << ' ' << h.getSum() << '\n';
+            out << name << "_count" << suffix << ' ' << h.getCount() << '\n';
+        }
+    }
+
+    return out.str();
+}
+
+std::string MetricsRegistry::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+
+    out << "{\n  \"counters\": {";
+    bool first = true;
+    for(const auto& entry : counters) {
+        out << (first ? "\n" : ",\n") << "    \"" << entry.first << "\": " << entry.second->get();
+        first = false;
+    }
+
+    out << "\n  },\n  \"gauges\": {";
+    first = true;
+    for(const auto& entry : gauges) {
+        out << (first ? "\n" : ",\n") << "    \"" << jsonKey(entry.first) << "\": " << entry.second->get();
+        first = false;
+    }
+
+    out << "\n  },\n  \"histograms\": {";
+    first = true;
+    for(const auto& entry : histograms) {
+        const LatencyHistogram& h = *entry.second;
+        out << (first ? "\n" : ",\n") << "    \"" << entry.first << "\": {"
+            << "\"count\": " << h.getCount()
+            << ", \"sumUs\": " << h.getSum()
+            << ", \"maxUs\": " << h.getMax()
+            << ", \"p50Us\": " << h.percentile(0.50)
+            << ", \"p90Us\": " << h.percentile(0.90)
+            << ", \"p99Us\": " << h.percentile(0.99)
+            << "}";
+        first = false;
+    }
+    out << "\n  }\n}\n";
+
+    return out.str();
+}
+
+bool MetricsRegistry::writePrometheusFile(const std::string& filePath) const {
+    std::ofstream file(filePath, std::ios::binary);
+    if(!file.is_open()) return false;
+    file << toPrometheusText();
+    return static_cast<bool>(file);
+}
+
+bool MetricsRegistry::writeJsonFile(const std::string& filePath) const {
+    std::ofstream file(filePath, std::ios::binary);
+    if(!file.is_open()) return false;
+    file << toJson();
+    return static_cast<bool>(file);
+}
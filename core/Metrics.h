@@ -0,0 +1,141 @@
+// Metrics.h
+// Lokalizacja: core/Metrics.h
+// Opis: Metryki działania aplikacji - liczniki, gauge'e i histogramy opóźnień
+//       (log-liniowe kubełki w stylu HDR), eksport Prometheus text / JSON
+// Design Pattern: Singleton Pattern, Registry Pattern, RAII (ScopedLatency)
+//
+// Aktualizacja metryk jest lock-free (std::atomic, memory_order_relaxed).
+// Mutex chroni wyłącznie rejestrację nowych metryk - dlatego wywołujący
+// powinien trzymać referencję w zmiennej statycznej:
+//     static Counter& calls = MetricsRegistry::getInstance().counter("...");
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Licznik monotoniczny (np. liczba wywołań findByName)
+class Counter {
+private:
+    std::atomic<uint64_t> value{0};
+
+public:
+    void increment(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+    void reset() { value.store(0, std::memory_order_relaxed); }
+};
+
+// Wartość chwilowa (np. liczba ćwiczeń w katalogu, zajęta pamięć)
+class Gauge {
+private:
+    std::atomic<int64_t> value{0};
+
+public:
+    void set(int64_t v) { value.store(v, std::memory_order_relaxed); }
+    void add(int64_t delta) { value.fetch_add(delta, std::memory_order_relaxed); }
+    int64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// Histogram opóźnień w mikrosekundach.
+// Kubełki log-liniowe: każda potęga dwójki podzielona na 16 równych części,
+// więc błąd względny percentyla to maks. ~6% przy stałej pamięci (8 KB).
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr uint64_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+
+public:
+    LatencyHistogram();
+
+    void record(uint64_t micros);
+
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    uint64_t getSum() const { return sum.load(std::memory_order_relaxed); }
+    uint64_t getMax() const { return max.load(std::memory_order_relaxed); }
+
+    // Wartość percentyla (q w zakresie 0.0 - 1.0), górna granica kubełka
+    uint64_t percentile(double q) const;
+
+    uint64_t bucketCount(size_t index) const { return buckets[index].load(std::memory_order_relaxed); }
+
+    void reset();
+
+    // Mapowanie wartość <-> kubełek
+    static size_t bucketIndex(uint64_t micros);
+    static uint64_t bucketUpperBound(size_t index);
+};
+
+// Centralny rejestr metryk - metryki żyją do końca procesu (stabilne adresy)
+class MetricsRegistry {
+private:
+    MetricsRegistry() = default;
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<Gauge>> gauges;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms;
+    mutable std::mutex mutex;
+
+public:
+    static MetricsRegistry& getInstance() {
+        static MetricsRegistry instance;
+        return instance;
+    }
+
+    // Pobranie (lub utworzenie przy pierwszym użyciu) metryki o danej nazwie
+    Counter& counter(const std::string& name);
+    Gauge& gauge(const std::string& name);
+    LatencyHistogram& histogram(const std::string& name);
+
+    // Nazwa serii z etykietą: name{label="value"}. Gauge'e stanu instancji
+    // (liczba ćwiczeń, pamięć) dostają etykietę pliku/katalogu danych, żeby
+    // kilka baz w jednym procesie nie nadpisywało sobie wartości.
+    static std::string labeled(const std::string& name, const std::string& label, const std::string& value);
+
+    // Wyzerowanie liczników i histogramów (gauge'e zostają)
+    void resetAll();
+
+    // Eksport
+    std::string toPrometheusText() const;
+    std::string toJson() const;
+    bool writePrometheusFile(const std::string& filePath) const;
+    bool writeJsonFile(const std::string& filePath) const;
+};
+
+// RAII - mierzy czas życia obiektu i zapisuje go do histogramu
+class ScopedLatency {
+private:
+    LatencyHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedLatency(LatencyHistogram& target)
+        : histogram(target), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedLatency() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        histogram.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+};
+
+#endif // METRICS_H
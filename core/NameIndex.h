@@ -0,0 +1,98 @@
+// NameIndex.h
+// Lokalizacja: core/NameIndex.h
+// Opis: Indeks nazwa -> obiekt podzielony na shardy, każdy z własnym
+//       std::shared_mutex. Wyszukiwania w różnych shardach nie rywalizują
+//       o jedną blokadę, a zapis blokuje tylko jeden shard.
+//
+// Wątki: wszystkie metody bezpieczne wielowątkowo. Sprawdzenie "czy istnieje"
+// i wstawienie nie są jedną operacją - repozytorium serializuje pisarzy
+// własną blokadą, indeks chroni jedynie czytelników. Nazwa, która przeżywa
+// zmianę, nie może zniknąć z indeksu nawet na chwilę: podmiana przez assign(),
+// zmiana nazwy = najpierw nowy klucz, potem usunięcie starego.
+
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+template<typename T>
+class NameIndex {
+public:
+    static constexpr size_t SHARD_COUNT = 16;
+
+private:
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<T>> items;
+    };
+
+    std::array<Shard, SHARD_COUNT> shards;
+
+    Shard& shardFor(const std::string& name) {
+        return shards[std::hash<std::string>{}(name) % SHARD_COUNT];
+    }
+    const Shard& shardFor(const std::string& name) const {
+        return shards[std::hash<std::string>{}(name) % SHARD_COUNT];
+    }
+
+public:
+    std::shared_ptr<T> find(const std::string& name) const {
+        const Shard& shard = shardFor(name);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.items.find(name);
+        return it != shard.items.end() ? it->second : nullptr;
+    }
+
+    // Wstawienie, jeśli nazwa jest wolna (false = już istnieje, bez zmian)
+    bool insert(const std::string& name, std::shared_ptr<T> item) {
+        Shard& shard = shardFor(name);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.items.emplace(name, std::move(item)).second;
+    }
+
+    // Wstawienie albo podmiana pod jedną blokadą shardu - czytelnik widzi
+    // stary albo nowy obiekt, nigdy brak (aktualizacja w miejscu)
+    void assign(const std::string& name, std::shared_ptr<T> item) {
+        Shard& shard = shardFor(name);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.items[name] = std::move(item);
+    }
+
+    bool erase(const std::string& name) {
+        Shard& shard = shardFor(name);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.items.erase(name) > 0;
+    }
+
+    void clear() {
+        for(auto& shard : shards) {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            shard.items.clear();
+        }
+    }
+
+    // Odbudowa z listy - przy powtórzonych nazwach wygrywa pierwsza (jak find_if).
+    // Shardy budowane obok i podmieniane pojedynczo - nazwa obecna przed i po
+    // odbudowie jest cały czas widoczna dla czytelników.
+    template<typename Ptr>
+    void rebuild(const std::vector<Ptr>& items) {
+        std::array<std::unordered_map<std::string, std::shared_ptr<T>>, SHARD_COUNT> built;
+        for(const auto& item : items) {
+            const std::string& name = item->getName();
+            built[std::hash<std::string>{}(name) % SHARD_COUNT].emplace(name, item);
+        }
+        for(size_t i = 0; i < SHARD_COUNT; ++i) {
+            std::unique_lock<std::shared_mutex> lock(shards[i].mutex);
+            shards[i].items.swap(built[i]);
+        }
+    }
+};
+
+#endif // NAMEINDEX_H
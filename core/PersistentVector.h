@@ -0,0 +1,193 @@
+// PersistentVector.h
+// Lokalizacja: core/PersistentVector.h
+// Opis: Wektor ze współdzieleniem struktury (structural sharing) dla snapshotów MVCC.
+//       Elementy leżą w blokach po CHUNK_SIZE; kopia wektora kopiuje tylko "kręgosłup"
+//       (wskaźniki na bloki), a zmiana elementu kopiuje jeden blok - i to tylko wtedy,
+//       gdy blok jest współdzielony z opublikowaną wersją.
+//
+// Wątki: wersja opublikowana (kopia) jest niezmienna i może być czytana z wielu
+// wątków naraz. Metody modyfikujące wolno wołać tylko w wątku właściciela kopii.
+
+#ifndef PERSISTENTVECTOR_H
+#define PERSISTENTVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+// ChunkSize: mniejsze bloki = tańsza pierwsza zmiana kopii, większe = mniej wskaźników
+template<typename T, size_t ChunkSize = 64>
+class PersistentVector {
+public:
+    static constexpr size_t CHUNK_SIZE = ChunkSize;
+
+private:
+    using Chunk = std::vector<T>;
+
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    std::vector<size_t> ends;   // ends[k] = liczba elementów w blokach 0..k
+
+    // Blok i pozycja w bloku dla indeksu i (wyszukiwanie binarne po ends)
+    std::pair<size_t, size_t> locate(size_t i) const {
+        size_t k = static_cast<size_t>(std::upper_bound(ends.begin(), ends.end(), i) - ends.begin());
+        return {k, i - (k > 0 ? ends[k - 1] : 0)};
+    }
+
+    // Blok k do zapisu - kopia, jeśli współdzieli go inna wersja
+    Chunk& writableChunk(size_t k) {
+        if(chunks[k].use_count() > 1) {
+            chunks[k] = std::make_shared<Chunk>(*chunks[k]);
+        }
+        return *chunks[k];
+    }
+
+public:
+    PersistentVector() = default;
+
+    explicit PersistentVector(const std::vector<T>& items) {
+        chunks.reserve((items.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+        ends.reserve(chunks.capacity());
+        for(size_t start = 0; start < items.size(); start += CHUNK_SIZE) {
+            size_t end = std::min(items.size(), start + CHUNK_SIZE);
+            chunks.push_back(std::make_shared<Chunk>(items.begin() + start, items.begin() + end));
+            ends.push_back(end);
+        }
+    }
+
+    size_t size() const { return ends.empty() ? 0 : ends.back(); }
+    bool empty() const { return size() == 0; }
+
+    const T& operator[](size_t i) const {
+        auto pos = locate(i);
+        return (*chunks[pos.first])[pos.second];
+    }
+
+    // === Modyfikacje (kopiują co najwyżej jeden blok) ===
+    // insert/erase: O(CHUNK_SIZE) w bloku + O(liczba bloków) na sumy ends za nim
+
+    void pushBack(T value) {
+        if(chunks.empty() || chunks.back()->size() >= CHUNK_SIZE) {
+            chunks.push_back(std::make_shared<Chunk>());
+            chunks.back()->reserve(CHUNK_SIZE);
+            ends.push_back(size());
+        }
+        writableChunk(chunks.size() - 1).push_back(std::move(value));
+        ++ends.back();
+    }
+
+    void set(size_t i, T value) {
+        auto pos = locate(i);
+        writableChunk(pos.first)[pos.second] = std::move(value);
+    }
+
+    // Wstawienie przed pozycją i (i == size() = na koniec); przepełniony blok dzielimy na pół
+    void insert(size_t i, T value) {
+        if(i >= size()) {
+            pushBack(std::move(value));
+            return;
+        }
+        auto pos = locate(i);
+        Chunk& chunk = writableChunk(pos.first);
+        chunk.insert(chunk.begin() + static_cast<std::ptrdiff_t>(pos.second), std::move(value));
+        for(size_t k = pos.first; k < ends.size(); ++k) {
+            ++ends[k];
+        }
+        if(chunk.size() > 2 * CHUNK_SIZE) {
+            const auto middle = chunk.begin() + static_cast<std::ptrdiff_t>(chunk.size() / 2);
+            auto tail = std::make_shared<Chunk>(middle, chunk.end());
+            chunk.erase(middle, chunk.end());
+            const size_t k = pos.first;
+            ends.insert(ends.begin() + static_cast<std::ptrdiff_t>(k), ends[k] - tail->size());
+            chunks.insert(chunks.begin() + static_cast<std::ptrdiff_t>(k) + 1, std::move(tail));
+        }
+    }
+
+    void erase(size_t i) {
+        auto pos = locate(i);
+        Chunk& chunk = writableChunk(pos.first);
+        chunk.erase(chunk.begin() + static_cast<std::ptrdiff_t>(pos.second));
+        for(size_t k = pos.first; k < ends.size(); ++k) {
+            --ends[k];
+        }
+        if(chunk.empty()) {
+            chunks.erase(chunks.begin() + static_cast<std::ptrdiff_t>(pos.first));
+            ends.erase(ends.begin() + static_cast<std::ptrdiff_t>(pos.first));
+        }
+    }
+
+    void clear() {
+        chunks.clear();
+        ends.clear();
+    }
+
+    // Czy element i leży w tym samym bloku fizycznym co element i w other
+    // (blok współdzielony między wersjami - zmiana jednej nie kopiowała go)
+    bool sharesChunkWith(const PersistentVector& other, size_t i) const {
+        if(i >= size() || i >= other.size()) {
+            return false;
+        }
+        return chunks[locate(i).first] == other.chunks[other.locate(i).first];
+    }
+
+    // Liczba bloków (pamięć: bloki współdzielone liczą się raz dla wszystkich wersji)
+    size_t chunkCount() const { return chunks.size(); }
+
+    // === Iteracja (tylko odczyt) ===
+
+    class const_iterator {
+    private:
+        const PersistentVector* owner = nullptr;
+        size_t chunk = 0;
+        size_t offset = 0;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+        const_iterator(const PersistentVector* owner, size_t chunk)
+            : owner(owner), chunk(chunk) {}
+
+        reference operator*() const { return (*owner->chunks[chunk])[offset]; }
+        pointer operator->() const { return &**this; }
+
+        const_iterator& operator++() {
+            if(++offset >= owner->chunks[chunk]->size()) {
+                ++chunk;
+                offset = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return chunk == other.chunk && offset == other.offset;
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, chunks.size()); }
+
+    // Kopia do zwykłego wektora (np. dla API zwracającego std::vector)
+    std::vector<T> toVector() const {
+        std::vector<T> result;
+        result.reserve(size());
+        for(const auto& chunk : chunks) {
+            result.insert(result.end(), chunk->begin(), chunk->end());
+        }
+        return result;
+    }
+};
+
+#endif // PERSISTENTVECTOR_H
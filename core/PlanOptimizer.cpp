@@ -0,0 +1,445 @@
+// PlanOptimizer.cpp
+// Lokalizacja: core/PlanOptimizer.cpp
+
+#include "PlanOptimizer.h"
+#include "FuzzyIndex.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PlanOptimizerMetrics {
+    LatencyHistogram& latency = MetricsRegistry::getInstance().histogram("pumpapp_optimizer_latency_us");
+    Counter& statesEvaluated = MetricsRegistry::getInstance().counter("pumpapp_optimizer_states_total");
+};
+
+PlanOptimizerMetrics& metrics() {
+    static PlanOptimizerMetrics instance;
+    return instance;
+}
+
+constexpr float SECONDARY_MUSCLE_WEIGHT = 0.5f;   // Mięsień pomocniczy = pół serii
+constexpr size_t LOCAL_SEARCH_STALL = 4000;       // Ruchy bez poprawy przed końcem wątku
+
+// Ćwiczenie z katalogu z wkładem w cele (tylko mięśnie, które mają cel)
+struct Candidate {
+    std::shared_ptr<Exercise> exercise;
+    std::vector<std::pair<uint16_t, float>> contributions;   // (cel, waga serii)
+};
+
+struct Item {
+    uint32_t candidate = 0;
+    int sets = 0;
+};
+
+struct State {
+    std::vector<Item> items;
+    std::vector<float> volume;   // Serie na cel
+    int duration = 0;
+    double cost = 0.0;
+    uint64_t hash = 0;           // Suma skrótów elementów - niezależna od kolejności
+};
+
+// Dziecko stanu z beamu - materializowane dopiero po selekcji
+struct Child {
+    uint32_t parent = 0;
+    Item item;
+    double cost = 0.0;
+    int duration = 0;
+    uint64_t hash = 0;
+};
+
+uint64_t itemHash(const Item& item) {
+    uint64_t x = (uint64_t(item.candidate) << 8) ^ uint64_t(item.sets);
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+class Problem {
+public:
+    const OptimizerConstraints& constraints;
+    std::vector<Candidate> candidates;
+    std::vector<float> targets;
+
+    Problem(const std::vector<std::shared_ptr<Exercise>>& catalog, const OptimizerConstraints& c,
+            size_t maxCandidates, Clock::time_point deadline)
+        : constraints(c) {
+        std::vector<std::string> targetNames;
+        for(const auto& target : c.muscleTargets) {
+            if(target.sets <= 0) {
+                continue;
+            }
+            targetNames.push_back(FuzzyIndex::normalize(target.muscle));
+            targets.push_back(static_cast<float>(target.sets));
+        }
+        if(targets.empty()) {
+            throw std::invalid_argument("Optymalizator wymaga co najmniej jednego celu objętości!");
+        }
+
+        // Przegląd krokiem względnie pierwszym z rozmiarem katalogu - przerwany
+        // (limit kandydatów albo budżet czasu) daje równomierną próbkę, a nie
+        // początek katalogu. Bez żadnego kandydata przegląd trwa do końca.
+        const size_t count = catalog.size();
+        size_t step = 1;
+        if(count > maxCandidates) {
+            step = std::max<size_t>(1, static_cast<size_t>(static_cast<double>(count) * 0.6180339887));
+            while(std::gcd(step, count) != 1) {
+                ++step;
+            }
+        }
+        size_t index = 0;
+        for(size_t visited = 0; visited < count; ++visited, index = (index + step) % count) {
+            if(!candidates.empty() && (candidates.size() >= maxCandidates
+                                       || (visited % 256 == 0 && Clock::now() >= deadline))) {
+                break;
+            }
+            const auto& exercise = catalog[index];
+            if(!exercise || (c.type && exercise->getType() != *c.type)) {
+                continue;
+            }
+            Candidate candidate;
+            candidate.exercise = exercise;
+            auto muscles = PlanOptimizer::parseMuscles(exercise->getTargetMuscles());
+            for(size_t m = 0; m < muscles.size(); ++m) {
+                auto found = std::find(targetNames.begin(), targetNames.end(), muscles[m]);
+                if(found != targetNames.end()) {
+                    candidate.contributions.emplace_back(static_cast<uint16_t>(found - targetNames.begin()),
+                                                         m == 0 ? 1.0f : SECONDARY_MUSCLE_WEIGHT);
+                }
+            }
+            if(!candidate.contributions.empty()) {
+                candidates.push_back(std::move(candidate));
+            }
+        }
+    }
+
+    int duration(int sets) const {
+        return PlanOptimizer::entryDuration(sets, constraints.reps, constraints.restTime, constraints);
+    }
+
+    double deviation(size_t target, float volume) const {
+        return std::fabs(volume - targets[target]) / targets[target];
+    }
+
+    State empty() const {
+        State state;
+        state.volume.assign(targets.size(), 0.0f);
+        for(size_t t = 0; t < targets.size(); ++t) {
+            state.cost += deviation(t, 0.0f);
+        }
+        return state;
+    }
+
+    bool contains(const State& state, uint32_t candidate) const {
+        for(const auto& item : state.items) {
+            if(item.candidate == candidate) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Koszt po dodaniu (sets > 0) albo odjęciu (sets < 0) serii kandydata - tylko zmienione cele
+    double costWith(const State& state, uint32_t candidate, int sets) const {
+        double cost = state.cost;
+        for(const auto& [target, weight] : candidates[candidate].contributions) {
+            cost -= deviation(target, state.volume[target]);
+            cost += deviation(target, state.volume[target] + weight * static_cast<float>(sets));
+        }
+        return cost;
+    }
+
+    void add(State& state, const Item& item) const {
+        state.cost = costWith(state, item.candidate, item.sets);
+        for(const auto& [target, weight] : candidates[item.candidate].contributions) {
+            state.volume[target] += weight * static_cast<float>(item.sets);
+        }
+        state.duration += duration(item.sets);
+        state.hash += itemHash(item);
+        state.items.push_back(item);
+    }
+
+    void remove(State& state, size_t index) const {
+        const Item item = state.items[index];
+        state.cost = costWith(state, item.candidate, -item.sets);
+        for(const auto& [target, weight] : candidates[item.candidate].contributions) {
+            state.volume[target] -= weight * static_cast<float>(item.sets);
+        }
+        state.duration -= duration(item.sets);
+        state.hash -= itemHash(item);
+        state.items.erase(state.items.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+};
+
+// Rozwinięcia stanów [begin, end) beamu - najlepsze width dzieci
+std::vector<Child> expand(const Problem& problem, const std::vector<State>& beam, size_t begin, size_t end,
+                          size_t width, Clock::time_point deadline) {
+    const auto& c = problem.constraints;
+    std::vector<Child> children;
+    for(size_t s = begin; s < end && Clock::now() < deadline; ++s) {
+        const State& state = beam[s];
+        for(uint32_t candidate = 0; candidate < problem.candidates.size(); ++candidate) {
+            if(problem.contains(state, candidate)) {
+                continue;
+            }
+            for(int sets = c.minSets; sets <= c.maxSets; ++sets) {
+                const int duration = state.duration + problem.duration(sets);
+                if(duration > c.durationSeconds) {
+                    break;   // Więcej serii = jeszcze dłużej
+                }
+                const double cost = problem.costWith(state, candidate, sets);
+                if(cost >= state.cost) {
+                    continue;   // Dodanie nic nie daje - nie rozwijamy
+                }
+                const Item item{candidate, sets};
+                children.push_back({static_cast<uint32_t>(s), item, cost, duration, state.hash + itemHash(item)});
+            }
+        }
+        // Ograniczenie pamięci: co jakiś czas zostawiamy tylko najlepsze
+        if(children.size() > 8 * width) {
+            std::nth_element(children.begin(), children.begin() + static_cast<std::ptrdiff_t>(width), children.end(),
+                             [](const Child& a, const Child& b) { return a.cost < b.cost; });
+            children.resize(width);
+        }
+    }
+    return children;
+}
+
+// Hill climbing z losowymi ruchami (zmiana serii, podmiana, dodanie, usunięcie)
+State localSearch(const Problem& problem, State current, uint64_t seed, Clock::time_point deadline) {
+    const auto& c = problem.constraints;
+    const auto candidateCount = static_cast<uint32_t>(problem.candidates.size());
+    std::mt19937_64 random(seed);
+    State best = current;
+    size_t stall = 0;
+    size_t evaluated = 0;
+
+    while(stall < LOCAL_SEARCH_STALL && (++evaluated % 64 != 0 || Clock::now() < deadline)) {
+        State next = current;
+        const int move = static_cast<int>(random() % 4);
+        if(move == 0 && !next.items.empty()) {
+            const size_t index = random() % next.items.size();
+            Item item = next.items[index];
+            problem.remove(next, index);
+            item.sets = c.minSets + static_cast<int>(random() % static_cast<uint64_t>(c.maxSets - c.minSets + 1));
+            problem.add(next, item);
+        } else if(move == 1 && !next.items.empty()) {
+            const uint32_t candidate = static_cast<uint32_t>(random() % candidateCount);
+            if(problem.contains(next, candidate)) {
+                ++stall;
+                continue;
+            }
+            const size_t index = random() % next.items.size();
+            const int sets = next.items[index].sets;
+            problem.remove(next, index);
+            problem.add(next, {candidate, sets});
+        } else if(move == 2 && next.items.size() < c.maxExercises) {
+            const uint32_t candidate = static_cast<uint32_t>(random() % candidateCount);
+            if(problem.contains(next, candidate)) {
+                ++stall;
+                continue;
+            }
+            problem.add(next, {candidate, c.minSets});
+        } else if(move == 3 && next.items.size() > 1) {
+            problem.remove(next, random() % next.items.size());
+        } else {
+            ++stall;
+            continue;
+        }
+
+        if(next.duration > c.durationSeconds || next.cost > current.cost) {
+            ++stall;
+            continue;
+        }
+        // Ruchy "w bok" (ten sam koszt) pozwalają zejść z płaskowyżu
+        stall = next.cost < current.cost ? 0 : stall + 1;
+        current = std::move(next);
+        if(current.cost < best.cost) {
+            best = current;
+        }
+    }
+    metrics().statesEvaluated.increment(evaluated);
+    return best;
+}
+
+// Jedno przejście po kandydatach: dodajemy każdego, kto zmniejsza koszt
+// (najlepsza liczba serii mieszcząca się w czasie) - wynik, gdy na beam
+// search nie starczyło budżetu
+State greedy(const Problem& problem) {
+    const auto& c = problem.constraints;
+    State state = problem.empty();
+    for(uint32_t candidate = 0; candidate < problem.candidates.size() && state.items.size() < c.maxExercises;
+        ++candidate) {
+        Item best{candidate, 0};
+        double bestCost = state.cost;
+        for(int sets = c.minSets; sets <= c.maxSets; ++sets) {
+            if(state.duration + problem.duration(sets) > c.durationSeconds) {
+                break;
+            }
+            const double cost = problem.costWith(state, candidate, sets);
+            if(cost < bestCost) {
+                bestCost = cost;
+                best.sets = sets;
+            }
+        }
+        if(best.sets > 0) {
+            problem.add(state, best);
+        }
+    }
+    return state;
+}
+
+// Najlepsze stany bez duplikatów (ten sam zestaw ćwiczeń i serii)
+void keepBest(std::vector<State>& states, size_t limit) {
+    std::sort(states.begin(), states.end(), [](const State& a, const State& b) {
+        return a.cost != b.cost ? a.cost < b.cost : a.duration < b.duration;
+    });
+    std::unordered_set<uint64_t> seen;
+    std::vector<State> unique;
+    for(auto& state : states) {
+        if(unique.size() >= limit) {
+            break;
+        }
+        if(!state.items.empty() && seen.insert(state.hash).second) {
+            unique.push_back(std::move(state));
+        }
+    }
+    states = std::move(unique);
+}
+
+} // namespace
+
+int PlanOptimizer::entryDuration(int sets, int reps, int restTime, const OptimizerConstraints& constraints) {
+    return sets * (reps * constraints.secondsPerRep + restTime) + constraints.transitionSeconds;
+}
+
+int PlanOptimizer::planDuration(const WorkoutPlan& plan, const OptimizerConstraints& constraints) {
+    int total = 0;
+    for(const auto& entry : plan.getEntries()) {
+        total += entryDuration(entry.sets, entry.reps, entry.restTime, constraints);
+    }
+    return total;
+}
+
+std::vector<std::string> PlanOptimizer::parseMuscles(const std::string& targetMuscles) {
+    std::vector<std::string> muscles;
+    size_t start = 0;
+    while(start <= targetMuscles.size()) {
+        size_t end = targetMuscles.find_first_of(",;/", start);
+        if(end == std::string::npos) {
+            end = targetMuscles.size();
+        }
+        std::string muscle = FuzzyIndex::normalize(std::string_view(targetMuscles).substr(start, end - start));
+        if(!muscle.empty() && std::find(muscles.begin(), muscles.end(), muscle) == muscles.end()) {
+            muscles.push_back(std::move(muscle));
+        }
+        start = end + 1;
+    }
+    return muscles;
+}
+
+std::vector<OptimizedPlan> PlanOptimizer::optimize(const std::string& planName,
+                                                   const std::vector<std::shared_ptr<Exercise>>& catalog,
+                                                   const OptimizerConstraints& constraints,
+                                                   const OptimizerOptions& options,
+                                                   ThreadPool& pool) {
+    PUMP_TRACE_SCOPE("PlanOptimizer::optimize", "core");
+    ScopedLatency latency(metrics().latency);
+    const auto deadline = Clock::now() + options.timeBudget;
+    if(constraints.minSets < 1 || constraints.maxSets < constraints.minSets) {
+        throw std::invalid_argument("Nieprawidłowy zakres serii!");
+    }
+
+    const Problem problem(catalog, constraints, std::max<size_t>(1, options.maxCandidates), deadline);
+    std::vector<OptimizedPlan> results;
+    if(problem.candidates.empty()) {
+        return results;
+    }
+    const size_t width = std::max<size_t>(1, options.beamWidth);
+    const size_t threads = std::max<size_t>(1, pool.getThreadCount());
+
+    // Etap 1: beam search - poziom = liczba ćwiczeń w planie
+    std::vector<State> beam{problem.empty()};
+    std::vector<State> elite;
+    for(size_t level = 0; level < constraints.maxExercises && !beam.empty() && Clock::now() < deadline; ++level) {
+        auto parts = pool.parallelRanges(beam.size(), [&problem, &beam, width, deadline](size_t begin, size_t end) {
+            return expand(problem, beam, begin, end, width, deadline);
+        });
+        std::vector<Child> children;
+        for(const auto& part : parts) {
+            children.insert(children.end(), part.begin(), part.end());
+        }
+        metrics().statesEvaluated.increment(children.size());
+
+        std::sort(children.begin(), children.end(), [](const Child& a, const Child& b) {
+            return a.cost != b.cost ? a.cost < b.cost : a.duration < b.duration;
+        });
+        std::unordered_set<uint64_t> seen;
+        std::vector<State> next;
+        for(const auto& child : children) {
+            if(next.size() >= width) {
+                break;
+            }
+            if(!seen.insert(child.hash).second) {
+                continue;   // Ten sam zestaw osiągnięty w innej kolejności
+            }
+            State state = beam[child.parent];
+            problem.add(state, child.item);
+            next.push_back(std::move(state));
+        }
+        elite.insert(elite.end(), next.begin(), next.end());
+        beam = std::move(next);
+    }
+    if(elite.empty()) {
+        elite.push_back(greedy(problem));   // Budżet zjedzony przez przygotowanie
+    }
+    keepBest(elite, std::max(threads, options.results));
+
+    // Etap 2: local search - każdy wątek od innego z najlepszych stanów
+    if(!elite.empty() && Clock::now() < deadline) {
+        std::vector<std::future<State>> tasks;
+        for(size_t t = 0; t < threads; ++t) {
+            State start = elite[t % elite.size()];
+            const uint64_t seed = options.seed * 0x9E3779B97F4A7C15ull + t;
+            tasks.push_back(pool.submit([&problem, start = std::move(start), seed, deadline]() {
+                return localSearch(problem, start, seed, deadline);
+            }));
+        }
+        for(auto& task : tasks) {
+            elite.push_back(task.get());
+        }
+    }
+    keepBest(elite, options.results);
+
+    for(auto& state : elite) {
+        // Kolejność w planie: najwięcej serii najpierw (zwykle ćwiczenia złożone)
+        std::stable_sort(state.items.begin(), state.items.end(),
+                         [](const Item& a, const Item& b) { return a.sets > b.sets; });
+        auto plan = std::make_shared<WorkoutPlan>(planName);
+        for(const auto& item : state.items) {
+            plan->addEntry(problem.candidates[item.candidate].exercise, item.sets, constraints.reps,
+                           0.0, constraints.restTime);
+        }
+        results.push_back({plan, state.cost, state.duration});
+    }
+    return results;
+}
+
+std::vector<OptimizedPlan> PlanOptimizer::optimize(const std::string& planName,
+                                                   const std::vector<std::shared_ptr<Exercise>>& catalog,
+                                                   const OptimizerConstraints& constraints,
+                                                   const OptimizerOptions& options) {
+    return optimize(planName, catalog, constraints, options, ThreadPool::getShared());
+}
@@ -0,0 +1,89 @@
+// PlanOptimizer.h
+// Lokalizacja: core/PlanOptimizer.h
+// Opis: Dobór planu pod ograniczenia trenera: budżet czasu sesji
+//       (serie x (powtórzenia x tempo + przerwa) + przejście), docelowa
+//       objętość (serie) na grupę mięśniową i filtr typu ćwiczeń.
+//       Przeszukiwanie heurystyczne: beam search po liczbie ćwiczeń (rozwinięcia
+//       stanów równolegle w puli), potem local search z kilku najlepszych
+//       stanów - każdy wątek z innego punktu startu - do upływu budżetu czasu.
+//       Wynik zawsze mieści się w budżecie czasu sesji; czas odpowiedzi
+//       ograniczony przez OptimizerOptions::timeBudget - także przygotowanie:
+//       duży katalog to równomierna próbka (maxCandidates / przerwana po
+//       budżecie), a gdy na beam search nie starczy czasu - wynik zachłanny.
+// Design Pattern: brak (algorytm)
+//
+// Wątki: optimize() nie zmienia katalogu; ćwiczenia są tylko czytane.
+// Nie wołać z zadania tej samej puli (zob. ThreadPool.h).
+
+#ifndef PLANOPTIMIZER_H
+#define PLANOPTIMIZER_H
+
+#include "WorkoutPlan.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Docelowa liczba serii na grupę mięśniową (nazwa jak w Exercise::targetMuscles)
+struct MuscleTarget {
+    std::string muscle;
+    int sets = 0;
+};
+
+struct OptimizerConstraints {
+    int durationSeconds = 45 * 60;      // Budżet czasu sesji
+    int secondsPerRep = 4;              // Tempo - czas pracy na powtórzenie
+    int transitionSeconds = 60;         // Przejście między ćwiczeniami (ustawienie sprzętu)
+    int reps = 10;
+    int restTime = 90;
+    int minSets = 2;
+    int maxSets = 5;
+    size_t maxExercises = 8;
+    std::vector<MuscleTarget> muscleTargets;
+    std::optional<ExerciseType> type;   // Filtr typu (sprzęt); brak = wszystkie
+};
+
+struct OptimizerOptions {
+    std::chrono::milliseconds timeBudget{250};   // Górne ograniczenie czasu odpowiedzi
+    size_t beamWidth = 48;
+    size_t maxCandidates = 2000;                 // Próbka katalogu - koszt poziomu beamu ~ width x kandydaci
+    size_t results = 3;                          // Ile różnych planów zwrócić
+    uint64_t seed = 1;                           // Ziarno local search (powtarzalność)
+};
+
+struct OptimizedPlan {
+    std::shared_ptr<WorkoutPlan> plan;
+    double cost = 0.0;            // Suma względnych odchyleń objętości od celów (0 = idealnie)
+    int durationSeconds = 0;
+};
+
+class PlanOptimizer {
+public:
+    // Najlepsze znalezione plany (rosnąco po koszcie). std::invalid_argument
+    // przy braku celów objętości albo błędnym zakresie serii.
+    static std::vector<OptimizedPlan> optimize(const std::string& planName,
+                                               const std::vector<std::shared_ptr<Exercise>>& catalog,
+                                               const OptimizerConstraints& constraints,
+                                               const OptimizerOptions& options,
+                                               ThreadPool& pool);
+    static std::vector<OptimizedPlan> optimize(const std::string& planName,
+                                               const std::vector<std::shared_ptr<Exercise>>& catalog,
+                                               const OptimizerConstraints& constraints,
+                                               const OptimizerOptions& options = OptimizerOptions());
+
+    // Czas jednego wpisu: serie x (powtórzenia x tempo + przerwa) + przejście
+    static int entryDuration(int sets, int reps, int restTime, const OptimizerConstraints& constraints);
+
+    // Czas całego planu według tych samych zasad
+    static int planDuration(const WorkoutPlan& plan, const OptimizerConstraints& constraints);
+
+    // Grupy mięśniowe z opisu ("Klatka, triceps / barki"), znormalizowane
+    // jak w FuzzyIndex; pierwsza to mięsień główny
+    static std::vector<std::string> parseMuscles(const std::string& targetMuscles);
+};
+
+#endif // PLANOPTIMIZER_H
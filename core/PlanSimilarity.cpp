@@ -0,0 +1,380 @@
+// PlanSimilarity.cpp
+// Lokalizacja: core/PlanSimilarity.cpp
+
+#include "PlanSimilarity.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+struct PlanSimilarityMetrics {
+    LatencyHistogram& queryLatency = MetricsRegistry::getInstance().histogram("pumpapp_plan_similar_latency_us");
+    LatencyHistogram& dedupLatency = MetricsRegistry::getInstance().histogram("pumpapp_plan_dedup_latency_us");
+    Counter& candidatePairs = MetricsRegistry::getInstance().counter("pumpapp_plan_dedup_pairs_total");
+};
+
+PlanSimilarityMetrics& metrics() {
+    static PlanSimilarityMetrics instance;
+    return instance;
+}
+
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+uint64_t nameHash(const std::string& name) {
+    uint64_t hash = 0xCBF29CE484222325ull;   // FNV-1a
+    for(unsigned char c : name) {
+        hash = (hash ^ c) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// Ziarna funkcji skrótu - jedna na wartość sygnatury
+const std::array<uint64_t, PlanSimilarityIndex::HASHES>& seeds() {
+    static const auto instance = [] {
+        std::array<uint64_t, PlanSimilarityIndex::HASHES> result{};
+        for(size_t i = 0; i < result.size(); ++i) {
+            result[i] = mix(i + 1);
+        }
+        return result;
+    }();
+    return instance;
+}
+
+std::array<uint64_t, PlanSimilarityIndex::BANDS> bandKeys(const PlanSimilarityIndex::Signature& signature) {
+    std::array<uint64_t, PlanSimilarityIndex::BANDS> keys{};
+    for(size_t band = 0; band < PlanSimilarityIndex::BANDS; ++band) {
+        uint64_t key = band;
+        for(size_t row = 0; row < PlanSimilarityIndex::ROWS; ++row) {
+            key = mix(key ^ signature[band * PlanSimilarityIndex::ROWS + row]);
+        }
+        keys[band] = key;
+    }
+    return keys;
+}
+
+// Union-find z kompresją ścieżek (połowienie) i łączeniem po rozmiarze
+class DisjointSets {
+public:
+    explicit DisjointSets(size_t count) : parent(count), sizes(count, 1) {
+        std::iota(parent.begin(), parent.end(), 0u);
+    }
+
+    uint32_t find(uint32_t x) {
+        while(parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    void unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if(a == b) {
+            return;
+        }
+        if(sizes[a] < sizes[b]) {
+            std::swap(a, b);
+        }
+        parent[b] = a;
+        sizes[a] += sizes[b];
+    }
+
+private:
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> sizes;
+};
+
+} // namespace
+
+PlanProfile PlanSimilarityIndex::profile(const WorkoutPlan& plan) {
+    PlanProfile result;
+    result.reserve(plan.getEntryCount());
+    for(const auto& entry : plan.getEntries()) {
+        result.emplace_back(nameHash(entry.exercise->getName()),
+                            static_cast<double>(entry.sets) * entry.reps);
+    }
+    std::sort(result.begin(), result.end());
+
+    // To samo ćwiczenie w kilku wpisach - jedna pozycja z sumą objętości
+    size_t out = 0;
+    for(size_t i = 0; i < result.size(); ++i) {
+        if(out > 0 && result[out - 1].first == result[i].first) {
+            result[out - 1].second += result[i].second;
+        } else {
+            result[out++] = result[i];
+        }
+    }
+    result.resize(out);
+    return result;
+}
+
+PlanSimilarityIndex::Signature PlanSimilarityIndex::signature(const PlanProfile& profile) {
+    Signature result;
+    result.fill(std::numeric_limits<uint32_t>::max());
+    const auto& hashSeeds = seeds();
+    for(const auto& [exercise, volume] : profile) {
+        const int tokens = std::clamp(static_cast<int>(std::ceil(volume / VOLUME_UNIT)), 1, MAX_TOKENS);
+        for(int k = 1; k <= tokens; ++k) {
+            const uint64_t token = mix(exercise + static_cast<uint64_t>(k));
+            for(size_t i = 0; i < HASHES; ++i) {
+                const auto value = static_cast<uint32_t>(((token ^ hashSeeds[i]) * 0x9E3779B97F4A7C15ull) >> 32);
+                result[i] = std::min(result[i], value);
+            }
+        }
+    }
+    return result;
+}
+
+double PlanSimilarityIndex::similarity(const PlanProfile& a, const PlanProfile& b) {
+    double common = 0.0;
+    double total = 0.0;
+    size_t i = 0;
+    size_t j = 0;
+    while(i < a.size() || j < b.size()) {
+        if(j == b.size() || (i < a.size() && a[i].first < b[j].first)) {
+            total += a[i++].second;
+        } else if(i == a.size() || b[j].first < a[i].first) {
+            total += b[j++].second;
+        } else {
+            common += std::min(a[i].second, b[j].second);
+            total += std::max(a[i].second, b[j].second);
+            ++i;
+            ++j;
+        }
+    }
+    return total > 0.0 ? common / total : 0.0;
+}
+
+double PlanSimilarityIndex::similarity(const WorkoutPlan& a, const WorkoutPlan& b) {
+    return similarity(profile(a), profile(b));
+}
+
+void PlanSimilarityIndex::insert(std::shared_ptr<const WorkoutPlan> plan) {
+    if(!plan || bySlot.count(plan.get())) {
+        return;
+    }
+
+    uint32_t id;
+    if(freeSlots.empty()) {
+        id = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    } else {
+        id = freeSlots.back();
+        freeSlots.pop_back();
+    }
+
+    Slot& slot = slots[id];
+    slot.profile = profile(*plan);
+    slot.bandKeys = bandKeys(signature(slot.profile));
+    for(size_t band = 0; band < BANDS; ++band) {
+        bands[band][slot.bandKeys[band]].push_back(id);
+    }
+    bySlot.emplace(plan.get(), id);
+    slot.plan = std::move(plan);
+}
+
+void PlanSimilarityIndex::erase(const WorkoutPlan* plan) {
+    auto it = bySlot.find(plan);
+    if(it == bySlot.end()) {
+        return;
+    }
+    const uint32_t id = it->second;
+    bySlot.erase(it);
+
+    Slot& slot = slots[id];
+    for(size_t band = 0; band < BANDS; ++band) {
+        auto bucket = bands[band].find(slot.bandKeys[band]);
+        auto& ids = bucket->second;
+        auto pos = std::find(ids.begin(), ids.end(), id);
+        *pos = ids.back();
+        ids.pop_back();
+        if(ids.empty()) {
+            bands[band].erase(bucket);
+        }
+    }
+    slot = Slot();
+    freeSlots.push_back(id);
+}
+
+void PlanSimilarityIndex::clear() {
+    slots.clear();
+    freeSlots.clear();
+    bySlot.clear();
+    for(auto& band : bands) {
+        band.clear();
+    }
+}
+
+void PlanSimilarityIndex::rebuild(const std::vector<std::shared_ptr<WorkoutPlan>>& plans) {
+    clear();
+    slots.reserve(plans.size());
+    bySlot.reserve(plans.size());
+    for(const auto& plan : plans) {
+        insert(plan);
+    }
+}
+
+std::vector<SimilarPlan> PlanSimilarityIndex::query(const WorkoutPlan& plan, size_t limit,
+                                                    double minSimilarity) const {
+    ScopedLatency latency(metrics().queryLatency);
+    const PlanProfile queryProfile = profile(plan);
+    const auto keys = bandKeys(signature(queryProfile));
+
+    std::vector<uint32_t> candidates;
+    for(size_t band = 0; band < BANDS; ++band) {
+        auto bucket = bands[band].find(keys[band]);
+        if(bucket != bands[band].end()) {
+            candidates.insert(candidates.end(), bucket->second.begin(), bucket->second.end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::vector<SimilarPlan> results;
+    for(uint32_t id : candidates) {
+        const Slot& slot = slots[id];
+        if(slot.plan.get() == &plan) {
+            continue;
+        }
+        const double score = similarity(queryProfile, slot.profile);
+        if(score >= minSimilarity) {
+            results.push_back({slot.plan, score});
+        }
+    }
+
+    std::sort(results.begin(), results.end(), [](const SimilarPlan& a, const SimilarPlan& b) {
+        if(a.similarity != b.similarity) {
+            return a.similarity > b.similarity;
+        }
+        return a.plan->getName() < b.plan->getName();
+    });
+    if(results.size() > limit) {
+        results.resize(limit);
+    }
+    return results;
+}
+
+size_t PlanSimilarityIndex::estimateMemoryUsage() const {
+    size_t total = slots.capacity() * sizeof(Slot) + freeSlots.capacity() * sizeof(uint32_t)
+                   + bySlot.size() * (sizeof(void*) + sizeof(uint32_t) + 2 * sizeof(void*));
+    for(const auto& slot : slots) {
+        total += slot.profile.capacity() * sizeof(PlanProfile::value_type);
+    }
+    for(const auto& band : bands) {
+        total += band.size() * (sizeof(uint64_t) + sizeof(std::vector<uint32_t>) + 2 * sizeof(void*));
+    }
+    return total + bySlot.size() * BANDS * sizeof(uint32_t);
+}
+
+std::vector<PlanCluster> PlanSimilarityIndex::findNearDuplicates(
+    const std::vector<std::shared_ptr<const WorkoutPlan>>& plans, double threshold, ThreadPool& pool) {
+    PUMP_TRACE_SCOPE("PlanSimilarityIndex::findNearDuplicates", "core");
+    ScopedLatency latency(metrics().dedupLatency);
+    const size_t count = plans.size();
+    if(count < 2) {
+        return {};
+    }
+
+    // Etap 1: profile i klucze pasm
+    std::vector<PlanProfile> profiles(count);
+    std::vector<std::array<uint64_t, BANDS>> keys(count);
+    pool.parallelRanges(count, [&](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; ++i) {
+            profiles[i] = profile(*plans[i]);
+            keys[i] = bandKeys(signature(profiles[i]));
+        }
+    });
+
+    // Etap 2: kubełki - każde zadanie obsługuje swoje pasma. W kubełku porównujemy
+    // pierwszy plan z każdym i sąsiadów między sobą: liniowo zamiast kwadratowo
+    // (tysiąc kopii "Push" to tysiąc par, nie pół miliona), a union-find i tak
+    // łączy przechodnio.
+    std::vector<std::vector<uint64_t>> bandPairs(BANDS);
+    pool.parallelRanges(BANDS, [&](size_t begin, size_t end) {
+        for(size_t band = begin; band < end; ++band) {
+            std::unordered_map<uint64_t, std::vector<uint32_t>> buckets;
+            buckets.reserve(count);
+            for(size_t i = 0; i < count; ++i) {
+                buckets[keys[i][band]].push_back(static_cast<uint32_t>(i));
+            }
+            auto& pairs = bandPairs[band];
+            for(const auto& [key, members] : buckets) {
+                for(size_t m = 1; m < members.size(); ++m) {
+                    pairs.push_back((uint64_t(members[0]) << 32) | members[m]);
+                    if(m > 1) {
+                        pairs.push_back((uint64_t(members[m - 1]) << 32) | members[m]);
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<uint64_t> pairs;
+    for(auto& band : bandPairs) {
+        pairs.insert(pairs.end(), band.begin(), band.end());
+        band = std::vector<uint64_t>();
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    metrics().candidatePairs.increment(pairs.size());
+
+    // Etap 3: dokładna weryfikacja kandydatów
+    std::vector<char> similar(pairs.size(), 0);
+    pool.parallelRanges(pairs.size(), [&](size_t begin, size_t end) {
+        for(size_t p = begin; p < end; ++p) {
+            const auto a = static_cast<uint32_t>(pairs[p] >> 32);
+            const auto b = static_cast<uint32_t>(pairs[p]);
+            similar[p] = similarity(profiles[a], profiles[b]) >= threshold;
+        }
+    });
+
+    // Etap 4: skupiska
+    DisjointSets sets(count);
+    for(size_t p = 0; p < pairs.size(); ++p) {
+        if(similar[p]) {
+            sets.unite(static_cast<uint32_t>(pairs[p] >> 32), static_cast<uint32_t>(pairs[p]));
+        }
+    }
+
+    std::unordered_map<uint32_t, size_t> clusterOf;
+    std::vector<PlanCluster> clusters;
+    for(uint32_t i = 0; i < count; ++i) {
+        const uint32_t root = sets.find(i);
+        auto [it, added] = clusterOf.emplace(root, clusters.size());
+        if(added) {
+            clusters.emplace_back();
+        }
+        clusters[it->second].plans.push_back(plans[i]);
+    }
+
+    clusters.erase(std::remove_if(clusters.begin(), clusters.end(),
+                                  [](const PlanCluster& c) { return c.plans.size() < 2; }),
+                   clusters.end());
+    for(auto& cluster : clusters) {
+        std::sort(cluster.plans.begin(), cluster.plans.end(),
+                  [](const auto& a, const auto& b) { return a->getName() < b->getName(); });
+    }
+    std::sort(clusters.begin(), clusters.end(), [](const PlanCluster& a, const PlanCluster& b) {
+        if(a.plans.size() != b.plans.size()) {
+            return a.plans.size() > b.plans.size();
+        }
+        return a.plans.front()->getName() < b.plans.front()->getName();
+    });
+    return clusters;
+}
+
+std::vector<PlanCluster> PlanSimilarityIndex::findNearDuplicates(
+    const std::vector<std::shared_ptr<const WorkoutPlan>>& plans, double threshold) {
+    return findNearDuplicates(plans, threshold, ThreadPool::getShared());
+}
@@ -0,0 +1,102 @@
+// PlanSimilarity.h
+// Lokalizacja: core/PlanSimilarity.h
+// Opis: Podobieństwo planów po zawartości, a nie po nazwie ("Push", "Push v2", ...).
+//       Miara: ważone podobieństwo Jaccarda profili ćwiczenie -> objętość
+//       (serie x powtórzenia): suma minimów / suma maksimów.
+//
+//       Wyszukiwanie podliniowe: sygnatura MinHash (64 wartości) z tokenów
+//       (ćwiczenie, k) dla k = 1..ceil(objętość / VOLUME_UNIT) - zbiór tokenów
+//       przybliża profil ważony, więc zgodność MinHash szacuje ważony Jaccard.
+//       LSH: 16 pasm po 4 wartości; kandydatem jest plan z tym samym kluczem
+//       w co najmniej jednym paśmie, a wynik potwierdza dokładne podobieństwo.
+//       Dla podobieństwa 0.8 kandydat trafia się z prawdopodobieństwem > 99.9%,
+//       dla 0.3 - ok. 12%.
+//
+//       findNearDuplicates: zadanie wsadowe dla całej biblioteki - profile,
+//       kubełki pasm i weryfikacja par równolegle w puli wątków, skupiska przez
+//       union-find (plan podobny do dowolnego członka skupiska dołącza do niego).
+// Design Pattern: brak (struktura danych)
+//
+// Wątki: indeks bez własnej synchronizacji - zapisy pod blokadą właściciela
+// (WorkoutPlanRepository::storageLock), zapytania równoległe są bezpieczne.
+// findNearDuplicates działa na niezmiennych planach (snapshot) bez blokad;
+// nie wołać z zadania tej samej puli (zob. ThreadPool.h).
+
+#ifndef PLANSIMILARITY_H
+#define PLANSIMILARITY_H
+
+#include "WorkoutPlan.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class ThreadPool;
+
+// Profil planu: (hash nazwy ćwiczenia, objętość), posortowany po hashu
+using PlanProfile = std::vector<std::pair<uint64_t, double>>;
+
+struct SimilarPlan {
+    std::shared_ptr<const WorkoutPlan> plan;
+    double similarity = 0.0;   // Ważony Jaccard, 1 = ta sama zawartość
+};
+
+// Skupisko prawie-duplikatów (co najmniej dwa plany, posortowane po nazwie)
+struct PlanCluster {
+    std::vector<std::shared_ptr<const WorkoutPlan>> plans;
+};
+
+class PlanSimilarityIndex {
+public:
+    static constexpr size_t HASHES = 64;
+    static constexpr size_t BANDS = 16;
+    static constexpr size_t ROWS = HASHES / BANDS;
+    static constexpr int VOLUME_UNIT = 10;           // Powtórzeń na token
+    static constexpr int MAX_TOKENS = 16;            // Na ćwiczenie (duża objętość nie dominuje)
+
+    using Signature = std::array<uint32_t, HASHES>;
+
+    static PlanProfile profile(const WorkoutPlan& plan);
+    static Signature signature(const PlanProfile& profile);
+
+    // Dokładny ważony Jaccard dwóch profili (0 gdy oba puste)
+    static double similarity(const PlanProfile& a, const PlanProfile& b);
+    static double similarity(const WorkoutPlan& a, const WorkoutPlan& b);
+
+    void insert(std::shared_ptr<const WorkoutPlan> plan);
+    void erase(const WorkoutPlan* plan);
+    void clear();
+    void rebuild(const std::vector<std::shared_ptr<WorkoutPlan>>& plans);
+
+    // Plany z indeksu o podobieństwie >= minSimilarity (bez samego planu),
+    // malejąco po podobieństwie, potem po nazwie; maks. limit wyników
+    std::vector<SimilarPlan> query(const WorkoutPlan& plan, size_t limit = 10,
+                                   double minSimilarity = 0.5) const;
+
+    size_t size() const { return bySlot.size(); }
+    size_t estimateMemoryUsage() const;
+
+    // Skupiska planów o podobieństwie >= threshold (największe najpierw)
+    static std::vector<PlanCluster> findNearDuplicates(
+        const std::vector<std::shared_ptr<const WorkoutPlan>>& plans,
+        double threshold, ThreadPool& pool);
+    static std::vector<PlanCluster> findNearDuplicates(
+        const std::vector<std::shared_ptr<const WorkoutPlan>>& plans,
+        double threshold = 0.8);
+
+private:
+    struct Slot {
+        std::shared_ptr<const WorkoutPlan> plan;
+        PlanProfile profile;
+        std::array<uint64_t, BANDS> bandKeys{};
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<const WorkoutPlan*, uint32_t> bySlot;
+    std::array<std::unordered_map<uint64_t, std::vector<uint32_t>>, BANDS> bands;   // Klucz pasma -> sloty
+};
+
+#endif // PLANSIMILARITY_H
@@ -0,0 +1,209 @@
+// ProgramGenerator.cpp
+// Lokalizacja: core/ProgramGenerator.cpp
+
+#include "ProgramGenerator.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+struct ProgramGeneratorMetrics {
+    Counter& programs = MetricsRegistry::getInstance().counter("pumpapp_programs_generated_total");
+    LatencyHistogram& batchLatency = MetricsRegistry::getInstance().histogram("pumpapp_program_batch_latency_us");
+};
+
+ProgramGeneratorMetrics& metrics() {
+    static ProgramGeneratorMetrics instance;
+    return instance;
+}
+
+// Parametry wpisu w danym tygodniu
+struct Target {
+    int sets = 0;
+    int reps = 0;
+    double weight = 0.0;
+
+    bool operator==(const Target& other) const {
+        return sets == other.sets && reps == other.reps && weight == other.weight;
+    }
+    bool operator!=(const Target& other) const { return !(*this == other); }
+};
+
+// Wpis planu bazowego z rozwiązaną regułą (liczone raz na program)
+struct EntryPlan {
+    const ProgressionRule* rule = nullptr;   // nullptr = bez progresji
+    Target base;
+    double oneRepMax = 0.0;
+};
+
+const ProgressionRule* findRule(const std::vector<ProgressionRule>& rules, const std::string& exerciseName) {
+    const ProgressionRule* fallback = nullptr;
+    for(const auto& rule : rules) {
+        if(rule.exerciseName == exerciseName) {
+            return &rule;
+        }
+        if(rule.exerciseName.empty() && !fallback) {
+            fallback = &rule;
+        }
+    }
+    return fallback;
+}
+
+double roundWeight(double weight, double step) {
+    if(step <= 0.0 || weight <= 0.0) {
+        return weight;
+    }
+    return std::round(weight / step) * step;
+}
+
+// progress = liczba tygodni pracy (bez deloadów) przed bieżącym
+Target targetFor(const EntryPlan& entry, int progress, bool deload, const ProgramSpec& spec) {
+    Target target = entry.base;
+    if(entry.rule) {
+        const ProgressionRule& rule = *entry.rule;
+        switch(rule.kind) {
+        case ProgressionRule::Kind::NONE:
+            break;
+        case ProgressionRule::Kind::LINEAR:
+            if(target.weight > 0.0) {
+                target.weight += rule.weightStep * progress;
+            } else {
+                target.reps += rule.repsStep * progress;
+            }
+            break;
+        case ProgressionRule::Kind::PERCENT_WAVE:
+            if(entry.oneRepMax > 0.0) {
+                const int length = static_cast<int>(rule.wave.size());
+                const WaveStep& step = rule.wave[static_cast<size_t>(progress % length)];
+                const double oneRepMax = entry.oneRepMax + rule.oneRepMaxStep * (progress / length);
+                target.weight = oneRepMax * step.percent;
+                target.reps = step.reps;
+                if(step.sets > 0) {
+                    target.sets = step.sets;
+                }
+            }
+            break;
+        }
+    }
+
+    if(deload) {
+        target.weight *= spec.deload.weightFactor;
+        target.sets = std::max(1, static_cast<int>(std::lround(target.sets * spec.deload.setsFactor)));
+    }
+    target.weight = roundWeight(target.weight, spec.rounding);
+    target.reps = std::max(1, target.reps);
+    return target;
+}
+
+void validate(const ProgramSpec& spec) {
+    if(!spec.basePlan) {
+        throw std::invalid_argument("Program bez planu bazowego!");
+    }
+    if(spec.weeks < 1) {
+        throw std::invalid_argument("Program musi mieć co najmniej jeden tydzień!");
+    }
+    for(const auto& rule : spec.rules) {
+        if(rule.kind == ProgressionRule::Kind::PERCENT_WAVE && rule.wave.empty()) {
+            throw std::invalid_argument("Fala %1RM bez tygodni: " + rule.exerciseName);
+        }
+    }
+}
+
+} // namespace
+
+double ProgramGenerator::estimateOneRepMax(double weight, int reps) {
+    return reps <= 1 ? weight : weight * (1.0 + reps / 30.0);
+}
+
+Program ProgramGenerator::generate(const ProgramSpec& spec) {
+    validate(spec);
+    const WorkoutPlan& base = *spec.basePlan;
+    const auto& baseEntries = base.getEntries();
+
+    std::vector<EntryPlan> entries;
+    entries.reserve(baseEntries.size());
+    for(const auto& entry : baseEntries) {
+        EntryPlan planned;
+        planned.rule = findRule(spec.rules, entry.exercise->getName());
+        planned.base = {entry.sets, entry.reps, entry.weight};
+        if(planned.rule && planned.rule->kind == ProgressionRule::Kind::PERCENT_WAVE) {
+            planned.oneRepMax = planned.rule->oneRepMax > 0.0 ? planned.rule->oneRepMax
+                                                              : estimateOneRepMax(entry.weight, entry.reps);
+        }
+        entries.push_back(planned);
+    }
+
+    Program program;
+    program.name = spec.name.empty() ? base.getName() : spec.name;
+    program.weeks.reserve(static_cast<size_t>(spec.weeks));
+    program.deloadWeeks.reserve(static_cast<size_t>(spec.weeks));
+
+    int progress = 0;
+    const WorkoutPlan* previous = &base;
+    for(int week = 0; week < spec.weeks; ++week) {
+        const bool deload = spec.deload.every > 0 && (week + 1) % spec.deload.every == 0;
+
+        // Kopia poprzedniego tygodnia - zmieniamy tylko wpisy, których parametry się różnią
+        auto plan = std::make_shared<WorkoutPlan>(*previous);
+        plan->setName(program.name + " - tydzień " + std::to_string(week + 1) + (deload ? " (deload)" : ""));
+        const auto& current = previous->getEntries();
+        for(size_t i = 0; i < entries.size(); ++i) {
+            const Target target = targetFor(entries[i], progress, deload, spec);
+            const PlanEntry& entry = current[i];
+            if(target != Target{entry.sets, entry.reps, entry.weight}) {
+                plan->editEntry(i, target.sets, target.reps, target.weight, entry.restTime);
+            }
+        }
+
+        if(!deload) {
+            ++progress;
+        }
+        program.weeks.push_back(plan);
+        program.deloadWeeks.push_back(deload);
+        previous = plan.get();
+    }
+
+    metrics().programs.increment();
+    return program;
+}
+
+std::vector<Program> ProgramGenerator::generateAll(const std::vector<ProgramSpec>& specs, ThreadPool& pool) {
+    PUMP_TRACE_SCOPE("ProgramGenerator::generateAll", "core");
+    ScopedLatency latency(metrics().batchLatency);
+    std::vector<Program> programs(specs.size());
+    if(specs.empty()) {
+        return programs;
+    }
+
+    // Każde zadanie pisze tylko swoje pozycje programs
+    pool.parallelRanges(specs.size(), [&specs, &programs](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; ++i) {
+            programs[i] = generate(specs[i]);
+        }
+    });
+    return programs;
+}
+
+std::vector<Program> ProgramGenerator::generateAll(const std::vector<ProgramSpec>& specs) {
+    return generateAll(specs, ThreadPool::getShared());
+}
+
+size_t Program::estimateMemoryUsage() const {
+    size_t total = sizeof(Program) + name.capacity() + weeks.capacity() * sizeof(std::shared_ptr<WorkoutPlan>);
+    for(size_t w = 0; w < weeks.size(); ++w) {
+        const auto& entries = weeks[w]->getEntries();
+        total += sizeof(WorkoutPlan) + weeks[w]->getName().capacity()
+                 + entries.chunkCount() * (sizeof(std::shared_ptr<void>) + sizeof(size_t));
+        // Tydzień jest kopią poprzedniego - blok wspólny z nim był już policzony
+        for(size_t i = 0; i < entries.size(); ++i) {
+            if(w == 0 || !entries.sharesChunkWith(weeks[w - 1]->getEntries(), i)) {
+                total += sizeof(PlanEntry);
+            }
+        }
+    }
+    return total;
+}
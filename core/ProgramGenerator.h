@@ -0,0 +1,91 @@
+// ProgramGenerator.h
+// Lokalizacja: core/ProgramGenerator.h
+// Opis: Generator programów periodyzowanych - z planu bazowego i reguł progresji
+//       (liniowa, fale %1RM, tygodnie deload) powstaje plan na każdy tydzień.
+//       Tydzień N+1 jest kopią tygodnia N (O(1), wpisy współdzielone - zob.
+//       WorkoutPlan) ze zmienionymi tylko wpisami, które progresują, więc
+//       pamięć programu rośnie o zmienione bloki wpisów, a nie o pełne plany.
+//       Wiele programów (np. setki klientów) generuje się równolegle w puli wątków.
+// Design Pattern: Builder (ProgramSpec -> Program), Strategy (reguły progresji)
+//
+// Wątki: generate() jest czystą funkcją specyfikacji; plan bazowy jest tylko
+// czytany (kopiowany), więc wiele wątków może generować z tego samego planu.
+
+#ifndef PROGRAMGENERATOR_H
+#define PROGRAMGENERATOR_H
+
+#include "WorkoutPlan.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Jeden tydzień fali %1RM (np. 5/3/1: 65% x 5, 75% x 3, 85% x 1)
+struct WaveStep {
+    double percent = 0.0;   // Ułamek 1RM (0.65 = 65%)
+    int reps = 0;
+    int sets = 0;           // 0 = serie z planu bazowego
+};
+
+// Reguła progresji - dla jednego ćwiczenia albo domyślna (pusta nazwa)
+struct ProgressionRule {
+    enum class Kind {
+        NONE,           // Wpis bez zmian co tydzień (współdzielony między tygodniami)
+        LINEAR,         // +weightStep kg co tydzień; bez ciężaru: +repsStep powtórzeń
+        PERCENT_WAVE    // Cykl tygodni wave po %1RM, 1RM rośnie o oneRepMaxStep co cykl
+    };
+
+    Kind kind = Kind::LINEAR;
+    std::string exerciseName;        // Pusta = reguła domyślna
+
+    double weightStep = 2.5;
+    int repsStep = 1;
+
+    double oneRepMax = 0.0;          // 0 = szacowany z wpisu bazowego (wzór Epleya)
+    double oneRepMaxStep = 2.5;
+    std::vector<WaveStep> wave;
+};
+
+// Tydzień odciążenia co every tygodni (0 = bez deloadów); tydzień deload nie
+// liczy się do progresji - następny kontynuuje od ostatniego tygodnia pracy
+struct DeloadRule {
+    int every = 4;
+    double weightFactor = 0.6;
+    double setsFactor = 0.5;
+};
+
+struct ProgramSpec {
+    std::string name;                             // Prefiks nazw tygodni (pusty = nazwa planu)
+    std::shared_ptr<const WorkoutPlan> basePlan;
+    int weeks = 12;
+    std::vector<ProgressionRule> rules;           // Pierwsza pasująca po nazwie, potem domyślna
+    DeloadRule deload;
+    double rounding = 2.5;                        // Zaokrąglenie ciężaru (talerze), 0 = brak
+};
+
+struct Program {
+    std::string name;
+    std::vector<std::shared_ptr<WorkoutPlan>> weeks;   // "<nazwa> - tydzień N"
+    std::vector<bool> deloadWeeks;
+
+    // Pamięć wpisów z uwzględnieniem bloków współdzielonych między tygodniami
+    size_t estimateMemoryUsage() const;
+};
+
+class ProgramGenerator {
+public:
+    // Program dla jednej specyfikacji; std::invalid_argument przy błędnej
+    // specyfikacji (brak planu, weeks < 1, pusta fala)
+    static Program generate(const ProgramSpec& spec);
+
+    // Wiele programów równolegle (kolejność wyników = kolejność specyfikacji).
+    // Nie wołać z zadania tej samej puli (zob. ThreadPool.h).
+    static std::vector<Program> generateAll(const std::vector<ProgramSpec>& specs, ThreadPool& pool);
+    static std::vector<Program> generateAll(const std::vector<ProgramSpec>& specs);
+
+    // Szacowany 1RM ze wzoru Epleya: ciężar * (1 + powtórzenia / 30)
+    static double estimateOneRepMax(double weight, int reps);
+};
+
+#endif // PROGRAMGENERATOR_H
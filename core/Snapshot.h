@@ -0,0 +1,243 @@
+// Snapshot.h
+// Lokalizacja: core/Snapshot.h
+// Opis: Niezmienne wersje repozytoriów (MVCC). Pisarz (wątek GUI) zmienia kopię
+//       roboczą i po każdej partii zmian publikuje nową wersję przez atomowy
+//       wskaźnik; czytelnicy (zapis w tle, statystyki, wyszukiwanie) biorą snapshot
+//       bez blokad i widzą spójny stan, niezależnie od późniejszych zmian.
+//       Subskrybenci dostają z każdą wersją partię zmian (dodane/zmienione/
+//       usunięte obiekty), więc indeksy, listy GUI i dziennik zapisu
+//       aktualizują się przyrostowo zamiast przeliczać całą kolekcję.
+// Design Pattern: Immutable Object, Copy-on-Write, Observer
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "PersistentVector.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Jedna opublikowana wersja kolekcji (T musi mieć getName())
+template<typename T>
+class RepositorySnapshot {
+public:
+    using Items = PersistentVector<std::shared_ptr<const T>>;
+
+private:
+    Items items;
+    uint64_t version;
+
+public:
+    RepositorySnapshot(Items items, uint64_t version)
+        : items(std::move(items)), version(version) {}
+
+    // Numer wersji - rośnie z każdą opublikowaną partią zmian
+    uint64_t getVersion() const { return version; }
+
+    size_t getCount() const { return items.size(); }
+    const Items& getItems() const { return items; }
+
+    typename Items::const_iterator begin() const { return items.begin(); }
+    typename Items::const_iterator end() const { return items.end(); }
+
+    std::shared_ptr<const T> findByName(const std::string& name) const {
+        for(const auto& item : items) {
+            if(item->getName() == name) {
+                return item;
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<std::shared_ptr<const T>> searchByName(const std::string& query) const {
+        std::vector<std::shared_ptr<const T>> results;
+        for(const auto& item : items) {
+            if(item->getName().find(query) != std::string::npos) {
+                results.push_back(item);
+            }
+        }
+        return results;
+    }
+};
+
+// Jedna zmiana kolekcji. Identyfikatorem jest nazwa: before->getName() to nazwa
+// sprzed zmiany (przy zmianie nazwy różna od after->getName()).
+template<typename T>
+struct RepositoryChange {
+    enum class Kind { ADDED, UPDATED, REMOVED };
+
+    Kind kind;
+    std::shared_ptr<const T> before;   // nullptr dla ADDED
+    std::shared_ptr<const T> after;    // nullptr dla REMOVED
+};
+
+// Zmiany jednej opublikowanej wersji (pojedyncza operacja albo cała partia),
+// w kolejności wykonania. reset = kolekcja podmieniona w całości (wczytanie,
+// clear, katalog bazowy) - changes jest wtedy puste, stan tylko w snapshot.
+template<typename T>
+struct ChangeBatch {
+    uint64_t version = 0;
+    std::shared_ptr<const RepositorySnapshot<T>> snapshot;
+    std::vector<RepositoryChange<T>> changes;
+    bool reset = false;
+};
+
+// Kopia robocza + ostatnia opublikowana wersja. Zmiany kopii roboczej wolno
+// wykonywać tylko w jednym wątku (pisarza); current() - z dowolnego wątku.
+template<typename T>
+class VersionPublisher {
+private:
+    typename RepositorySnapshot<T>::Items pending;
+    std::shared_ptr<const RepositorySnapshot<T>> published;   // atomic_load/atomic_store
+    uint64_t version = 0;
+    int batchDepth = 0;
+    bool dirty = false;
+    std::function<void()> listener;   // Wołany po każdej publikacji (w wątku pisarza)
+
+    // Subskrybenci partii zmian; zmiany zbierane tylko, gdy ktoś słucha
+    std::vector<std::pair<uint64_t, std::function<void(const ChangeBatch<T>&)>>> subscribers;
+    uint64_t nextSubscription = 1;
+    std::vector<RepositoryChange<T>> recorded;
+    bool recordedReset = false;
+
+    void record(typename RepositoryChange<T>::Kind kind, std::shared_ptr<const T> before,
+                std::shared_ptr<const T> after) {
+        if(!subscribers.empty() && !recordedReset) {
+            recorded.push_back({kind, std::move(before), std::move(after)});
+        }
+    }
+
+    void recordReset() {
+        if(!subscribers.empty()) {
+            recorded.clear();
+            recordedReset = true;   // Dalsze zmiany partii i tak są w snapshocie
+        }
+    }
+
+    void changed() {
+        dirty = true;
+        if(batchDepth == 0) {
+            publish();
+        }
+    }
+
+    void publish() {
+        auto snapshot = std::make_shared<const RepositorySnapshot<T>>(pending, ++version);
+        std::atomic_store(&published, std::shared_ptr<const RepositorySnapshot<T>>(snapshot));
+        dirty = false;
+
+        // Subskrybenci przed listenerem - dziennik zapisu zna zmiany, zanim
+        // DatabaseManager opublikuje parę wersji do zapisu
+        if(!subscribers.empty()) {
+            ChangeBatch<T> batch;
+            batch.version = version;
+            batch.snapshot = std::move(snapshot);
+            batch.changes.swap(recorded);
+            batch.reset = recordedReset;
+            recordedReset = false;
+            for(const auto& subscriber : subscribers) {
+                subscriber.second(batch);
+            }
+        }
+        if(listener) {
+            listener();
+        }
+    }
+
+public:
+    VersionPublisher()
+        : published(std::make_shared<const RepositorySnapshot<T>>(pending, 0)) {}
+
+    std::shared_ptr<const RepositorySnapshot<T>> current() const {
+        return std::atomic_load(&published);
+    }
+
+    // === Zmiany kopii roboczej (publikowane od razu albo na końcu partii) ===
+
+    void pushBack(std::shared_ptr<const T> item) {
+        record(RepositoryChange<T>::Kind::ADDED, nullptr, item);
+        pending.pushBack(std::move(item));
+        changed();
+    }
+
+    void set(size_t index, std::shared_ptr<const T> item) {
+        record(RepositoryChange<T>::Kind::UPDATED, pending[index], item);
+        pending.set(index, std::move(item));
+        changed();
+    }
+
+    void erase(size_t index) {
+        record(RepositoryChange<T>::Kind::REMOVED, pending[index], nullptr);
+        pending.erase(index);
+        changed();
+    }
+
+    template<typename Ptr>
+    void reset(const std::vector<Ptr>& items) {
+        pending = typename RepositorySnapshot<T>::Items(
+            std::vector<std::shared_ptr<const T>>(items.begin(), items.end()));
+        recordReset();
+        changed();
+    }
+
+    // Podmiana na gotowy wektor (np. kopię współdzielącą bloki z katalogiem bazowym)
+    void reset(typename RepositorySnapshot<T>::Items items) {
+        pending = std::move(items);
+        recordReset();
+        changed();
+    }
+
+    // === Partie zmian - jedna nowa wersja zamiast wersji po każdej operacji ===
+
+    void beginBatch() { ++batchDepth; }
+
+    void commitBatch() {
+        if(batchDepth > 0 && --batchDepth == 0 && dirty) {
+            publish();
+        }
+    }
+
+    bool inBatch() const { return batchDepth > 0; }
+
+    void setListener(std::function<void()> callback) { listener = std::move(callback); }
+
+    // === Subskrypcje zmian (w wątku pisarza, po każdej publikacji) ===
+
+    uint64_t subscribe(std::function<void(const ChangeBatch<T>&)> callback) {
+        subscribers.emplace_back(nextSubscription, std::move(callback));
+        return nextSubscription++;
+    }
+
+    void unsubscribe(uint64_t id) {
+        for(auto it = subscribers.begin(); it != subscribers.end(); ++it) {
+            if(it->first == id) {
+                subscribers.erase(it);
+                break;
+            }
+        }
+        if(subscribers.empty()) {
+            recorded.clear();
+            recordedReset = false;
+        }
+    }
+};
+
+// RAII dla partii zmian: MutationBatch<ExerciseRepository> batch(repo);
+template<typename Target>
+class MutationBatch {
+private:
+    Target& target;
+
+public:
+    explicit MutationBatch(Target& t) : target(t) { target.beginBatch(); }
+    ~MutationBatch() { target.commitBatch(); }
+
+    MutationBatch(const MutationBatch&) = delete;
+    MutationBatch& operator=(const MutationBatch&) = delete;
+};
+
+#endif // SNAPSHOT_H
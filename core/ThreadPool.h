@@ -0,0 +1,120 @@
+// ThreadPool.h
+// Lokalizacja: core/ThreadPool.h
+// Opis: Prosta pula wątków roboczych (stała liczba wątków + kolejka zadań)
+// Design Pattern: Thread Pool, Singleton (pula współdzielona)
+//
+// UWAGA: zadanie wykonywane w puli nie powinno czekać (future.get()) na inne
+// zadanie z tej samej puli - przy zajętych wszystkich wątkach grozi zakleszczeniem.
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+
+    void workerLoop();
+
+public:
+    // 0 = liczba rdzeni (std::thread::hardware_concurrency)
+    explicit ThreadPool(size_t threadCount = 0);
+
+    // Kończy zadania z kolejki i łączy wątki
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t getThreadCount() const { return workers.size(); }
+
+    // Zlecenie zadania - wynik (lub wyjątek) dostępny przez std::future
+    template<typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+
+        // packaged_task nie jest kopiowalny, a std::function tego wymaga
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([packaged]() { (*packaged)(); });
+        }
+        condition.notify_one();
+        return result;
+    }
+
+    // Podział [0, count) na ciągłe zakresy, po jednym na wątek: fn(begin, end)
+    // w puli. Wyniki (gdy fn coś zwraca) w kolejności zakresów. Czeka na
+    // wszystkie zadania, zanim pierwszy wyjątek opuści funkcję - zadania
+    // zwykle piszą do struktur wywołującego. Nie wołać z zadania tej puli.
+    template<typename Fn>
+    auto parallelRanges(size_t count, Fn fn) {
+        using Result = std::invoke_result_t<Fn&, size_t, size_t>;
+        std::vector<std::future<Result>> tasks;
+        if(count > 0) {
+            const size_t parts = std::min(count, std::max<size_t>(1, getThreadCount()));
+            const size_t step = (count + parts - 1) / parts;
+            tasks.reserve(parts);
+            for(size_t begin = 0; begin < count; begin += step) {
+                const size_t end = std::min(count, begin + step);
+                tasks.push_back(submit([&fn, begin, end]() { return fn(begin, end); }));
+            }
+        }
+
+        std::exception_ptr failure;
+        if constexpr(std::is_void_v<Result>) {
+            for(auto& task : tasks) {
+                try {
+                    task.get();
+                } catch(...) {
+                    if(!failure) {
+                        failure = std::current_exception();
+                    }
+                }
+            }
+            if(failure) {
+                std::rethrow_exception(failure);
+            }
+        } else {
+            std::vector<Result> results;
+            results.reserve(tasks.size());
+            for(auto& task : tasks) {
+                try {
+                    results.push_back(task.get());
+                } catch(...) {
+                    if(!failure) {
+                        failure = std::current_exception();
+                    }
+                }
+            }
+            if(failure) {
+                std::rethrow_exception(failure);
+            }
+            return results;
+        }
+    }
+
+    // Pula współdzielona przez core (tworzona przy pierwszym użyciu)
+    static ThreadPool& getShared() {
+        static ThreadPool instance;
+        return instance;
+    }
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,109 @@
+// Trace.cpp
+// Lokalizacja: core/Trace.cpp
+
+#include "Trace.h"
+#include <fstream>
+#include <sstream>
+
+Tracer::Tracer()
+    : ring(DEFAULT_CAPACITY), origin(std::chrono::steady_clock::now()) {
+}
+
+void Tracer::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ring.assign(capacity > 0 ? capacity : 1, TraceEvent{});
+    next = 0;
+    recorded = 0;
+}
+
+void Tracer::record(const char* name, const char* category,
+                    std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point end) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.startUs = static_cast<uint64_t>(duration_cast<microseconds>(start - origin).count());
+    event.durationUs = static_cast<uint64_t>(duration_cast<microseconds>(end - start).count());
+    event.threadId = currentThreadId();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ring[next] = event;
+    next = (next + 1) % ring.size();
+    ++recorded;
+}
+
+std::vector<TraceEvent> Tracer::getEvents() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<TraceEvent> result;
+    if(recorded < ring.size()) {
+        result.assign(ring.begin(), ring.begin() + recorded);
+    } else {
+        // Bufor pełny - najstarsze zdarzenie jest pod indeksem next
+        result.reserve(ring.size());
+        result.insert(result.end(), ring.begin() + next, ring.end());
+        result.insert(result.end(), ring.begin(), ring.begin() + next);
+    }
+    return result;
+}
+
+size_t Tracer::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return recorded > ring.size() ? recorded - ring.size() : 0;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    next = 0;
+    recorded = 0;
+}
+
+// Nazwy spanów to literały z kodu, ale na wszelki wypadek escapujemy cudzysłowy
+static void appendJsonString(std::ostringstream& out, const char* str) {
+    out << '"';
+    for(const char* p = str ? str : ""; *p; ++p) {
+        if(*p == '"' || *p == '\\') out << '\\';
+        out << *p;
+    }
+    out << '"';
+}
+
+std::string Tracer::toChromeTraceJson() const {
+    std::vector<TraceEvent> events = getEvents();
+
+    std::ostringstream out;
+    out << "{\"traceEvents\":[\n";
+    for(size_t i = 0; i < events.size(); ++i) {
+        const auto& e = events[i];
+        out << "{\"name\":";
+        appendJsonString(out, e.name);
+        out << ",\"cat\":";
+        appendJsonString(out, e.category);
+        out << ",\"ph\":\"X\",\"ts\":" << e.startUs
+            << ",\"dur\":" << e.durationUs
+            << ",\"pid\":1,\"tid\":" << e.threadId << '}';
+        if(i + 1 < events.size()) out << ',';
+        out << '\n';
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}\n";
+    return out.str();
+}
+
+bool Tracer::exportChromeTrace(const std::string& filePath) const {
+    std::ofstream file(filePath, std::ios::binary);
+    if(!file.is_open()) {
+        return false;
+    }
+    file << toChromeTraceJson();
+    return static_cast<bool>(file);
+}
+
+uint32_t Tracer::currentThreadId() {
+    // Krótki, stabilny identyfikator wątku (Chrome oczekuje liczby)
+    static std::atomic<uint32_t> counter{0};
+    thread_local uint32_t id = ++counter;
+    return id;
+}
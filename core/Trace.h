@@ -0,0 +1,115 @@
+// Trace.h
+// Lokalizacja: core/Trace.h
+// Opis: Lekki tracing - pomiar czasu sekcji kodu (RAII) zapisywany do bufora
+//       cyklicznego, eksport do formatu Chrome Trace Event (chrome://tracing, Perfetto)
+// Design Pattern: Singleton Pattern, RAII
+//
+// Całość można usunąć w czasie kompilacji definiując PUMPAPP_DISABLE_TRACING
+// (opcja CMake PUMPAPP_ENABLE_TRACING=OFF) - makra rozwijają się wtedy do niczego.
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Jedno zakończone zdarzenie (span) - event typu "X" w formacie Chrome
+struct TraceEvent {
+    const char* name = nullptr;      // Literał - nie kopiujemy stringów na gorącej ścieżce
+    const char* category = nullptr;  // np. "db", "repo", "gui"
+    uint64_t startUs = 0;            // Start względem początku procesu (mikrosekundy)
+    uint64_t durationUs = 0;
+    uint32_t threadId = 0;
+};
+
+class Tracer {
+private:
+    Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    std::vector<TraceEvent> ring;    // Bufor cykliczny - najstarsze zdarzenia są nadpisywane
+    size_t next = 0;                 // Indeks następnego zapisu
+    size_t recorded = 0;             // Ile zdarzeń zapisano łącznie
+    std::atomic<bool> enabled{true};
+    std::chrono::steady_clock::time_point origin;
+    mutable std::mutex mutex;
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 16384;
+
+    static Tracer& getInstance() {
+        static Tracer instance;
+        return instance;
+    }
+
+    // Włączenie/wyłączenie zbierania w czasie działania
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Zmiana pojemności bufora (czyści zebrane zdarzenia)
+    void setCapacity(size_t capacity);
+
+    // Zapis zakończonego spanu
+    void record(const char* name, const char* category,
+                std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end);
+
+    // Zdarzenia w kolejności chronologicznej (najstarsze pierwsze)
+    std::vector<TraceEvent> getEvents() const;
+
+    // Liczba zdarzeń utraconych przez nadpisanie bufora
+    size_t getDroppedCount() const;
+
+    void clear();
+
+    // Eksport do JSON w formacie Chrome Trace Event
+    std::string toChromeTraceJson() const;
+    bool exportChromeTrace(const std::string& filePath) const;
+
+    static uint32_t currentThreadId();
+};
+
+// RAII - mierzy czas od konstrukcji do destrukcji i zapisuje span do Tracera
+class ScopedTrace {
+private:
+    const char* name;
+    const char* category;
+    std::chrono::steady_clock::time_point start;
+    bool active;
+
+public:
+    ScopedTrace(const char* spanName, const char* spanCategory)
+        : name(spanName), category(spanCategory),
+          active(Tracer::getInstance().isEnabled()) {
+        if(active) start = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedTrace() {
+        if(active) {
+            Tracer::getInstance().record(name, category, start,
+                                         std::chrono::steady_clock::now());
+        }
+    }
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+};
+
+#define PUMP_TRACE_CONCAT_INNER(a, b) a##b
+#define PUMP_TRACE_CONCAT(a, b) PUMP_TRACE_CONCAT_INNER(a, b)
+
+#ifdef PUMPAPP_DISABLE_TRACING
+#define PUMP_TRACE_SCOPE(name, category) ((void)0)
+#else
+// Użycie: PUMP_TRACE_SCOPE("ExerciseRepository::loadFromJSON", "repo");
+#define PUMP_TRACE_SCOPE(name, category) \
+    ScopedTrace PUMP_TRACE_CONCAT(pumpTraceScope_, __LINE__)(name, category)
+#endif
+
+#endif // TRACE_H
@@ -5,7 +5,30 @@
 #include <stdexcept>
 
 WorkoutPlan::WorkoutPlan(const std::string& planName)
-    : name(planName) {
+    : name(planName), entries(std::make_shared<PlanEntries>()) {
+}
+
+WorkoutPlan::WorkoutPlan(const WorkoutPlan& other)
+    : name(other.name), entries(other.entries) {
+}
+
+WorkoutPlan& WorkoutPlan::operator=(const WorkoutPlan& other) {
+    if(this != &other) {
+        const PlanEntryChange change{PlanEntryChange::Kind::RESET};
+        aboutToChange(change);
+        name = other.name;
+        entries = other.entries;
+        changed(change);
+    }
+    return *this;
+}
+
+PlanEntries& WorkoutPlan::writableEntries() {
+    // Licznik 1 = tylko ten plan widzi wpisy; opublikowana kopia trzyma własną referencję
+    if(entries.use_count() > 1) {
+        entries = std::make_shared<PlanEntries>(*entries);
+    }
+    return *entries;
 }
 
 void WorkoutPlan::addEntry(std::shared_ptr<Exercise> exercise,
@@ -17,27 +40,80 @@ void WorkoutPlan::addEntry(std::shared_ptr<Exercise> exercise,
         throw std::invalid_argument("Serie i powtórzenia muszą być większe od 0!");
     }
 
-    entries.emplace_back(exercise, sets, reps, weight, restTime);
+    const PlanEntryChange change{PlanEntryChange::Kind::INSERT, entries->size()};
+    aboutToChange(change);
+    writableEntries().pushBack(PlanEntry(exercise, sets, reps, weight, restTime));
+    changed(change);
+}
+
+void WorkoutPlan::insertEntry(size_t index, std::shared_ptr<Exercise> exercise,
+                              int sets, int reps, double weight, int restTime) {
+    if(index > entries->size()) {
+        throw std::out_of_range("Nieprawidłowy indeks ćwiczenia!");
+    }
+    if(!exercise) {
+        throw std::invalid_argument("Nie można dodać pustego ćwiczenia!");
+    }
+    if(sets <= 0 || reps <= 0) {
+        throw std::invalid_argument("Serie i powtórzenia muszą być większe od 0!");
+    }
+
+    const PlanEntryChange change{PlanEntryChange::Kind::INSERT, index};
+    aboutToChange(change);
+    writableEntries().insert(index, PlanEntry(exercise, sets, reps, weight, restTime));
+    changed(change);
 }
 
 void WorkoutPlan::removeEntry(size_t index) {
-    if(index >= entries.size()) {
+    if(index >= entries->size()) {
         throw std::out_of_range("Nieprawidłowy indeks ćwiczenia!");
     }
-    entries.erase(entries.begin() + index);
+    const PlanEntryChange change{PlanEntryChange::Kind::REMOVE, index};
+    aboutToChange(change);
+    writableEntries().erase(index);
+    changed(change);
 }
 
 void WorkoutPlan::editEntry(size_t index, int sets, int reps,
                             double weight, int restTime) {
-    if(index >= entries.size()) {
+    if(index >= entries->size()) {
         throw std::out_of_range("Nieprawidłowy indeks ćwiczenia!");
     }
     if(sets <= 0 || reps <= 0) {
         throw std::invalid_argument("Serie i powtórzenia muszą być większe od 0!");
     }
 
-    entries[index].sets = sets;
-    entries[index].reps = reps;
-    entries[index].weight = weight;
-    entries[index].restTime = restTime;
+    PlanEntry entry = (*entries)[index];
+    entry.sets = sets;
+    entry.reps = reps;
+    entry.weight = weight;
+    entry.restTime = restTime;
+    const PlanEntryChange change{PlanEntryChange::Kind::EDIT, index};
+    aboutToChange(change);
+    writableEntries().set(index, std::move(entry));
+    changed(change);
+}
+
+void WorkoutPlan::moveEntry(size_t from, size_t to) {
+    if(from >= entries->size() || to >= entries->size()) {
+        throw std::out_of_range("Nieprawidłowy indeks ćwiczenia!");
+    }
+    if(from == to) {
+        return;
+    }
+
+    const PlanEntryChange change{PlanEntryChange::Kind::MOVE, from, to};
+    aboutToChange(change);
+    PlanEntries& list = writableEntries();
+    PlanEntry entry = list[from];
+    list.erase(from);
+    list.insert(to, std::move(entry));
+    changed(change);
+}
+
+void WorkoutPlan::clear() {
+    const PlanEntryChange change{PlanEntryChange::Kind::RESET};
+    aboutToChange(change);
+    entries = std::make_shared<PlanEntries>();
+    changed(change);
 }
@@ -1,11 +1,18 @@
 // WorkoutPlan.h
 // Lokalizacja: core/WorkoutPlan.h
-// Opis: Klasa reprezentująca plan treningowy składający się z ćwiczeń
+// Opis: Klasa reprezentująca plan treningowy składający się z ćwiczeń.
+//       Wpisy są współdzielone między kopiami (copy-on-write na PersistentVector):
+//       kopia planu to O(1), pierwsza zmiana kopiuje kręgosłup i jeden blok
+//       wpisów, a nie wszystkie wpisy z ich wskaźnikami do ćwiczeń.
+//       Zmiany wpisów zgłaszane są obserwatorowi (np. model listy w GUI)
+//       pojedynczo - bez przebudowy całej listy po każdej edycji.
+// Design Pattern: Observer (WorkoutPlanObserver)
 
 #ifndef WORKOUTPLAN_H
 #define WORKOUTPLAN_H
 
 #include "Exercise.h"
+#include "PersistentVector.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -25,39 +32,95 @@ struct PlanEntry {
         : exercise(ex), sets(s), reps(r), weight(w), restTime(rest) {}
 };
 
+// Bloki po 16 wpisów - plan zwykle ma ich kilkanaście, a kopia zmieniana co tydzień
+// (ProgramGenerator) kopiuje tylko blok ze zmienionym wpisem
+using PlanEntries = PersistentVector<PlanEntry, 16>;
+
+// Zmiana wpisów planu zgłaszana obserwatorowi
+struct PlanEntryChange {
+    enum class Kind {
+        INSERT,   // Nowy wpis na pozycji index
+        REMOVE,   // Usunięty wpis z pozycji index
+        EDIT,     // Zmienione parametry wpisu index
+        MOVE,     // Wpis z index przeniesiony na pozycję to (indeks po przeniesieniu)
+        RESET     // Cała lista wymieniona (clear, przypisanie)
+    };
+
+    Kind kind = Kind::RESET;
+    size_t index = 0;
+    size_t to = 0;
+};
+
+// Obserwator jednego obiektu planu. Para wywołań otacza każdą zmianę
+// (jak begin/end w modelach Qt); wołany w wątku, który zmienia plan.
+class WorkoutPlanObserver {
+public:
+    virtual ~WorkoutPlanObserver() = default;
+    virtual void entriesAboutToChange(const PlanEntryChange& change) = 0;
+    virtual void entriesChanged(const PlanEntryChange& change) = 0;
+};
+
 // Klasa reprezentująca cały plan treningowy
 class WorkoutPlan {
 private:
-    std::string name;                    // Nazwa planu (np. "Trening FBW")
-    std::vector<PlanEntry> entries;      // Lista ćwiczeń w planie
+    std::string name;                         // Nazwa planu (np. "Trening FBW")
+    std::shared_ptr<PlanEntries> entries;     // Lista ćwiczeń w planie (współdzielona z kopiami)
+    WorkoutPlanObserver* observer = nullptr;  // Nie przechodzi na kopie planu
+
+    // Wpisy do zapisu - własna kopia, jeśli współdzieli je inny plan
+    PlanEntries& writableEntries();
+
+    void aboutToChange(const PlanEntryChange& change) { if(observer) observer->entriesAboutToChange(change); }
+    void changed(const PlanEntryChange& change) { if(observer) observer->entriesChanged(change); }
 
 public:
     // Konstruktor
     explicit WorkoutPlan(const std::string& planName);
 
+    // Kopia O(1) - wpisy współdzielone, bez obserwatora
+    WorkoutPlan(const WorkoutPlan& other);
+    WorkoutPlan& operator=(const WorkoutPlan& other);
+
     // Dodanie ćwiczenia do planu
     void addEntry(std::shared_ptr<Exercise> exercise,
                   int sets, int reps, double weight, int restTime);
 
+    // Wstawienie ćwiczenia przed pozycją index (index == liczba wpisów = na koniec)
+    void insertEntry(size_t index, std::shared_ptr<Exercise> exercise,
+                     int sets, int reps, double weight, int restTime);
+
     // Usunięcie ćwiczenia z planu (po indeksie)
     void removeEntry(size_t index);
 
     // Edycja parametrów ćwiczenia (po indeksie)
     void editEntry(size_t index, int sets, int reps, double weight, int restTime);
 
+    // Przeniesienie wpisu z from na pozycję to (indeks po przeniesieniu).
+    // Usunięcie + wstawienie w PersistentVector: O(16) przesunięć w dwóch
+    // blokach (+ ich kopia, jeśli współdzielone) i O(n/16) aktualizacji sum
+    // bloków - nie O(1), ale bez przesuwania wpisów pomiędzy from i to.
+    void moveEntry(size_t from, size_t to);
+
     // Gettery
-    std::string getName() const { return name; }
-    const std::vector<PlanEntry>& getEntries() const { return entries; }
-    size_t getEntryCount() const { return entries.size(); }
+    const std::string& getName() const { return name; }
+    const PlanEntries& getEntries() const { return *entries; }
+    size_t getEntryCount() const { return entries->size(); }
+
+    // Czy oba plany wciąż współdzielą listę wpisów (żaden nie był zmieniany po kopii)
+    bool sharesEntriesWith(const WorkoutPlan& other) const { return entries == other.entries; }
 
     // Settery
     void setName(const std::string& n) { name = n; }
 
     // Sprawdzenie czy plan jest pusty
-    bool isEmpty() const { return entries.empty(); }
+    bool isEmpty() const { return entries->empty(); }
+
+    // Wyczyszczenie całego planu (kopie zachowują swoje wpisy)
+    void clear();
 
-    // Wyczyszczenie całego planu
-    void clear() { entries.clear(); }
+    // Jeden obserwator naraz (nullptr = odłączenie); obserwator musi się
+    // odłączyć przed zniszczeniem
+    void setObserver(WorkoutPlanObserver* planObserver) { observer = planObserver; }
 };
 
 #endif // WORKOUTPLAN_H
@@ -2,14 +2,46 @@
 // Lokalizacja: core/WorkoutPlanRepository.cpp
 
 #include "WorkoutPlanRepository.h"
-#include <fstream>
-#include <sstream>
-#include <iostream>
+#include "Logger.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include "JsonUtils.h"
+#include "ThreadPool.h"
+#include "JsonWriter.h"
+#include <charconv>
 #include <algorithm>
+#include <cstdio>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+struct WorkoutPlanRepositoryMetrics {
+    Counter& findCalls = MetricsRegistry::getInstance().counter("pumpapp_plan_find_total");
+    LatencyHistogram& findLatency = MetricsRegistry::getInstance().histogram("pumpapp_plan_find_latency_us");
+    Counter& searchCalls = MetricsRegistry::getInstance().counter("pumpapp_plan_search_total");
+    LatencyHistogram& searchLatency = MetricsRegistry::getInstance().histogram("pumpapp_plan_search_latency_us");
+    LatencyHistogram& loadLatency = MetricsRegistry::getInstance().histogram("pumpapp_plan_load_latency_us");
+    LatencyHistogram& saveLatency = MetricsRegistry::getInstance().histogram("pumpapp_plan_save_latency_us");
+    LatencyHistogram& importLatency = MetricsRegistry::getInstance().histogram("pumpapp_plan_import_latency_us");
+    Counter& importRows = MetricsRegistry::getInstance().counter("pumpapp_plan_import_rows_total");
+    Counter& importErrors = MetricsRegistry::getInstance().counter("pumpapp_plan_import_errors_total");
+    Counter& saveConflicts = MetricsRegistry::getInstance().counter("pumpapp_plan_save_conflicts_total");
+    LatencyHistogram& reloadLatency = MetricsRegistry::getInstance().histogram("pumpapp_plan_reload_latency_us");
+};
+
+WorkoutPlanRepositoryMetrics& metrics() {
+    static WorkoutPlanRepositoryMetrics instance;
+    return instance;
+}
+}
 
 WorkoutPlanRepository::WorkoutPlanRepository(const std::string& filePath,
                                              ExerciseRepository* exRepo)
-    : jsonFilePath(filePath), exerciseRepo(exRepo) {
+    : jsonFilePath(filePath)
+    , countGauge(MetricsRegistry::getInstance().gauge(MetricsRegistry::labeled("pumpapp_plans", "file", filePath)))
+    , exerciseRepo(exRepo) {
+    versions.subscribe([this](const WorkoutPlanChangeBatch& batch) { applyContentChanges(batch); });
 }
 
 void WorkoutPlanRepository::addPlan(std::shared_ptr<WorkoutPlan> plan) {
@@ -17,25 +49,45 @@ void WorkoutPlanRepository::addPlan(std::shared_ptr<WorkoutPlan> plan) {
         throw std::invalid_argument("Nie można dodać pustego planu!");
     }
 
-    if(exists(plan->getName())) {
-        throw std::runtime_error("Plan o nazwie '" + plan->getName() + "' już istnieje!");
+    {
+        std::unique_lock<std::shared_mutex> lock(storageLock);
+
+        if(!nameIndex.insert(plan->getName(), plan)) {
+            throw std::runtime_error("Plan o nazwie '" + plan->getName() + "' już istnieje!");
+        }
+
+        plans.push_back(plan);
+        versions.pushBack(plan);
+        countGauge.set(static_cast<int64_t>(plans.size()));
     }
+    markExercisesUsed(*plan);
+}
 
-    plans.push_back(plan);
+// Poza storageLock - blokada repozytorium ćwiczeń nie jest zagnieżdżana w naszej
+void WorkoutPlanRepository::markExercisesUsed(const WorkoutPlan& plan) {
+    if(!exerciseRepo) {
+        return;
+    }
+    for(const auto& entry : plan.getEntries()) {
+        exerciseRepo->markUsed(entry.exercise->getName());
+    }
 }
 
 std::shared_ptr<WorkoutPlan> WorkoutPlanRepository::findByName(const std::string& name) const {
-    auto it = std::find_if(plans.begin(), plans.end(),
-                           [&name](const std::shared_ptr<WorkoutPlan>& p) {
-                               return p->getName() == name;
-                           });
+    metrics().findCalls.increment();
+    ScopedLatency latency(metrics().findLatency);
 
-    return (it != plans.end()) ? *it : nullptr;
+    return nameIndex.find(name);
 }
 
 std::vector<std::shared_ptr<WorkoutPlan>> WorkoutPlanRepository::searchByName(const std::string& query) const {
+    PUMP_TRACE_SCOPE("WorkoutPlanRepository::searchByName", "repo");
+    metrics().searchCalls.increment();
+    ScopedLatency latency(metrics().searchLatency);
     std::vector<std::shared_ptr<WorkoutPlan>> results;
 
+    std::shared_lock<std::shared_mutex> lock(storageLock);
+
     for(const auto& plan : plans) {
         if(plan->getName().find(query) != std::string::npos) {
             results.push_back(plan);
@@ -45,186 +97,670 @@ std::vector<std::shared_ptr<WorkoutPlan>> WorkoutPlanRepository::searchByName(co
     return results;
 }
 
-bool WorkoutPlanRepository::updatePlan(const std::string& oldName,
-                                       std::shared_ptr<WorkoutPlan> newPlan) {
-    auto it = std::find_if(plans.begin(), plans.end(),
-                           [&oldName](const std::shared_ptr<WorkoutPlan>& p) {
-                               return p->getName() == oldName;
-                           });
+std::vector<SimilarPlan> WorkoutPlanRepository::findSimilarPlans(const WorkoutPlan& plan, size_t limit,
+                                                                 double minSimilarity) const {
+    std::shared_lock<std::shared_mutex> lock(storageLock);
+    return similarityIndex.query(plan, limit, minSimilarity);
+}
 
-    if(it != plans.end()) {
-        *it = newPlan;
-        return true;
-    }
-    return false;
+std::vector<ExerciseRecommendation> WorkoutPlanRepository::recommendExercises(const WorkoutPlan& draft,
+                                                                              size_t limit) const {
+    std::shared_lock<std::shared_mutex> lock(storageLock);
+    return recommender.recommend(draft, limit);
 }
 
-bool WorkoutPlanRepository::removePlan(const std::string& name) {
+std::vector<PlanCluster> WorkoutPlanRepository::findNearDuplicates(double threshold, ThreadPool* pool) const {
+    auto snapshot = getSnapshot();
+    std::vector<std::shared_ptr<const WorkoutPlan>> published(snapshot->begin(), snapshot->end());
+    return PlanSimilarityIndex::findNearDuplicates(published, threshold,
+                                                   pool ? *pool : ThreadPool::getShared());
+}
+
+// Pozycja planu w kopii roboczej (wołane pod blokadą pisarza)
+size_t WorkoutPlanRepository::indexOf(const std::string& name) const {
     auto it = std::find_if(plans.begin(), plans.end(),
                            [&name](const std::shared_ptr<WorkoutPlan>& p) {
                                return p->getName() == name;
                            });
+    return static_cast<size_t>(it - plans.begin());
+}
 
-    if(it != plans.end()) {
-        plans.erase(it);
-        return true;
+void WorkoutPlanRepository::reindexName(const std::string& name) {
+    size_t index = indexOf(name);
+    if(index < plans.size()) {
+        nameIndex.assign(name, plans[index]);
+    } else {
+        nameIndex.erase(name);
     }
-    return false;
 }
 
-bool WorkoutPlanRepository::exists(const std::string& name) const {
-    return findByName(name) != nullptr;
+bool WorkoutPlanRepository::updatePlan(const std::string& oldName,
+                                       std::shared_ptr<WorkoutPlan> newPlan) {
+    {
+        std::unique_lock<std::shared_mutex> lock(storageLock);
+
+        size_t index = indexOf(oldName);
+        if(index >= plans.size()) {
+            return false;
+        }
+        replaceLocked(index, oldName, newPlan);
+    }
+    markExercisesUsed(*newPlan);
+    return true;
+}
+
+void WorkoutPlanRepository::applyContentChanges(const WorkoutPlanChangeBatch& batch) {
+    if(batch.reset) {
+        rebuildContent();
+        return;
+    }
+    // UPDATED = usunięcie starej wersji + dodanie nowej (także przy zmianie nazwy)
+    for(const auto& change : batch.changes) {
+        if(change.before) {
+            similarityIndex.erase(change.before.get());
+            recommender.removePlan(*change.before);
+        }
+        if(change.after) {
+            similarityIndex.insert(change.after);
+            recommender.addPlan(*change.after);
+        }
+    }
 }
 
-// === JSON Helpers ===
+void WorkoutPlanRepository::rebuildContent() {
+    similarityIndex.rebuild(plans);
+    recommender.rebuild(plans);
+}
 
-static std::string escapeJson(const std::string& str) {
-    std::string result;
-    for(char c : str) {
-        if(c == '"') result += "\\\"";
-        else if(c == '\\') result += "\\\\";
-        else if(c == '\n') result += "\\n";
-        else if(c == '\r') result += "\\r";
-        else if(c == '\t') result += "\\t";
-        else result += c;
+void WorkoutPlanRepository::replaceLocked(size_t index, const std::string& oldName,
+                                          std::shared_ptr<WorkoutPlan> newPlan) {
+    plans[index] = newPlan;
+    versions.set(index, newPlan);
+
+    // Nazwa przeżywająca zmianę nie znika z indeksu (findByName/openDraft w tle)
+    if(newPlan->getName() != oldName) {
+        nameIndex.insert(newPlan->getName(), newPlan);
+        reindexName(oldName);
+    } else {
+        nameIndex.assign(oldName, newPlan);
     }
-    return result;
 }
 
-static std::string unescapeJson(const std::string& str) {
-    std::string result;
-    for(size_t i = 0; i < str.size(); ++i) {
-        if(str[i] == '\\' && i + 1 < str.size()) {
-            char next = str[i + 1];
-            if(next == 'n') { result += '\n'; i++; }
-            else if(next == 'r') { result += '\r'; i++; }
-            else if(next == 't') { result += '\t'; i++; }
-            else if(next == '"') { result += '"'; i++; }
-            else if(next == '\\') { result += '\\'; i++; }
-            else result += str[i];
-        } else {
-            result += str[i];
-        }
+PlanDraft WorkoutPlanRepository::openDraft(const std::string& name) const {
+    PlanDraft draft;
+    auto current = findByName(name);
+    if(!current) {
+        return draft;
     }
-    return result;
+    draft.originalName = name;
+    draft.base = current;
+    draft.plan = std::make_shared<WorkoutPlan>(*current);   // O(1) - wpisy współdzielone
+    return draft;
 }
 
-bool WorkoutPlanRepository::saveToJSON() const {
-    std::ofstream file(jsonFilePath);
-    if(!file.is_open()) {
-        std::cerr << "Błąd: Nie można otworzyć pliku do zapisu: " << jsonFilePath << std::endl;
+PlanDraft WorkoutPlanRepository::newDraft(const std::string& name) {
+    PlanDraft draft;
+    draft.plan = std::make_shared<WorkoutPlan>(name);
+    return draft;
+}
+
+bool WorkoutPlanRepository::commitDraft(const PlanDraft& draft) {
+    if(!draft.plan) {
         return false;
     }
+    if(draft.isNew()) {
+        addPlan(draft.plan);
+        return true;
+    }
 
-    file << "[\n";
-    for(size_t i = 0; i < plans.size(); ++i) {
-        const auto& plan = plans[i];
-        file << "  {\n";
-        file << "    \"name\": \"" << escapeJson(plan->getName()) << "\",\n";
-        file << "    \"entries\": [\n";
-
-        const auto& entries = plan->getEntries();
-        for(size_t j = 0; j < entries.size(); ++j) {
-            const auto& entry = entries[j];
-            file << "      {\n";
-            file << "        \"exerciseName\": \"" << escapeJson(entry.exercise->getName()) << "\",\n";
-            file << "        \"sets\": " << entry.sets << ",\n";
-            file << "        \"reps\": " << entry.reps << ",\n";
-            file << "        \"weight\": " << entry.weight << ",\n";
-            file << "        \"restTime\": " << entry.restTime << "\n";
-            file << "      }";
-            if(j < entries.size() - 1) file << ",";
-            file << "\n";
-        }
-
-        file << "    ]\n";
-        file << "  }";
-        if(i < plans.size() - 1) file << ",";
-        file << "\n";
-    }
-    file << "]\n";
-
-    file.close();
+    {
+        std::unique_lock<std::shared_mutex> lock(storageLock);
+
+        size_t index = indexOf(draft.originalName);
+        if(index >= plans.size() || plans[index] != draft.base) {
+            Logger::warning("WorkoutPlanRepository", "Konflikt szkicu - plan zmienił się od otwarcia",
+                            {{"name", draft.originalName}});
+            return false;
+        }
+        replaceLocked(index, draft.originalName, draft.plan);
+    }
+    markExercisesUsed(*draft.plan);
     return true;
 }
 
-bool WorkoutPlanRepository::loadFromJSON() {
+bool WorkoutPlanRepository::removePlan(const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+
+    size_t index = indexOf(name);
+    if(index < plans.size()) {
+        versions.erase(index);
+        plans.erase(plans.begin() + static_cast<std::ptrdiff_t>(index));
+        reindexName(name);
+        countGauge.set(static_cast<int64_t>(plans.size()));
+        return true;
+    }
+    return false;
+}
+
+ImportReport WorkoutPlanRepository::importPlans(const std::vector<PlanRecord>& records,
+                                               const ImportOptions& options) {
+    PUMP_TRACE_SCOPE("WorkoutPlanRepository::importPlans", "repo");
+    ScopedLatency latency(metrics().importLatency);
+    metrics().importRows.increment(records.size());
+    ImportReport report;
+
     if(!exerciseRepo) {
-        std::cerr << "Błąd: Brak referencji do ExerciseRepository!" << std::endl;
+        Logger::error("WorkoutPlanRepository", "Brak referencji do ExerciseRepository!");
+        for(size_t i = 0; i < records.size(); ++i) {
+            report.errors.push_back({i, records[i].name, "Brak repozytorium ćwiczeń"});
+        }
+        return report;
+    }
+
+    // Etap 1: budowa i walidacja planów poza blokadą (nazwy ćwiczeń przez indeks O(1))
+    std::vector<std::shared_ptr<WorkoutPlan>> built(records.size());
+    std::unordered_set<std::string_view> seen;
+    seen.reserve(records.size());
+
+    for(size_t i = 0; i < records.size(); ++i) {
+        const PlanRecord& record = records[i];
+        if(record.name.empty()) {
+            report.errors.push_back({i, record.name, "Brak nazwy planu"});
+            continue;
+        }
+        if(record.entries.empty()) {
+            report.errors.push_back({i, record.name, "Plan bez wpisów"});
+            continue;
+        }
+
+        auto plan = std::make_shared<WorkoutPlan>(record.name);
+        std::string error;
+        for(const auto& entry : record.entries) {
+            auto exercise = exerciseRepo->findByName(entry.exerciseName);
+            if(!exercise) {
+                error = "Nieznane ćwiczenie '" + entry.exerciseName + "'";
+                auto suggestions = exerciseRepo->suggestNames(entry.exerciseName, 1);
+                if(!suggestions.empty()) {
+                    error += " (czy chodziło o '" + suggestions.front().name + "'?)";
+                }
+                break;
+            }
+            if(entry.sets <= 0 || entry.reps <= 0) {
+                error = "Serie i powtórzenia muszą być większe od 0 ('" + entry.exerciseName + "')";
+                break;
+            }
+            plan->addEntry(exercise, entry.sets, entry.reps, entry.weight, entry.restTime);
+        }
+        if(!error.empty()) {
+            report.errors.push_back({i, record.name, error});
+            continue;
+        }
+
+        if(!seen.insert(record.name).second) {
+            ++report.duplicates;
+            continue;
+        }
+        built[i] = std::move(plan);
+    }
+
+    metrics().importErrors.increment(report.errors.size());
+    if(options.allOrNothing && !report.ok()) {
+        return report;
+    }
+
+    // Etap 2: zatwierdzenie pod blokadą pisarza - jedna nowa wersja
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+
+    std::unordered_map<std::string_view, size_t> positions;
+    positions.reserve(plans.size());
+    for(size_t i = 0; i < plans.size(); ++i) {
+        positions.emplace(plans[i]->getName(), i);
+    }
+
+    // Podmiany najpierw (klucze positions wskazują nazwy podmienianych planów)
+    std::vector<std::pair<size_t, size_t>> replacements;
+    size_t appended = 0;
+    for(size_t i = 0; i < built.size(); ++i) {
+        if(!built[i]) {
+            continue;
+        }
+        auto existing = positions.find(built[i]->getName());
+        if(existing == positions.end()) {
+            ++appended;
+        } else if(options.duplicates == DuplicatePolicy::SKIP) {
+            ++report.skipped;
+            built[i] = nullptr;
+        } else {
+            replacements.emplace_back(i, existing->second);
+        }
+    }
+
+    plans.reserve(plans.size() + appended);
+    versions.beginBatch();
+    for(const auto& replacement : replacements) {
+        auto& plan = built[replacement.first];
+        plans[replacement.second] = plan;
+        versions.set(replacement.second, plan);
+        nameIndex.assign(plan->getName(), plan);
+        ++report.replaced;
+        plan = nullptr;
+    }
+    for(auto& plan : built) {
+        if(plan) {
+            plans.push_back(plan);
+            versions.pushBack(plan);
+            nameIndex.insert(plan->getName(), plan);
+            ++report.added;
+        }
+    }
+    versions.commitBatch();
+
+    countGauge.set(static_cast<int64_t>(plans.size()));
+    report.committed = true;
+    return report;
+}
+
+bool WorkoutPlanRepository::exists(const std::string& name) const {
+    return findByName(name) != nullptr;
+}
+
+size_t WorkoutPlanRepository::getCount() const {
+    std::shared_lock<std::shared_mutex> lock(storageLock);
+    return plans.size();
+}
+
+void WorkoutPlanRepository::beginBatch() {
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    versions.beginBatch();
+}
+
+void WorkoutPlanRepository::commitBatch() {
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    versions.commitBatch();
+}
+
+void WorkoutPlanRepository::clear() {
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    plans.clear();
+    versions.reset(plans);
+    nameIndex.clear();
+    countGauge.set(0);
+}
+
+std::shared_ptr<const WorkoutPlanSnapshot> WorkoutPlanRepository::getSnapshot() const {
+    return versions.current();
+}
+
+size_t WorkoutPlanRepository::estimateMemoryUsage() const {
+    // Ćwiczenia są współdzielone z ExerciseRepository - liczymy tylko wpisy (na snapshocie)
+    auto snapshot = getSnapshot();
+    size_t total = snapshot->getCount() * 2 * sizeof(std::shared_ptr<WorkoutPlan>);
+    for(const auto& plan : *snapshot) {
+        total += sizeof(WorkoutPlan) + 2 * sizeof(void*) + plan->getName().capacity();
+        total += plan->getEntries().size() * sizeof(PlanEntry);
+    }
+    std::shared_lock<std::shared_mutex> lock(storageLock);
+    return total + similarityIndex.estimateMemoryUsage() + recommender.estimateMemoryUsage();
+}
+
+// === Persistence (JSON) - escapowanie w JsonUtils ===
+
+bool WorkoutPlanRepository::saveToJSON() const {
+    return saveSnapshot(*getSnapshot());
+}
+
+bool WorkoutPlanRepository::saveSnapshot(const WorkoutPlanSnapshot& snapshot) const {
+    PUMP_TRACE_SCOPE("WorkoutPlanRepository::saveToJSON", "repo");
+    ScopedLatency latency(metrics().saveLatency);
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+
+    // Plik zmieniony poza aplikacją - nadpisanie zgubiłoby tę zmianę
+    if(stampKnown && JsonUtils::fileStamp(jsonFilePath) != knownStamp) {
+        Logger::warning("WorkoutPlanRepository", "Plik zmieniony z zewnątrz - zapis wstrzymany do przeładowania",
+                        {{"path", jsonFilePath}});
+        metrics().saveConflicts.increment();
         return false;
     }
 
-    std::ifstream file(jsonFilePath);
-    if(!file.is_open()) {
-        std::cerr << "Plik nie istnieje lub nie można go otworzyć: " << jsonFilePath << std::endl;
+    // Plik tymczasowy + rename - przerwany zapis nie zostawi uciętego pliku
+    const std::string temporaryPath = JsonUtils::temporaryPath(jsonFilePath);
+    JsonWriter writer(JsonWriter::Style::PRETTY);
+    if(!writer.open(temporaryPath)) {
+        Logger::error("WorkoutPlanRepository", "Nie można otworzyć pliku do zapisu", {{"path", temporaryPath}});
         return false;
     }
 
-    plans.clear();
+    writer.beginArray();
+    for(const auto& plan : snapshot) {
+        writer.beginObject();
+        writer.field("name", plan->getName());
+        writer.key("entries");
+        writer.beginArray();
+        for(const auto& entry : plan->getEntries()) {
+            writer.beginObject();
+            writer.field("exerciseName", entry.exercise->getName());
+            writer.field("sets", entry.sets);
+            writer.field("reps", entry.reps);
+            writer.field("weight", entry.weight);
+            writer.field("restTime", entry.restTime);
+            writer.endObject();
+        }
+        writer.endArray();
+        writer.endObject();
+    }
+    writer.endArray();
 
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    file.close();
+    if(!writer.close() || !JsonUtils::replaceFile(temporaryPath, jsonFilePath)) {
+        Logger::error("WorkoutPlanRepository", "Błąd zapisu pliku", {{"path", jsonFilePath}});
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+    knownStamp = JsonUtils::fileStamp(jsonFilePath);
+    stampKnown = true;
+    return true;
+}
+
+// Parsowanie fragmentu [begin, end) treści pliku - fragment zawiera całe plany
+static std::vector<PlanRecord> parsePlanRange(const std::string& content,
+                                              size_t begin, size_t end) {
+    std::vector<PlanRecord> result;
 
     // Prosty parser - zakładamy poprawny format
-    std::shared_ptr<WorkoutPlan> currentPlan = nullptr;
-    std::string planName;
-    std::string exerciseName;
-    int sets = 0, reps = 0, restTime = 0;
-    double weight = 0.0;
+    bool inPlan = false;
+    PlanRecord current;
+    PlanEntryRecord entry;
 
-    std::istringstream stream(content);
-    std::string line;
+    size_t lineStart = begin;
+    while(lineStart < end) {
+        size_t lineEnd = content.find('\n', lineStart);
+        if(lineEnd == std::string::npos || lineEnd > end) lineEnd = end;
+        const std::string line = content.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
 
-    while(std::getline(stream, line)) {
         if(line.find("\"name\"") != std::string::npos && line.find("exerciseName") == std::string::npos) {
             // Nazwa planu
             size_t start = line.find(":") + 1;
             size_t first = line.find("\"", start) + 1;
-            size_t last = line.find("\"", first);
-            planName = unescapeJson(line.substr(first, last - first));
-            currentPlan = std::make_shared<WorkoutPlan>(planName);
+            size_t last = JsonUtils::findClosingQuote(line, first);
+            current = PlanRecord{};
+            current.name = JsonUtils::unescape(std::string_view(line).substr(first, last - first));
+            inPlan = true;
         }
         else if(line.find("\"exerciseName\"") != std::string::npos) {
             size_t start = line.find(":") + 1;
             size_t first = line.find("\"", start) + 1;
-            size_t last = line.find("\"", first);
-            exerciseName = unescapeJson(line.substr(first, last - first));
+            size_t last = JsonUtils::findClosingQuote(line, first);
+            entry.exerciseName = JsonUtils::unescape(std::string_view(line).substr(first, last - first));
         }
         else if(line.find("\"sets\"") != std::string::npos) {
             size_t pos = line.find(":") + 1;
-            sets = std::stoi(line.substr(pos));
+            entry.sets = std::stoi(line.substr(pos));
         }
         else if(line.find("\"reps\"") != std::string::npos) {
             size_t pos = line.find(":") + 1;
-            reps = std::stoi(line.substr(pos));
+            entry.reps = std::stoi(line.substr(pos));
         }
         else if(line.find("\"weight\"") != std::string::npos) {
             size_t pos = line.find(":") + 1;
-            weight = std::stod(line.substr(pos));
+            // from_chars - niezależne od locale (w przeciwieństwie do stod), para do to_chars w JsonWriter
+            size_t first = line.find_first_not_of(' ', pos);
+            if(first == std::string::npos ||
+               std::from_chars(line.data() + first, line.data() + line.size(), entry.weight).ec != std::errc()) {
+                throw std::invalid_argument("Niepoprawny ciężar: " + line);
+            }
         }
         else if(line.find("\"restTime\"") != std::string::npos) {
             size_t pos = line.find(":") + 1;
-            restTime = std::stoi(line.substr(pos));
-
-            // Mamy kompletny entry, dodajemy do planu
-            if(currentPlan) {
-                auto exercise = exerciseRepo->findByName(exerciseName);
-                if(exercise) {
-                    currentPlan->addEntry(exercise, sets, reps, weight, restTime);
-                } else {
-                    std::cerr << "Ostrzeżenie: Nie znaleziono ćwiczenia '" << exerciseName << "'" << std::endl;
-                }
+            entry.restTime = std::stoi(line.substr(pos));
+
+            // Mamy kompletny entry - ćwiczenie rozwiązujemy dopiero w fazie linkowania
+            if(inPlan) {
+                current.entries.push_back(entry);
             }
         }
         else if(line.find("]") != std::string::npos && line.find("entries") == std::string::npos) {
             // Koniec planu
-            if(currentPlan && currentPlan->getEntryCount() > 0) {
-                plans.push_back(currentPlan);
+            if(inPlan) {
+                result.push_back(std::move(current));
+            }
+            inPlan = false;
+        }
+    }
+
+    return result;
+}
+
+std::vector<PlanRecord> WorkoutPlanRepository::parseJSON(const std::string& content,
+                                                         ThreadPool* pool) {
+    PUMP_TRACE_SCOPE("WorkoutPlanRepository::parseJSON", "repo");
+
+    size_t chunks = 1;
+    if(pool && content.size() >= ExerciseRepository::PARALLEL_PARSE_THRESHOLD) {
+        chunks = pool->getThreadCount();
+    }
+
+    // Granica fragmentu tylko na linii z nazwą planu (nie "exerciseName")
+    auto ranges = JsonUtils::splitAtRecordLines(content, "\"name\"", chunks);
+    if(ranges.size() == 1) {
+        return parsePlanRange(content, ranges[0].first, ranges[0].second);
+    }
+
+    std::vector<std::future<std::vector<PlanRecord>>> parts;
+    parts.reserve(ranges.size());
+    for(const auto& range : ranges) {
+        parts.push_back(pool->submit([&content, range]() {
+            return parsePlanRange(content, range.first, range.second);
+        }));
+    }
+
+    std::vector<PlanRecord> result;
+    for(auto& part : parts) {
+        auto chunk = part.get();
+        result.insert(result.end(),
+                      std::make_move_iterator(chunk.begin()),
+                      std::make_move_iterator(chunk.end()));
+    }
+    return result;
+}
+
+bool WorkoutPlanRepository::readJSON(std::string& content) const {
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        knownStamp = JsonUtils::fileStamp(jsonFilePath);
+        stampKnown = true;
+    }
+    if(!JsonUtils::readFile(jsonFilePath, content)) {
+        Logger::warning("WorkoutPlanRepository", "Plik nie istnieje lub nie można go otworzyć", {{"path", jsonFilePath}});
+        return false;
+    }
+    return true;
+}
+
+size_t WorkoutPlanRepository::linkRecords(const std::vector<PlanRecord>& records) {
+    PUMP_TRACE_SCOPE("WorkoutPlanRepository::linkRecords", "repo");
+
+    size_t unresolved = 0;
+    std::vector<std::shared_ptr<WorkoutPlan>> linked;
+    linked.reserve(records.size());
+
+    for(const auto& record : records) {
+        if(auto plan = linkRecord(record, unresolved)) {
+            linked.push_back(std::move(plan));
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    plans = std::move(linked);
+    versions.reset(plans);
+    nameIndex.rebuild(plans);
+    countGauge.set(static_cast<int64_t>(plans.size()));
+    return unresolved;
+}
+
+std::shared_ptr<WorkoutPlan> WorkoutPlanRepository::linkRecord(const PlanRecord& record, size_t& unresolved) const {
+    auto plan = std::make_shared<WorkoutPlan>(record.name);
+
+    for(const auto& entry : record.entries) {
+        // Indeks nazw repozytorium ćwiczeń - O(1) na wpis
+        auto found = exerciseRepo->findByName(entry.exerciseName);
+        if(!found) {
+            // Zmiana pisowni (wielkość liter, bez polskich znaków) jest przyjmowana;
+            // literówka mogłaby wskazać inne ćwiczenie - wpis pomijamy z podpowiedzią
+            found = exerciseRepo->findEquivalent(entry.exerciseName);
+            if(found) {
+                Logger::warning("WorkoutPlanRepository", "Dopasowano ćwiczenie po podobnej nazwie",
+                                {{"plan", record.name}, {"exerciseName", entry.exerciseName},
+                                 {"resolved", found->getName()}});
+            } else {
+                std::string suggestions;
+                for(const auto& suggestion : exerciseRepo->suggestNames(entry.exerciseName, 3)) {
+                    suggestions += (suggestions.empty() ? "" : ", ") + suggestion.name;
+                }
+                Logger::warning("WorkoutPlanRepository", "Nie znaleziono ćwiczenia",
+                                {{"exerciseName", entry.exerciseName}, {"suggestions", suggestions}});
+                ++unresolved;
+                continue;
             }
-            currentPlan = nullptr;
         }
+
+        try {
+            plan->addEntry(found, entry.sets, entry.reps, entry.weight, entry.restTime);
+        } catch(const std::exception& e) {
+            Logger::warning("WorkoutPlanRepository", "Błędny wpis planu",
+                            {{"plan", record.name}, {"error", e.what()}});
+            ++unresolved;
+        }
+    }
+
+    // Plany bez żadnego poprawnego wpisu są pomijane
+    return plan->getEntryCount() > 0 ? plan : nullptr;
+}
+
+bool WorkoutPlanRepository::hasExternalChanges() const {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    return stampKnown && JsonUtils::fileStamp(jsonFilePath) != knownStamp;
+}
+
+void WorkoutPlanRepository::keepLocalVersion() {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    knownStamp = JsonUtils::fileStamp(jsonFilePath);
+    stampKnown = true;
+}
+
+// Ta sama treść planu - plik przechowuje tylko nazwy ćwiczeń i parametry wpisów
+static bool samePlan(const WorkoutPlan& current, const WorkoutPlan& loaded) {
+    if(current.getEntryCount() != loaded.getEntryCount()) {
+        return false;
+    }
+    const auto& before = current.getEntries();
+    const auto& after = loaded.getEntries();
+    for(size_t i = 0; i < before.size(); ++i) {
+        const PlanEntry& a = before[i];
+        const PlanEntry& b = after[i];
+        if(a.exercise->getName() != b.exercise->getName() || a.sets != b.sets || a.reps != b.reps
+           || a.weight != b.weight || a.restTime != b.restTime) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ReloadReport WorkoutPlanRepository::applyExternalChanges(const std::vector<PlanRecord>& records,
+                                                         const std::function<bool(const std::string&)>& keepLocal) {
+    PUMP_TRACE_SCOPE("WorkoutPlanRepository::applyExternalChanges", "repo");
+    ScopedLatency latency(metrics().reloadLatency);
+
+    ReloadReport report;
+    report.reloaded = true;
+    if(!exerciseRepo) {
+        Logger::error("WorkoutPlanRepository", "Brak referencji do ExerciseRepository!");
+        report.reloaded = false;
+        return report;
+    }
+
+    // Linkowanie poza storageLock (blokada repozytorium ćwiczeń nie jest zagnieżdżana)
+    size_t unresolved = 0;
+    std::vector<std::shared_ptr<WorkoutPlan>> linked;
+    std::unordered_set<std::string> inFile;
+    linked.reserve(records.size());
+    for(const auto& record : records) {
+        auto plan = linkRecord(record, unresolved);
+        if(plan && inFile.insert(plan->getName()).second) {   // Powtórzona nazwa - wygrywa pierwsza
+            linked.push_back(std::move(plan));
+        }
+    }
+
+    auto isLocal = [&keepLocal, &report](const std::string& name) {
+        if(keepLocal && keepLocal(name)) {
+            report.conflicts.push_back(name);
+            return true;
+        }
+        return false;
+    };
+
+    std::unique_lock<std::shared_mutex> lock(storageLock);
+    versions.beginBatch();
+
+    // Usunięte w pliku - od końca, żeby pozycje w versions się zgadzały
+    for(size_t i = plans.size(); i-- > 0;) {
+        const std::string name = plans[i]->getName();
+        if(inFile.count(name) == 0 && !isLocal(name)) {
+            versions.erase(i);
+            plans.erase(plans.begin() + static_cast<std::ptrdiff_t>(i));
+            reindexName(name);
+            ++report.removed;
+        }
+    }
+
+    std::unordered_map<std::string, size_t> positions;
+    positions.reserve(plans.size());
+    for(size_t i = 0; i < plans.size(); ++i) {
+        positions.emplace(plans[i]->getName(), i);
+    }
+    for(const auto& plan : linked) {
+        auto existing = positions.find(plan->getName());
+        if(existing != positions.end() && samePlan(*plans[existing->second], *plan)) {
+            ++report.unchanged;
+        } else if(isLocal(plan->getName())) {
+            continue;
+        } else if(existing == positions.end()) {
+            positions.emplace(plan->getName(), plans.size());
+            plans.push_back(plan);
+            versions.pushBack(plan);
+            nameIndex.insert(plan->getName(), plan);
+            ++report.added;
+        } else {
+            plans[existing->second] = plan;
+            versions.set(existing->second, plan);
+            nameIndex.assign(plan->getName(), plan);
+            ++report.updated;
+        }
+    }
+
+    versions.commitBatch();
+    countGauge.set(static_cast<int64_t>(plans.size()));
+    Logger::info("WorkoutPlanRepository", "Przeładowano plik zmieniony z zewnątrz",
+                 {{"added", std::to_string(report.added)}, {"updated", std::to_string(report.updated)},
+                  {"removed", std::to_string(report.removed)}, {"conflicts", std::to_string(report.conflicts.size())},
+                  {"unresolved", std::to_string(unresolved)}});
+    return report;
+}
+
+bool WorkoutPlanRepository::loadFromJSON() {
+    PUMP_TRACE_SCOPE("WorkoutPlanRepository::loadFromJSON", "repo");
+    ScopedLatency latency(metrics().loadLatency);
+
+    if(!exerciseRepo) {
+        Logger::error("WorkoutPlanRepository", "Brak referencji do ExerciseRepository!");
+        return false;
+    }
+
+    std::string content;
+    if(!readJSON(content)) {
+        return false;
     }
 
+    linkRecords(parseJSON(content, &ThreadPool::getShared()));
     return true;
 }
@@ -7,16 +7,85 @@
 
 #include "WorkoutPlan.h"
 #include "ExerciseRepository.h"
+#include "Snapshot.h"
+#include "NameIndex.h"
+#include "PlanSimilarity.h"
+#include "ExerciseRecommender.h"
+#include "BulkImport.h"
+#include "JsonUtils.h"
+#include <functional>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 
-// Repository dla planów treningowych
+// Surowy wpis planu z pliku - ćwiczenie jeszcze nie rozwiązane (tylko nazwa)
+struct PlanEntryRecord {
+    std::string exerciseName;
+    int sets = 0;
+    int reps = 0;
+    double weight = 0.0;
+    int restTime = 0;
+};
+
+// Surowy plan z pliku - wynik parsowania przed fazą linkowania
+struct PlanRecord {
+    std::string name;
+    std::vector<PlanEntryRecord> entries;
+};
+
+// Niezmienna wersja listy planów (zob. Snapshot.h)
+using WorkoutPlanSnapshot = RepositorySnapshot<WorkoutPlan>;
+using WorkoutPlanChangeBatch = ChangeBatch<WorkoutPlan>;
+
+// Szkic edycji planu (WorkoutPlanRepository::openDraft). Kopia robocza
+// współdzieli wpisy z opublikowaną wersją do pierwszej zmiany, więc otwarcie
+// jest O(1); wycofanie = porzucenie szkicu, zatwierdzenie = podmiana wskaźnika.
+struct PlanDraft {
+    std::string originalName;                  // Nazwa w repozytorium (pusta = nowy plan)
+    std::shared_ptr<const WorkoutPlan> base;   // Wersja, z której powstał szkic (nullptr = nowy)
+    std::shared_ptr<WorkoutPlan> plan;         // Kopia robocza - tylko właściciel szkicu ją zmienia
+
+    bool isNew() const { return base == nullptr; }
+};
+
+// Repository dla planów treningowych.
+// Wątki: gwarancje jak w ExerciseRepository (pisarze pod storageLock, findByName
+// przez indeks shardowany, getSnapshot bez blokad).
 class WorkoutPlanRepository {
 private:
     std::vector<std::shared_ptr<WorkoutPlan>> plans;  // Kontener planów
     std::string jsonFilePath;                         // Ścieżka do pliku JSON
+    Gauge& countGauge;                                // pumpapp_plans{file=...} - seria tej instancji
     ExerciseRepository* exerciseRepo;                 // Referencja do repo ćwiczeń (potrzebne do odczytu JSON)
+    VersionPublisher<WorkoutPlan> versions;           // Wersje dla czytelników (MVCC)
+    mutable std::mutex fileMutex;                     // Jeden zapis pliku naraz (zapis w tle)
+    mutable JsonUtils::FileStamp knownStamp;          // Stan pliku po odczycie/zapisie (pod fileMutex)
+    mutable bool stampKnown = false;
+    mutable std::shared_mutex storageLock;            // Kopia robocza + versions
+    NameIndex<WorkoutPlan> nameIndex;                 // Nazwa -> plan, O(1)
+    PlanSimilarityIndex similarityIndex;              // Podobne plany po zawartości (LSH)
+    ExerciseRecommender recommender;                  // Współwystąpienia ćwiczeń w planach
+
+    // Pozycja w kopii roboczej / przywrócenie duplikatu nazwy - pod storageLock
+    size_t indexOf(const std::string& name) const;
+    void reindexName(const std::string& name);
+
+    // Ćwiczenia dodanego/zmienionego planu jako "ostatnio używane" (sortowanie RECENT)
+    void markExercisesUsed(const WorkoutPlan& plan);
+
+    // Indeksy zawartości (podobieństwo, rekomendacje) - subskrybent własnych
+    // wersji, aktualizowane partią zmian przy publikacji (pod storageLock)
+    void applyContentChanges(const WorkoutPlanChangeBatch& batch);
+    void rebuildContent();
+
+    // Podmiana planu na pozycji index - pod storageLock
+    void replaceLocked(size_t index, const std::string& oldName, std::shared_ptr<WorkoutPlan> newPlan);
+
+    // Plan z rekordu (nazwy ćwiczeń przez exerciseRepo) - poza storageLock;
+    // nullptr gdy nie ma żadnego poprawnego wpisu
+    std::shared_ptr<WorkoutPlan> linkRecord(const PlanRecord& record, size_t& unresolved) const;
 
 public:
     // Konstruktor
@@ -31,7 +100,7 @@ public:
     // Create - dodanie nowego planu
     void addPlan(std::shared_ptr<WorkoutPlan> plan);
 
-    // Read - pobranie wszystkich planów
+    // Read - pobranie wszystkich planów (kopia robocza - tylko wątek pisarza/GUI)
     const std::vector<std::shared_ptr<WorkoutPlan>>& getAllPlans() const {
         return plans;
     }
@@ -42,28 +111,121 @@ public:
     // Read - wyszukiwanie planów po fragmencie nazwy
     std::vector<std::shared_ptr<WorkoutPlan>> searchByName(const std::string& query) const;
 
+    // Read - plany o podobnej zawartości (zob. PlanSimilarityIndex::query);
+    // plan nie musi być w repozytorium (np. szkic), sam plan jest pomijany
+    std::vector<SimilarPlan> findSimilarPlans(const WorkoutPlan& plan, size_t limit = 10,
+                                              double minSimilarity = 0.5) const;
+
+    // Skupiska prawie-duplikatów w ostatniej opublikowanej wersji - równolegle
+    // w puli (pool == nullptr = wspólna pula), bez blokowania pisarza
+    std::vector<PlanCluster> findNearDuplicates(double threshold = 0.8,
+                                                ThreadPool* pool = nullptr) const;
+
+    // Read - ćwiczenia często łączone w planach z tymi ze szkicu
+    // (zob. ExerciseRecommender::recommend)
+    std::vector<ExerciseRecommendation> recommendExercises(const WorkoutPlan& draft, size_t limit = 5) const;
+
     // Update - aktualizacja planu
     bool updatePlan(const std::string& oldName, std::shared_ptr<WorkoutPlan> newPlan);
 
     // Delete - usunięcie planu po nazwie
     bool removePlan(const std::string& name);
 
+    // === Szkice (edycja transakcyjna) ===
+
+    // Szkic istniejącego planu (plan == nullptr, gdy nie ma takiej nazwy)
+    PlanDraft openDraft(const std::string& name) const;
+
+    // Szkic nowego planu
+    static PlanDraft newDraft(const std::string& name);
+
+    // Zatwierdzenie szkicu: nowy plan jak addPlan (wyjątek przy zajętej nazwie),
+    // istniejący - podmiana, o ile w repozytorium jest wciąż wersja base.
+    // false = konflikt (plan zmieniony lub usunięty od otwarcia szkicu), bez zmian.
+    bool commitDraft(const PlanDraft& draft);
+
+    // Import wsadowy planów z rekordów (nazwy ćwiczeń rozwiązywane przez exerciseRepo).
+    // Plan z nieznanym ćwiczeniem lub błędnym wpisem jest w całości odrzucany
+    // (błąd w raporcie); poprawne plany trafiają do jednej nowej wersji.
+    ImportReport importPlans(const std::vector<PlanRecord>& records,
+                             const ImportOptions& options = ImportOptions());
+
+    // === Snapshoty (MVCC) - zasady jak w ExerciseRepository ===
+    // Opublikowanych planów nie wolno zmieniać w miejscu - edycja to nowy obiekt
+    // (kopia) podmieniany przez updatePlan.
+
+    std::shared_ptr<const WorkoutPlanSnapshot> getSnapshot() const;
+
+    void beginBatch();
+    void commitBatch();
+
+    // Listener wołany pod storageLock (jak w ExerciseRepository)
+    void setPublishListener(std::function<void()> listener) {
+        std::unique_lock<std::shared_mutex> lock(storageLock);
+        versions.setListener(std::move(listener));
+    }
+
+    // Subskrypcja zmian planów (jak ExerciseRepository::subscribe)
+    uint64_t subscribe(std::function<void(const WorkoutPlanChangeBatch&)> subscriber) {
+        std::unique_lock<std::shared_mutex> lock(storageLock);
+        return versions.subscribe(std::move(subscriber));
+    }
+
+    void unsubscribe(uint64_t id) {
+        std::unique_lock<std::shared_mutex> lock(storageLock);
+        versions.unsubscribe(id);
+    }
+
     // === Persistence (JSON) ===
 
-    // Zapis do pliku JSON
+    // Zapis ostatniej opublikowanej wersji do pliku JSON (bezpieczne w tle)
     bool saveToJSON() const;
 
+    // Zapis konkretnej wersji (np. spójnej z ćwiczeniami - DatabaseManager::saveAll)
+    bool saveSnapshot(const WorkoutPlanSnapshot& snapshot) const;
+
     // Odczyt z pliku JSON (wymaga wcześniej ustawionego exerciseRepo!)
     bool loadFromJSON();
 
+    // === Ładowanie etapami (parsowanie nie wymaga załadowanych ćwiczeń) ===
+
+    // Odczyt surowej treści pliku JSON
+    bool readJSON(std::string& content) const;
+
+    // Parsowanie do rekordów z nazwami ćwiczeń - można uruchomić równolegle
+    // z ładowaniem ćwiczeń, duże pliki dzielone są na fragmenty w puli wątków
+    static std::vector<PlanRecord> parseJSON(const std::string& content,
+                                             ThreadPool* pool = nullptr);
+
+    // Faza linkowania: rozwiązanie nazw ćwiczeń przez exerciseRepo i podmiana planów.
+    // Nazwa równa jednemu ćwiczeniu po normalizacji (ExerciseRepository::findEquivalent)
+    // jest przyjmowana z ostrzeżeniem w logu; literówki tylko z podpowiedzią w logu.
+    // Zwraca liczbę pominiętych wpisów (nieznane ćwiczenie / błędne parametry).
+    size_t linkRecords(const std::vector<PlanRecord>& records);
+
+    // === Zmiany pliku z zewnątrz (zasady jak w ExerciseRepository) ===
+
+    bool hasExternalChanges() const;
+    void keepLocalVersion();
+
+    // Różnica między rekordami z pliku a pamięcią jako jedna nowa wersja
+    // (plany porównywane po nazwach ćwiczeń i parametrach wpisów)
+    ReloadReport applyExternalChanges(const std::vector<PlanRecord>& records,
+                                      const std::function<bool(const std::string&)>& keepLocal = nullptr);
+
     // Liczba planów w repozytorium
-    size_t getCount() const { return plans.size(); }
+    size_t getCount() const;
+
+    const std::string& getFilePath() const { return jsonFilePath; }
 
     // Sprawdzenie czy istnieje plan o danej nazwie
     bool exists(const std::string& name) const;
 
     // Wyczyszczenie całego repozytorium
-    void clear() { plans.clear(); }
+    void clear();
+
+    // Przybliżona pamięć zajmowana przez plany (bajty) - do metryk
+    size_t estimateMemoryUsage() const;
 };
 
 #endif // WORKOUTPLANREPOSITORY_H
@@ -0,0 +1,88 @@
+// DiagnosticsDialog.cpp
+// Lokalizacja: gui/DiagnosticsDialog.cpp
+
+#include "DiagnosticsDialog.h"
+#include "ui_DiagnosticsDialog.h"
+#include "../core/Metrics.h"
+#include "../core/Trace.h"
+#include <QFileDialog>
+#include <QFontDatabase>
+#include <QMessageBox>
+
+DiagnosticsDialog::DiagnosticsDialog(QWidget *parent, DatabaseManager* dbManager)
+    : QDialog(parent)
+    , ui(new Ui::DiagnosticsDialog)
+    , db(dbManager)
+{
+    ui->setupUi(this);
+    setupUI();
+    setWindowTitle(QString::fromUtf8("Diagnostyka"));
+    onRefresh();
+}
+
+DiagnosticsDialog::~DiagnosticsDialog()
+{
+    delete ui;
+}
+
+void DiagnosticsDialog::setupUI()
+{
+    connect(ui->btnRefresh, &QPushButton::clicked, this, &DiagnosticsDialog::onRefresh);
+    connect(ui->btnSaveMetrics, &QPushButton::clicked, this, &DiagnosticsDialog::onSaveMetrics);
+    connect(ui->btnExportTrace, &QPushButton::clicked, this, &DiagnosticsDialog::onExportTrace);
+    connect(ui->buttonBox, &QDialogButtonBox::rejected, this, &DiagnosticsDialog::reject);
+
+    ui->btnRefresh->setText(QString::fromUtf8("Odśwież"));
+    ui->btnSaveMetrics->setText(QString::fromUtf8("Zapisz metryki..."));
+    ui->btnExportTrace->setText(QString::fromUtf8("Eksportuj trace..."));
+    ui->plainTextMetrics->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+}
+
+void DiagnosticsDialog::onRefresh()
+{
+    db->updateMetrics();
+
+    auto& registry = MetricsRegistry::getInstance();
+    const auto& search = registry.histogram("pumpapp_exercise_search_latency_us");
+    const auto& save = registry.histogram("pumpapp_db_save_latency_us");
+
+    ui->labelSummary->setText(
+        QString::fromUtf8("Ćwiczenia: %1 | Plany: %2 | Pamięć katalogu: %3 KB\n"
+                          "Wyszukiwanie p50/p99: %4/%5 µs | Zapis p50/p99: %6/%7 µs")
+            .arg(db->getExerciseRepository().getCount())
+            .arg(db->getWorkoutPlanRepository().getCount())
+            .arg(registry.gauge(MetricsRegistry::labeled("pumpapp_catalog_memory_bytes", "data_dir",
+                                                         db->getDataDir())).get() / 1024)
+            .arg(search.percentile(0.50))
+            .arg(search.percentile(0.99))
+            .arg(save.percentile(0.50))
+            .arg(save.percentile(0.99)));
+
+    ui->plainTextMetrics->setPlainText(QString::fromStdString(registry.toPrometheusText()));
+}
+
+void DiagnosticsDialog::onSaveMetrics()
+{
+    QString path = QFileDialog::getSaveFileName(this, QString::fromUtf8("Zapisz metryki"),
+                                                QStringLiteral("metrics.prom"),
+                                                QString::fromUtf8("Prometheus (*.prom *.txt);;JSON (*.json)"));
+    if (path.isEmpty()) return;
+
+    if (!db->dumpMetrics(path.toStdString())) {
+        QMessageBox::warning(this, QString::fromUtf8("Błąd"),
+                             QString::fromUtf8("Nie udało się zapisać metryk!"));
+    }
+}
+
+void DiagnosticsDialog::onExportTrace()
+{
+    QString path = QFileDialog::getSaveFileName(this, QString::fromUtf8("Eksportuj trace"),
+                                                QStringLiteral("pumpapp_trace.json"),
+                                                QString::fromUtf8("Chrome Trace (*.json)"));
+    if (path.isEmpty()) return;
+
+    if (!Tracer::getInstance().exportChromeTrace(path.toStdString())) {
+        QMessageBox::warning(this, QString::fromUtf8("Błąd"),
+                             QString::fromUtf8("Nie udało się zapisać trace!"));
+    }
+}
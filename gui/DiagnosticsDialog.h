@@ -0,0 +1,37 @@
+// DiagnosticsDialog.h
+// Lokalizacja: gui/DiagnosticsDialog.h
+// Opis: Dialog diagnostyczny - podgląd metryk (MetricsRegistry) i eksport trace
+
+#ifndef DIAGNOSTICSDIALOG_H
+#define DIAGNOSTICSDIALOG_H
+
+#include <QDialog>
+#include "../core/DatabaseManager.h"
+
+QT_BEGIN_NAMESPACE
+namespace Ui {
+class DiagnosticsDialog;
+}
+QT_END_NAMESPACE
+
+class DiagnosticsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    DiagnosticsDialog(QWidget *parent, DatabaseManager* dbManager);
+    ~DiagnosticsDialog();
+
+private slots:
+    void onRefresh();
+    void onSaveMetrics();
+    void onExportTrace();
+
+private:
+    Ui::DiagnosticsDialog *ui;
+    DatabaseManager* db = nullptr;
+
+    void setupUI();
+};
+
+#endif // DIAGNOSTICSDIALOG_H
@@ -0,0 +1,122 @@
+// ExerciseListModel.cpp
+// Lokalizacja: gui/ExerciseListModel.cpp
+
+#include "ExerciseListModel.h"
+
+ExerciseListModel::ExerciseListModel(ExerciseRepository& repository, QObject *parent)
+    : QAbstractListModel(parent)
+    , repo(repository)
+{
+    query.sortBy = ExerciseSortKey::RECENT;
+    query.pageSize = PAGE_SIZE;
+}
+
+int ExerciseListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    return pinnedCount() + static_cast<int>(items.size());
+}
+
+QVariant ExerciseListModel::data(const QModelIndex &index, int role) const
+{
+    auto exercise = exerciseAt(index);
+    if (!exercise) return QVariant();
+
+    const QString name = QString::fromStdString(exercise->getName());
+    switch (role) {
+    case Qt::DisplayRole: {
+        if (index.row() < pinnedCount()) {
+            return QString::fromUtf8("⭐ %1").arg(name);
+        }
+        QString typeIcon = (exercise->getType() == ExerciseType::WEIGHTED) ? QString::fromUtf8("🏋️") : QString::fromUtf8("💪");
+        return QString("%1 %2").arg(typeIcon, name);
+    }
+    case Qt::ToolTipRole:
+        return QString::fromStdString(exercise->getTargetMuscles());
+    case NameRole:
+        return name;
+    default:
+        return QVariant();
+    }
+}
+
+bool ExerciseListModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && !exhausted;
+}
+
+void ExerciseListModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid() || exhausted) return;
+
+    ExercisePage page = repo.queryExercises(query);
+    if (!page.items.empty()) {
+        const int first = rowCount();
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(page.items.size()) - 1);
+        items.insert(items.end(), page.items.begin(), page.items.end());
+        endInsertRows();
+    }
+    query.cursor = page.nextCursor;
+    exhausted = !page.hasMore();
+}
+
+bool ExerciseListModel::loadPage()
+{
+    ExercisePage page = repo.queryExercises(query);
+    items.insert(items.end(), page.items.begin(), page.items.end());
+    query.cursor = page.nextCursor;
+    exhausted = !page.hasMore();
+    return !page.items.empty();
+}
+
+void ExerciseListModel::setFilter(const QString &text)
+{
+    beginResetModel();
+    filterText = text.trimmed();
+    query.nameContains = filterText.toStdString();
+    query.cursor.clear();
+    items.clear();
+
+    // Brak trafień po fragmencie nazwy - literówka? Najbliższe nazwy z indeksu podpowiedzi
+    if (!loadPage() && !filterText.isEmpty()) {
+        for (const auto& suggestion : repo.suggestNames(query.nameContains, 10)) {
+            if (auto exercise = repo.findByName(suggestion.name)) {
+                items.push_back(exercise);
+            }
+        }
+        exhausted = true;
+    }
+    endResetModel();
+}
+
+void ExerciseListModel::setPinned(const std::vector<std::string> &names)
+{
+    std::vector<std::shared_ptr<Exercise>> resolved;
+    for (const auto& name : names) {
+        if (auto exercise = repo.findByName(name)) {   // Usunięte, ale wciąż w planach - pomijamy
+            resolved.push_back(exercise);
+        }
+    }
+
+    if (filterText.isEmpty() && !pinned.empty()) {
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(pinned.size()) - 1);
+        pinned.clear();
+        endRemoveRows();
+    }
+    if (filterText.isEmpty() && !resolved.empty()) {
+        beginInsertRows(QModelIndex(), 0, static_cast<int>(resolved.size()) - 1);
+        pinned = std::move(resolved);
+        endInsertRows();
+        return;
+    }
+    pinned = std::move(resolved);
+}
+
+std::shared_ptr<Exercise> ExerciseListModel::exerciseAt(const QModelIndex &index) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= rowCount()) return nullptr;
+
+    const size_t row = static_cast<size_t>(index.row());
+    const size_t pinnedRows = static_cast<size_t>(pinnedCount());
+    return row < pinnedRows ? pinned[row] : items[row - pinnedRows];
+}
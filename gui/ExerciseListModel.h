@@ -0,0 +1,61 @@
+// ExerciseListModel.h
+// Lokalizacja: gui/ExerciseListModel.h
+// Opis: Model listy ćwiczeń do wyboru w WorkoutPlanDialog. Wiersze pobierane
+//       stronami z ExerciseRepository::queryExercises dopiero, gdy widok ich
+//       potrzebuje (canFetchMore/fetchMore), więc otwarcie dialogu nie zależy
+//       od rozmiaru katalogu. Filtr po fragmencie nazwy korzysta z tego samego
+//       zapytania; brak trafień - podpowiedzi "czy chodziło o..." (suggestNames).
+//       Nad listą (przy pustym filtrze) - przypięte rekomendacje dla szkicu.
+// Design Pattern: Model/View (Qt)
+
+#ifndef EXERCISELISTMODEL_H
+#define EXERCISELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../core/ExerciseRepository.h"
+
+class ExerciseListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr size_t PAGE_SIZE = 200;
+
+    enum Roles {
+        NameRole = Qt::UserRole   // Nazwa ćwiczenia bez ikony
+    };
+
+    explicit ExerciseListModel(ExerciseRepository& repository, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    // Nowy filtr - lista od początku (pierwsza strona od razu)
+    void setFilter(const QString &text);
+    QString filter() const { return filterText; }
+
+    // Rekomendacje na górze listy (tylko przy pustym filtrze)
+    void setPinned(const std::vector<std::string> &names);
+    int pinnedCount() const { return filterText.isEmpty() ? static_cast<int>(pinned.size()) : 0; }
+
+    std::shared_ptr<Exercise> exerciseAt(const QModelIndex &index) const;
+
+private:
+    ExerciseRepository& repo;
+    QString filterText;
+    ExerciseQuery query;
+    bool exhausted = false;
+    std::vector<std::shared_ptr<Exercise>> pinned;
+    std::vector<std::shared_ptr<Exercise>> items;
+
+    // Strona bez powiadomień widoku (reset modelu) - false gdy pusta
+    bool loadPage();
+};
+
+#endif // EXERCISELISTMODEL_H
@@ -4,9 +4,15 @@
 #include "MainWindow.h"
 #include "ui_MainWindow.h"
 #include <QMessageBox>
+#include <QMenu>
+#include <QComboBox>
+#include <QStatusBar>
+#include <QFileInfo>
 #include "ExerciseDialog.h"
 #include "WorkoutPlanDialog.h"
+#include "DiagnosticsDialog.h"
 #include "ui_ExerciseDialog.h"
+#include "../core/Trace.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -35,6 +41,19 @@ MainWindow::MainWindow(QWidget *parent)
     ui->lineSearchPlans->setPlaceholderText(QString::fromUtf8("Szukaj planu..."));
 
     setupConnections();
+    setupMenu();
+    subscribeToChanges();
+
+    // Zmiany plików danych spoza aplikacji - przeładowanie po RELOAD_DEBOUNCE_MS ciszy
+    fileWatcher = new QFileSystemWatcher(this);
+    reloadTimer = new QTimer(this);
+    reloadTimer->setSingleShot(true);
+    reloadTimer->setInterval(RELOAD_DEBOUNCE_MS);
+    connect(fileWatcher, &QFileSystemWatcher::fileChanged, this, &MainWindow::onDataFilesChanged);
+    connect(fileWatcher, &QFileSystemWatcher::directoryChanged, this, &MainWindow::onDataFilesChanged);
+    connect(reloadTimer, &QTimer::timeout, this, &MainWindow::onReloadChangedFiles);
+    watchDataFiles();
+
     refreshExerciseList();
     refreshPlanList();
     updateExerciseButtons();
@@ -42,15 +61,287 @@ MainWindow::MainWindow(QWidget *parent)
 }
 
 MainWindow::~MainWindow() {
+    // Zamknięcie okna w trakcie ładowania - czekamy na wątek, bo pisze do repozytoriów
+    if(loaderThread) {
+        loaderThread->wait();
+    }
+    db.getExerciseRepository().unsubscribe(exerciseSubscription);
+    db.getWorkoutPlanRepository().unsubscribe(planSubscription);
     delete ui;
 }
 
+void MainWindow::startProgressiveLoad() {
+    if(loading) return;
+
+    loadProgress = new QProgressBar(this);
+    loadProgress->setMaximumWidth(240);
+    loadProgress->setRange(0, 0);  // Nieokreślony postęp w trakcie parsowania
+    loadProgress->setFormat(QString::fromUtf8("Ładowanie %p%"));
+    ui->statusbar->addPermanentWidget(loadProgress);
+    ui->statusbar->showMessage(QString::fromUtf8("Ładowanie danych..."));
+
+    setLoadingState(true);
+
+    // initialize() wypełnia repozytoria - GUI nie czyta ich aż do onDataLoaded()
+    DatabaseManager* database = &db;
+    loaderThread = QThread::create([database]() {
+        database->initialize();
+    });
+    connect(loaderThread, &QThread::finished, this, &MainWindow::onDataLoaded);
+    loaderThread->start();
+}
+
+void MainWindow::onDataLoaded() {
+    PUMP_TRACE_SCOPE("MainWindow::onDataLoaded", "gui");
+
+    loaderThread->deleteLater();
+    loaderThread = nullptr;
+
+    ui->listExercises->clear();
+    ui->listPlans->clear();
+    populatedExercises = 0;
+    populatedPlans = 0;
+    exerciseCursor.clear();
+    exercisesPopulated = false;
+
+    size_t total = db.getExerciseRepository().getCount() + db.getWorkoutPlanRepository().getCount();
+    loadProgress->setRange(0, static_cast<int>(total));
+    loadProgress->setValue(0);
+
+    // Wiersze dodajemy porcjami, żeby okno pozostało responsywne
+    populateTimer = new QTimer(this);
+    populateTimer->setInterval(0);
+    connect(populateTimer, &QTimer::timeout, this, &MainWindow::onPopulateBatch);
+    populateTimer->start();
+}
+
+void MainWindow::onPopulateBatch() {
+    PUMP_TRACE_SCOPE("MainWindow::onPopulateBatch", "gui");
+
+    const auto& plans = db.getWorkoutPlanRepository().getAllPlans();
+
+    // Ćwiczenia stronami w wybranym porządku - strona = kursor + budżet wierszy
+    size_t budget = POPULATE_BATCH_SIZE;
+    if(!exercisesPopulated) {
+        ExerciseQuery query = exerciseQuery();
+        query.pageSize = budget;
+        query.cursor = exerciseCursor;
+        auto page = db.getExerciseRepository().queryExercises(query);
+        for(const auto& ex : page.items) {
+            addExerciseItem(*ex);
+        }
+        populatedExercises += page.items.size();
+        budget -= page.items.size();
+        exerciseCursor = page.nextCursor;
+        exercisesPopulated = !page.hasMore();
+    }
+    while(budget > 0 && populatedPlans < plans.size()) {
+        addPlanItem(*plans[populatedPlans++]);
+        --budget;
+    }
+
+    loadProgress->setValue(static_cast<int>(populatedExercises + populatedPlans));
+
+    if(!exercisesPopulated || populatedPlans < plans.size()) {
+        return;
+    }
+
+    // Koniec - sprzątanie i włączenie edycji
+    populateTimer->stop();
+    populateTimer->deleteLater();
+    populateTimer = nullptr;
+
+    ui->statusbar->removeWidget(loadProgress);
+    loadProgress->deleteLater();
+    loadProgress = nullptr;
+    ui->statusbar->showMessage(QString::fromUtf8("Załadowano %1 ćwiczeń i %2 planów")
+                                   .arg(populatedExercises)
+                                   .arg(plans.size()), 5000);
+
+    setLoadingState(false);
+    watchDataFiles();
+
+    // Użytkownik mógł wpisać zapytanie w trakcie ładowania
+    if(!ui->lineSearchExercises->text().isEmpty()) onSearchExercises();
+    if(!ui->lineSearchPlans->text().isEmpty()) onSearchPlans();
+}
+
+void MainWindow::setLoadingState(bool isLoading) {
+    loading = isLoading;
+
+    ui->btnAddExercise->setEnabled(!isLoading);
+    ui->btnAddPlan->setEnabled(!isLoading);
+    ui->lineSearchExercises->setEnabled(!isLoading);
+    ui->comboSortExercises->setEnabled(!isLoading);
+    ui->lineSearchPlans->setEnabled(!isLoading);
+
+    updateExerciseButtons();
+    updatePlanButtons();
+    updateUndoActions();
+}
+
+void MainWindow::updateUndoActions() {
+    if(!undoAction) return;
+
+    CommandLog& log = db.getCommandLog();
+    undoAction->setEnabled(!loading && log.canUndo());
+    redoAction->setEnabled(!loading && log.canRedo());
+    undoAction->setText(log.canUndo()
+                            ? QString::fromUtf8("Cofnij: %1").arg(QString::fromStdString(log.undoLabel()))
+                            : QString::fromUtf8("Cofnij"));
+    redoAction->setText(log.canRedo()
+                            ? QString::fromUtf8("Ponów: %1").arg(QString::fromStdString(log.redoLabel()))
+                            : QString::fromUtf8("Ponów"));
+}
+
+void MainWindow::addExerciseItem(const Exercise& exercise, int row) {
+    QString typeIcon = (exercise.getType() == ExerciseType::WEIGHTED) ? QString::fromUtf8("🏋️") : QString::fromUtf8("💪");
+    QString itemText = QString("%1 %2").arg(typeIcon, QString::fromStdString(exercise.getName()));
+    auto* item = new QListWidgetItem(itemText);
+    item->setData(NameRole, QString::fromStdString(exercise.getName()));
+
+    // Klucz sortowania do wstawiania pojedynczych zmian (RECENT zmienia się bez zdarzeń)
+    ExerciseSortKey sortBy = exerciseQuery().sortBy;
+    if(sortBy != ExerciseSortKey::RECENT) {
+        item->setData(SortKeyRole, QByteArray::fromStdString(exerciseSortKey(sortBy, exercise)));
+    }
+    ui->listExercises->insertItem(row < 0 ? ui->listExercises->count() : row, item);
+}
+
+ExerciseQuery MainWindow::exerciseQuery() const {
+    static const ExerciseSortKey keys[] = {ExerciseSortKey::NAME, ExerciseSortKey::TYPE,
+                                           ExerciseSortKey::MUSCLES, ExerciseSortKey::RECENT};
+    ExerciseQuery query;
+    int index = ui->comboSortExercises->currentIndex();
+    query.sortBy = keys[(index >= 0 && index < 4) ? index : 0];
+    query.pageSize = POPULATE_BATCH_SIZE;
+    return query;
+}
+
+size_t MainWindow::addExercisePages(ExerciseQuery query) {
+    size_t added = 0;
+    do {
+        auto page = db.getExerciseRepository().queryExercises(query);
+        for(const auto& ex : page.items) {
+            addExerciseItem(*ex);
+        }
+        added += page.items.size();
+        query.cursor = page.nextCursor;
+    } while(!query.cursor.empty());
+    return added;
+}
+
+void MainWindow::addPlanItem(const WorkoutPlan& plan) {
+    auto* item = new QListWidgetItem();
+    setPlanItem(item, plan);
+    ui->listPlans->addItem(item);
+}
+
+void MainWindow::setPlanItem(QListWidgetItem* item, const WorkoutPlan& plan) {
+    item->setText(QString::fromUtf8("📋 %1 (%2 ćwiczeń)")
+                      .arg(QString::fromStdString(plan.getName()))
+                      .arg(plan.getEntryCount()));
+    item->setData(NameRole, QString::fromStdString(plan.getName()));
+}
+
+void MainWindow::subscribeToChanges() {
+    // Subskrybent działa w wątku pisarza pod blokadą repozytorium - tylko
+    // kopiuje partię do kolejki zdarzeń GUI (usunięte okno = zdarzenie pominięte)
+    exerciseSubscription = db.getExerciseRepository().subscribe([this](const ExerciseChangeBatch& batch) {
+        QMetaObject::invokeMethod(this, [this, batch]() { applyExerciseChanges(batch); }, Qt::QueuedConnection);
+    });
+    planSubscription = db.getWorkoutPlanRepository().subscribe([this](const WorkoutPlanChangeBatch& batch) {
+        QMetaObject::invokeMethod(this, [this, batch]() { applyPlanChanges(batch); }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::applyExerciseChanges(const ExerciseChangeBatch& batch) {
+    PUMP_TRACE_SCOPE("MainWindow::applyExerciseChanges", "gui");
+    if(loading) {
+        return;  // onDataLoaded i tak wypełnia listę od nowa
+    }
+
+    const ExerciseSortKey sortBy = exerciseQuery().sortBy;
+    if(batch.reset || sortBy == ExerciseSortKey::RECENT || !ui->lineSearchExercises->text().isEmpty()) {
+        onSortExercisesChanged();
+        return;
+    }
+
+    for(const auto& change : batch.changes) {
+        if(change.before) {
+            const QByteArray key = QByteArray::fromStdString(exerciseSortKey(sortBy, *change.before));
+            const int row = exerciseRow(key);
+            if(row < ui->listExercises->count() && ui->listExercises->item(row)->data(SortKeyRole).toByteArray() == key) {
+                delete ui->listExercises->takeItem(row);
+            }
+        }
+        if(change.after) {
+            addExerciseItem(*change.after, exerciseRow(QByteArray::fromStdString(exerciseSortKey(sortBy, *change.after))));
+        }
+    }
+    updateExerciseButtons();
+}
+
+void MainWindow::applyPlanChanges(const WorkoutPlanChangeBatch& batch) {
+    PUMP_TRACE_SCOPE("MainWindow::applyPlanChanges", "gui");
+    if(loading) {
+        return;
+    }
+
+    if(batch.reset || !ui->lineSearchPlans->text().isEmpty()) {
+        onSearchPlans();
+        return;
+    }
+
+    // Kolejność listy = kolejność repozytorium: nowe na końcu, podmiana w miejscu
+    for(const auto& change : batch.changes) {
+        QListWidgetItem* item = change.before
+                                    ? findPlanItem(QString::fromStdString(change.before->getName()))
+                                    : nullptr;
+        if(!change.after) {
+            delete item;
+        } else if(item) {
+            setPlanItem(item, *change.after);
+        } else {
+            addPlanItem(*change.after);
+        }
+    }
+    updatePlanButtons();
+}
+
+int MainWindow::exerciseRow(const QByteArray& sortKey) const {
+    int first = 0;
+    int count = ui->listExercises->count();
+    while(count > 0) {
+        const int step = count / 2;
+        if(ui->listExercises->item(first + step)->data(SortKeyRole).toByteArray() < sortKey) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+QListWidgetItem* MainWindow::findPlanItem(const QString& name) const {
+    for(int row = 0; row < ui->listPlans->count(); ++row) {
+        QListWidgetItem* item = ui->listPlans->item(row);
+        if(item->data(NameRole).toString() == name) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
 void MainWindow::setupConnections() {
     connect(ui->btnAddExercise, &QPushButton::clicked, this, &MainWindow::onAddExercise);
     connect(ui->btnEditExercise, &QPushButton::clicked, this, &MainWindow::onEditExercise);
     connect(ui->btnDeleteExercise, &QPushButton::clicked, this, &MainWindow::onDeleteExercise);
     connect(ui->lineSearchExercises, &QLineEdit::textChanged, this, &MainWindow::onSearchExercises);
     connect(ui->listExercises, &QListWidget::itemSelectionChanged, this, &MainWindow::onExerciseSelectionChanged);
+    connect(ui->comboSortExercises, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onSortExercisesChanged);
 
     connect(ui->btnAddPlan, &QPushButton::clicked, this, &MainWindow::onAddPlan);
     connect(ui->btnEditPlan, &QPushButton::clicked, this, &MainWindow::onEditPlan);
@@ -60,26 +351,65 @@ void MainWindow::setupConnections() {
     connect(ui->listPlans, &QListWidget::itemSelectionChanged, this, &MainWindow::onPlanSelectionChanged);
 }
 
-void MainWindow::refreshExerciseList() {
-    ui->listExercises->clear();
+void MainWindow::setupMenu() {
+    QMenu* editMenu = ui->menubar->addMenu(QString::fromUtf8("Edycja"));
+    undoAction = editMenu->addAction(QString::fromUtf8("Cofnij"));
+    undoAction->setShortcut(QKeySequence::Undo);
+    connect(undoAction, &QAction::triggered, this, &MainWindow::onUndo);
+    redoAction = editMenu->addAction(QString::fromUtf8("Ponów"));
+    redoAction->setShortcut(QKeySequence::Redo);
+    connect(redoAction, &QAction::triggered, this, &MainWindow::onRedo);
+    updateUndoActions();
+
+    QMenu* helpMenu = ui->menubar->addMenu(QString::fromUtf8("Pomoc"));
+    QAction* diagnosticsAction = helpMenu->addAction(QString::fromUtf8("Diagnostyka..."));
+    connect(diagnosticsAction, &QAction::triggered, this, &MainWindow::onShowDiagnostics);
+}
 
-    const auto& exercises = db.getExerciseRepository().getAllExercises();
-    for(const auto& ex : exercises) {
-        QString typeIcon = (ex->getType() == ExerciseType::WEIGHTED) ? QString::fromUtf8("🏋️") : QString::fromUtf8("💪");
-        QString itemText = QString("%1 %2").arg(typeIcon, QString::fromStdString(ex->getName()));
-        ui->listExercises->addItem(itemText);
+void MainWindow::onShowDiagnostics() {
+    // Metryki czytają repozytoria - nie w trakcie ładowania w tle
+    if(loading) {
+        ui->statusbar->showMessage(QString::fromUtf8("Poczekaj na zakończenie ładowania danych"), 3000);
+        return;
     }
+
+    DiagnosticsDialog dialog(this, &db);
+    dialog.exec();
+}
+
+void MainWindow::onUndo() {
+    if(loading) return;
+
+    if(!db.getCommandLog().undo()) {
+        statusBar()->showMessage(QString::fromUtf8("Nie można cofnąć - dane zmieniły się poza historią"), 5000);
+    }
+    updateUndoActions();
+    saveDatabase();
+}
+
+void MainWindow::onRedo() {
+    if(loading) return;
+
+    if(!db.getCommandLog().redo()) {
+        statusBar()->showMessage(QString::fromUtf8("Nie można ponowić - dane zmieniły się poza historią"), 5000);
+    }
+    updateUndoActions();
+    saveDatabase();
+}
+
+void MainWindow::refreshExerciseList() {
+    PUMP_TRACE_SCOPE("MainWindow::refreshExerciseList", "gui");
+    ui->listExercises->clear();
+    addExercisePages(exerciseQuery());
 }
 
 void MainWindow::refreshPlanList() {
+    PUMP_TRACE_SCOPE("MainWindow::refreshPlanList", "gui");
     ui->listPlans->clear();
 
     const auto& plans = db.getWorkoutPlanRepository().getAllPlans();
     for(const auto& plan : plans) {
-        QString itemText = QString::fromUtf8("📋 %1 (%2 ćwiczeń)")
-                               .arg(QString::fromStdString(plan->getName()))
-                               .arg(plan->getEntryCount());
-        ui->listPlans->addItem(itemText);
+        addPlanItem(*plan);
     }
 }
 
@@ -88,7 +418,7 @@ void MainWindow::onExerciseSelectionChanged() {
 }
 
 void MainWindow::updateExerciseButtons() {
-    bool hasSelection = ui->listExercises->currentItem() != nullptr;
+    bool hasSelection = !loading && ui->listExercises->currentItem() != nullptr;
     ui->btnEditExercise->setEnabled(hasSelection);
     ui->btnDeleteExercise->setEnabled(hasSelection);
 }
@@ -98,18 +428,76 @@ void MainWindow::onPlanSelectionChanged() {
 }
 
 void MainWindow::updatePlanButtons() {
-    bool hasSelection = ui->listPlans->currentItem() != nullptr;
+    bool hasSelection = !loading && ui->listPlans->currentItem() != nullptr;
     ui->btnEditPlan->setEnabled(hasSelection);
     ui->btnDeletePlan->setEnabled(hasSelection);
     ui->btnViewPlan->setEnabled(hasSelection);
 }
 
 void MainWindow::saveDatabase() {
+    // Plik zmieniony z zewnątrz przed sygnałem obserwatora - najpierw jego zmiany,
+    // inaczej saveAll odmówi nadpisania
+    if(db.hasExternalChanges()) {
+        reloadTimer->stop();
+        onReloadChangedFiles();
+    }
     if(!db.saveAll()) {
         QMessageBox::warning(this, QString::fromUtf8("Błąd"), QString::fromUtf8("Nie udało się zapisać danych!"));
     }
 }
 
+void MainWindow::watchDataFiles() {
+    // Katalog - żeby zauważyć plik utworzony od nowa (zapis przez zamianę pliku
+    // usuwa go z obserwowanych); pliki - zmiany w miejscu
+    QStringList paths{QString::fromStdString(db.getDataDir())};
+    for(const auto& file : db.getDataFiles()) {
+        paths << QString::fromStdString(file);
+    }
+    const QStringList watched = fileWatcher->files() + fileWatcher->directories();
+    for(const QString& path : paths) {
+        if(!watched.contains(path) && QFileInfo::exists(path)) {
+            fileWatcher->addPath(path);
+        }
+    }
+}
+
+void MainWindow::onDataFilesChanged() {
+    reloadTimer->start();   // Kolejne zdarzenie odsuwa przeładowanie
+}
+
+void MainWindow::onReloadChangedFiles() {
+    PUMP_TRACE_SCOPE("MainWindow::onReloadChangedFiles", "gui");
+
+    // W trakcie ładowania repozytoria pisze wątek roboczy - po nim i tak watchDataFiles
+    if(loading) return;
+
+    watchDataFiles();
+    if(!db.hasExternalChanges()) return;   // Nasz własny zapis albo zmiana innego pliku
+
+    // Listy odświeżają się same - przeładowanie publikuje partie zmian (subscribeToChanges)
+    DatabaseReload reload = db.reloadChangedFiles();
+    if(!reload.any()) return;
+    updateUndoActions();
+
+    ui->statusbar->showMessage(QString::fromUtf8("Dane zmienione poza aplikacją - przeładowano "
+                                                 "(dodane: %1, zmienione: %2, usunięte: %3)")
+                                   .arg(reload.exercises.added + reload.plans.added)
+                                   .arg(reload.exercises.updated + reload.plans.updated)
+                                   .arg(reload.exercises.removed + reload.plans.removed), 5000);
+
+    QStringList conflicts;
+    for(const auto& name : reload.exercises.conflicts) conflicts << QString::fromStdString(name);
+    for(const auto& name : reload.plans.conflicts) conflicts << QString::fromStdString(name);
+    if(reload.exercises.resetConflict) conflicts << QString::fromUtf8("wszystkie ćwiczenia (niezapisana podmiana całej listy)");
+    if(reload.plans.resetConflict) conflicts << QString::fromUtf8("wszystkie plany (niezapisana podmiana całej listy)");
+    if(!conflicts.isEmpty()) {
+        QMessageBox::warning(this, QString::fromUtf8("Konflikt zmian"),
+                             QString::fromUtf8("Plik danych zmieniono poza aplikacją, a te pozycje mają "
+                                               "niezapisane zmiany lokalne - zostawiono wersję lokalną:\n")
+                                 + conflicts.join("\n"));
+    }
+}
+
 // === TYMCZASOWE IMPLEMENTACJE (zadziałają po dodaniu dialogów) ===
 
 void MainWindow::onAddExercise() {
@@ -117,8 +505,8 @@ void MainWindow::onAddExercise() {
     if(dialog.exec() == QDialog::Accepted) {
         auto exercise = dialog.getExercise();
         try {
-            db.getExerciseRepository().addExercise(exercise);
-            refreshExerciseList();
+            db.getCommandLog().addExercise(exercise);
+            updateUndoActions();
             saveDatabase();
             QMessageBox::information(this, QString::fromUtf8("Sukces"),
                                      QString::fromUtf8("Ćwiczenie dodane!"));
@@ -146,8 +534,8 @@ void MainWindow::onEditExercise() {
     ExerciseDialog dialog(this, exercise);
     if(dialog.exec() == QDialog::Accepted) {
         auto updatedExercise = dialog.getExercise();
-        db.getExerciseRepository().updateExercise(exName.toStdString(), updatedExercise);
-        refreshExerciseList();
+        db.getCommandLog().updateExercise(exName.toStdString(), updatedExercise);
+        updateUndoActions();
         saveDatabase();
         QMessageBox::information(this, QString::fromUtf8("Sukces"),
                                  QString::fromUtf8("Ćwiczenie zaktualizowane!"));
@@ -166,14 +554,15 @@ void MainWindow::onDeleteExercise() {
                                        QMessageBox::Yes | QMessageBox::No);
 
     if(reply == QMessageBox::Yes) {
-        db.getExerciseRepository().removeExercise(exName.toStdString());
-        refreshExerciseList();
+        db.getCommandLog().removeExercise(exName.toStdString());
+        updateUndoActions();
         saveDatabase();
         QMessageBox::information(this, QString::fromUtf8("Sukces"), QString::fromUtf8("Ćwiczenie usunięte!"));
     }
 }
 
 void MainWindow::onSearchExercises() {
+    PUMP_TRACE_SCOPE("MainWindow::onSearchExercises", "gui");
     QString query = ui->lineSearchExercises->text();
 
     if(query.isEmpty()) {
@@ -182,22 +571,43 @@ void MainWindow::onSearchExercises() {
     }
 
     ui->listExercises->clear();
-    auto results = db.getExerciseRepository().searchByName(query.toStdString());
+    ExerciseQuery filtered = exerciseQuery();
+    filtered.nameContains = query.toStdString();
+    if(addExercisePages(filtered) > 0) {
+        return;
+    }
 
-    for(const auto& ex : results) {
-        QString typeIcon = (ex->getType() == ExerciseType::WEIGHTED) ? QString::fromUtf8("🏋️") : QString::fromUtf8("💪");
-        QString itemText = QString("%1 %2").arg(typeIcon, QString::fromStdString(ex->getName()));
-        ui->listExercises->addItem(itemText);
+    // Brak trafień - "czy chodziło o...": najbliższe nazwy (literówki, bez polskich znaków)
+    auto& repo = db.getExerciseRepository();
+    size_t suggested = 0;
+    for(const auto& suggestion : repo.suggestNames(query.toStdString())) {
+        if(auto ex = repo.findByName(suggestion.name)) {
+            addExerciseItem(*ex);
+            ++suggested;
+        }
+    }
+    if(suggested > 0) {
+        statusBar()->showMessage(QString::fromUtf8("Brak dokładnych wyników - pokazano podobne nazwy"), 5000);
+    }
+}
+
+void MainWindow::onSortExercisesChanged() {
+    if(loading) {
+        return;
+    }
+    if(ui->lineSearchExercises->text().isEmpty()) {
+        refreshExerciseList();
+    } else {
+        onSearchExercises();
     }
 }
 
 void MainWindow::onAddPlan() {
     WorkoutPlanDialog dialog(this, &db);
     if (dialog.exec() == QDialog::Accepted) {
-        auto plan = dialog.getWorkoutPlan();
         try {
-            db.getWorkoutPlanRepository().addPlan(plan);
-            refreshPlanList();
+            db.getCommandLog().commitDraft(dialog.getDraft());
+            updateUndoActions();
             saveDatabase();
             QMessageBox::information(this, QString::fromUtf8("Sukces"),
                                      QString::fromUtf8("Plan treningowy dodany!"));
@@ -217,18 +627,22 @@ void MainWindow::onEditPlan() {
     int end = fullText.indexOf(" (");
     QString planName = fullText.mid(start, end - start);
 
-    auto plan = db.getWorkoutPlanRepository().findByName(planName.toStdString());
-    if (!plan) {
+    // Szkic współdzieli wpisy z opublikowanym planem - anulowanie niczego nie zmienia
+    PlanDraft draft = db.getWorkoutPlanRepository().openDraft(planName.toStdString());
+    if (!draft.plan) {
         QMessageBox::warning(this, QString::fromUtf8("Błąd"),
                              QString::fromUtf8("Nie znaleziono planu!"));
         return;
     }
 
-    WorkoutPlanDialog dialog(this, &db, plan);
+    WorkoutPlanDialog dialog(this, &db, std::move(draft));
     if (dialog.exec() == QDialog::Accepted) {
-        auto updatedPlan = dialog.getWorkoutPlan();
-        db.getWorkoutPlanRepository().updatePlan(planName.toStdString(), updatedPlan);
-        refreshPlanList();
+        if (!db.getCommandLog().commitDraft(dialog.getDraft())) {
+            QMessageBox::warning(this, QString::fromUtf8("Błąd"),
+                                 QString::fromUtf8("Plan zmienił się w trakcie edycji - zmiany nie zostały zapisane."));
+            return;
+        }
+        updateUndoActions();
         saveDatabase();
         QMessageBox::information(this, QString::fromUtf8("Sukces"),
                                  QString::fromUtf8("Plan zaktualizowany!"));
@@ -249,8 +663,8 @@ void MainWindow::onDeletePlan() {
                                        QMessageBox::Yes | QMessageBox::No);
 
     if(reply == QMessageBox::Yes) {
-        db.getWorkoutPlanRepository().removePlan(planName.toStdString());
-        refreshPlanList();
+        db.getCommandLog().removePlan(planName.toStdString());
+        updateUndoActions();
         saveDatabase();
         QMessageBox::information(this, QString::fromUtf8("Sukces"),
                                  QString::fromUtf8("Plan usunięty!"));
@@ -288,6 +702,7 @@ void MainWindow::onViewPlan() {
 }
 
 void MainWindow::onSearchPlans() {
+    PUMP_TRACE_SCOPE("MainWindow::onSearchPlans", "gui");
     QString query = ui->lineSearchPlans->text();
 
     if(query.isEmpty()) {
@@ -299,9 +714,6 @@ void MainWindow::onSearchPlans() {
     auto results = db.getWorkoutPlanRepository().searchByName(query.toStdString());
 
     for(const auto& plan : results) {
-        QString itemText = QString::fromUtf8("📋 %1 (%2 ćwiczeń)")
-                               .arg(QString::fromStdString(plan->getName()))
-                               .arg(plan->getEntryCount());
-        ui->listPlans->addItem(itemText);
+        addPlanItem(*plan);
     }
 }
@@ -6,7 +6,12 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QAction>
+#include <QFileSystemWatcher>
 #include <QListWidget>
+#include <QProgressBar>
+#include <QThread>
+#include <QTimer>
 #include <memory>
 #include "../core/DatabaseManager.h"
 
@@ -21,6 +26,10 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // Progresywny start: okno jest już widoczne, dane ładują się w wątku roboczym,
+    // a wiersze trafiają na listy porcjami. Edycja włącza się po zakończeniu.
+    void startProgressiveLoad();
+
 private slots:
     // === SLOTY DLA ZAKŁADKI "ĆWICZENIA" ===
     void onAddExercise();
@@ -28,6 +37,7 @@ private slots:
     void onDeleteExercise();
     void onSearchExercises();
     void onExerciseSelectionChanged();
+    void onSortExercisesChanged();
 
     // === SLOTY DLA ZAKŁADKI "PLANY TRENINGOWE" ===
     void onAddPlan();
@@ -37,16 +47,74 @@ private slots:
     void onSearchPlans();
     void onPlanSelectionChanged();
 
+    // === MENU ===
+    void onShowDiagnostics();
+    void onUndo();
+    void onRedo();
+
+    // === PROGRESYWNE ŁADOWANIE ===
+    void onDataLoaded();
+    void onPopulateBatch();
+
+    // === PLIKI ZMIENIONE POZA APLIKACJĄ ===
+    void onDataFilesChanged();
+    void onReloadChangedFiles();
+
 private:
     Ui::MainWindow *ui;
     DatabaseManager& db;
 
+    // Stan progresywnego ładowania
+    static constexpr int POPULATE_BATCH_SIZE = 500;  // Wierszy na jeden obieg pętli zdarzeń
+    QThread* loaderThread = nullptr;
+    QTimer* populateTimer = nullptr;
+    QProgressBar* loadProgress = nullptr;
+    size_t populatedExercises = 0;
+    size_t populatedPlans = 0;
+    std::string exerciseCursor;       // Kursor następnej strony ćwiczeń (queryExercises)
+    bool exercisesPopulated = false;
+    bool loading = false;
+
+    // Cofnij/ponów (DatabaseManager::getCommandLog)
+    QAction* undoAction = nullptr;
+    QAction* redoAction = nullptr;
+
+    // Subskrypcje zmian repozytoriów - listy aktualizowane partiami zmian
+    // (kolejka zdarzeń GUI), bez ponownego odczytu całej kolekcji
+    static constexpr int NameRole = Qt::UserRole;         // Nazwa bez ikony
+    static constexpr int SortKeyRole = Qt::UserRole + 1;  // exerciseSortKey (QByteArray)
+    uint64_t exerciseSubscription = 0;
+    uint64_t planSubscription = 0;
+
+    // Obserwacja plików danych - zapis z zewnątrz (inna instancja, edytor)
+    // przeładowany różnicowo po chwili ciszy (zapis bywa kilkoma zdarzeniami)
+    static constexpr int RELOAD_DEBOUNCE_MS = 500;
+    QFileSystemWatcher* fileWatcher = nullptr;
+    QTimer* reloadTimer = nullptr;
+
     void setupConnections();
+    void setupMenu();
     void refreshExerciseList();
     void refreshPlanList();
     void updateExerciseButtons();
     void updatePlanButtons();
+    void setLoadingState(bool isLoading);
+    void updateUndoActions();
+    void addExerciseItem(const Exercise& exercise, int row = -1);   // -1 = na końcu
+    ExerciseQuery exerciseQuery() const;           // Sortowanie wybrane w comboSortExercises
+    size_t addExercisePages(ExerciseQuery query);  // Wszystkie strony zapytania na listę
+    void addPlanItem(const WorkoutPlan& plan);
+    void setPlanItem(QListWidgetItem* item, const WorkoutPlan& plan);
     void saveDatabase();
+    void watchDataFiles();
+
+    // Partie zmian (w wątku GUI) - pozycja ćwiczenia po kluczu sortowania,
+    // plan po nazwie; reset, filtr albo sortowanie RECENT - pełne odświeżenie
+    void subscribeToChanges();
+    void applyExerciseChanges(const ExerciseChangeBatch& batch);
+    void applyPlanChanges(const WorkoutPlanChangeBatch& batch);
+    int exerciseRow(const QByteArray& sortKey) const;   // lower_bound na liście
+    QListWidgetItem* findPlanItem(const QString& name) const;
 };
 
 #endif // MAINWINDOW_H
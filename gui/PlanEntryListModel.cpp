@@ -0,0 +1,123 @@
+// PlanEntryListModel.cpp
+// Lokalizacja: gui/PlanEntryListModel.cpp
+
+#include "PlanEntryListModel.h"
+#include <algorithm>
+
+PlanEntryListModel::PlanEntryListModel(std::shared_ptr<WorkoutPlan> workoutPlan, QObject *parent)
+    : QAbstractListModel(parent)
+    , plan(std::move(workoutPlan))
+{
+    if (plan) plan->setObserver(this);
+}
+
+PlanEntryListModel::~PlanEntryListModel()
+{
+    if (plan) plan->setObserver(nullptr);
+}
+
+int PlanEntryListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !plan) return 0;
+    return static_cast<int>(plan->getEntryCount());
+}
+
+QVariant PlanEntryListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    const PlanEntry& entry = plan->getEntries()[static_cast<size_t>(index.row())];
+    QString itemText = QString::fromUtf8("%1. %2 - %3x%4")
+                           .arg(index.row() + 1)
+                           .arg(QString::fromStdString(entry.exercise->getName()))
+                           .arg(entry.sets)
+                           .arg(entry.reps);
+
+    if (entry.weight > 0) {
+        itemText += QString(" @ %1kg").arg(entry.weight);
+    }
+
+    itemText += QString::fromUtf8(" (przerwa: %1s)").arg(entry.restTime);
+    return itemText;
+}
+
+Qt::ItemFlags PlanEntryListModel::flags(const QModelIndex &index) const
+{
+    // Korzeń przyjmuje upuszczenie (między wierszami), wiersz - nie (bez nadpisywania)
+    if (!index.isValid()) return Qt::ItemIsDropEnabled;
+    return QAbstractListModel::flags(index) | Qt::ItemIsDragEnabled;
+}
+
+Qt::DropActions PlanEntryListModel::supportedDropActions() const
+{
+    return Qt::MoveAction;
+}
+
+bool PlanEntryListModel::moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
+                                  const QModelIndex &destinationParent, int destinationChild)
+{
+    if (sourceParent.isValid() || destinationParent.isValid() || count != 1) return false;
+    if (sourceRow < 0 || sourceRow >= rowCount() || destinationChild < 0 || destinationChild > rowCount()) {
+        return false;
+    }
+
+    // destinationChild liczony przed przeniesieniem (Qt), moveEntry - po przeniesieniu
+    const int to = destinationChild > sourceRow ? destinationChild - 1 : destinationChild;
+    if (to == sourceRow) return false;
+
+    plan->moveEntry(static_cast<size_t>(sourceRow), static_cast<size_t>(to));
+    return true;
+}
+
+void PlanEntryListModel::entriesAboutToChange(const PlanEntryChange &change)
+{
+    const int row = static_cast<int>(change.index);
+    switch (change.kind) {
+    case PlanEntryChange::Kind::INSERT:
+        beginInsertRows(QModelIndex(), row, row);
+        break;
+    case PlanEntryChange::Kind::REMOVE:
+        beginRemoveRows(QModelIndex(), row, row);
+        break;
+    case PlanEntryChange::Kind::MOVE: {
+        const int to = static_cast<int>(change.to);
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), to > row ? to + 1 : to);
+        break;
+    }
+    case PlanEntryChange::Kind::RESET:
+        beginResetModel();
+        break;
+    case PlanEntryChange::Kind::EDIT:
+        break;
+    }
+}
+
+void PlanEntryListModel::entriesChanged(const PlanEntryChange &change)
+{
+    switch (change.kind) {
+    case PlanEntryChange::Kind::INSERT:
+        endInsertRows();
+        break;
+    case PlanEntryChange::Kind::REMOVE:
+        endRemoveRows();
+        break;
+    case PlanEntryChange::Kind::MOVE:
+        endMoveRows();
+        break;
+    case PlanEntryChange::Kind::RESET:
+        endResetModel();
+        return;
+    case PlanEntryChange::Kind::EDIT:
+        emit dataChanged(index(static_cast<int>(change.index)), index(static_cast<int>(change.index)));
+        return;
+    }
+
+    // Numeracja "N." w wierszach za zmianą przesunęła się
+    const int first = static_cast<int>(change.kind == PlanEntryChange::Kind::MOVE
+                                           ? std::min(change.index, change.to) : change.index);
+    if (first < rowCount()) {
+        emit dataChanged(index(first), index(rowCount() - 1), {Qt::DisplayRole});
+    }
+}
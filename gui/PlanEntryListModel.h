@@ -0,0 +1,43 @@
+// PlanEntryListModel.h
+// Lokalizacja: gui/PlanEntryListModel.h
+// Opis: Model listy wpisów planu w WorkoutPlanDialog. Obserwuje plan
+//       (WorkoutPlanObserver) i zamienia każdą zmianę wpisu na sygnał jednego
+//       wiersza (insert/remove/move/dataChanged), więc dodanie czy usunięcie
+//       wpisu nie przebudowuje listy. Tekst wiersza formatowany dopiero, gdy
+//       widok go rysuje. Przeciąganie wierszy (InternalMove) -> moveRows ->
+//       WorkoutPlan::moveEntry.
+// Design Pattern: Model/View (Qt), Observer
+
+#ifndef PLANENTRYLISTMODEL_H
+#define PLANENTRYLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <memory>
+#include "../core/WorkoutPlan.h"
+
+class PlanEntryListModel : public QAbstractListModel, public WorkoutPlanObserver
+{
+    Q_OBJECT
+
+public:
+    explicit PlanEntryListModel(std::shared_ptr<WorkoutPlan> plan, QObject *parent = nullptr);
+    ~PlanEntryListModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Przeciąganie: wiersze przenoszalne, upuszczanie między wierszami
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    Qt::DropActions supportedDropActions() const override;
+    bool moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
+                  const QModelIndex &destinationParent, int destinationChild) override;
+
+    // === WorkoutPlanObserver ===
+    void entriesAboutToChange(const PlanEntryChange &change) override;
+    void entriesChanged(const PlanEntryChange &change) override;
+
+private:
+    std::shared_ptr<WorkoutPlan> plan;
+};
+
+#endif // PLANENTRYLISTMODEL_H
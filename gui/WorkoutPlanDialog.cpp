@@ -5,13 +5,22 @@
 #include "WorkoutPlanDialog.h"
 #include "ui_WorkoutPlanDialog.h"
 #include <QMessageBox>
-#include <QInputDialog>
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QThread>
+#include <QTimer>
+#include "ExerciseListModel.h"
+#include "PlanEntryListModel.h"
 
 // Konstruktor - tryb dodawania
 WorkoutPlanDialog::WorkoutPlanDialog(QWidget *parent, DatabaseManager* dbManager)
     : QDialog(parent)
     , ui(new Ui::WorkoutPlanDialog)
-    , plan(nullptr)
+    , draft(WorkoutPlanRepository::newDraft(""))
     , db(dbManager)
     , editMode(false)
 {
@@ -21,10 +30,10 @@ WorkoutPlanDialog::WorkoutPlanDialog(QWidget *parent, DatabaseManager* dbManager
 }
 
 // Konstruktor - tryb edycji
-WorkoutPlanDialog::WorkoutPlanDialog(QWidget *parent, DatabaseManager* dbManager, std::shared_ptr<WorkoutPlan> planToEdit)
+WorkoutPlanDialog::WorkoutPlanDialog(QWidget *parent, DatabaseManager* dbManager, PlanDraft draftToEdit)
     : QDialog(parent)
     , ui(new Ui::WorkoutPlanDialog)
-    , plan(planToEdit)
+    , draft(std::move(draftToEdit))
     , db(dbManager)
     , editMode(true)
 {
@@ -36,6 +45,11 @@ WorkoutPlanDialog::WorkoutPlanDialog(QWidget *parent, DatabaseManager* dbManager
 
 WorkoutPlanDialog::~WorkoutPlanDialog()
 {
+    // Wątek optymalizacji czyta katalog i pisze do pól dialogu - czekamy na koniec
+    if (optimizerThread) {
+        optimizerThread->wait();
+        delete optimizerThread;
+    }
     delete ui;
 }
 
@@ -46,135 +60,110 @@ void WorkoutPlanDialog::setupUI()
     connect(ui->buttonBox, &QDialogButtonBox::rejected, this, &WorkoutPlanDialog::onReject);
     connect(ui->btnAddExercise, &QPushButton::clicked, this, &WorkoutPlanDialog::onAddExerciseToPlan);
     connect(ui->btnRemoveExercise, &QPushButton::clicked, this, &WorkoutPlanDialog::onRemoveExerciseFromPlan);
-    connect(ui->listPlanEntries, &QListWidget::itemSelectionChanged, this, &WorkoutPlanDialog::onPlanEntrySelectionChanged);
+    connect(ui->btnOptimizePlan, &QPushButton::clicked, this, &WorkoutPlanDialog::onOptimizePlan);
+
+    // Wpisy szkicu - model dostaje zmiany pojedynczych wpisów od planu
+    planModel = new PlanEntryListModel(draft.plan, this);
+    ui->listPlanEntries->setModel(planModel);
+    connect(ui->listPlanEntries->selectionModel(), &QItemSelectionModel::currentChanged,
+            this, &WorkoutPlanDialog::onPlanEntrySelectionChanged);
+    connect(planModel, &QAbstractItemModel::rowsInserted, this, &WorkoutPlanDialog::refreshRecommendations);
+    connect(planModel, &QAbstractItemModel::rowsRemoved, this, &WorkoutPlanDialog::refreshRecommendations);
+    connect(planModel, &QAbstractItemModel::modelReset, this, &WorkoutPlanDialog::refreshRecommendations);
 
-    // Załadowanie dostępnych ćwiczeń
-    loadAvailableExercises();
+    // Lista ćwiczeń do wyboru
+    setupExercisePicker();
 
     // Początkowy stan przycisków
     ui->btnRemoveExercise->setEnabled(false);
 }
 
-void WorkoutPlanDialog::loadAvailableExercises()
+void WorkoutPlanDialog::setupExercisePicker()
 {
-    ui->comboExercises->clear();
-
-    const auto& exercises = db->getExerciseRepository().getAllExercises();
-
-    if (exercises.empty()) {
-        ui->comboExercises->addItem(QString::fromUtf8("Brak ćwiczeń w bazie!"));
-        ui->btnAddExercise->setEnabled(false);
-        return;
-    }
+    // Model pobiera strony ćwiczeń leniwie - koszt otwarcia nie zależy od rozmiaru bazy
+    exerciseModel = new ExerciseListModel(db->getExerciseRepository(), this);
+    exerciseModel->setFilter(QString());
+    ui->listExercises->setModel(exerciseModel);
+
+    connect(ui->listExercises->selectionModel(), &QItemSelectionModel::currentChanged,
+            this, &WorkoutPlanDialog::onExerciseSelectionChanged);
+    connect(ui->listExercises, &QListView::doubleClicked, this, &WorkoutPlanDialog::onAddExerciseToPlan);
+
+    // Filtr po krótkiej przerwie w pisaniu, a nie po każdym znaku
+    filterTimer = new QTimer(this);
+    filterTimer->setSingleShot(true);
+    filterTimer->setInterval(150);
+    connect(ui->lineEditExerciseFilter, &QLineEdit::textChanged, filterTimer, qOverload<>(&QTimer::start));
+    connect(filterTimer, &QTimer::timeout, this, [this]() {
+        exerciseModel->setFilter(ui->lineEditExerciseFilter->text());
+        selectFirstExercise();
+    });
+
+    refreshRecommendations();
+    selectFirstExercise();
+}
 
-    for (const auto& ex : exercises) {
-        QString typeIcon = (ex->getType() == ExerciseType::WEIGHTED) ? QString::fromUtf8("🏋️") : QString::fromUtf8("💪");
-        QString itemText = QString("%1 %2").arg(typeIcon, QString::fromStdString(ex->getName()));
-        ui->comboExercises->addItem(itemText, QString::fromStdString(ex->getName()));
+void WorkoutPlanDialog::selectFirstExercise()
+{
+    if (exerciseModel->rowCount() > 0) {
+        ui->listExercises->setCurrentIndex(exerciseModel->index(0));
     }
-
-    ui->btnAddExercise->setEnabled(true);
+    onExerciseSelectionChanged();
 }
 
-void WorkoutPlanDialog::loadPlanData()
+void WorkoutPlanDialog::onExerciseSelectionChanged()
 {
-    if (!plan) return;
+    auto exercise = exerciseModel->exerciseAt(ui->listExercises->currentIndex());
+    ui->btnAddExercise->setEnabled(exercise != nullptr);
 
-    ui->lineEditPlanName->setText(QString::fromStdString(plan->getName()));
-    refreshPlanEntries();
+    // Ciężar tylko dla ćwiczeń z obciążeniem
+    const bool weighted = exercise && exercise->getType() == ExerciseType::WEIGHTED;
+    ui->spinWeight->setEnabled(weighted);
+    ui->labelWeight->setEnabled(weighted);
 }
 
-void WorkoutPlanDialog::refreshPlanEntries()
+void WorkoutPlanDialog::refreshRecommendations()
 {
-    ui->listPlanEntries->clear();
-
-    if (!plan) return;
-
-    const auto& entries = plan->getEntries();
-    for (size_t i = 0; i < entries.size(); ++i) {
-        const auto& entry = entries[i];
-
-        QString itemText = QString::fromUtf8("%1. %2 - %3x%4")
-                               .arg(i + 1)
-                               .arg(QString::fromStdString(entry.exercise->getName()))
-                               .arg(entry.sets)
-                               .arg(entry.reps);
+    // Podpowiedzi dla bieżącego szkicu na górze listy
+    if (!draft.plan || !exerciseModel) return;
 
-        if (entry.weight > 0) {
-            itemText += QString(" @ %1kg").arg(entry.weight);
-        }
+    std::vector<std::string> names;
+    for (const auto& recommendation : db->getWorkoutPlanRepository().recommendExercises(*draft.plan, 5)) {
+        names.push_back(recommendation.name);
+    }
+    exerciseModel->setPinned(names);
+}
 
-        itemText += QString::fromUtf8(" (przerwa: %1s)").arg(entry.restTime);
+void WorkoutPlanDialog::loadPlanData()
+{
+    if (!draft.plan) return;
 
-        ui->listPlanEntries->addItem(itemText);
-    }
+    ui->lineEditPlanName->setText(QString::fromStdString(draft.plan->getName()));
 }
 
 void WorkoutPlanDialog::onPlanEntrySelectionChanged()
 {
-    bool hasSelection = ui->listPlanEntries->currentItem() != nullptr;
+    bool hasSelection = ui->listPlanEntries->currentIndex().isValid();
     ui->btnRemoveExercise->setEnabled(hasSelection);
 }
 
 void WorkoutPlanDialog::onAddExerciseToPlan()
 {
-    if (ui->comboExercises->currentIndex() < 0) {
-        QMessageBox::warning(this, QString::fromUtf8("Błąd"),
-                             QString::fromUtf8("Wybierz ćwiczenie z listy!"));
-        return;
-    }
-
-    // Pobranie nazwy ćwiczenia z userData (bez emoji)
-    QString exerciseName = ui->comboExercises->currentData().toString();
-    auto exercise = db->getExerciseRepository().findByName(exerciseName.toStdString());
-
+    auto exercise = exerciseModel->exerciseAt(ui->listExercises->currentIndex());
     if (!exercise) {
         QMessageBox::warning(this, QString::fromUtf8("Błąd"),
-                             QString::fromUtf8("Nie znaleziono wybranego ćwiczenia!"));
+                             QString::fromUtf8("Wybierz ćwiczenie z listy!"));
         return;
     }
 
-    // Pytanie o parametry treningu
-    bool ok;
-
-    // Serie
-    int sets = QInputDialog::getInt(this, QString::fromUtf8("Serie"),
-                                    QString::fromUtf8("Liczba serii:"),
-                                    3, 1, 20, 1, &ok);
-    if (!ok) return;
-
-    // Powtórzenia
-    int reps = QInputDialog::getInt(this, QString::fromUtf8("Powtórzenia"),
-                                    QString::fromUtf8("Liczba powtórzeń w serii:"),
-                                    10, 1, 100, 1, &ok);
-    if (!ok) return;
-
-    // Ciężar (tylko dla weighted exercises)
-    double weight = 0.0;
-    if (exercise->getType() == ExerciseType::WEIGHTED) {
-        weight = QInputDialog::getDouble(this, QString::fromUtf8("Ciężar"),
-                                         QString::fromUtf8("Ciężar (kg):"),
-                                         20.0, 0.0, 500.0, 1, &ok);
-        if (!ok) return;
-    }
-
-    // Czas odpoczynku (ZAWSZE pytamy!)
-    int restTime = QInputDialog::getInt(this, QString::fromUtf8("Odpoczynek"),
-                                        QString::fromUtf8("Czas odpoczynku między seriami (sekundy):"),
-                                        60, 10, 600, 10, &ok);
-    if (!ok) return;
+    // Parametry z edytora pod listą (ciężar tylko dla weighted exercises)
+    const double weight = exercise->getType() == ExerciseType::WEIGHTED ? ui->spinWeight->value() : 0.0;
 
-    // Utworzenie planu jeśli nie istnieje
-    if (!plan) {
-        plan = std::make_shared<WorkoutPlan>("Temporary");
-    }
-
-    // Dodanie ćwiczenia do planu
+    // Dodanie ćwiczenia do szkicu planu
     try {
-        plan->addEntry(exercise, sets, reps, weight, restTime);
-        refreshPlanEntries();
-        QMessageBox::information(this, QString::fromUtf8("Sukces"),
-                                 QString::fromUtf8("Ćwiczenie dodane do planu!"));
+        draft.plan->addEntry(exercise, ui->spinSets->value(), ui->spinReps->value(),
+                             weight, ui->spinRestTime->value());
+        ui->listPlanEntries->scrollToBottom();
     } catch (const std::exception& e) {
         QMessageBox::warning(this, QString::fromUtf8("Błąd"),
                              QString::fromUtf8("Nie można dodać ćwiczenia:\n") + e.what());
@@ -183,19 +172,125 @@ void WorkoutPlanDialog::onAddExerciseToPlan()
 
 void WorkoutPlanDialog::onRemoveExerciseFromPlan()
 {
-    QListWidgetItem* item = ui->listPlanEntries->currentItem();
-    if (!item || !plan) return;
+    const QModelIndex current = ui->listPlanEntries->currentIndex();
+    if (!current.isValid() || !draft.plan) return;
 
-    int index = ui->listPlanEntries->currentRow();
+    int index = current.row();
 
     auto reply = QMessageBox::question(this, QString::fromUtf8("Potwierdzenie"),
                                        QString::fromUtf8("Czy na pewno usunąć to ćwiczenie z planu?"),
                                        QMessageBox::Yes | QMessageBox::No);
 
     if (reply == QMessageBox::Yes) {
-        plan->removeEntry(index);
-        refreshPlanEntries();
+        draft.plan->removeEntry(index);
+    }
+}
+
+void WorkoutPlanDialog::onOptimizePlan()
+{
+    // Parametry sesji - prosty formularz zamiast osobnego pliku .ui
+    QDialog form(this);
+    form.setWindowTitle(QString::fromUtf8("Dobierz plan do sesji"));
+    auto* layout = new QFormLayout(&form);
+    auto* spinMinutes = new QSpinBox(&form);
+    spinMinutes->setRange(10, 180);
+    spinMinutes->setValue(45);
+    spinMinutes->setSuffix(" min");
+    auto* comboType = new QComboBox(&form);
+    comboType->addItem(QString::fromUtf8("Wszystkie"));
+    comboType->addItem(QString::fromUtf8("Z obciążeniem"));
+    comboType->addItem(QString::fromUtf8("Masa ciała"));
+    auto* lineTargets = new QLineEdit(QString::fromUtf8("Klatka:6, Plecy:6, Nogi:6"), &form);
+    lineTargets->setToolTip(QString::fromUtf8("Grupa mięśniowa:liczba serii, rozdzielone przecinkami"));
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &form);
+    layout->addRow(QString::fromUtf8("Czas sesji:"), spinMinutes);
+    layout->addRow(QString::fromUtf8("Typ ćwiczeń:"), comboType);
+    layout->addRow(QString::fromUtf8("Serie na partię:"), lineTargets);
+    layout->addRow(buttons);
+    connect(buttons, &QDialogButtonBox::accepted, &form, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &form, &QDialog::reject);
+    if (form.exec() != QDialog::Accepted) return;
+
+    OptimizerConstraints constraints;
+    constraints.durationSeconds = spinMinutes->value() * 60;
+    if (comboType->currentIndex() == 1) {
+        constraints.type = ExerciseType::WEIGHTED;
+    } else if (comboType->currentIndex() == 2) {
+        constraints.type = ExerciseType::BODYWEIGHT;
+    }
+    for (const QString& part : lineTargets->text().split(',', Qt::SkipEmptyParts)) {
+        const QStringList pair = part.split(':');
+        bool ok = false;
+        const int sets = pair.size() == 2 ? pair[1].trimmed().toInt(&ok) : 0;
+        if (ok && sets > 0) {
+            constraints.muscleTargets.push_back({pair[0].trimmed().toStdString(), sets});
+        }
+    }
+    if (constraints.muscleTargets.empty()) {
+        QMessageBox::warning(this, QString::fromUtf8("Błąd"),
+                             QString::fromUtf8("Podaj cele w formacie \"Klatka:6, Plecy:6\"."));
+        return;
+    }
+
+    // Stronicowanie katalogu i optymalizacja poza wątkiem GUI - okno pozostaje
+    // responsywne; wynik trafia do szkicu w onOptimizeFinished()
+    ui->btnOptimizePlan->setEnabled(false);
+    if (auto* ok = ui->buttonBox->button(QDialogButtonBox::Ok)) ok->setEnabled(false);
+    setCursor(Qt::BusyCursor);
+    optimizeResults.clear();
+    optimizeError.clear();
+
+    DatabaseManager* database = db;
+    const std::string planName = draft.plan->getName();
+    optimizerThread = QThread::create([this, database, planName, constraints]() {
+        try {
+            std::vector<std::shared_ptr<Exercise>> catalog;
+            ExerciseQuery query;
+            query.pageSize = 1000;
+            do {
+                auto page = database->getExerciseRepository().queryExercises(query);
+                catalog.insert(catalog.end(), page.items.begin(), page.items.end());
+                query.cursor = page.nextCursor;
+            } while (!query.cursor.empty());
+
+            // Czas odpowiedzi ograniczony przez OptimizerOptions::timeBudget
+            optimizeResults = PlanOptimizer::optimize(planName, catalog, constraints);
+        } catch (const std::exception& e) {
+            optimizeError = QString::fromStdString(e.what());
+        }
+    });
+    connect(optimizerThread, &QThread::finished, this, &WorkoutPlanDialog::onOptimizeFinished);
+    optimizerThread->start();
+}
+
+void WorkoutPlanDialog::onOptimizeFinished()
+{
+    optimizerThread->deleteLater();
+    optimizerThread = nullptr;
+    ui->btnOptimizePlan->setEnabled(true);
+    if (auto* ok = ui->buttonBox->button(QDialogButtonBox::Ok)) ok->setEnabled(true);
+    unsetCursor();
+
+    if (!optimizeError.isEmpty()) {
+        QMessageBox::warning(this, QString::fromUtf8("Błąd"), optimizeError);
+        return;
+    }
+    if (optimizeResults.empty()) {
+        QMessageBox::information(this, QString::fromUtf8("Optymalizacja"),
+                                 QString::fromUtf8("Brak ćwiczeń pasujących do podanych partii i typu."));
+        return;
+    }
+
+    // Wynik trafia do szkicu - anulowanie dialogu nadal niczego nie zapisuje
+    const auto best = optimizeResults.front();
+    draft.plan->clear();
+    for (const auto& entry : best.plan->getEntries()) {
+        draft.plan->addEntry(entry.exercise, entry.sets, entry.reps, entry.weight, entry.restTime);
     }
+    QMessageBox::information(this, QString::fromUtf8("Optymalizacja"),
+                             QString::fromUtf8("Dobrano %1 ćwiczeń, czas sesji ok. %2 min.")
+                                 .arg(draft.plan->getEntryCount())
+                                 .arg((best.durationSeconds + 59) / 60));
 }
 
 bool WorkoutPlanDialog::validateInput()
@@ -206,7 +301,7 @@ bool WorkoutPlanDialog::validateInput()
         return false;
     }
 
-    if (!plan || plan->isEmpty()) {
+    if (!draft.plan || draft.plan->isEmpty()) {
         QMessageBox::warning(this, QString::fromUtf8("Błąd"),
                              QString::fromUtf8("Plan musi zawierać przynajmniej jedno ćwiczenie!"));
         return false;
@@ -222,7 +317,7 @@ void WorkoutPlanDialog::onAccept()
     }
 
     QString planName = ui->lineEditPlanName->text().trimmed();
-    plan->setName(planName.toStdString());
+    draft.plan->setName(planName.toStdString());
 
     accept();
 }
@@ -234,5 +329,5 @@ void WorkoutPlanDialog::onReject()
 
 std::shared_ptr<WorkoutPlan> WorkoutPlanDialog::getWorkoutPlan() const
 {
-    return plan;
+    return draft.plan;
 }
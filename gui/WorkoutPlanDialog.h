@@ -10,6 +10,12 @@
 #include <memory>
 #include "../core/WorkoutPlan.h"
 #include "../core/DatabaseManager.h"
+#include "../core/PlanOptimizer.h"
+
+class ExerciseListModel;
+class PlanEntryListModel;
+class QTimer;
+class QThread;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -25,8 +31,8 @@ public:
     // Konstruktor - dodawanie nowego planu
     explicit WorkoutPlanDialog(QWidget *parent, DatabaseManager* dbManager);
     
-    // Konstruktor - edycja istniejącego planu
-    WorkoutPlanDialog(QWidget *parent, DatabaseManager* dbManager, std::shared_ptr<WorkoutPlan> planToEdit);
+    // Konstruktor - edycja istniejącego planu na szkicu (WorkoutPlanRepository::openDraft)
+    WorkoutPlanDialog(QWidget *parent, DatabaseManager* dbManager, PlanDraft draftToEdit);
     
     // Destruktor
     ~WorkoutPlanDialog();
@@ -34,23 +40,36 @@ public:
     // Pobranie stworzonego/edytowanego planu
     std::shared_ptr<WorkoutPlan> getWorkoutPlan() const;
 
+    // Szkic do zatwierdzenia (CommandLog::commitDraft); odrzucony dialog = porzucony szkic
+    const PlanDraft& getDraft() const { return draft; }
+
 private slots:
     void onAddExerciseToPlan();
     void onRemoveExerciseFromPlan();
+    void onOptimizePlan();
+    void onOptimizeFinished();
     void onAccept();
     void onReject();
     void onPlanEntrySelectionChanged();
+    void onExerciseSelectionChanged();
+    void refreshRecommendations();
 
 private:
     Ui::WorkoutPlanDialog *ui;
-    std::shared_ptr<WorkoutPlan> plan = nullptr;
+    PlanDraft draft;   // Kopia robocza planu - opublikowana wersja nie zmienia się do zatwierdzenia
     DatabaseManager* db = nullptr;
     bool editMode = false;
+    ExerciseListModel* exerciseModel = nullptr;   // Ćwiczenia do wyboru (leniwie, z filtrem)
+    QTimer* filterTimer = nullptr;                // Opóźnienie filtra przy pisaniu
+    PlanEntryListModel* planModel = nullptr;      // Wpisy szkicu (obserwuje draft.plan)
+    QThread* optimizerThread = nullptr;           // Katalog + PlanOptimizer poza wątkiem GUI
+    std::vector<OptimizedPlan> optimizeResults;   // Zapisywane przez optimizerThread, czytane po finished
+    QString optimizeError;
 
     void setupUI();
-    void loadAvailableExercises();
+    void setupExercisePicker();
+    void selectFirstExercise();
     void loadPlanData();
-    void refreshPlanEntries();
     bool validateInput();
 };
 
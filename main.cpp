@@ -1,17 +1,39 @@
 #include <QApplication>
 #include "gui/MainWindow.h"
 #include "core/DatabaseManager.h"
+#include "core/Logger.h"
+#include "core/Trace.h"
 
 int main(int argc, char *argv[]) {
     QApplication a(argc, argv);
 
-    // Inicjalizacja bazy danych
     auto& db = DatabaseManager::getInstance();
-    db.initialize();
 
-    // Otwarcie głównego okna
+    // --sync-load: stare zachowanie (ładowanie przed pokazaniem okna)
+    bool syncLoad = QCoreApplication::arguments().contains(QStringLiteral("--sync-load"));
+    if(syncLoad) {
+        db.initialize();
+    }
+
+    // Otwarcie głównego okna - w trybie progresywnym od razu, dane dochodzą w tle
     MainWindow w;
     w.show();
+    if(!syncLoad) {
+        w.startProgressiveLoad();
+    }
+
+    int result = a.exec();
+
+    // PUMPAPP_TRACE=<plik.json> - zrzut zebranych spanów (chrome://tracing, Perfetto)
+    QByteArray tracePath = qgetenv("PUMPAPP_TRACE");
+    if(!tracePath.isEmpty()) {
+        if(Tracer::getInstance().exportChromeTrace(tracePath.toStdString())) {
+            Logger::info("main", "Zapisano trace", {{"path", tracePath.toStdString()}});
+        } else {
+            Logger::error("main", "Nie można zapisać trace", {{"path", tracePath.toStdString()}});
+        }
+    }
+    Logger::getInstance().flush();
 
-    return a.exec();
+    return result;
 }
@@ -10,7 +10,36 @@
 #include "../core/BodyweightExercise.h"
 #include "../core/WorkoutPlan.h"
 #include "../core/ExerciseRepository.h"
+#include "../core/ExerciseCatalog.h"
+#include "../core/Logger.h"
+#include "../core/Metrics.h"
+#include "../core/ThreadPool.h"
+#include "../core/WorkoutPlanRepository.h"
+#include "../core/DescriptionStore.h"
+#include "../core/DescriptionCodec.h"
+#include "../core/Trace.h"
+#include "../core/JsonUtils.h"
+#include "../core/JsonWriter.h"
+#include "../core/PersistentVector.h"
+#include "../core/Interchange.h"
+#include "../core/FuzzyIndex.h"
+#include "../core/Collation.h"
+#include "../core/CommandLog.h"
+#include "../core/ProgramGenerator.h"
+#include "../core/PlanOptimizer.h"
+#include "../core/PlanSimilarity.h"
+#include "../core/ExerciseRecommender.h"
+#include "../core/ChangeJournal.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <map>
 #include <memory>
+#include <sstream>
+#include <thread>
 
 // ===== TEST 1: Factory Pattern - tworzenie ćwiczeń =====
 TEST(ExerciseFactoryTest, CreateWeightedExercise) {
@@ -224,6 +253,2012 @@ TEST(ExerciseRepositoryTest, DuplicateExercise) {
     EXPECT_THROW(repo.addExercise(ex2), std::runtime_error);
 }
 
+// ===== TEST 6: Tracing i logowanie =====
+TEST(TraceTest, RingBufferKeepsNewestEvents) {
+    // Test czy bufor cykliczny nadpisuje najstarsze zdarzenia
+    Tracer& tracer = Tracer::getInstance();
+    tracer.setCapacity(4);
+
+    auto now = std::chrono::steady_clock::now();
+    const char* names[] = {"a", "b", "c", "d", "e", "f"};
+    for(const char* name : names) {
+        tracer.record(name, "test", now, now);
+    }
+
+    auto events = tracer.getEvents();
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_STREQ(events.front().name, "c");
+    EXPECT_STREQ(events.back().name, "f");
+    EXPECT_EQ(tracer.getDroppedCount(), 2u);
+
+    tracer.setCapacity(Tracer::DEFAULT_CAPACITY);
+}
+
+TEST(TraceTest, ChromeTraceExport) {
+    // Test czy span z makra trafia do JSON-a w formacie Chrome
+    Tracer& tracer = Tracer::getInstance();
+    tracer.clear();
+    {
+        ScopedTrace span("TestSpan", "test");
+    }
+
+    std::string json = tracer.toChromeTraceJson();
+    EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"TestSpan\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+}
+
+// Sink zbierający wpisy w pamięci (do testów)
+class CapturingLogSink : public LogSink {
+public:
+    std::vector<LogRecord> records;
+    void write(const LogRecord& record) override { records.push_back(record); }
+};
+
+TEST(LoggerTest, StructuredFieldsAndMinLevel) {
+    // Test czy logger przekazuje pola i filtruje po poziomie
+    auto sink = std::make_shared<CapturingLogSink>();
+    Logger::getInstance().setSink(sink);
+    Logger::getInstance().setMinLevel(LogLevel::INFO);
+
+    Logger::debug("Test", "pominięte");
+    Logger::info("Test", "Załadowano", {{"count", "3"}});
+
+    ASSERT_EQ(sink->records.size(), 1u);
+    EXPECT_EQ(sink->records[0].component, "Test");
+    EXPECT_EQ(sink->records[0].fields[0].first, "count");
+    EXPECT_EQ(sink->records[0].fields[0].second, "3");
+
+    Logger::getInstance().setSink(std::make_shared<ConsoleLogSink>());
+}
+
+// ===== TEST 7: Metryki =====
+TEST(MetricsTest, HistogramPercentiles) {
+    // Test czy percentyle mieszczą się w granicy błędu kubełków (~6%)
+    LatencyHistogram histogram;
+    for(uint64_t v = 1; v <= 1000; ++v) {
+        histogram.record(v);
+    }
+
+    EXPECT_EQ(histogram.getCount(), 1000u);
+    EXPECT_EQ(histogram.getMax(), 1000u);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.5)), 500.0, 500.0 * 0.07);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.99)), 990.0, 990.0 * 0.07);
+}
+
+TEST(MetricsTest, BucketBoundsAreMonotonic) {
+    // Test czy każda wartość trafia do kubełka, którego granica ją obejmuje
+    for(uint64_t v : {0ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull}) {
+        size_t index = LatencyHistogram::bucketIndex(v);
+        EXPECT_GE(LatencyHistogram::bucketUpperBound(index), v);
+        if(index > 0) {
+            EXPECT_LT(LatencyHistogram::bucketUpperBound(index - 1), v);
+        }
+    }
+}
+
+TEST(MetricsTest, RepositoryUpdatesCounters) {
+    // Test czy findByName aktualizuje licznik w rejestrze
+    Counter& finds = MetricsRegistry::getInstance().counter("pumpapp_exercise_find_total");
+    uint64_t before = finds.get();
+
+    ExerciseRepository repo("test_metrics.json");
+    repo.findByName("Nieistniejące");
+    repo.findByName("Nieistniejące");
+
+    EXPECT_EQ(finds.get(), before + 2);
+    EXPECT_NE(MetricsRegistry::getInstance().toPrometheusText()
+                  .find("pumpapp_exercise_find_total"), std::string::npos);
+}
+
+TEST(MetricsTest, InstanceGaugesAreLabeled) {
+    // Test czy dwie instancje repozytorium mają osobne serie pumpapp_exercises
+    ExerciseRepository first("test_metrics_a.json");
+    ExerciseRepository second("test_metrics_b.json");
+    first.addExercise(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "A1", "", "Klatka"));
+    first.addExercise(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "A2", "", "Klatka"));
+    second.addExercise(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "B1", "", "Plecy"));
+
+    auto& registry = MetricsRegistry::getInstance();
+    EXPECT_EQ(registry.gauge(MetricsRegistry::labeled("pumpapp_exercises", "file", "test_metrics_a.json")).get(), 2);
+    EXPECT_EQ(registry.gauge(MetricsRegistry::labeled("pumpapp_exercises", "file", "test_metrics_b.json")).get(), 1);
+
+    const std::string text = registry.toPrometheusText();
+    EXPECT_NE(text.find("pumpapp_exercises{file=\"test_metrics_a.json\"} 2"), std::string::npos);
+    const size_t type = text.find("# TYPE pumpapp_exercises gauge");
+    ASSERT_NE(type, std::string::npos);
+    EXPECT_EQ(text.find("# TYPE pumpapp_exercises gauge", type + 1), std::string::npos);
+    EXPECT_EQ(MetricsRegistry::labeled("g", "path", "a\"b"), "g{path=\"a\\\"b\"}");
+}
+
+TEST(MetricsTest, PrometheusGroupsFamilies) {
+    // Test czy rodzina dostaje jeden nagłówek, gdy inna metryka sortuje się
+    // między jej seriami (t_family < t_family_other < t_family{...})
+    auto& registry = MetricsRegistry::getInstance();
+    registry.gauge("t_family").set(1);
+    registry.gauge("t_family_other").set(2);
+    registry.gauge(MetricsRegistry::labeled("t_family", "file", "a")).set(3);
+    registry.histogram(MetricsRegistry::labeled("t_family_ms", "file", "a")).record(5);
+
+    const std::string text = registry.toPrometheusText();
+    const size_t type = text.find("# TYPE t_family gauge\n");
+    ASSERT_NE(type, std::string::npos);
+    EXPECT_EQ(text.find("# TYPE t_family gauge\n", type + 1), std::string::npos);
+    const size_t plain = text.find("\nt_family 1\n");
+    const size_t labeled = text.find("\nt_family{file=\"a\"} 3\n");
+    const size_t other = text.find("# TYPE t_family_other gauge\n");
+    ASSERT_NE(plain, std::string::npos);
+    ASSERT_NE(labeled, std::string::npos);
+    EXPECT_LT(plain, other);
+    EXPECT_LT(labeled, other);
+
+    // Etykiety histogramu idą przed le i przy _sum/_count
+    EXPECT_NE(text.find("t_family_ms_bucket{file=\"a\",le=\"+Inf\"} 1"), std::string::npos);
+    EXPECT_NE(text.find("t_family_ms_count{file=\"a\"} 1"), std::string::npos);
+}
+
+// ===== TEST 8: Równoległe ładowanie =====
+// Pomocnik: treść pliku ćwiczeń w formacie zapisywanym przez saveToJSON
+static std::string makeExercisesJson(size_t count, size_t descLength) {
+    std::string json = "[\n";
+    for(size_t i = 0; i < count; ++i) {
+        json += "  {\n";
+        json += "    \"name\": \"Ex " + std::to_string(i) + "\",\n";
+        json += "    \"description\": \"" + std::string(descLength, 'x') + "\",\n";
+        json += "    \"muscles\": \"Chest\",\n";
+        json += std::string("    \"type\": \"") + (i % 2 ? "weighted" : "bodyweight") + "\"\n";
+        json += (i + 1 < count) ? "  },\n" : "  }\n";
+    }
+    json += "]\n";
+    return json;
+}
+
+TEST(ParallelLoadTest, ChunkedParseMatchesSerial) {
+    // Test czy parsowanie fragmentami daje te same rekordy w tej samej kolejności
+    std::string json = makeExercisesJson(5000, 300);
+    ASSERT_GE(json.size(), ExerciseRepository::PARALLEL_PARSE_THRESHOLD);
+
+    ThreadPool pool(4);
+    auto serial = ExerciseRepository::parseJSON(json);
+    auto parallel = ExerciseRepository::parseJSON(json, &pool);
+
+    ASSERT_EQ(serial.size(), 5000u);
+    ASSERT_EQ(parallel.size(), serial.size());
+    for(size_t i = 0; i < serial.size(); ++i) {
+        EXPECT_EQ(parallel[i]->getName(), serial[i]->getName());
+        EXPECT_EQ(parallel[i]->getType(), serial[i]->getType());
+    }
+}
+
+TEST(ParallelLoadTest, PlanRecordsLinkAfterExercises) {
+    // Test czy plany sparsowane bez ćwiczeń są poprawnie linkowane później
+    std::string json =
+        "[\n  {\n    \"name\": \"Push\",\n    \"entries\": [\n"
+        "      {\n        \"exerciseName\": \"Ex 1\",\n        \"sets\": 4,\n"
+        "        \"reps\": 12,\n        \"weight\": 20.5,\n        \"restTime\": 90\n      },\n"
+        "      {\n        \"exerciseName\": \"Missing\",\n        \"sets\": 3,\n"
+        "        \"reps\": 10,\n        \"weight\": 0,\n        \"restTime\": 60\n      }\n"
+        "    ]\n  }\n]\n";
+
+    auto records = WorkoutPlanRepository::parseJSON(json);
+    ASSERT_EQ(records.size(), 1u);
+    ASSERT_EQ(records[0].entries.size(), 2u);
+
+    ExerciseRepository exRepo("test_link_exercises.json");
+    exRepo.replaceAll(ExerciseRepository::parseJSON(makeExercisesJson(3, 10)));
+
+    WorkoutPlanRepository planRepo("test_link_plans.json", &exRepo);
+    EXPECT_EQ(planRepo.linkRecords(records), 1u);  // "Missing" pominięte
+    ASSERT_EQ(planRepo.getCount(), 1u);
+
+    auto plan = planRepo.findByName("Push");
+    ASSERT_NE(plan, nullptr);
+    ASSERT_EQ(plan->getEntryCount(), 1u);
+    EXPECT_EQ(plan->getEntries()[0].exercise, exRepo.findByName("Ex 1"));
+    EXPECT_DOUBLE_EQ(plan->getEntries()[0].weight, 20.5);
+}
+
+// ===== TEST 9: Leniwe opisy =====
+TEST(LazyDescriptionTest, LoadSaveRoundTrip) {
+    // Test czy opisy czytane na żądanie są identyczne po load i po ponownym save
+    const std::string path = "test_lazy_exercises.json";
+    {
+        ExerciseRepository writer(path);
+        writer.addExercise(ExerciseFactory::createExercise(
+            ExerciseType::BODYWEIGHT, "Pompki", "Opis \"pompek\"\nlinia 2", "Chest"));
+        writer.addExercise(ExerciseFactory::createExercise(
+            ExerciseType::WEIGHTED, "Martwy ciąg", "Długi opis ze znakami ąęśćż", "Back"));
+        ASSERT_TRUE(writer.saveToJSON());
+    }
+
+    ExerciseRepository repo(path);
+    repo.setLazyDescriptions(true, 1);
+    ASSERT_TRUE(repo.loadFromJSON());
+    ASSERT_EQ(repo.getCount(), 2u);
+
+    auto pompki = repo.findByName("Pompki");
+    auto ciag = repo.findByName("Martwy ciąg");
+    EXPECT_TRUE(pompki->hasLazyDescription());
+    EXPECT_EQ(pompki->getDescriptionFootprint(), 0u);
+    EXPECT_EQ(pompki->getDescription(), "Opis \"pompek\"\nlinia 2");
+    EXPECT_EQ(ciag->getDescription(), "Długi opis ze znakami ąęśćż");
+
+    // Zapis przepina offsety na nowy plik; nowe ćwiczenie zostaje w pamięci
+    // (mogą je czytać snapshoty) i stanie się leniwe po ponownym wczytaniu
+    repo.addExercise(ExerciseFactory::createExercise(
+        ExerciseType::BODYWEIGHT, "Plank", "Nowy opis", "Abs"));
+    ASSERT_TRUE(repo.saveToJSON());
+    EXPECT_FALSE(repo.findByName("Plank")->hasLazyDescription());
+    EXPECT_EQ(repo.findByName("Plank")->getDescription(), "Nowy opis");
+    EXPECT_EQ(pompki->getDescription(), "Opis \"pompek\"\nlinia 2");
+
+    std::remove(path.c_str());
+}
+
+TEST(LazyDescriptionTest, LruEvictsOldest) {
+    // Test czy cache nie przekracza pojemności i liczy trafienia
+    const std::string path = "test_lru_store.txt";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "aaaabbbbcccc";
+    }
+
+    DescriptionStore store(path, 2);
+    EXPECT_EQ(store.fetch(0, 4), "aaaa");
+    EXPECT_EQ(store.fetch(4, 4), "bbbb");
+    EXPECT_EQ(store.fetch(0, 4), "aaaa");   // trafienie
+    EXPECT_EQ(store.fetch(8, 4), "cccc");   // wypiera "bbbb"
+
+    EXPECT_EQ(store.getCachedCount(), 2u);
+    EXPECT_EQ(store.getHits(), 1u);
+    EXPECT_EQ(store.getMisses(), 3u);
+
+    std::remove(path.c_str());
+}
+
+// ===== TEST 10: Kompresja opisów =====
+
+TEST(DescriptionCodecTest, DictionaryRoundTrip) {
+    // Test czy blok ze słownikiem się rozpakowuje i jest mniejszy niż bez słownika
+    std::vector<std::string> samples;
+    for(int i = 0; i < 200; ++i) {
+        samples.push_back("Stań prosto, stopy na szerokość barków. Napnij mięśnie brzucha i wykonaj "
+                          "powtórzenie nr " + std::to_string(i) + " w kontrolowanym tempie.");
+    }
+    DescriptionCodec::Dictionary dict(DescriptionCodec::trainDictionary(samples));
+    DescriptionCodec::Dictionary empty;
+
+    const std::string text = "Stań prosto, stopy na szerokość barków. Napnij mięśnie brzucha.";
+    const std::string withDict = dict.compress(text);
+    EXPECT_EQ(dict.decompress(withDict), text);
+    EXPECT_EQ(empty.decompress(empty.compress(text)), text);
+    EXPECT_LT(withDict.size(), empty.compress(text).size());
+    EXPECT_EQ(dict.decompress(dict.compress("")), "");
+
+    EXPECT_EQ(DescriptionCodec::decodeBase64(DescriptionCodec::encodeBase64(withDict)), withDict);
+    EXPECT_THROW(dict.decompress("\x05\xF0"), std::runtime_error);
+}
+
+TEST(DescriptionCodecTest, CompressedRepositoryRoundTrip) {
+    // Test zapisu skompresowanego i odczytu zarówno leniwego, jak i pełnego
+    const std::string path = "test_compressed_exercises.json";
+    {
+        ExerciseRepository repo(path);
+        repo.setDescriptionCompression(true);
+        repo.addExercise(ExerciseFactory::createExercise(
+            ExerciseType::BODYWEIGHT, "Pompki", "Opis \"pompek\"\nlinia 2", "Chest"));
+        repo.addExercise(ExerciseFactory::createExercise(
+            ExerciseType::WEIGHTED, "Ciąg", "Długi opis ze znakami ąęśćż", "Back"));
+        ASSERT_TRUE(repo.saveToJSON());
+    }
+
+    ExerciseRepository eager(path);
+    ASSERT_TRUE(eager.loadFromJSON());
+    EXPECT_EQ(eager.findByName("Pompki")->getDescription(), "Opis \"pompek\"\nlinia 2");
+
+    ExerciseRepository lazy(path);
+    lazy.setLazyDescriptions(true);
+    ASSERT_TRUE(lazy.loadFromJSON());
+    auto ciag = lazy.findByName("Ciąg");
+    EXPECT_TRUE(ciag->hasLazyDescription());
+    EXPECT_EQ(ciag->getDescription(), "Długi opis ze znakami ąęśćż");
+
+    std::remove(path.c_str());
+    std::remove(eager.getDictionaryPath().c_str());
+}
+
+TEST(DescriptionCodecTest, MismatchedDictionaryRejected) {
+    // Test id słownika w wartościach: nowy JSON obok starego .dict nie daje
+    // śmieci - plik nie jest przyjęty, dopóki nie dojdzie pasujący słownik
+    const std::string path = "test_dict_mismatch.json";
+    const std::string otherPath = "test_dict_mismatch_other.json";
+    for(const auto& file : {path, otherPath}) {
+        ExerciseRepository repo(file);
+        repo.setDescriptionCompression(true);
+        const std::string phrase = file == path ? "Stopy na szerokość barków, kontrolowane tempie"
+                                                : "Łokcie blisko tułowia, pełny zakres ruchu";
+        for(int i = 0; i < 20; ++i) {
+            repo.addExercise(ExerciseFactory::createExercise(
+                ExerciseType::WEIGHTED, i == 0 ? "Przysiad" : "Ex" + std::to_string(i), phrase, "Legs"));
+        }
+        ASSERT_TRUE(repo.saveToJSON());
+    }
+    ExerciseRepository repo(path);
+    std::string dictBytes, otherDictBytes;
+    ASSERT_TRUE(JsonUtils::readFile(repo.getDictionaryPath(), dictBytes));
+    ASSERT_TRUE(JsonUtils::readFile(otherPath + ".dict", otherDictBytes));
+    ASSERT_NE(dictBytes, otherDictBytes);
+
+    DescriptionCodec::Dictionary dict(dictBytes), otherDict(otherDictBytes);
+    EXPECT_EQ(DescriptionCodec::decodeValue(dict, DescriptionCodec::encodeValue(dict, "Opis")), "Opis");
+    EXPECT_THROW(DescriptionCodec::decodeValue(otherDict, DescriptionCodec::encodeValue(dict, "Opis")),
+                 std::runtime_error);
+
+    std::ofstream(repo.getDictionaryPath(), std::ios::binary) << otherDictBytes;   // Stary .dict
+    EXPECT_FALSE(repo.loadFromJSON());
+    EXPECT_EQ(repo.getCount(), 0u);
+    EXPECT_TRUE(repo.hasExternalChanges());   // Zapis nie nadpisze nieprzyjętego pliku
+    EXPECT_FALSE(repo.saveToJSON());
+
+    std::ofstream(repo.getDictionaryPath(), std::ios::binary) << dictBytes;        // Dochodzi właściwy
+    ASSERT_TRUE(repo.loadFromJSON());
+    EXPECT_EQ(repo.findByName("Przysiad")->getDescription(), "Stopy na szerokość barków, kontrolowane tempie");
+    EXPECT_FALSE(std::ifstream(JsonUtils::temporaryPath(repo.getDictionaryPath())).is_open());
+
+    for(const auto& file : {path, otherPath}) {
+        std::remove(file.c_str());
+        std::remove((file + ".dict").c_str());
+    }
+}
+
+// ===== TEST 11: Escapowanie JSON =====
+
+TEST(JsonEscapeTest, ControlCharactersAndUnicode) {
+    // Test pełnego zestawu escape'ów i dekodowania \uXXXX
+    EXPECT_EQ(JsonUtils::escape("a\"b\\c\nd\te\b\f\r"), "a\\\"b\\\\c\\nd\\te\\b\\f\\r");
+    EXPECT_EQ(JsonUtils::escape(std::string("\x01\x1F", 2)), "\\u0001\\u001f");
+    EXPECT_EQ(JsonUtils::escape("Żółć/ąę"), "Żółć/ąę");
+
+    EXPECT_EQ(JsonUtils::unescape("\\u017b\\u00F3\\/x"), "Żó/x");
+    EXPECT_EQ(JsonUtils::unescape("\\ud83d\\udcaa"), "\xF0\x9F\x92\xAA");  // para surogatów
+    EXPECT_EQ(JsonUtils::unescape("\\ud83d!"), "\xEF\xBF\xBD!");         // niesparowany
+    EXPECT_EQ(JsonUtils::unescape("\\q\\u12"), "\\q\\u12");              // nieznane zostają
+
+    EXPECT_EQ(JsonUtils::findClosingQuote("\"a\\\\\" x", 1), 4u);   // "a\\" - escapowany backslash
+    EXPECT_EQ(JsonUtils::findClosingQuote("\"a\\\"b\"", 1), 5u);
+}
+
+TEST(JsonEscapeTest, SimdMatchesScalar) {
+    // Test czy każdy wariant skanu daje ten sam wynik (znaki specjalne na granicach bloków)
+    std::string text;
+    for(int i = 0; i < 300; ++i) {
+        text += (i % 37 == 0) ? '"' : (i % 41 == 0) ? '\n' : (i % 53 == 0) ? '\x02'
+              : static_cast<char>('a' + i % 26);
+        if(i % 64 == 31) text += "ąę";
+    }
+
+    const JsonUtils::SimdLevel original = JsonUtils::getSimdLevel();
+    JsonUtils::setSimdLevel(JsonUtils::SimdLevel::SCALAR);
+    const std::string expected = JsonUtils::escape(text);
+
+    for(auto level : {JsonUtils::SimdLevel::SSE2, JsonUtils::SimdLevel::AVX2}) {
+        JsonUtils::setSimdLevel(level);
+        for(size_t offset = 0; offset < 40; ++offset) {
+            std::string_view part(text.data() + offset, text.size() - offset);
+            JsonUtils::setSimdLevel(JsonUtils::SimdLevel::SCALAR);
+            const std::string scalar = JsonUtils::escape(part);
+            JsonUtils::setSimdLevel(level);
+            EXPECT_EQ(JsonUtils::escape(part), scalar);
+        }
+        EXPECT_EQ(JsonUtils::escape(text), expected);
+    }
+    JsonUtils::setSimdLevel(original);
+
+    EXPECT_EQ(JsonUtils::unescape(expected), text);
+
+    std::string appended = "prefix:";
+    JsonUtils::appendEscaped(appended, "x\"y");
+    EXPECT_EQ(appended, "prefix:x\\\"y");
+}
+
+// ===== TEST 12: JsonWriter =====
+
+TEST(JsonWriterTest, PrettyAndCompact) {
+    // Test formatu PRETTY (taki jak czytają parsery repozytoriów) i COMPACT
+    auto write = [](JsonWriter& writer) {
+        writer.beginArray();
+        writer.beginObject();
+        writer.field("name", "A\"B");
+        writer.key("entries");
+        writer.beginArray();
+        writer.endArray();
+        writer.field("sets", 3);
+        writer.field("weight", 62.5);
+        writer.endObject();
+        writer.endArray();
+    };
+
+    JsonWriter pretty(JsonWriter::Style::PRETTY);
+    write(pretty);
+    EXPECT_EQ(pretty.getBuffer(),
+              "[\n  {\n    \"name\": \"A\\\"B\",\n    \"entries\": [\n    ],\n"
+              "    \"sets\": 3,\n    \"weight\": 62.5\n  }\n]\n");
+
+    JsonWriter compact(JsonWriter::Style::COMPACT);
+    write(compact);
+    EXPECT_EQ(compact.getBuffer(), "[{\"name\":\"A\\\"B\",\"entries\":[],\"sets\":3,\"weight\":62.5}]");
+}
+
+TEST(JsonWriterTest, ShortestRoundTripDoubles) {
+    // Test czy ciężary zapisują się najkrótszym zapisem i wracają bez strat
+    for(double weight : {0.1, 62.5, 100.0, 1.0 / 3.0, 1e-7}) {
+        JsonWriter writer(JsonWriter::Style::COMPACT);
+        writer.value(weight);
+        EXPECT_EQ(std::stod(writer.getBuffer()), weight);
+    }
+    JsonWriter writer(JsonWriter::Style::COMPACT);
+    writer.value(0.1);
+    EXPECT_EQ(writer.getBuffer(), "0.1");
+}
+
+TEST(JsonWriterTest, StreamsToFileWithOffsets) {
+    // Test strumieniowania małymi porcjami - offsety liczone w całym pliku
+    const std::string path = "test_writer.json";
+    JsonWriter writer(JsonWriter::Style::COMPACT, 16);
+    ASSERT_TRUE(writer.open(path));
+    writer.beginArray();
+    std::vector<uint64_t> offsets;
+    for(int i = 0; i < 50; ++i) {
+        offsets.push_back(writer.getOffset() + (i > 0 ? 2 : 1));  // za przecinkiem i cudzysłowem
+        writer.value("item" + std::to_string(i));
+    }
+    writer.endArray();
+    ASSERT_TRUE(writer.close());
+
+    std::string content;
+    ASSERT_TRUE(JsonUtils::readFile(path, content));
+    EXPECT_EQ(content.substr(offsets[0], 5), "item0");
+    EXPECT_EQ(content.substr(offsets[42], 6), "item42");
+    std::remove(path.c_str());
+}
+
+TEST(JsonWriterTest, LazySaveChangesDescriptionFormat) {
+    // Test zapisu leniwych opisów po zmianie formatu (zwykły -> skompresowany -> zwykły)
+    const std::string path = "test_writer_lazy.json";
+    {
+        ExerciseRepository repo(path);
+        repo.addExercise(ExerciseFactory::createExercise(
+            ExerciseType::BODYWEIGHT, "Pompki", "Opis \"pompek\"", "Chest"));
+        ASSERT_TRUE(repo.saveToJSON());
+    }
+
+    ExerciseRepository lazy(path);
+    lazy.setLazyDescriptions(true);
+    ASSERT_TRUE(lazy.loadFromJSON());
+    lazy.setDescriptionCompression(true);
+    ASSERT_TRUE(lazy.saveToJSON());
+    lazy.setDescriptionCompression(false);
+    ASSERT_TRUE(lazy.saveToJSON());
+    EXPECT_EQ(lazy.findByName("Pompki")->getDescription(), "Opis \"pompek\"");
+
+    ExerciseRepository eager(path);
+    ASSERT_TRUE(eager.loadFromJSON());
+    EXPECT_EQ(eager.findByName("Pompki")->getDescription(), "Opis \"pompek\"");
+
+    std::remove(path.c_str());
+    std::remove(eager.getDictionaryPath().c_str());
+}
+
+// ===== TEST 13: Snapshoty (MVCC) =====
+
+TEST(SnapshotTest, PersistentVectorSharesStructure) {
+    // Test czy kopia nie widzi zmian oryginału (kopiowany jest tylko zmieniony blok)
+    PersistentVector<int> items;
+    for(int i = 0; i < 200; ++i) {
+        items.pushBack(i);
+    }
+    PersistentVector<int> frozen = items;
+
+    items.set(5, -5);
+    items.erase(0);
+    items.pushBack(200);
+
+    EXPECT_EQ(frozen.size(), 200u);
+    EXPECT_EQ(frozen[5], 5);
+    EXPECT_EQ(frozen[0], 0);
+    EXPECT_EQ(items.size(), 200u);
+    EXPECT_EQ(items[4], -5);
+    EXPECT_EQ(items[199], 200);
+
+    int expected = 0;
+    for(int value : frozen) {
+        EXPECT_EQ(value, expected++);
+    }
+}
+
+TEST(SnapshotTest, RepositoryPublishesVersions) {
+    // Test izolacji snapshotu i jednej wersji na partię zmian
+    ExerciseRepository repo;
+    repo.addExercise(ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Pompki", "", "Chest"));
+    auto before = repo.getSnapshot();
+    EXPECT_EQ(before->getCount(), 1u);
+
+    {
+        MutationBatch<ExerciseRepository> batch(repo);
+        repo.addExercise(ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Plank", "", "Abs"));
+        repo.removeExercise("Pompki");
+        EXPECT_EQ(repo.getSnapshot()->getVersion(), before->getVersion());  // jeszcze nieopublikowane
+    }
+
+    auto after = repo.getSnapshot();
+    EXPECT_EQ(after->getVersion(), before->getVersion() + 1);
+    EXPECT_EQ(after->getCount(), 1u);
+    EXPECT_NE(after->findByName("Plank"), nullptr);
+    EXPECT_NE(before->findByName("Pompki"), nullptr);   // stara wersja bez zmian
+    EXPECT_EQ(before->findByName("Plank"), nullptr);
+}
+
+TEST(SnapshotTest, BackgroundSaveWhileWriting) {
+    // Test zapisu snapshotu w innym wątku równolegle ze zmianami kopii roboczej
+    const std::string path = "test_snapshot_save.json";
+    ExerciseRepository repo(path);
+    for(int i = 0; i < 500; ++i) {
+        repo.addExercise(ExerciseFactory::createExercise(
+            ExerciseType::WEIGHTED, "Ex" + std::to_string(i), "Opis", "Legs"));
+    }
+
+    auto saved = std::async(std::launch::async, [&repo]() { return repo.saveToJSON(); });
+    for(int i = 500; i < 1000; ++i) {
+        repo.addExercise(ExerciseFactory::createExercise(
+            ExerciseType::WEIGHTED, "Ex" + std::to_string(i), "Opis", "Legs"));
+    }
+    ASSERT_TRUE(saved.get());
+
+    ExerciseRepository loaded(path);
+    ASSERT_TRUE(loaded.loadFromJSON());
+    EXPECT_GE(loaded.getCount(), 500u);   // spójna wersja z chwili rozpoczęcia zapisu
+    EXPECT_LE(loaded.getCount(), 1000u);
+    EXPECT_EQ(repo.getSnapshot()->getCount(), 1000u);
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotTest, OldVersionReadsReplacedFile) {
+    // Test podmiany pliku przez rename: obiekty sprzed zapisu czytają opisy ze
+    // starej wersji pliku (otwarty deskryptor), bez kopii treści w pamięci
+    const std::string path = "test_snapshot_replace.json";
+    {
+        ExerciseRepository writer(path);
+        writer.addExercise(std::make_shared<WeightedExercise>("Przysiad", "Stopy na szerokość bioder", "Nogi"));
+        writer.addExercise(std::make_shared<WeightedExercise>("Wiosłowanie", "Plecy proste", "Plecy"));
+        ASSERT_TRUE(writer.saveToJSON());
+    }
+
+    ExerciseRepository repo(path);
+    repo.setLazyDescriptions(true);
+    ASSERT_TRUE(repo.loadFromJSON());
+    auto oldSquat = repo.findByName("Przysiad");
+    for(int i = 0; i < 3; ++i) {
+        repo.updateExercise("Przysiad", std::make_shared<WeightedExercise>(
+            "Przysiad", "Wersja " + std::to_string(i) + " - dłuższy opis przesuwa offsety", "Nogi"));
+        ASSERT_TRUE(repo.saveToJSON());
+    }
+
+    EXPECT_EQ(oldSquat->getDescription(), "Stopy na szerokość bioder");
+    EXPECT_EQ(repo.findByName("Przysiad")->getDescription(), "Wersja 2 - dłuższy opis przesuwa offsety");
+    EXPECT_EQ(repo.findByName("Wiosłowanie")->getDescription(), "Plecy proste");
+    EXPECT_FALSE(std::ifstream(JsonUtils::temporaryPath(path)).is_open());   // Plik tymczasowy podmieniony
+    std::remove(path.c_str());
+}
+
+// ===== TEST 14: Repozytoria wielowątkowo =====
+
+TEST(ConcurrencyTest, ReadersAndWriterStress) {
+    // Test wielu czytelników (findByName/searchByName/snapshot) i pisarzy naraz
+    // (sensowny głównie pod -fsanitize=thread)
+    ExerciseRepository repo("test_concurrency.json");
+    for(int i = 0; i < 200; ++i) {
+        repo.addExercise(ExerciseFactory::createExercise(
+            ExerciseType::WEIGHTED, "Stale" + std::to_string(i), "", "Legs"));
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> missing{0};
+    std::vector<std::thread> readers;
+    for(int r = 0; r < 8; ++r) {
+        readers.emplace_back([&repo, &stop, &missing, r]() {
+            while(!stop.load()) {
+                // Ćwiczenia "Stale" nigdy nie są usuwane - muszą być zawsze widoczne
+                if(!repo.findByName("Stale" + std::to_string(r * 20))) {
+                    ++missing;
+                }
+                repo.searchByName("Tmp");
+                size_t count = 0;
+                auto snapshot = repo.getSnapshot();   // trzymamy wersję przez całą iterację
+                for(const auto& ex : *snapshot) {
+                    count += ex->getName().empty() ? 0 : 1;
+                }
+                if(count < 200) {
+                    ++missing;
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for(int w = 0; w < 2; ++w) {
+        writers.emplace_back([&repo, w]() {
+            for(int i = 0; i < 300; ++i) {
+                std::string name = "Tmp" + std::to_string(w) + "_" + std::to_string(i);
+                repo.addExercise(ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, name, "", "Core"));
+                repo.updateExercise(name, ExerciseFactory::createExercise(
+                    ExerciseType::BODYWEIGHT, name + "x", "", "Core"));
+                if(i % 2 == 0) {
+                    repo.removeExercise(name + "x");
+                }
+            }
+        });
+    }
+
+    for(auto& t : writers) {
+        t.join();
+    }
+    stop = true;
+    for(auto& t : readers) {
+        t.join();
+    }
+
+    // Etap 2: aktualizacja bez zmiany nazwy - czytelnicy tych samych nazw nie
+    // mogą trafić na chwilę, w której nazwy nie ma w indeksie
+    std::atomic<bool> updating{true};
+    readers.clear();
+    for(int r = 0; r < 4; ++r) {
+        readers.emplace_back([&repo, &updating, &missing, r]() {
+            const std::string name = "Stale" + std::to_string(r);
+            while(updating.load()) {
+                if(!repo.findByName(name) || !repo.exists(name)) {
+                    ++missing;
+                }
+            }
+        });
+    }
+    for(int i = 0; i < 4000; ++i) {
+        const std::string name = "Stale" + std::to_string(i % 4);
+        repo.updateExercise(name, ExerciseFactory::createExercise(ExerciseType::WEIGHTED, name, "", "Legs"));
+    }
+    updating = false;
+    for(auto& t : readers) {
+        t.join();
+    }
+
+    EXPECT_EQ(missing.load(), 0);
+    EXPECT_EQ(repo.getCount(), 200u + 2 * 150u);
+    EXPECT_EQ(repo.getSnapshot()->getCount(), repo.getCount());
+    EXPECT_TRUE(repo.exists("Tmp1_299x"));
+    EXPECT_FALSE(repo.exists("Tmp1_298x"));
+    EXPECT_FALSE(repo.exists("Tmp0_1"));   // stara nazwa zwolniona przez update
+}
+
+TEST(ConcurrencyTest, PlanUpdatesKeepNamesVisible) {
+    // Test podmiany planu w miejscu (updatePlan, commitDraft, import z REPLACE):
+    // czytelnicy nigdy nie widzą braku planu, który tylko się zmienia
+    ExerciseRepository exercises("test_concurrency_plan_ex.json");
+    auto squat = std::make_shared<WeightedExercise>("Przysiad", "", "Legs");
+    exercises.addExercise(squat);
+    WorkoutPlanRepository plans("test_concurrency_plans.json", &exercises);
+    auto makePlan = [&squat](const std::string& name, int reps) {
+        auto plan = std::make_shared<WorkoutPlan>(name);
+        plan->addEntry(squat, 3, reps, 60.0, 90);
+        return plan;
+    };
+    for(int i = 0; i < 4; ++i) {
+        plans.addPlan(makePlan("Plan" + std::to_string(i), 5));
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> missing{0};
+    std::vector<std::thread> readers;
+    for(int r = 0; r < 4; ++r) {
+        readers.emplace_back([&plans, &stop, &missing, r]() {
+            const std::string name = "Plan" + std::to_string(r);
+            for(size_t n = 0; !stop.load(); ++n) {
+                if(!plans.findByName(name) || (n % 16 == 0 && !plans.openDraft(name).plan)) {
+                    ++missing;
+                }
+            }
+        });
+    }
+
+    ImportOptions replace;
+    replace.duplicates = DuplicatePolicy::REPLACE;
+    for(int i = 0; i < 3000; ++i) {
+        const std::string name = "Plan" + std::to_string(i % 4);
+        if(i % 3 == 0) {
+            plans.updatePlan(name, makePlan(name, i % 20 + 1));
+        } else if(i % 3 == 1) {
+            auto draft = plans.openDraft(name);
+            draft.plan->editEntry(0, 3, i % 20 + 1, 60.0, 90);
+            plans.commitDraft(draft);
+        } else {
+            plans.importPlans({PlanRecord{name, {{"Przysiad", 4, i % 20 + 1, 50.0, 60}}}}, replace);
+        }
+    }
+    stop = true;
+    for(auto& t : readers) {
+        t.join();
+    }
+
+    EXPECT_EQ(missing.load(), 0);
+    EXPECT_EQ(plans.getCount(), 4u);
+}
+
+// ===== TEST 15: Katalog bazowy i nakładki użytkowników =====
+
+TEST(ExerciseCatalogTest, OverlaySharesBaseCatalog) {
+    // Test dwóch użytkowników na wspólnym katalogu - każdy widzi tylko swoje zmiany
+    auto catalog = std::make_shared<const ExerciseCatalog>(std::vector<std::shared_ptr<Exercise>>{
+        ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Przysiad", "Opis", "Legs"),
+        ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Pompki", "", "Chest"),
+        ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Plank", "", "Abs")});
+
+    const std::string pathA = "test_overlay_a.json";
+    ExerciseRepository userA(pathA);
+    ExerciseRepository userB("test_overlay_b.json");
+    userA.setBaseCatalog(catalog);
+    userB.setBaseCatalog(catalog);
+
+    userA.addExercise(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Wiosłowanie", "", "Back"));
+    EXPECT_THROW(userA.addExercise(ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Plank", "", "Abs")),
+                 std::runtime_error);
+    EXPECT_TRUE(userA.updateExercise("Pompki", ExerciseFactory::createExercise(
+        ExerciseType::BODYWEIGHT, "Pompki", "", "Triceps")));
+    EXPECT_FALSE(userA.updateExercise("Plank", ExerciseFactory::createExercise(
+        ExerciseType::BODYWEIGHT, "Deska", "", "Abs")));   // zmiana nazwy ćwiczenia z katalogu
+    EXPECT_FALSE(userA.removeExercise("Przysiad"));         // katalog jest tylko do odczytu
+
+    EXPECT_EQ(userA.getCount(), 4u);
+    EXPECT_EQ(userA.getOverlayCount(), 2u);
+    EXPECT_EQ(userA.findByName("Pompki")->getTargetMuscles(), "Triceps");
+    EXPECT_EQ(userB.findByName("Pompki")->getTargetMuscles(), "Chest");
+    EXPECT_EQ(userB.findByName("Przysiad"), catalog->findByName("Przysiad"));  // ten sam obiekt
+    EXPECT_EQ(userA.searchByName("P").size(), 3u);
+
+    // Kolejność widoku scalonego: katalog (z przesłonięciami), potem własne
+    auto snapshot = userA.getSnapshot();
+    ASSERT_EQ(snapshot->getCount(), 4u);
+    EXPECT_EQ(snapshot->getItems()[1]->getTargetMuscles(), "Triceps");
+    EXPECT_EQ(snapshot->getItems()[3]->getName(), "Wiosłowanie");
+    EXPECT_EQ(userA.getAllExercises().size(), 4u);
+
+    // Do pliku trafia tylko nakładka, po wczytaniu widok scalony wraca
+    ASSERT_TRUE(userA.saveToJSON());
+    ExerciseRepository plain(pathA);
+    ASSERT_TRUE(plain.loadFromJSON());
+    EXPECT_EQ(plain.getCount(), 2u);
+
+    ExerciseRepository reloaded(pathA);
+    reloaded.setBaseCatalog(catalog);
+    ASSERT_TRUE(reloaded.loadFromJSON());
+    EXPECT_EQ(reloaded.getCount(), 4u);
+    EXPECT_EQ(reloaded.findByName("Pompki")->getTargetMuscles(), "Triceps");
+
+    // Usunięcie przesłonięcia przywraca wersję z katalogu
+    EXPECT_TRUE(reloaded.removeExercise("Pompki"));
+    EXPECT_EQ(reloaded.findByName("Pompki"), catalog->findByName("Pompki"));
+    EXPECT_EQ(reloaded.getSnapshot()->getItems()[1], catalog->findByName("Pompki"));
+    EXPECT_EQ(reloaded.getCount(), 4u);   // Pozycja katalogu zostaje
+
+    // Licznik nakładki: przesłonięcie z importu nie zwiększa liczby, własne tak
+    ImportOptions replace;
+    replace.duplicates = DuplicatePolicy::REPLACE;
+    reloaded.importExercises({ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Plank", "", "Core"),
+                              ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Dipy", "", "Triceps")},
+                             replace);
+    EXPECT_EQ(reloaded.getCount(), 5u);
+    EXPECT_TRUE(reloaded.removeExercise("Wiosłowanie"));
+    EXPECT_EQ(reloaded.getCount(), 4u);
+    EXPECT_EQ(reloaded.getSnapshot()->getCount(), reloaded.getCount());
+    reloaded.setBaseCatalog(nullptr);
+    EXPECT_EQ(reloaded.getCount(), 2u);   // Bez katalogu - sama nakładka
+    std::remove(pathA.c_str());
+}
+
+// ===== TEST 16: Import wsadowy =====
+
+TEST(BulkImportTest, ExercisesDeduplicatedAndReported) {
+    // Test importu z duplikatami, błędnymi wierszami i jedną publikacją wersji
+    ExerciseRepository repo("test_import.json");
+    repo.addExercise(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Przysiad", "", "Legs"));
+    const uint64_t versionBefore = repo.getSnapshot()->getVersion();
+
+    std::vector<std::shared_ptr<Exercise>> rows;
+    for(int i = 0; i < 1000; ++i) {
+        rows.push_back(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Imp" + std::to_string(i), "", "Back"));
+    }
+    rows.push_back(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Imp7", "", "Back"));   // duplikat w partii
+    rows.push_back(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Przysiad", "", "Glutes"));
+    rows.push_back(nullptr);
+    rows.push_back(ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "", "", "Abs"));
+
+    ImportReport report = repo.importExercises(rows);
+    EXPECT_TRUE(report.committed);
+    EXPECT_EQ(report.added, 1000u);
+    EXPECT_EQ(report.duplicates, 1u);
+    EXPECT_EQ(report.skipped, 1u);
+    ASSERT_EQ(report.errors.size(), 2u);
+    EXPECT_EQ(report.errors[0].row, 1002u);
+    EXPECT_EQ(report.errors[1].row, 1003u);
+    EXPECT_EQ(repo.getCount(), 1001u);
+    EXPECT_EQ(repo.getSnapshot()->getVersion(), versionBefore + 1);   // jedna nowa wersja
+    EXPECT_EQ(repo.findByName("Przysiad")->getTargetMuscles(), "Legs");
+
+    // REPLACE podmienia istniejące, allOrNothing przy błędzie niczego nie zmienia
+    ImportOptions replace;
+    replace.duplicates = DuplicatePolicy::REPLACE;
+    report = repo.importExercises({rows[1001]}, replace);
+    EXPECT_EQ(report.replaced, 1u);
+    EXPECT_EQ(repo.findByName("Przysiad")->getTargetMuscles(), "Glutes");
+
+    replace.allOrNothing = true;
+    report = repo.importExercises({ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Nowe", "", "Legs"), nullptr},
+                                  replace);
+    EXPECT_FALSE(report.committed);
+    EXPECT_FALSE(repo.exists("Nowe"));
+}
+
+TEST(BulkImportTest, PlansResolvedAgainstExercises) {
+    // Test importu planów z rekordów - plan z nieznanym ćwiczeniem odrzucony w całości
+    ExerciseRepository exercises("test_import_ex.json");
+    exercises.addExercise(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Przysiad", "", "Legs"));
+    WorkoutPlanRepository plans("test_import_plans.json", &exercises);
+
+    std::vector<PlanRecord> records = {
+        {"Nogi", {{"Przysiad", 5, 5, 100.0, 180}}},
+        {"Zły", {{"Przysiad", 3, 10, 60.0, 90}, {"Brak", 3, 10, 0.0, 60}}},
+        {"Zero", {{"Przysiad", 0, 10, 60.0, 90}}},
+        {"Nogi", {{"Przysiad", 3, 3, 120.0, 240}}}};
+
+    ImportReport report = plans.importPlans(records);
+    EXPECT_TRUE(report.committed);
+    EXPECT_EQ(report.added, 1u);
+    EXPECT_EQ(report.duplicates, 1u);
+    ASSERT_EQ(report.errors.size(), 2u);
+    EXPECT_EQ(report.errors[0].name, "Zły");
+    EXPECT_EQ(plans.getCount(), 1u);
+    EXPECT_EQ(plans.findByName("Nogi")->getEntries()[0].exercise, exercises.findByName("Przysiad"));
+}
+
+// ===== TEST 17: Import/eksport CSV i JSON Lines =====
+
+TEST(InterchangeTest, CsvRoundTripWithQuoting) {
+    // Test pól z przecinkami, cudzysłowami i nowymi liniami oraz kolejności kolumn
+    std::stringstream csv;
+    Interchange::ExerciseWriter writer(csv, Interchange::Format::CSV);
+    writer.write(Interchange::ExerciseRow{"Wyciskanie, skos", "weighted", "Chest", "Linia 1\nPowiedz \"tak\""});
+    writer.write(Interchange::ExerciseRow{"Plank", "bodyweight", "Abs", std::string(20000, 'a')});  // > bufor linii
+    EXPECT_EQ(writer.getCount(), 2u);
+
+    std::vector<Interchange::ExerciseRow> rows;
+    auto stats = Interchange::readExercises(csv, Interchange::Format::CSV, [&rows](Interchange::ExerciseRow&& row) {
+        rows.push_back(std::move(row));
+        return true;
+    });
+    EXPECT_EQ(stats.records, 2u);
+    EXPECT_EQ(stats.errors, 0u);
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0].name, "Wyciskanie, skos");
+    EXPECT_EQ(rows[0].description, "Linia 1\nPowiedz \"tak\"");
+    EXPECT_EQ(rows[1].type, "bodyweight");
+    EXPECT_EQ(rows[1].description.size(), 20000u);
+
+    std::stringstream reordered("type,name,extra\r\nweighted,Przysiad,x\r\n\r\nbodyweight,Pompki,y\r\n");
+    rows.clear();
+    Interchange::readExercises(reordered, Interchange::Format::CSV, [&rows](Interchange::ExerciseRow&& row) {
+        rows.push_back(std::move(row));
+        return true;
+    });
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[1].name, "Pompki");
+    EXPECT_EQ(rows[1].muscles, "");
+}
+
+TEST(InterchangeTest, JsonlPlansAndEntries) {
+    // Test planów w JSONL (plan w linii i wpis w linii) oraz błędnej linii
+    std::shared_ptr<Exercise> ex = ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Przysiad \"low bar\"", "", "Legs");
+    WorkoutPlan plan("Nogi");
+    plan.addEntry(ex, 5, 5, 102.5, 180);
+    plan.addEntry(ex, 3, 8, 80.0, 120);
+
+    for(auto layout : {Interchange::PlanLayout::PLANS, Interchange::PlanLayout::ENTRIES}) {
+        std::stringstream out;
+        Interchange::PlanWriter writer(out, Interchange::Format::JSONL, layout);
+        writer.write(plan);
+        out << "{\"name\": broken\n";
+
+        std::vector<PlanRecord> plans;
+        std::vector<size_t> errorRecords;
+        auto stats = Interchange::readPlans(out, Interchange::Format::JSONL, layout,
+            [&plans](PlanRecord&& p) { plans.push_back(std::move(p)); return true; },
+            [&errorRecords](size_t record, const std::string&) { errorRecords.push_back(record); });
+
+        EXPECT_EQ(stats.records, 1u);
+        EXPECT_EQ(stats.errors, 1u);
+        ASSERT_EQ(plans.size(), 1u);
+        EXPECT_EQ(plans[0].name, "Nogi");
+        ASSERT_EQ(plans[0].entries.size(), 2u);
+        EXPECT_EQ(plans[0].entries[0].exerciseName, "Przysiad \"low bar\"");
+        EXPECT_DOUBLE_EQ(plans[0].entries[0].weight, 102.5);
+        EXPECT_EQ(plans[0].entries[1].restTime, 120);
+        ASSERT_EQ(errorRecords.size(), 1u);
+        EXPECT_EQ(errorRecords[0], layout == Interchange::PlanLayout::PLANS ? 1u : 2u);
+    }
+}
+
+TEST(InterchangeTest, StreamingImportInBatches) {
+    // Test importu strumieniowego partiami - numery wierszy błędów liczone od początku
+    std::stringstream csv;
+    csv << "name,type,muscles\n";
+    for(int i = 0; i < 250; ++i) {
+        csv << "Ex" << i << ",weighted,Legs\n";
+    }
+    csv << "Zly,unknown,Legs\n";
+
+    ExerciseRepository repo("test_interchange.json");
+    ImportReport report = Interchange::importExercises(csv, Interchange::Format::CSV, repo, ImportOptions(), 64);
+    EXPECT_TRUE(report.committed);
+    EXPECT_EQ(report.added, 250u);
+    ASSERT_EQ(report.errors.size(), 1u);
+    EXPECT_EQ(report.errors[0].row, 250u);
+    EXPECT_EQ(repo.getCount(), 250u);
+
+    std::stringstream exported;
+    EXPECT_EQ(Interchange::exportExercises(*repo.getSnapshot(), exported, Interchange::Format::JSONL), 250u);
+    ExerciseRepository copy("test_interchange_copy.json");
+    report = Interchange::importExercises(exported, Interchange::Format::JSONL, copy);
+    EXPECT_EQ(report.added, 250u);
+    EXPECT_EQ(copy.findByName("Ex42")->getTargetMuscles(), "Legs");
+}
+
+// ===== TEST 18: Podpowiedzi nazw ("czy chodziło o...") =====
+
+TEST(FuzzyIndexTest, DiacriticsTyposAndTranspositions) {
+    // Test normalizacji i odległości: polskie znaki, wielkość liter, przestawione litery
+    EXPECT_EQ(FuzzyIndex::normalize("  Wyciskanie  na ŁAWCE "), "wyciskanie na lawce");
+    EXPECT_EQ(FuzzyIndex::distance("przysiad", "pzrysiad", 3), 1);
+    EXPECT_EQ(FuzzyIndex::distance("abc", "xyz", 1), 2);   // Powyżej limitu: limit + 1
+
+    ExerciseRepository repo("test_fuzzy.json");
+    repo.addExercise(std::make_shared<WeightedExercise>("Wyciskanie na ławce", "", "Chest"));
+    repo.addExercise(std::make_shared<WeightedExercise>("Przysiad", "", "Legs"));
+    repo.addExercise(std::make_shared<WeightedExercise>("Przysiad bułgarski", "", "Legs"));
+
+    auto suggestions = repo.suggestNames("wyciskanie na lawce");
+    ASSERT_FALSE(suggestions.empty());
+    EXPECT_EQ(suggestions[0].name, "Wyciskanie na ławce");
+    EXPECT_EQ(suggestions[0].distance, 0);
+
+    EXPECT_EQ(repo.findClosest("Pzrysiad"), repo.findByName("Przysiad"));
+    EXPECT_EQ(repo.findClosest("Martwy ciąg"), nullptr);
+    EXPECT_EQ(repo.findEquivalent("PRZYSIAD BULGARSKI"), repo.findByName("Przysiad bułgarski"));
+    EXPECT_EQ(repo.findEquivalent("Pzrysiad"), nullptr);
+
+    // Indeks śledzi zmiany nazw i usunięcia
+    repo.updateExercise("Przysiad", std::make_shared<WeightedExercise>("Przysiad przedni", "", "Legs"));
+    EXPECT_EQ(repo.findClosest("Przysiad przedi")->getName(), "Przysiad przedni");
+    repo.removeExercise("Przysiad bułgarski");
+    EXPECT_TRUE(repo.suggestNames("Przysiad bulgarski").empty());
+}
+
+TEST(FuzzyIndexTest, PlanLinkResolvesOnlyNormalizedNames) {
+    // Test linkowania planu: inna pisownia przyjęta, literówka (nawet jednoznaczna) pominięta
+    ExerciseRepository exRepo("test_fuzzy_link.json");
+    exRepo.addExercise(std::make_shared<WeightedExercise>("Wiosłowanie sztangą", "", "Back"));
+    exRepo.addExercise(std::make_shared<WeightedExercise>("Ex 1", "", "Legs"));
+    exRepo.addExercise(std::make_shared<WeightedExercise>("Ex 2", "", "Legs"));
+
+    PlanRecord record;
+    record.name = "Pull";
+    record.entries.push_back({"wioslowanie sztanga", 4, 8, 60.0, 90});
+    record.entries.push_back({"Ex 3", 3, 10, 0.0, 60});   // Remis Ex 1 / Ex 2
+    record.entries.push_back({"Wiosłowanie sztagną", 3, 10, 60.0, 90});   // Literówka - tylko podpowiedź
+
+    WorkoutPlanRepository planRepo("test_fuzzy_link_plans.json", &exRepo);
+    EXPECT_EQ(planRepo.linkRecords({record}), 2u);
+    auto plan = planRepo.findByName("Pull");
+    ASSERT_NE(plan, nullptr);
+    ASSERT_EQ(plan->getEntryCount(), 1u);
+    EXPECT_EQ(plan->getEntries()[0].exercise, exRepo.findByName("Wiosłowanie sztangą"));
+}
+
+TEST(FuzzyIndexTest, LargeIndexLookup) {
+    // Test wydajności na 100k nazw - zapytanie z literówką i przestawieniem
+    const char* words[] = {"wyciskanie", "przysiad", "martwy", "ciag", "wioslowanie", "podciaganie",
+                           "uginanie", "hantle", "sztanga", "lawka", "skos", "wykroki"};
+    FuzzyIndex index;
+    std::vector<std::string> names;
+    for(int i = 0; i < 100000; ++i) {
+        names.push_back(std::string(words[i % 12]) + " " + words[(i / 12) % 12] + " " + std::to_string(i));
+        index.insert(names.back());
+    }
+    EXPECT_EQ(index.size(), 100000u);
+
+    const int queries = 200;
+    auto start = std::chrono::steady_clock::now();
+    size_t hits = 0;
+    for(int q = 0; q < queries; ++q) {
+        std::string query = names[static_cast<size_t>(q) * 499];
+        std::swap(query[1], query[2]);
+        auto results = index.query(query);
+        hits += !results.empty() && results[0].name == names[static_cast<size_t>(q) * 499];
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(hits, static_cast<size_t>(queries));
+    EXPECT_LT(elapsed / queries, 20000);   // Luźny próg (debug, sanitizery); cel: < 1 ms
+}
+
+// ===== TEST 19: Posortowane strony zapytań =====
+
+namespace {
+std::vector<std::string> pageNames(const ExercisePage& page) {
+    std::vector<std::string> names;
+    for(const auto& ex : page.items) {
+        names.push_back(ex->getName());
+    }
+    return names;
+}
+}
+
+TEST(SortedQueryTest, PolishCollationWithCursorPaging) {
+    // Test porządku polskiego (ą po a, ł po l, ź i ż po z) i stronicowania kursorem
+    EXPECT_GT(Collation::comparePolish("Łydki", "Lunges"), 0);
+    EXPECT_LT(Collation::comparePolish("cable", "Ćwiczenie"), 0);
+
+    ExerciseRepository repo("test_sorted.json");
+    for(const char* name : {"Żuraw", "Zakroki", "Źdźbło", "Łydki", "Lunges", "Ćwiczenie", "Cable", "ab"}) {
+        repo.addExercise(std::make_shared<BodyweightExercise>(name, "", "Core"));
+    }
+
+    ExerciseQuery query;
+    query.pageSize = 3;
+    auto first = repo.queryExercises(query);
+    EXPECT_EQ(pageNames(first), (std::vector<std::string>{"ab", "Cable", "Ćwiczenie"}));
+    ASSERT_TRUE(first.hasMore());
+
+    // Zmiana przed kursorem nie przesuwa następnej strony
+    repo.addExercise(std::make_shared<BodyweightExercise>("Bieg", "", "Legs"));
+    query.cursor = first.nextCursor;
+    auto second = repo.queryExercises(query);
+    EXPECT_EQ(pageNames(second), (std::vector<std::string>{"Lunges", "Łydki", "Zakroki"}));
+
+    query.cursor = second.nextCursor;
+    auto last = repo.queryExercises(query);
+    EXPECT_EQ(pageNames(last), (std::vector<std::string>{"Źdźbło", "Żuraw"}));
+    EXPECT_FALSE(last.hasMore());
+
+    query = ExerciseQuery();
+    query.nameContains = "u";
+    EXPECT_EQ(pageNames(repo.queryExercises(query)), (std::vector<std::string>{"Lunges", "Żuraw"}));
+}
+
+TEST(SortedQueryTest, TypeMusclesAndRecentOverBaseCatalog) {
+    // Test kluczy TYPE/MUSCLES/RECENT na widoku scalonym katalogu i nakładki
+    auto catalog = std::make_shared<const ExerciseCatalog>(std::vector<std::shared_ptr<Exercise>>{
+        ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Przysiad", "", "Nogi"),
+        ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Pompki", "", "Klatka"),
+        ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Deska", "", "Brzuch")});
+
+    ExerciseRepository repo("test_sorted_overlay.json");
+    repo.setBaseCatalog(catalog);
+    repo.addExercise(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Wiosłowanie", "", "Plecy"));
+    repo.updateExercise("Pompki", ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Pompki", "", "Triceps"));
+
+    ExerciseQuery query;
+    query.pageSize = 10;
+    query.sortBy = ExerciseSortKey::TYPE;
+    EXPECT_EQ(pageNames(repo.queryExercises(query)),
+              (std::vector<std::string>{"Deska", "Pompki", "Przysiad", "Wiosłowanie"}));
+
+    query.sortBy = ExerciseSortKey::MUSCLES;
+    auto byMuscles = repo.queryExercises(query);
+    EXPECT_EQ(pageNames(byMuscles), (std::vector<std::string>{"Deska", "Przysiad", "Wiosłowanie", "Pompki"}));
+    EXPECT_EQ(byMuscles.items[3]->getTargetMuscles(), "Triceps");   // Przesłonięcie, jedna pozycja
+
+    // Ostatnio używane najpierw (także ćwiczenia katalogu), potem reszta po nazwie
+    EXPECT_TRUE(repo.markUsed("Przysiad"));
+    EXPECT_TRUE(repo.markUsed("Wiosłowanie"));
+    EXPECT_FALSE(repo.markUsed("Nieznane"));
+    query.sortBy = ExerciseSortKey::RECENT;
+    query.pageSize = 1;
+    std::vector<std::string> names;
+    do {
+        auto page = repo.queryExercises(query);
+        auto pageItems = pageNames(page);
+        names.insert(names.end(), pageItems.begin(), pageItems.end());
+        query.cursor = page.nextCursor;
+    } while(!query.cursor.empty());
+    EXPECT_EQ(names, (std::vector<std::string>{"Wiosłowanie", "Przysiad", "Deska", "Pompki"}));
+
+    // Usunięcie własnego ćwiczenia usuwa je też z "ostatnio używanych"
+    repo.removeExercise("Wiosłowanie");
+    query.cursor.clear();
+    query.pageSize = 10;
+    EXPECT_EQ(pageNames(repo.queryExercises(query)), (std::vector<std::string>{"Przysiad", "Deska", "Pompki"}));
+}
+
+// ===== TEST 20: Cofnij/ponów (CommandLog) =====
+
+TEST(CommandLogTest, ExerciseAndPlanUndoRedo) {
+    // Test delt: ćwiczenia jako wskaźniki do niezmiennych wersji, plan jako zmieniony fragment
+    ExerciseRepository exercises("test_undo_ex.json");
+    WorkoutPlanRepository plans("test_undo_plans.json", &exercises);
+    CommandLog log(exercises, plans);
+
+    auto squat = std::make_shared<WeightedExercise>("Przysiad", "", "Nogi");
+    auto pushups = std::make_shared<BodyweightExercise>("Pompki", "", "Klatka");
+    log.addExercise(squat);
+    log.addExercise(pushups);
+    ASSERT_TRUE(log.updateExercise("Pompki", std::make_shared<BodyweightExercise>("Pompki szerokie", "", "Klatka")));
+    EXPECT_EQ(log.undoLabel(), "Edycja ćwiczenia");
+
+    ASSERT_TRUE(log.undo());
+    EXPECT_EQ(exercises.findByName("Pompki"), pushups);   // Ten sam obiekt, nie kopia
+    EXPECT_FALSE(exercises.exists("Pompki szerokie"));
+    ASSERT_TRUE(log.redo());
+    EXPECT_TRUE(exercises.exists("Pompki szerokie"));
+
+    auto plan = std::make_shared<WorkoutPlan>("FBW");
+    for(int i = 0; i < 20; ++i) {
+        plan->addEntry(squat, 3, 10 + i, 60.0, 90);
+    }
+    log.addPlan(plan);
+    auto edited = std::make_shared<WorkoutPlan>(*plan);
+    edited->editEntry(7, 5, 5, 100.0, 180);
+    ASSERT_TRUE(log.updatePlan("FBW", edited));
+    EXPECT_LT(log.estimateMemoryUsage(), 2048u);   // Jeden wpis w delcie, nie 2 x 20
+
+    ASSERT_TRUE(log.undo());
+    EXPECT_EQ(plans.findByName("FBW")->getEntries()[7].reps, 17);
+    ASSERT_TRUE(log.redo());
+    EXPECT_EQ(plans.findByName("FBW")->getEntries()[7].reps, 5);
+
+    // Nowa zmiana unieważnia ponowienia
+    ASSERT_TRUE(log.undo());
+    ASSERT_TRUE(log.removeExercise("Przysiad"));
+    EXPECT_FALSE(log.canRedo());
+    ASSERT_TRUE(log.undo());
+    EXPECT_EQ(exercises.findByName("Przysiad"), squat);
+
+    // Zmiana z pominięciem historii - cofnięcie jej nie nadpisuje
+    plans.removePlan("FBW");
+    EXPECT_FALSE(log.undo());
+    EXPECT_FALSE(log.canUndo());
+}
+
+TEST(CommandLogTest, TransactionIsOneStepAndOneVersion) {
+    // Test grupowania: wiele edycji = jeden krok historii i jedna publikacja
+    auto catalog = std::make_shared<const ExerciseCatalog>(std::vector<std::shared_ptr<Exercise>>{
+        ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Deska", "", "Brzuch")});
+    ExerciseRepository exercises("test_undo_tx.json");
+    exercises.setBaseCatalog(catalog);
+    WorkoutPlanRepository plans("test_undo_tx_plans.json", &exercises);
+    CommandLog log(exercises, plans);
+
+    const uint64_t before = exercises.getSnapshot()->getVersion();
+    {
+        CommandTransaction tx(log, "Import");
+        for(int i = 0; i < 50; ++i) {
+            log.addExercise(std::make_shared<BodyweightExercise>("Ćwiczenie " + std::to_string(i), "", "Core"));
+        }
+        log.updateExercise("Deska", ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Deska", "", "Core"));
+    }
+    EXPECT_EQ(exercises.getSnapshot()->getVersion(), before + 1);
+    EXPECT_EQ(exercises.getOverlayCount(), 51u);
+    EXPECT_EQ(log.undoLabel(), "Import");
+
+    // Cofnięcie przesłonięcia katalogu usuwa je z nakładki zamiast kopiować katalog
+    ASSERT_TRUE(log.undo());
+    EXPECT_FALSE(log.canUndo());
+    EXPECT_EQ(exercises.getOverlayCount(), 0u);
+    EXPECT_EQ(exercises.findByName("Deska")->getTargetMuscles(), "Brzuch");
+
+    ASSERT_TRUE(log.redo());
+    EXPECT_EQ(exercises.getCount(), 51u);
+    EXPECT_EQ(exercises.findByName("Deska")->getTargetMuscles(), "Core");
+}
+
+// ===== TEST 21: Szkice planów (współdzielenie wpisów) =====
+
+TEST(PlanDraftTest, DraftSharesEntriesUntilCommit) {
+    // Test izolacji szkicu: otwarcie O(1), zmiany niewidoczne do zatwierdzenia
+    ExerciseRepository exercises("test_draft_ex.json");
+    WorkoutPlanRepository plans("test_draft_plans.json", &exercises);
+    auto squat = std::make_shared<WeightedExercise>("Przysiad", "", "Nogi");
+    exercises.addExercise(squat);
+
+    auto plan = std::make_shared<WorkoutPlan>("Duży plan");
+    for(int i = 0; i < 500; ++i) {
+        plan->addEntry(squat, 3, 1 + i % 20, 50.0, 60);
+    }
+    plans.addPlan(plan);
+    const long references = squat.use_count();
+
+    PlanDraft draft = plans.openDraft("Duży plan");
+    ASSERT_TRUE(draft.plan);
+    EXPECT_TRUE(draft.plan->sharesEntriesWith(*plan));
+    EXPECT_EQ(squat.use_count(), references);   // Kopia nie podbiła liczników wpisów
+
+    draft.plan->editEntry(250, 5, 5, 100.0, 180);
+    draft.plan->insertEntry(0, squat, 2, 2, 20.0, 30);
+    EXPECT_EQ(plan->getEntryCount(), 500u);
+    EXPECT_EQ(plan->getEntries()[250].reps, 11);
+    EXPECT_EQ(plans.getSnapshot()->findByName("Duży plan")->getEntries()[250].sets, 3);
+
+    // Porzucenie szkicu = wycofanie
+    PlanDraft abandoned = plans.openDraft("Duży plan");
+    abandoned.plan->clear();
+    EXPECT_EQ(plans.findByName("Duży plan")->getEntryCount(), 500u);
+
+    ASSERT_TRUE(plans.commitDraft(draft));
+    auto committed = plans.findByName("Duży plan");
+    EXPECT_EQ(committed->getEntryCount(), 501u);
+    EXPECT_EQ(committed->getEntries()[251].reps, 5);
+    EXPECT_EQ(committed->getEntries()[0].sets, 2);
+
+    // Szkic ze starej wersji nie nadpisuje zatwierdzonej zmiany
+    EXPECT_FALSE(plans.commitDraft(abandoned));
+    EXPECT_EQ(plans.findByName("Duży plan")->getEntryCount(), 501u);
+}
+
+TEST(PlanDraftTest, CommitThroughCommandLogRecordsDelta) {
+    // Test zatwierdzenia przez CommandLog - cofnięcie przywraca wersję sprzed szkicu
+    ExerciseRepository exercises("test_draft_log_ex.json");
+    WorkoutPlanRepository plans("test_draft_log_plans.json", &exercises);
+    CommandLog log(exercises, plans);
+    auto pullups = std::make_shared<BodyweightExercise>("Podciąganie", "", "Plecy");
+    exercises.addExercise(pullups);
+
+    PlanDraft created = WorkoutPlanRepository::newDraft("Plecy");
+    created.plan->addEntry(pullups, 4, 8, 0.0, 120);
+    ASSERT_TRUE(log.commitDraft(created));
+
+    PlanDraft draft = plans.openDraft("Plecy");
+    draft.plan->setName("Plecy A");
+    draft.plan->addEntry(pullups, 3, 12, 0.0, 90);
+    ASSERT_TRUE(log.commitDraft(draft));
+    EXPECT_FALSE(plans.exists("Plecy"));
+
+    ASSERT_TRUE(log.undo());
+    ASSERT_TRUE(plans.exists("Plecy"));
+    EXPECT_EQ(plans.findByName("Plecy")->getEntryCount(), 1u);
+    ASSERT_TRUE(log.undo());
+    EXPECT_FALSE(plans.exists("Plecy"));
+}
+
+// ===== TEST 22: Generator programów periodyzowanych =====
+
+TEST(ProgramGeneratorTest, LinearWaveAndDeload) {
+    // Test reguł: liniowa (z ciężarem i bez), fala 5/3/1, deload co 4. tydzień
+    auto squat = std::make_shared<WeightedExercise>("Przysiad", "", "Nogi");
+    auto bench = std::make_shared<WeightedExercise>("Wyciskanie", "", "Klatka");
+    auto pullups = std::make_shared<BodyweightExercise>("Podciąganie", "", "Plecy");
+    auto base = std::make_shared<WorkoutPlan>("FBW");
+    base->addEntry(squat, 5, 5, 100.0, 180);
+    base->addEntry(bench, 3, 5, 80.0, 120);
+    base->addEntry(pullups, 3, 6, 0.0, 90);
+
+    ProgramSpec spec;
+    spec.basePlan = base;
+    spec.weeks = 8;
+    spec.rules.push_back(ProgressionRule());   // Domyślna liniowa: +2.5 kg / +1 powtórzenie
+    ProgressionRule wave;
+    wave.kind = ProgressionRule::Kind::PERCENT_WAVE;
+    wave.exerciseName = "Wyciskanie";
+    wave.oneRepMax = 100.0;
+    wave.oneRepMaxStep = 5.0;
+    wave.wave = {{0.65, 5, 3}, {0.75, 3, 3}, {0.85, 1, 3}};
+    spec.rules.push_back(wave);
+
+    Program program = ProgramGenerator::generate(spec);
+    ASSERT_EQ(program.weeks.size(), 8u);
+    EXPECT_EQ(program.weeks[0]->getName(), "FBW - tydzień 1");
+    EXPECT_TRUE(program.deloadWeeks[3]);
+    EXPECT_EQ(program.weeks[3]->getName(), "FBW - tydzień 4 (deload)");
+
+    // Tydzień 3 = trzeci tydzień pracy; deload nie przesuwa progresji
+    EXPECT_DOUBLE_EQ(program.weeks[2]->getEntries()[0].weight, 105.0);
+    EXPECT_DOUBLE_EQ(program.weeks[3]->getEntries()[0].weight, 65.0);    // 107.5 * 0.6 -> 65
+    EXPECT_EQ(program.weeks[3]->getEntries()[0].sets, 3);                // 5 * 0.5 -> 3 (zaokrąglenie)
+    EXPECT_DOUBLE_EQ(program.weeks[4]->getEntries()[0].weight, 107.5);
+    EXPECT_EQ(program.weeks[4]->getEntries()[2].reps, 9);
+
+    // Fala: tydzień pracy 4 = drugi cykl (1RM 105), 65%
+    EXPECT_DOUBLE_EQ(program.weeks[1]->getEntries()[1].weight, 75.0);
+    EXPECT_EQ(program.weeks[2]->getEntries()[1].reps, 1);
+    EXPECT_DOUBLE_EQ(program.weeks[4]->getEntries()[1].weight, 67.5);    // 68.25 -> 67.5
+
+    // Plan bazowy bez zmian
+    EXPECT_DOUBLE_EQ(base->getEntries()[0].weight, 100.0);
+}
+
+TEST(ProgramGeneratorTest, ParallelProgramsShareUnchangedEntries) {
+    // Test równoległego generowania i współdzielenia bloków wpisów między tygodniami
+    auto plank = std::make_shared<BodyweightExercise>("Deska", "", "Brzuch");
+    auto squat = std::make_shared<WeightedExercise>("Przysiad", "", "Nogi");
+    auto base = std::make_shared<WorkoutPlan>("Duży plan");
+    for(int i = 0; i < 64; ++i) {
+        base->addEntry(plank, 3, 30, 0.0, 60);
+    }
+    base->addEntry(squat, 5, 5, 100.0, 180);   // Jedyny wpis z progresją - ostatni blok
+
+    ProgramSpec spec;
+    spec.basePlan = base;
+    spec.deload.every = 0;
+    ProgressionRule none;
+    none.kind = ProgressionRule::Kind::NONE;
+    ProgressionRule linear;
+    linear.exerciseName = "Przysiad";
+    spec.rules = {linear, none};
+
+    std::vector<ProgramSpec> specs;
+    for(int client = 0; client < 300; ++client) {
+        spec.name = "Klient " + std::to_string(client);
+        specs.push_back(spec);
+    }
+    ThreadPool pool(4);
+    auto programs = ProgramGenerator::generateAll(specs, pool);
+    ASSERT_EQ(programs.size(), 300u);
+    EXPECT_EQ(programs[299].weeks[11]->getName(), "Klient 299 - tydzień 12");
+    EXPECT_DOUBLE_EQ(programs[123].weeks[11]->getEntries()[64].weight, 127.5);
+
+    const auto& week5 = programs[7].weeks[5]->getEntries();
+    const auto& week6 = programs[7].weeks[6]->getEntries();
+    EXPECT_TRUE(week6.sharesChunkWith(week5, 0));
+    EXPECT_TRUE(week6.sharesChunkWith(base->getEntries(), 63));
+    EXPECT_FALSE(week6.sharesChunkWith(week5, 64));
+
+    // 12 tygodni po 65 wpisów: zamiast 12 pełnych kopii - jedna plus zmienione bloki
+    const size_t oneWeek = 65 * sizeof(PlanEntry);
+    EXPECT_LT(programs[7].estimateMemoryUsage(), 3 * oneWeek);
+
+    spec.basePlan = nullptr;
+    specs.push_back(spec);
+    EXPECT_THROW(ProgramGenerator::generateAll(specs, pool), std::invalid_argument);
+}
+
+// ===== TEST 23: Optymalizator planów =====
+
+TEST(PlanOptimizerTest, FitsBudgetAndBalancesMuscles) {
+    // Test ograniczeń: budżet czasu, cele objętości i filtr typu
+    std::vector<std::shared_ptr<Exercise>> catalog = {
+        ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Wyciskanie", "", "Klatka, Triceps"),
+        ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Wiosłowanie", "", "Plecy, Biceps"),
+        ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Przysiad", "", "Nogi"),
+        ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Pompki", "", "Klatka"),
+        ExerciseFactory::createExercise(ExerciseType::BODYWEIGHT, "Podciąganie", "", "Plecy"),
+        ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Uginanie", "", "Biceps")};
+    EXPECT_EQ(PlanOptimizer::parseMuscles(" Klatka / TRICEPS; klatka"),
+              (std::vector<std::string>{"klatka", "triceps"}));
+
+    OptimizerConstraints constraints;
+    constraints.durationSeconds = 45 * 60;
+    constraints.muscleTargets = {{"klatka", 6}, {"plecy", 6}, {"nogi", 4}};
+    ThreadPool pool(4);
+    auto results = PlanOptimizer::optimize("Sesja", catalog, constraints, OptimizerOptions(), pool);
+    ASSERT_FALSE(results.empty());
+    const auto& best = results[0];
+    EXPECT_NEAR(best.cost, 0.0, 1e-9);
+    EXPECT_LE(best.durationSeconds, constraints.durationSeconds);
+    EXPECT_EQ(PlanOptimizer::planDuration(*best.plan, constraints), best.durationSeconds);
+    for(size_t i = 1; i < results.size(); ++i) {
+        EXPECT_GE(results[i].cost, results[i - 1].cost);
+    }
+
+    // Krótki budżet: mniej serii, wciąż w limicie
+    constraints.durationSeconds = 20 * 60;
+    auto tight = PlanOptimizer::optimize("Krótka", catalog, constraints, OptimizerOptions(), pool);
+    ASSERT_FALSE(tight.empty());
+    EXPECT_LE(tight[0].durationSeconds, 20 * 60);
+    EXPECT_GT(tight[0].cost, 0.0);
+
+    constraints.type = ExerciseType::BODYWEIGHT;
+    for(const auto& result : PlanOptimizer::optimize("Bez sprzętu", catalog, constraints, OptimizerOptions(), pool)) {
+        for(const auto& entry : result.plan->getEntries()) {
+            EXPECT_EQ(entry.exercise->getType(), ExerciseType::BODYWEIGHT);
+        }
+    }
+
+    constraints.muscleTargets.clear();
+    EXPECT_THROW(PlanOptimizer::optimize("X", catalog, constraints, OptimizerOptions(), pool), std::invalid_argument);
+}
+
+TEST(PlanOptimizerTest, LargeCatalogWithinTimeBudget) {
+    // Test ograniczonego czasu odpowiedzi na dużym katalogu
+    const char* muscles[] = {"Klatka", "Plecy", "Nogi", "Barki", "Biceps", "Triceps", "Brzuch", "Łydki"};
+    std::vector<std::shared_ptr<Exercise>> catalog;
+    for(int i = 0; i < 20000; ++i) {
+        std::string target = std::string(muscles[i % 8]) + ", " + muscles[(i / 8) % 8];
+        catalog.push_back(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Ćwiczenie " + std::to_string(i), "", target));
+    }
+
+    OptimizerConstraints constraints;
+    constraints.muscleTargets = {{"Klatka", 8}, {"Plecy", 8}, {"Barki", 4}, {"Łydki", 3}};
+    OptimizerOptions options;
+    options.timeBudget = std::chrono::milliseconds(150);
+    ThreadPool pool(4);
+
+    auto results = PlanOptimizer::optimize("Duży katalog", catalog, constraints, options, pool);
+    ASSERT_FALSE(results.empty());
+    EXPECT_LE(results[0].durationSeconds, constraints.durationSeconds);
+
+    // Budżet zerowy: przygotowanie przerwane, beam pominięty - zostaje wynik zachłanny
+    options.timeBudget = std::chrono::milliseconds(0);
+    results = PlanOptimizer::optimize("Bez budżetu", catalog, constraints, options, pool);
+    ASSERT_FALSE(results.empty());
+    EXPECT_LE(results[0].durationSeconds, constraints.durationSeconds);
+    EXPECT_LT(results[0].cost, 4.0);   // Lepiej niż pusty plan (suma odchyleń = liczba celów)
+}
+
+// ===== TEST 24: Podobieństwo i duplikaty planów =====
+
+TEST(PlanSimilarityTest, FindsSimilarPlansAndTracksEdits) {
+    // Test wyszukiwania po zawartości - indeks nadąża za dodaniem, edycją i usunięciem
+    ExerciseRepository exercises("test_similar_ex.json");
+    WorkoutPlanRepository plans("test_similar_plans.json", &exercises);
+    std::vector<std::shared_ptr<Exercise>> pool;
+    for(int i = 0; i < 12; ++i) {
+        pool.push_back(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Ćwiczenie " + std::to_string(i), "", "Klatka"));
+        exercises.addExercise(pool.back());
+    }
+    auto makePlan = [&pool](const std::string& name, int first, int reps) {
+        auto plan = std::make_shared<WorkoutPlan>(name);
+        for(int i = first; i < first + 6; ++i) {
+            plan->addEntry(pool[i], 3, i == first ? reps : 10, 50.0, 90);
+        }
+        return plan;
+    };
+
+    auto push = makePlan("Push", 0, 10);
+    plans.addPlan(push);
+    plans.addPlan(makePlan("Push v2", 0, 12));
+    plans.addPlan(makePlan("Pull", 6, 10));
+
+    auto similar = plans.findSimilarPlans(*push);
+    ASSERT_EQ(similar.size(), 1u);
+    EXPECT_EQ(similar[0].plan->getName(), "Push v2");
+    EXPECT_NEAR(similar[0].similarity, 180.0 / 186.0, 1e-9);
+
+    // Profil ważony objętością: 30 wspólnych z 50 łącznie
+    WorkoutPlan a("A");
+    WorkoutPlan b("B");
+    a.addEntry(pool[0], 3, 10, 0.0, 60);
+    b.addEntry(pool[0], 3, 10, 0.0, 60);
+    b.addEntry(pool[1], 2, 10, 0.0, 60);
+    EXPECT_DOUBLE_EQ(PlanSimilarityIndex::similarity(a, b), 0.6);
+
+    plans.updatePlan("Push v2", makePlan("Push v2", 1, 10));
+    similar = plans.findSimilarPlans(*push, 10, 0.6);
+    ASSERT_EQ(similar.size(), 1u);
+    EXPECT_NEAR(similar[0].similarity, 150.0 / 210.0, 1e-9);   // 5 z 6 ćwiczeń wspólnych
+    EXPECT_TRUE(plans.findSimilarPlans(*push, 10, 0.8).empty());
+
+    plans.removePlan("Push v2");
+    EXPECT_TRUE(plans.findSimilarPlans(*push, 10, 0.1).empty());
+}
+
+TEST(PlanSimilarityTest, NearDuplicateClustersInParallel) {
+    // Test zadania wsadowego: 200 planów bazowych po 5 wariantów -> 200 skupisk
+    ExerciseRepository exercises("test_dedup_ex.json");
+    WorkoutPlanRepository plans("test_dedup_plans.json", &exercises);
+    std::vector<std::shared_ptr<Exercise>> pool;
+    for(int i = 0; i < 1000; ++i) {
+        pool.push_back(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Ćwiczenie " + std::to_string(i), "", "Nogi"));
+    }
+
+    plans.beginBatch();
+    for(int base = 0; base < 200; ++base) {
+        for(int variant = 0; variant < 5; ++variant) {
+            auto plan = std::make_shared<WorkoutPlan>("Plan " + std::to_string(base) + (variant ? " v" + std::to_string(variant + 1) : ""));
+            for(int k = 0; k < 8; ++k) {
+                plan->addEntry(pool[(base * 5 + k) % 1000], 3, k == variant ? 12 : 10, 40.0, 90);
+            }
+            plans.addPlan(plan);
+        }
+    }
+    plans.commitBatch();
+
+    ThreadPool threads(4);
+    auto clusters = plans.findNearDuplicates(0.8, &threads);
+    ASSERT_EQ(clusters.size(), 200u);
+    for(const auto& cluster : clusters) {
+        ASSERT_EQ(cluster.plans.size(), 5u);
+        const std::string& first = cluster.plans.front()->getName();
+        for(const auto& plan : cluster.plans) {
+            EXPECT_EQ(plan->getName().substr(0, first.size()), first);
+        }
+    }
+    EXPECT_TRUE(plans.findNearDuplicates(0.99, &threads).empty());
+}
+
+// ===== TEST 25: Rekomendacje ćwiczeń =====
+
+TEST(ExerciseRecommenderTest, IncrementalCoOccurrence) {
+    // Test przyrostowej macierzy współwystąpień - dodanie, edycja i usunięcie planu
+    ExerciseRepository exercises("test_recommend_ex.json");
+    WorkoutPlanRepository plans("test_recommend_plans.json", &exercises);
+    std::map<std::string, std::shared_ptr<Exercise>> byName;
+    for(const char* name : {"Wyciskanie", "Rozpiętki", "Francuskie", "Dipy", "Przysiad", "Wykroki"}) {
+        byName[name] = ExerciseFactory::createExercise(ExerciseType::WEIGHTED, name, "", "");
+        exercises.addExercise(byName[name]);
+    }
+    auto makePlan = [&byName](const std::string& name, std::vector<std::string> entries) {
+        auto plan = std::make_shared<WorkoutPlan>(name);
+        for(const auto& entry : entries) {
+            plan->addEntry(byName[entry], 3, 10, 20.0, 90);
+        }
+        return plan;
+    };
+    plans.addPlan(makePlan("A", {"Wyciskanie", "Rozpiętki", "Francuskie", "Wyciskanie"}));
+    plans.addPlan(makePlan("B", {"Wyciskanie", "Rozpiętki", "Dipy"}));
+    plans.addPlan(makePlan("C", {"Przysiad", "Wykroki"}));
+
+    WorkoutPlan draft("Szkic");
+    draft.addEntry(byName["Wyciskanie"], 3, 8, 60.0, 120);
+    auto suggestions = plans.recommendExercises(draft);
+    ASSERT_EQ(suggestions.size(), 3u);
+    EXPECT_EQ(suggestions[0].name, "Rozpiętki");
+    EXPECT_DOUBLE_EQ(suggestions[0].score, 1.0);
+    EXPECT_EQ(suggestions[1].name, "Dipy");        // Remis wyniku - alfabetycznie
+    EXPECT_EQ(suggestions[2].name, "Francuskie");
+
+    // Pusty szkic - najczęściej używane
+    auto popular = plans.recommendExercises(WorkoutPlan("Nowy"), 2);
+    ASSERT_EQ(popular.size(), 2u);
+    EXPECT_EQ(popular[0].name, "Rozpiętki");
+    EXPECT_EQ(popular[1].name, "Wyciskanie");
+
+    plans.removePlan("B");
+    plans.updatePlan("A", makePlan("A", {"Wyciskanie", "Przysiad"}));
+    suggestions = plans.recommendExercises(draft);
+    ASSERT_EQ(suggestions.size(), 1u);
+    EXPECT_EQ(suggestions[0].name, "Przysiad");
+
+    ExerciseRecommender recommender;
+    recommender.rebuild(plans.getAllPlans());
+    EXPECT_EQ(recommender.coOccurrences("Wyciskanie", "Przysiad"), 1u);
+    EXPECT_EQ(recommender.coOccurrences("Wyciskanie", "Rozpiętki"), 0u);
+    EXPECT_EQ(recommender.planCount("Przysiad"), 2u);
+}
+
+TEST(ExerciseRecommenderTest, LargeLibraryQueryIsFast) {
+    // Test zapytania na dużej bibliotece - czyta tylko wiersze ćwiczeń szkicu
+    std::vector<std::shared_ptr<Exercise>> pool;
+    for(int i = 0; i < 2000; ++i) {
+        pool.push_back(ExerciseFactory::createExercise(ExerciseType::WEIGHTED, "Ćwiczenie " + std::to_string(i), "", ""));
+    }
+    ExerciseRecommender recommender;
+    for(int p = 0; p < 20000; ++p) {
+        WorkoutPlan plan("Plan " + std::to_string(p));
+        for(int k = 0; k < 8; ++k) {
+            plan.addEntry(pool[static_cast<size_t>((p * 7 + k * k * 13) % 2000)], 3, 10, 0.0, 60);
+        }
+        recommender.addPlan(plan);
+    }
+
+    WorkoutPlan draft("Szkic");
+    draft.addEntry(pool[0], 3, 10, 0.0, 60);
+    draft.addEntry(pool[13], 3, 10, 0.0, 60);
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<ExerciseRecommendation> top;
+    for(int i = 0; i < 1000; ++i) {
+        top = recommender.recommend(draft, 5);
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    ASSERT_EQ(top.size(), 5u);
+    for(const auto& item : top) {
+        EXPECT_NE(item.name, "Ćwiczenie 0");
+        EXPECT_NE(item.name, "Ćwiczenie 13");
+        EXPECT_GT(recommender.coOccurrences("Ćwiczenie 0", item.name) + recommender.coOccurrences("Ćwiczenie 13", item.name), 0u);
+    }
+    EXPECT_LT(elapsed.count() / 1000, 1000);   // Średnio poniżej 1 ms na zapytanie
+}
+
+// ===== TEST 26: Obserwator wpisów i przenoszenie =====
+
+namespace {
+struct RecordingObserver : WorkoutPlanObserver {
+    std::vector<std::string> events;
+    int open = 0;
+
+    void entriesAboutToChange(const PlanEntryChange&) override { ++open; }
+    void entriesChanged(const PlanEntryChange& change) override {
+        --open;
+        static const char* kinds[] = {"insert", "remove", "edit", "move", "reset"};
+        events.push_back(std::string(kinds[static_cast<int>(change.kind)]) + " "
+                         + std::to_string(change.index) + (change.kind == PlanEntryChange::Kind::MOVE
+                                                               ? ">" + std::to_string(change.to) : ""));
+    }
+};
+}
+
+TEST(WorkoutPlanObserverTest, ReportsSingleEntryChanges) {
+    // Test zgłaszania zmian pojedynczych wpisów - kopia planu nie przejmuje obserwatora
+    auto squat = std::make_shared<WeightedExercise>("Przysiad", "", "Nogi");
+    auto pullups = std::make_shared<BodyweightExercise>("Podciąganie", "", "Plecy");
+    WorkoutPlan plan("Obserwowany");
+    RecordingObserver observer;
+    plan.setObserver(&observer);
+
+    plan.addEntry(squat, 3, 5, 100.0, 180);
+    plan.addEntry(pullups, 3, 8, 0.0, 120);
+    plan.insertEntry(1, squat, 2, 10, 60.0, 90);
+    plan.editEntry(0, 5, 5, 105.0, 180);
+    plan.moveEntry(0, 2);
+    plan.removeEntry(1);
+    EXPECT_THROW(plan.addEntry(squat, 0, 5, 0.0, 60), std::invalid_argument);   // Bez zgłoszenia
+
+    WorkoutPlan copy = plan;
+    copy.addEntry(squat, 1, 1, 0.0, 60);
+    plan.clear();
+
+    EXPECT_EQ(observer.open, 0);
+    EXPECT_EQ(observer.events, (std::vector<std::string>{"insert 0", "insert 1", "insert 1", "edit 0",
+                                                         "move 0>2", "remove 1", "reset 0"}));
+    ASSERT_EQ(copy.getEntryCount(), 3u);
+    EXPECT_EQ(copy.getEntries()[0].reps, 10);
+    EXPECT_EQ(copy.getEntries()[1].weight, 105.0);
+    plan.setObserver(nullptr);
+}
+
+TEST(WorkoutPlanObserverTest, MoveKeepsOrderAndSharesUntouchedChunks) {
+    // Test przenoszenia: kolejność po przeniesieniu i współdzielenie nieruszonych bloków
+    auto squat = std::make_shared<WeightedExercise>("Przysiad", "", "Nogi");
+    WorkoutPlan plan("Długi");
+    for(int i = 0; i < 200; ++i) {
+        plan.addEntry(squat, 1, i + 1, 0.0, 60);
+    }
+
+    WorkoutPlan published = plan;
+    plan.moveEntry(3, 7);
+    EXPECT_EQ(plan.getEntries()[7].reps, 4);
+    EXPECT_EQ(plan.getEntries()[3].reps, 5);
+    EXPECT_EQ(published.getEntries()[3].reps, 4);
+    for(size_t i = 16; i < 200; ++i) {
+        EXPECT_TRUE(plan.getEntries().sharesChunkWith(published.getEntries(), i));
+    }
+
+    plan.moveEntry(199, 0);
+    plan.moveEntry(1, 199);
+    EXPECT_EQ(plan.getEntries()[0].reps, 200);
+    EXPECT_EQ(plan.getEntries()[199].reps, 1);
+    EXPECT_THROW(plan.moveEntry(0, 200), std::out_of_range);
+
+    // Wielokrotne przenoszenie przez całą listę nie gubi ani nie dubluje wpisów
+    for(int i = 0; i < 1000; ++i) {
+        plan.moveEntry(static_cast<size_t>(i * 37 % 200), static_cast<size_t>(i * 91 % 200));
+    }
+    std::vector<int> reps;
+    for(const auto& entry : plan.getEntries()) {
+        reps.push_back(entry.reps);
+    }
+    std::sort(reps.begin(), reps.end());
+    for(int i = 0; i < 200; ++i) {
+        EXPECT_EQ(reps[static_cast<size_t>(i)], i + 1);
+    }
+}
+
+// ===== TEST 27: Partie zmian repozytoriów =====
+
+TEST(RepositoryChangeTest, BatchesChangesPerVersion) {
+    // Test partii zmian: pojedyncza operacja = jedna partia, MutationBatch = jedna partia
+    // z wszystkimi zmianami w kolejności, podmiana całości = reset
+    ExerciseRepository repo("test_changes_ex.json");
+    std::vector<ExerciseChangeBatch> batches;
+    uint64_t id = repo.subscribe([&batches](const ExerciseChangeBatch& batch) { batches.push_back(batch); });
+
+    repo.addExercise(std::make_shared<WeightedExercise>("Przysiad", "", "Nogi"));
+    ASSERT_EQ(batches.size(), 1u);
+    ASSERT_EQ(batches[0].changes.size(), 1u);
+    EXPECT_EQ(batches[0].changes[0].kind, RepositoryChange<Exercise>::Kind::ADDED);
+    EXPECT_EQ(batches[0].changes[0].after->getName(), "Przysiad");
+    EXPECT_EQ(batches[0].version, repo.getSnapshot()->getVersion());
+
+    {
+        MutationBatch<ExerciseRepository> batch(repo);
+        repo.addExercise(std::make_shared<BodyweightExercise>("Pompki", "", "Klatka"));
+        repo.updateExercise("Przysiad", std::make_shared<WeightedExercise>("Przysiad przedni", "", "Nogi"));
+        repo.removeExercise("Pompki");
+        EXPECT_EQ(batches.size(), 1u);   // Nic przed końcem partii
+    }
+    ASSERT_EQ(batches.size(), 2u);
+    const auto& changes = batches[1].changes;
+    ASSERT_EQ(changes.size(), 3u);
+    EXPECT_EQ(changes[0].kind, RepositoryChange<Exercise>::Kind::ADDED);
+    EXPECT_EQ(changes[1].kind, RepositoryChange<Exercise>::Kind::UPDATED);
+    EXPECT_EQ(changes[1].before->getName(), "Przysiad");
+    EXPECT_EQ(changes[1].after->getName(), "Przysiad przedni");
+    EXPECT_EQ(changes[2].kind, RepositoryChange<Exercise>::Kind::REMOVED);
+    EXPECT_EQ(changes[2].before->getName(), "Pompki");
+    EXPECT_EQ(batches[1].snapshot->getCount(), 1u);
+
+    repo.clear();
+    ASSERT_EQ(batches.size(), 3u);
+    EXPECT_TRUE(batches[2].reset);
+    EXPECT_TRUE(batches[2].changes.empty());
+
+    repo.unsubscribe(id);
+    repo.addExercise(std::make_shared<WeightedExercise>("Martwy ciąg", "", "Plecy"));
+    EXPECT_EQ(batches.size(), 3u);
+}
+
+TEST(RepositoryChangeTest, JournalAndIndexesFollowChanges) {
+    // Test subskrybentów: dziennik zapisu (co i od której wersji do zapisu)
+    // oraz indeksy zawartości planów aktualizowane partiami
+    ExerciseRepository exercises("test_changes_ex2.json");
+    WorkoutPlanRepository plans("test_changes_plans.json", &exercises);
+    ChangeJournal journal;
+    plans.subscribe([&journal](const WorkoutPlanChangeBatch& batch) { journal.record("plans", batch); });
+
+    auto bench = std::make_shared<WeightedExercise>("Wyciskanie", "", "Klatka");
+    auto flyes = std::make_shared<WeightedExercise>("Rozpiętki", "", "Klatka");
+    auto dips = std::make_shared<BodyweightExercise>("Dipy", "", "Klatka");
+    auto makePlan = [](const std::string& name, std::vector<std::shared_ptr<Exercise>> entries) {
+        auto plan = std::make_shared<WorkoutPlan>(name);
+        for(const auto& entry : entries) {
+            plan->addEntry(entry, 3, 10, 20.0, 90);
+        }
+        return plan;
+    };
+
+    EXPECT_TRUE(journal.needsSave("plans", 0));   // Nigdy nie zapisane
+    plans.addPlan(makePlan("A", {bench, flyes}));
+    journal.markSaved("plans", plans.getSnapshot()->getVersion());
+    EXPECT_FALSE(journal.needsSave("plans", plans.getSnapshot()->getVersion()));
+    EXPECT_FALSE(journal.hasPendingChanges("plans"));
+
+    plans.beginBatch();
+    plans.addPlan(makePlan("B", {bench, dips}));
+    plans.updatePlan("A", makePlan("A2", {bench, dips}));
+    plans.commitBatch();
+    const uint64_t version = plans.getSnapshot()->getVersion();
+    EXPECT_TRUE(journal.needsSave("plans", version));
+    EXPECT_FALSE(journal.needsSave("plans", version - 1));   // Zmiany nowsze od zapisywanej wersji
+    EXPECT_EQ(journal.pendingNames("plans"), (std::vector<std::string>{"A", "A2", "B"}));
+
+    // Indeksy po partii: rozpiętki zniknęły z planów, dipy są w obu
+    WorkoutPlan draft("Szkic");
+    draft.addEntry(bench, 3, 8, 60.0, 120);
+    auto suggestions = plans.recommendExercises(draft);
+    ASSERT_EQ(suggestions.size(), 1u);
+    EXPECT_EQ(suggestions[0].name, "Dipy");
+    auto similar = plans.findSimilarPlans(*makePlan("X", {bench, dips}), 10, 0.9);
+    EXPECT_EQ(similar.size(), 2u);
+
+    journal.markSaved("plans", version);
+    EXPECT_TRUE(journal.pendingNames("plans").empty());
+    plans.clear();
+    EXPECT_TRUE(journal.hasPendingChanges("plans"));
+    EXPECT_TRUE(plans.recommendExercises(draft).empty());
+}
+
+// ===== TEST 28: Przeładowanie plików zmienionych z zewnątrz =====
+
+TEST(ExternalReloadTest, ExerciseFileDiffAndConflicts) {
+    // Test przeładowania: zapis do zmienionego pliku odrzucony, do pamięci trafia
+    // tylko różnica (jedna partia), niezmienione ćwiczenia zostają tymi samymi obiektami
+    const std::string path = "test_reload_exercises.json";
+    ExerciseRepository external(path);
+    external.addExercise(std::make_shared<WeightedExercise>("Przysiad", "Stopy na szerokość bioder", "Nogi"));
+    external.addExercise(std::make_shared<WeightedExercise>("Wiosłowanie", "Plecy proste, łokcie przy tułowiu", "Plecy"));
+    external.addExercise(std::make_shared<WeightedExercise>("Wyciskanie", "Łopatki ściągnięte", "Klatka"));
+    external.addExercise(std::make_shared<BodyweightExercise>("Pompki", "Ciało w linii", "Klatka"));
+    ASSERT_TRUE(external.saveToJSON());
+
+    ExerciseRepository repo(path);
+    repo.setLazyDescriptions(true);
+    ASSERT_TRUE(repo.loadFromJSON());
+    auto rowing = repo.findByName("Wiosłowanie");
+    EXPECT_FALSE(repo.hasExternalChanges());
+
+    external.updateExercise("Przysiad", std::make_shared<WeightedExercise>("Przysiad", "Kolana na zewnątrz, pełny zakres", "Nogi"));
+    external.updateExercise("Wyciskanie", std::make_shared<WeightedExercise>("Wyciskanie", "Łopatki ściągnięte", "Klatka, triceps"));
+    external.removeExercise("Pompki");
+    external.addExercise(std::make_shared<WeightedExercise>("Martwy ciąg", "Sztanga blisko nóg", "Plecy"));
+    ASSERT_TRUE(external.saveToJSON());
+
+    EXPECT_TRUE(repo.hasExternalChanges());
+    EXPECT_FALSE(repo.saveToJSON());   // Konflikt - plik nie został nadpisany
+
+    std::vector<ExerciseChangeBatch> batches;
+    repo.subscribe([&batches](const ExerciseChangeBatch& batch) { batches.push_back(batch); });
+    std::string content;
+    ASSERT_TRUE(repo.readJSON(content));
+    auto store = repo.createDescriptionStore();
+    auto report = repo.applyExternalChanges(ExerciseRepository::parseJSON(content, nullptr, store), store,
+                                            [](const std::string& name) { return name == "Wyciskanie"; });
+
+    EXPECT_EQ(report.added, 1u);
+    EXPECT_EQ(report.updated, 1u);
+    EXPECT_EQ(report.removed, 1u);
+    EXPECT_EQ(report.unchanged, 1u);
+    EXPECT_EQ(report.conflicts, (std::vector<std::string>{"Wyciskanie"}));
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_EQ(batches[0].changes.size(), 3u);
+
+    EXPECT_EQ(repo.findByName("Wiosłowanie"), rowing);
+    EXPECT_EQ(rowing->getDescription(), "Plecy proste, łokcie przy tułowiu");   // Opis przepięty na nowy plik
+    EXPECT_EQ(repo.findByName("Przysiad")->getDescription(), "Kolana na zewnątrz, pełny zakres");
+    EXPECT_EQ(repo.findByName("Wyciskanie")->getTargetMuscles(), "Klatka");   // Zmiana lokalna wygrywa
+    EXPECT_FALSE(repo.exists("Pompki"));
+    EXPECT_TRUE(repo.exists("Martwy ciąg"));
+
+    EXPECT_FALSE(repo.hasExternalChanges());
+    EXPECT_TRUE(repo.saveToJSON());
+    std::remove(path.c_str());
+}
+
+TEST(ExternalReloadTest, PlanFileDiff) {
+    // Test przeładowania planów: porównanie po nazwach ćwiczeń i parametrach wpisów
+    const std::string path = "test_reload_plans.json";
+    ExerciseRepository exercises("test_reload_plan_ex.json");
+    auto squat = std::make_shared<WeightedExercise>("Przysiad", "", "Nogi");
+    auto rowing = std::make_shared<WeightedExercise>("Wiosłowanie", "", "Plecy");
+    exercises.addExercise(squat);
+    exercises.addExercise(rowing);
+
+    WorkoutPlanRepository plans(path, &exercises);
+    for(const char* name : {"A", "B", "C"}) {
+        auto plan = std::make_shared<WorkoutPlan>(name);
+        plan->addEntry(squat, 3, 5, 100.0, 180);
+        plan->addEntry(rowing, 3, 8, 60.0, 120);
+        plans.addPlan(plan);
+    }
+    ASSERT_TRUE(plans.saveToJSON());
+    auto unchanged = plans.findByName("A");
+
+    WorkoutPlanRepository external(path, &exercises);
+    ASSERT_TRUE(external.loadFromJSON());
+    auto edited = std::make_shared<WorkoutPlan>(*external.findByName("B"));
+    edited->editEntry(0, 5, 5, 100.0, 180);
+    external.updatePlan("B", edited);
+    external.removePlan("C");
+    auto added = std::make_shared<WorkoutPlan>("D");
+    added->addEntry(rowing, 4, 10, 50.0, 90);
+    external.addPlan(added);
+    ASSERT_TRUE(external.saveToJSON());
+
+    EXPECT_TRUE(plans.hasExternalChanges());
+    EXPECT_FALSE(plans.saveToJSON());
+
+    std::vector<WorkoutPlanChangeBatch> batches;
+    plans.subscribe([&batches](const WorkoutPlanChangeBatch& batch) { batches.push_back(batch); });
+    std::string content;
+    ASSERT_TRUE(plans.readJSON(content));
+    auto report = plans.applyExternalChanges(WorkoutPlanRepository::parseJSON(content));
+
+    EXPECT_EQ(report.added, 1u);
+    EXPECT_EQ(report.updated, 1u);
+    EXPECT_EQ(report.removed, 1u);
+    EXPECT_EQ(report.unchanged, 1u);
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_EQ(batches[0].changes.size(), 3u);
+    EXPECT_EQ(plans.findByName("A"), unchanged);
+    EXPECT_EQ(plans.findByName("B")->getEntries()[0].sets, 5);
+    EXPECT_FALSE(plans.exists("C"));
+    EXPECT_EQ(plans.getCount(), 3u);
+    EXPECT_TRUE(plans.saveToJSON());
+    std::remove(path.c_str());
+}
+
+TEST(ExternalReloadTest, ConflictKeepsLocalDescription) {
+    // Test opisu ćwiczenia zostawionego jako konflikt, gdy plik zmienił mu opis:
+    // stary magazyn czyta swoją wersję pliku, a plik nadpisany w miejscu daje
+    // pusty opis zamiast tekstu spod nieaktualnego offsetu
+    const std::string path = "test_reload_conflict.json";
+    ExerciseRepository external(path);
+    external.addExercise(std::make_shared<WeightedExercise>("Przysiad", "Stopy na szerokość bioder", "Nogi"));
+    external.addExercise(std::make_shared<WeightedExercise>("Wyciskanie", "Łopatki ściągnięte", "Klatka"));
+    ASSERT_TRUE(external.saveToJSON());
+
+    ExerciseRepository repo(path);
+    repo.setLazyDescriptions(true);
+    ASSERT_TRUE(repo.loadFromJSON());
+
+    external.updateExercise("Przysiad", std::make_shared<WeightedExercise>("Przysiad", "Kolana na zewnątrz", "Nogi"));
+    external.updateExercise("Wyciskanie", std::make_shared<WeightedExercise>(
+        "Wyciskanie", "Zupełnie inny, dłuższy opis z pliku", "Klatka"));
+    ASSERT_TRUE(external.saveToJSON());
+
+    std::string content;
+    ASSERT_TRUE(repo.readJSON(content));
+    auto store = repo.createDescriptionStore();
+    auto report = repo.applyExternalChanges(ExerciseRepository::parseJSON(content, nullptr, store), store,
+                                            [](const std::string& name) { return name == "Wyciskanie"; });
+    EXPECT_EQ(report.conflicts, (std::vector<std::string>{"Wyciskanie"}));
+    EXPECT_EQ(repo.findByName("Wyciskanie")->getDescription(), "Łopatki ściągnięte");
+    EXPECT_EQ(repo.findByName("Przysiad")->getDescription(), "Kolana na zewnątrz");
+
+    ASSERT_TRUE(repo.saveToJSON());   // Wersja lokalna trafia do pliku
+    ExerciseRepository reloaded(path);
+    ASSERT_TRUE(reloaded.loadFromJSON());
+    EXPECT_EQ(reloaded.findByName("Wyciskanie")->getDescription(), "Łopatki ściągnięte");
+    EXPECT_EQ(reloaded.findByName("Przysiad")->getDescription(), "Kolana na zewnątrz");
+
+    // Nadpisanie w miejscu (ten sam i-węzeł) - skrót się nie zgadza, opis odrzucony
+    auto ref = repo.findByName("Wyciskanie")->getLazyDescription();
+    ASSERT_NE(ref.digest, 0u);
+    ASSERT_TRUE(JsonUtils::readFile(path, content));
+    std::string scrambled = content;
+    std::fill(scrambled.begin() + static_cast<std::ptrdiff_t>(ref.offset),
+              scrambled.begin() + static_cast<std::ptrdiff_t>(ref.offset + ref.length), 'x');
+    std::ofstream(path, std::ios::binary | std::ios::in) << scrambled;
+    DescriptionStore inPlace(path);
+    EXPECT_EQ(inPlace.fetch(ref.offset, ref.length, false, ref.digest), "");
+    EXPECT_EQ(inPlace.fetch(ref.offset, ref.length), std::string(ref.length, 'x'));
+    std::remove(path.c_str());
+}
+
+TEST(ExternalReloadTest, JournalReportsPendingReset) {
+    // Test dziennika: podmiana całej kolekcji to konflikt całego pliku aż do zapisu
+    ExerciseRepository repo;
+    ChangeJournal journal;
+    repo.subscribe([&journal](const ExerciseChangeBatch& batch) { journal.record("exercises", batch); });
+    repo.addExercise(std::make_shared<WeightedExercise>("Przysiad", "", "Nogi"));
+    journal.markSaved("exercises", repo.getSnapshot()->getVersion());
+    EXPECT_FALSE(journal.hasPendingReset("exercises"));
+
+    repo.clear();
+    EXPECT_TRUE(journal.hasPendingReset("exercises"));
+    EXPECT_TRUE(journal.pendingNames("exercises").empty());   // Usuniętych nazw już nie zna
+    journal.markSaved("exercises", repo.getSnapshot()->getVersion());
+    EXPECT_FALSE(journal.hasPendingReset("exercises"));
+}
+
+TEST(ExternalReloadTest, ReloadKeepsNamesVisible) {
+    // Test przeładowania przy działających czytelnikach: ćwiczenia zmienione w pliku
+    // (ta sama nazwa) są cały czas widoczne dla findByName/exists
+    auto makeContent = [](const std::string& description) {
+        ExerciseRepository source("test_reload_visible_src.json");
+        for(int i = 0; i < 32; ++i) {
+            source.addExercise(std::make_shared<WeightedExercise>("Ćwiczenie " + std::to_string(i), description, "Nogi"));
+        }
+        EXPECT_TRUE(source.saveToJSON());
+        std::string content;
+        EXPECT_TRUE(source.readJSON(content));
+        return content;
+    };
+    const std::string first = makeContent("Wersja pierwsza");
+    const std::string second = makeContent("Wersja druga");
+
+    ExerciseRepository repo("test_reload_visible.json");
+    repo.applyExternalChanges(ExerciseRepository::parseJSON(first), nullptr);
+
+    std::atomic<bool> reloading{true};
+    std::atomic<int> missing{0};
+    std::vector<std::thread> readers;
+    for(int r = 0; r < 4; ++r) {
+        readers.emplace_back([&repo, &reloading, &missing, r]() {
+            const std::string name = "Ćwiczenie " + std::to_string(r);
+            while(reloading.load()) {
+                if(!repo.findByName(name) || !repo.exists(name)) {
+                    ++missing;
+                }
+            }
+        });
+    }
+    for(int i = 0; i < 60; ++i) {
+        auto report = repo.applyExternalChanges(ExerciseRepository::parseJSON(i % 2 == 0 ? second : first), nullptr);
+        EXPECT_EQ(report.updated, 32u);
+    }
+    reloading = false;
+    for(auto& t : readers) {
+        t.join();
+    }
+
+    EXPECT_EQ(missing.load(), 0);
+    EXPECT_EQ(repo.getCount(), 32u);
+    EXPECT_EQ(repo.findByName("Ćwiczenie 0")->getDescription(), "Wersja pierwsza");
+}
+
 // ===== MAIN - uruchomienie testów =====
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);